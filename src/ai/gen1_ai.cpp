@@ -1,12 +1,22 @@
 #include "gen1_ai.hpp"
+#include "../core/instrument.hpp"
 #include "../core/rng.hpp"
 #include "../data/game_data.hpp"
 #include <algorithm>
+#include <array>
 #include <iostream>
+#include <memory_resource>
 
 int Gen1AI::choose_move(const Pokemon &ai_pokemon,
                         const Pokemon &player_pokemon) const {
-  std::vector<MoveScore> scored_moves;
+  BATTLER_COUNT(AiDecisions);
+  BATTLER_TIME(AiDecision);
+
+  // A Pokemon has at most four moves, so the scores fit on the stack
+  std::array<std::byte, 128> scratch;
+  std::pmr::monotonic_buffer_resource arena(scratch.data(), scratch.size());
+  std::pmr::vector<MoveScore> scored_moves(&arena);
+  scored_moves.reserve(ai_pokemon.move_count());
 
   // Score each move
   for (int i = 0; i < ai_pokemon.move_count(); i++) {
@@ -156,7 +166,7 @@ int Gen1AI::apply_special_rules(const MoveData *move, int base_score,
 }
 
 int Gen1AI::weighted_random_select(
-    const std::vector<MoveScore> &scored_moves) const {
+    const std::pmr::vector<MoveScore> &scored_moves) const {
   // Find the minimum score to normalize
   int min_score = scored_moves[0].score;
   for (const auto &ms : scored_moves) {
@@ -167,14 +177,10 @@ int Gen1AI::weighted_random_select(
 
   // Normalize scores to be non-negative and convert to weights
   // Score 0 = weight 1, score 1 = weight 2, etc.
-  std::vector<int> weights;
   int total_weight = 0;
 
   for (const auto &ms : scored_moves) {
-    int normalized_score = ms.score - min_score;
-    int weight = normalized_score + 1; // Minimum weight of 1
-    weights.push_back(weight);
-    total_weight += weight;
+    total_weight += ms.score - min_score + 1; // Minimum weight of 1
   }
 
   // Weighted random selection
@@ -182,7 +188,7 @@ int Gen1AI::weighted_random_select(
   int cumulative = 0;
 
   for (size_t i = 0; i < scored_moves.size(); i++) {
-    cumulative += weights[i];
+    cumulative += scored_moves[i].score - min_score + 1;
     if (random_value < cumulative) {
       return scored_moves[i].move_index;
     }
@@ -1,6 +1,7 @@
 #pragma once
 #include "../core/move.hpp"
 #include "ai_interface.hpp"
+#include <memory_resource>
 #include <vector>
 
 
@@ -34,7 +35,8 @@ private:
                           const Pokemon &player_pokemon) const;
 
   // Step 4: Weighted random selection
-  int weighted_random_select(const std::vector<MoveScore> &scored_moves) const;
+  int weighted_random_select(
+      const std::pmr::vector<MoveScore> &scored_moves) const;
 
   // Helper: Calculate type effectiveness
   float calculate_effectiveness(PokeType move_type,
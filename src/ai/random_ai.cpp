@@ -1,11 +1,19 @@
 #include "random_ai.hpp"
+#include "../core/instrument.hpp"
 #include "../core/rng.hpp"
+#include <array>
+#include <memory_resource>
 #include <vector>
 
 int RandomAI::choose_move(const Pokemon &ai_pokemon,
                           const Pokemon &player_pokemon) const {
-  // Get all moves with PP remaining
-  std::vector<int> valid_moves;
+  BATTLER_COUNT(AiDecisions);
+  BATTLER_TIME(AiDecision);
+  // Get all moves with PP remaining (at most four, so on the stack)
+  std::array<std::byte, 64> scratch;
+  std::pmr::monotonic_buffer_resource arena(scratch.data(), scratch.size());
+  std::pmr::vector<int> valid_moves(&arena);
+  valid_moves.reserve(ai_pokemon.move_count());
   for (int i = 0; i < ai_pokemon.move_count(); i++) {
     if (ai_pokemon.get_move(i).has_pp()) {
       valid_moves.push_back(i);
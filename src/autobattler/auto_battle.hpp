@@ -1,11 +1,12 @@
 #pragma once
 #include "../ai/random_ai.hpp"
 #include "../core/battle.hpp"
+#include "../core/battle_output.hpp"
+#include "../core/battle_pool.hpp"
+#include "fast_battle.hpp"
+#include "team_cache.hpp"
 #include <iostream>
-
-
-// Result of an auto-battle
-enum class BattleResult { Win, Loss, Draw };
+#include <memory>
 
 // Automated battle system for auto-battler mode
 class AutoBattle {
@@ -27,11 +28,55 @@ private:
     return 0; // Fallback
   }
 
+  // Send in the first healthy team member once the active one faints
+  void replace_fainted(Battle &battle, int team_num) {
+    const Pokemon &active = team_num == 1 ? battle.active1 : battle.active2;
+    if (active.hp() > 0)
+      return;
+    std::pmr::vector<int> available = battle.get_available_pokemon(team_num);
+    if (!available.empty())
+      battle.switch_pokemon(team_num, available.front());
+  }
+
 public:
-  // Run an automated battle between two teams
-  BattleResult run(std::vector<Pokemon> team1, std::vector<Pokemon> team2,
-                   bool verbose = true) {
-    Battle battle(team1, team2);
+  // Run an automated battle between two teams. Quiet battles go through
+  // FastAutoBattle whenever it can model both teams.
+  BattleResult run(const std::vector<Pokemon> &team1,
+                   const std::vector<Pokemon> &team2, bool verbose = true) {
+    if (!verbose && !team1.empty() && !team2.empty()) {
+      FastAutoBattle fast;
+      if (fast.load(team1, team2))
+        return fast.run();
+    }
+    return run_engine(team1, team2, verbose);
+  }
+
+  // Quiet battle between interned teams, which skip setting up their
+  // sides (see TeamCache)
+  BattleResult run(const InternedTeam &team1, const InternedTeam &team2) {
+    FastAutoBattle fast;
+    if (fast.load(team1, team2))
+      return fast.run();
+    return run_engine(team1.team, team2.team, false);
+  }
+
+  // The same battle through the full engine, always
+  BattleResult run_engine(const std::vector<Pokemon> &team1,
+                          const std::vector<Pokemon> &team2,
+                          bool verbose = true) {
+    if (team1.empty() || team2.empty()) {
+      if (team1.empty() && team2.empty())
+        return BattleResult::Draw;
+      return team1.empty() ? BattleResult::Loss : BattleResult::Win;
+    }
+
+    // Engine text goes nowhere for quiet (simulated) battles
+    std::unique_ptr<QuietBattleOutput> quiet;
+    if (!verbose)
+      quiet.reset(new QuietBattleOutput());
+
+    BattlePool::Lease lease = BattlePool::local().acquire(team1, team2);
+    Battle &battle = *lease;
 
     if (verbose) {
       std::cout << "\n=== AUTO-BATTLE START ===\n";
@@ -40,8 +85,7 @@ public:
     }
 
     int turn = 0;
-    while (!battle.over &&
-           turn < 100) { // Max 100 turns to prevent infinite loops
+    while (!battle.over && turn < FastAutoBattle::MAX_TURNS) {
       turn++;
 
       if (verbose) {
@@ -55,6 +99,11 @@ public:
       // Execute turn
       battle.execute_turn(move1, move2);
 
+      if (!battle.over) {
+        replace_fainted(battle, 1);
+        replace_fainted(battle, 2);
+      }
+
       if (verbose) {
         std::cout << battle.active1.name() << " HP: " << battle.active1.hp()
                   << "/" << battle.active1.max_hp() << "\n";
@@ -0,0 +1,465 @@
+#include "fast_battle.hpp"
+#include "../core/rng.hpp"
+#include "../data/game_data.hpp"
+#include "team_cache.hpp"
+#include <algorithm>
+
+// Everything below mirrors the engine (Battle, calculate_damage, the move
+// handlers, Pokemon) step for step, including the order of every
+// random roll. A change to one of those has to be made here as well.
+
+namespace {
+
+// rng_int() on an engine fetched once per battle instead of once per roll
+inline int roll(std::mt19937 &rng, int lo, int hi) {
+  return std::uniform_int_distribution<int>(lo, hi)(rng);
+}
+
+const int HP = static_cast<int>(PokeStat::HP);
+const int ATTACK = static_cast<int>(PokeStat::Attack);
+const int DEFENSE = static_cast<int>(PokeStat::Defense);
+const int SPEED = static_cast<int>(PokeStat::Speed);
+const int SPECIAL = static_cast<int>(PokeStat::Special);
+
+// Pokemon::get_modified_stat
+int modified_stat(const FastAutoBattle::Mon &mon, int stat) {
+  int stage = mon.stages[stat];
+  double multiplier = stage >= 0 ? (2.0 + stage) / 2.0 : 2.0 / (2.0 - stage);
+  int modified = static_cast<int>(mon.stats[stat] * multiplier);
+
+  if (stat == ATTACK && mon.status == PokeStatus::Burn)
+    modified /= 2;
+  if (stat == SPEED && mon.status == PokeStatus::Paralysis)
+    modified /= 4;
+  return modified > 0 ? modified : 1;
+}
+
+// Pokemon::take_damage
+void take_damage(FastAutoBattle::Mon &mon, int damage) {
+  mon.hp -= damage;
+  if (mon.hp < 0)
+    mon.hp = 0;
+  if (mon.hp == 0)
+    mon.status = PokeStatus::Fainted;
+}
+
+// Pokemon::heal
+void heal(FastAutoBattle::Mon &mon, int amount) {
+  mon.hp += amount;
+  if (mon.hp > mon.max_hp)
+    mon.hp = mon.max_hp;
+}
+
+// Pokemon::apply_status
+void apply_status(std::mt19937 &rng, FastAutoBattle::Mon &mon,
+                  PokeStatus status) {
+  if (mon.status != PokeStatus::None)
+    return;
+  if ((status == PokeStatus::Poison || status == PokeStatus::Toxic) &&
+      (mon.type1 == PokeType::Poison || mon.type2 == PokeType::Poison))
+    return;
+  if (status == PokeStatus::Burn &&
+      (mon.type1 == PokeType::Fire || mon.type2 == PokeType::Fire))
+    return;
+
+  mon.status = status;
+  if (status == PokeStatus::Sleep)
+    roll(rng, 1, 7); // Sleep counter, never read back
+  else if (status == PokeStatus::Toxic)
+    mon.toxic_counter = 1;
+}
+
+// Pokemon::modify_stat_stage
+void add_stages(FastAutoBattle::Mon &mon, const CompiledEffect &change) {
+  int stat = static_cast<int>(change.stat);
+  if (stat == HP)
+    return;
+  int &stage = mon.stages[stat];
+  stage += change.stages;
+  if (stage > 6)
+    stage = 6;
+  if (stage < -6)
+    stage = -6;
+}
+
+// apply_stat_change
+void apply_stat_change(std::mt19937 &rng, FastAutoBattle::Mon &mon,
+                       const CompiledEffect &change) {
+  if (roll(rng, 1, 100) > change.chance)
+    return;
+  add_stages(mon, change);
+}
+
+// calculate_damage, with the type effectiveness already looked up
+int roll_damage(std::mt19937 &rng, const FastAutoBattle::Mon &attacker,
+                const FastAutoBattle::Mon &defender, const MoveData &move,
+                float effectiveness) {
+  if (move.category == MoveCategory::Status)
+    return 0;
+
+  int threshold = attacker.stats[SPEED] / 2;
+  if (threshold > 255)
+    threshold = 255;
+  int crit_factor = roll(rng, 0, 255) < threshold ? 2 : 1;
+
+  // Screens are never up: the moves that raise them take the full engine
+  int atk;
+  int def;
+  if (move.category == MoveCategory::Physical) {
+    atk = modified_stat(attacker, ATTACK);
+    def = modified_stat(defender, DEFENSE);
+  } else {
+    atk = modified_stat(attacker, SPECIAL);
+    def = modified_stat(defender, SPECIAL);
+  }
+  if (atk > 255 || def > 255) {
+    atk /= 4;
+    def /= 4;
+  }
+  if (def == 0)
+    def = 1;
+
+  int damage =
+      ((2 * attacker.level * crit_factor / 5 + 2) * move.power * atk / def) /
+          50 +
+      2;
+  if (move.type == attacker.type1 || move.type == attacker.type2)
+    damage += damage / 2;
+  damage = static_cast<int>(damage * effectiveness);
+
+  if (damage > 1)
+    damage = (damage * roll(rng, 217, 255)) / 255;
+  return damage;
+}
+
+// calculate_multi_hit_count
+int roll_hit_count(std::mt19937 &rng) {
+  int hits = roll(rng, 0, 7);
+  if (hits < 3)
+    return 2;
+  if (hits < 6)
+    return 3;
+  return hits < 7 ? 4 : 5;
+}
+
+} // namespace
+
+bool FastAutoBattle::supports(const MoveData *move) {
+  if (!move)
+    return true; // Empty slot, never has PP
+  if (!move->handler)
+    return false; // Never compiled (not in GameData), so no effect to read
+  switch (move->effect.kind) {
+  case MoveEffectType::Counter:
+  case MoveEffectType::TwoTurn:
+  case MoveEffectType::Disable:
+  case MoveEffectType::Bide:
+  case MoveEffectType::Reflect:
+  case MoveEffectType::LightScreen:
+    return false;
+  default:
+    return true;
+  }
+}
+
+bool FastAutoBattle::load_side(const std::vector<Pokemon> &team, Side &side) {
+  if (team.empty() || team.size() > static_cast<size_t>(MAX_TEAM))
+    return false;
+
+  side.size = static_cast<int>(team.size());
+  side.active = 0;
+  for (int i = 0; i < side.size; i++) {
+    const Pokemon &pokemon = team[i];
+    if (pokemon.has_reflect() || pokemon.has_light_screen() ||
+        pokemon.is_bide_active())
+      return false;
+
+    Mon &mon = side.mons[i];
+    mon.hp = pokemon.hp();
+    mon.max_hp = pokemon.max_hp();
+    for (int s = 0; s < 5; s++) {
+      mon.stats[s] = pokemon.stat(static_cast<PokeStat>(s));
+      mon.stages[s] = pokemon.stat_stage(static_cast<PokeStat>(s));
+    }
+    mon.level = pokemon.level();
+    mon.type1 = pokemon.type1();
+    mon.type2 = pokemon.type2();
+    mon.status = pokemon.status();
+    mon.toxic_counter = pokemon.toxic_counter();
+    mon.move_count = pokemon.move_count();
+    mon.matchup = nullptr;
+    for (int m = 0; m < 4; m++) {
+      const Move &move = pokemon.get_move(m);
+      if (!supports(move.data) || pokemon.is_move_disabled(m))
+        return false;
+      mon.moves[m] = move.data;
+      mon.pp[m] = move.current_pp;
+    }
+  }
+  return true;
+}
+
+bool FastAutoBattle::load(const std::vector<Pokemon> &team1,
+                          const std::vector<Pokemon> &team2) {
+  return load_side(team1, sides_[0]) && load_side(team2, sides_[1]);
+}
+
+bool FastAutoBattle::load(const InternedTeam &team1,
+                          const InternedTeam &team2) {
+  if (!team1.fast || !team2.fast)
+    return false;
+  sides_[0] = team1.side;
+  sides_[1] = team2.side;
+  return true;
+}
+
+void FastAutoBattle::update_effectiveness() {
+  const GameData &data = GameData::getInstance();
+  for (int s = 0; s < 2; s++) {
+    const Mon &attacker = sides_[s].mons[sides_[s].active];
+    const Mon &defender = sides_[1 - s].mons[sides_[1 - s].active];
+    for (int m = 0; m < 4; m++) {
+      const MoveData *move = attacker.moves[m];
+      if (!move)
+        continue;
+      if (defender.matchup) {
+        sides_[s].effectiveness[m] =
+            (*defender.matchup)[static_cast<size_t>(move->type)];
+        continue;
+      }
+      float type2_eff = 1.0f;
+      if (defender.type2 != PokeType::None)
+        type2_eff = data.getEffectiveness(move->type, defender.type2);
+      sides_[s].effectiveness[m] =
+          data.getEffectiveness(move->type, defender.type1) * type2_eff;
+    }
+  }
+}
+
+// Battle::execute_pokemon_move and Battle::apply_move
+void FastAutoBattle::use_move(Side &attacker_side, Mon &defender,
+                              int move_index) {
+  Mon &attacker = attacker_side.mons[attacker_side.active];
+  if (attacker.pp[move_index] <= 0)
+    return;
+
+  // can_move_with_status. A thaw never clears Freeze in the engine.
+  switch (attacker.status) {
+  case PokeStatus::Sleep:
+    return;
+  case PokeStatus::Freeze:
+    if (roll(*rng_, 1, 100) > 20)
+      return;
+    break;
+  case PokeStatus::Paralysis:
+    if (roll(*rng_, 1, 100) <= 25)
+      return;
+    break;
+  default:
+    break;
+  }
+
+  attacker.pp[move_index]--;
+  const MoveData &move = *attacker.moves[move_index];
+  const CompiledEffect &effect = move.effect;
+  float effectiveness = attacker_side.effectiveness[move_index];
+
+  switch (effect.kind) {
+  case MoveEffectType::Damage:
+  case MoveEffectType::None: {
+    int damage = roll_damage(*rng_, attacker, defender, move, effectiveness);
+    if (move.category != MoveCategory::Status && effectiveness == 0.0f)
+      return; // "It doesn't affect..." ends the move, secondary included
+    take_damage(defender, damage);
+    break;
+  }
+
+  case MoveEffectType::StatChange:
+    apply_stat_change(*rng_, effect.target == EffectTarget::Self
+                          ? attacker
+                          : defender,
+                      effect);
+    break;
+
+  case MoveEffectType::StatusInflict:
+    apply_status(*rng_, effect.target == EffectTarget::Self
+                     ? attacker
+                     : defender,
+                 effect.status);
+    break;
+
+  case MoveEffectType::Heal:
+    if (attacker.hp < attacker.max_hp)
+      heal(attacker, attacker.max_hp * effect.percent / 100);
+    break;
+
+  default: {
+    // The move handlers in engine/move_effects.cpp
+    int damage = 0;
+    int recoil = 0;
+    int drain = 0;
+    switch (effect.kind) {
+    case MoveEffectType::Recoil:
+    case MoveEffectType::Drain:
+    case MoveEffectType::HighCritRatio:
+    case MoveEffectType::Rage:
+      damage = roll_damage(*rng_, attacker, defender, move, effectiveness);
+      if (effect.kind == MoveEffectType::Recoil && damage > 0)
+        recoil = (damage * effect.percent) / 100;
+      if (effect.kind == MoveEffectType::Drain && damage > 0)
+        drain = (damage * effect.percent) / 100;
+      break;
+    case MoveEffectType::MultiHit:
+    case MoveEffectType::TwoHit: {
+      int hits = effect.kind == MoveEffectType::MultiHit ? roll_hit_count(*rng_) : 2;
+      for (int i = 0; i < hits; i++)
+        damage += roll_damage(*rng_, attacker, defender, move, effectiveness);
+      break;
+    }
+    case MoveEffectType::OHKO:
+      if (defender.level <= attacker.level) {
+        int accuracy = attacker.level - defender.level + 30;
+        if (accuracy > 100)
+          accuracy = 100;
+        if (roll(*rng_, 1, 100) <= accuracy)
+          damage = defender.hp;
+      }
+      break;
+    case MoveEffectType::FixedDamage:
+      if (effect.fixed == FixedDamageData::Type::Level)
+        damage = attacker.level;
+      else if (effect.fixed == FixedDamageData::Type::Constant)
+        damage = effect.fixed_value;
+      else
+        damage = std::max(1, defender.hp / 2);
+      break;
+    case MoveEffectType::Confusion:
+      roll(*rng_, 2, 5); // Confusion counter, never read back
+      break;
+    case MoveEffectType::Flinch:
+      roll(*rng_, 1, 100); // Flinching never stops a move
+      break;
+    case MoveEffectType::Haze:
+      attacker.stages.fill(0);
+      defender.stages.fill(0);
+      break;
+    default:
+      break; // Unimplemented effects do nothing
+    }
+
+    if (damage > 0)
+      take_damage(defender, damage);
+    if (recoil > 0)
+      take_damage(attacker, recoil);
+    if (drain > 0)
+      heal(attacker, drain);
+    break;
+  }
+  }
+
+  // apply_secondary_effect
+  const CompiledEffect &secondary = move.secondary;
+  if (secondary.kind == MoveEffectType::None ||
+      roll(*rng_, 1, 100) > secondary.chance)
+    return;
+  Mon &target = secondary.target == EffectTarget::Self ? attacker : defender;
+  switch (secondary.kind) {
+  case MoveEffectType::StatChange:
+    add_stages(target, secondary);
+    break;
+  case MoveEffectType::StatusInflict:
+    apply_status(*rng_, target, secondary.status);
+    break;
+  case MoveEffectType::Confusion:
+    roll(*rng_, 2, 5); // Confusion counter, never read back
+    break;
+  default:
+    break; // Flinching never stops a move
+  }
+}
+
+bool FastAutoBattle::team_defeated(const Side &side) const {
+  for (int i = 0; i < side.size; i++) {
+    if (side.mons[i].hp > 0)
+      return false;
+  }
+  return true;
+}
+
+BattleResult FastAutoBattle::run() {
+  rng_ = &rng_engine();
+  update_effectiveness();
+
+  bool over = false;
+  for (int turn = 0; turn < MAX_TURNS && !over; turn++) {
+    // AutoBattle::select_move: the first move with PP, else the first move
+    std::array<int, 2> choice;
+    for (int s = 0; s < 2; s++) {
+      const Mon &mon = sides_[s].mons[sides_[s].active];
+      choice[s] = 0;
+      for (int m = 0; m < mon.move_count; m++) {
+        if (mon.pp[m] > 0) {
+          choice[s] = m;
+          break;
+        }
+      }
+    }
+
+    Mon &active1 = sides_[0].mons[sides_[0].active];
+    Mon &active2 = sides_[1].mons[sides_[1].active];
+    int first = modified_stat(active1, SPEED) >= modified_stat(active2, SPEED)
+                    ? 0
+                    : 1;
+    int second = 1 - first;
+    Mon &first_mon = first == 0 ? active1 : active2;
+    Mon &second_mon = first == 0 ? active2 : active1;
+
+    if (first_mon.hp > 0)
+      use_move(sides_[first], second_mon, choice[first]);
+    if (second_mon.hp > 0 && first_mon.hp > 0)
+      use_move(sides_[second], first_mon, choice[second]);
+
+    // End-of-turn status damage
+    for (Mon *mon : {&active1, &active2}) {
+      if (mon->hp <= 0)
+        continue;
+      PokeStatus status = mon->status;
+      if (status == PokeStatus::Burn || status == PokeStatus::Poison ||
+          status == PokeStatus::Toxic) {
+        int damage = std::max(1, mon->max_hp / 16);
+        if (status == PokeStatus::Toxic) {
+          damage *= mon->toxic_counter;
+          if (mon->toxic_counter < 15)
+            mon->toxic_counter++;
+        }
+        take_damage(*mon, damage);
+      }
+    }
+
+    over = team_defeated(sides_[0]) || team_defeated(sides_[1]);
+    if (over)
+      break;
+
+    // AutoBattle::replace_fainted
+    bool switched = false;
+    for (Side &side : sides_) {
+      if (side.mons[side.active].hp > 0)
+        continue;
+      for (int i = 0; i < side.size; i++) {
+        if (side.mons[i].hp > 0 && i != side.active) {
+          side.active = i;
+          switched = true;
+          break;
+        }
+      }
+    }
+    if (switched)
+      update_effectiveness();
+  }
+
+  bool team1_defeated = team_defeated(sides_[0]);
+  bool team2_defeated = team_defeated(sides_[1]);
+  if (team1_defeated && team2_defeated)
+    return BattleResult::Draw;
+  return team2_defeated ? BattleResult::Win : BattleResult::Loss;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "../core/pokemon.hpp"
+#include <array>
+#include <random>
+#include <vector>
+
+struct InternedTeam;
+
+// Result of an auto-battle
+enum class BattleResult { Win, Loss, Draw };
+
+// AutoBattle for headless simulation. Both teams are copied once into
+// fixed-size arrays holding only what the engine reads during a battle (no
+// names, no logging, no allocation), and the AutoBattle policy of using the
+// first move with PP left is inlined into the turn loop.
+//
+// It makes exactly the engine's rng_int() calls in the same order, so for a
+// given seed it produces the same result as the full Battle. Teams using a
+// move whose effect keeps state this model lacks (Counter, Bide, Disable,
+// two-turn moves, screens) are refused by load(), as are moves that were
+// never added to GameData and so have no compiled effect to read.
+class FastAutoBattle {
+public:
+  static const int MAX_TEAM = 6;
+  static const int MAX_TURNS = 100; // Same cap as AutoBattle
+
+  struct Mon {
+    int hp;
+    int max_hp;
+    std::array<int, 5> stats;  // Unmodified, indexed by PokeStat
+    std::array<int, 5> stages; // -6 to +6
+    int level;
+    PokeType type1;
+    PokeType type2;
+    PokeStatus status;
+    int toxic_counter; // Pokemon::toxic_counter
+    int move_count;
+    std::array<const MoveData *, 4> moves;
+    std::array<int, 4> pp;
+    // Precomputed type matchup as a defender (interned teams only)
+    const TypeMatchup *matchup = nullptr;
+  };
+
+  struct Side {
+    std::array<Mon, MAX_TEAM> mons;
+    int size;
+    int active;
+    std::array<float, 4> effectiveness; // Active's moves vs. the other active
+  };
+
+private:
+  std::array<Side, 2> sides_;
+  std::mt19937 *rng_ = nullptr; // This thread's rng_engine() while running
+
+  void update_effectiveness();
+  void use_move(Side &attacker_side, Mon &defender, int move_index);
+  bool team_defeated(const Side &side) const;
+
+public:
+  // False if a team is larger than MAX_TEAM or needs the full engine
+  bool load(const std::vector<Pokemon> &team1,
+            const std::vector<Pokemon> &team2);
+  // Copies the sides the teams were interned with (see TeamCache), which
+  // must outlive the battle
+  bool load(const InternedTeam &team1, const InternedTeam &team2);
+
+  // One team's side as load() sets it up; false if it cannot be modelled
+  static bool load_side(const std::vector<Pokemon> &team, Side &side);
+
+  // Fight the loaded teams; the result is from team 1's point of view
+  BattleResult run();
+
+  // Whether the fast path models every effect of this move
+  static bool supports(const MoveData *move);
+
+  const Side &side(int team_num) const { return sides_[team_num - 1]; }
+};
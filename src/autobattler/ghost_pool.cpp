@@ -0,0 +1,267 @@
+#include "ghost_pool.hpp"
+#include "../data/binary_io.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+const char GHOST_MAGIC[8] = {'G', '1', 'G', 'H', 'O', 'S', 'T', 'S'};
+const uint32_t GHOST_FORMAT_VERSION = 1;
+const size_t HEADER_SIZE = 32;
+const size_t MON_SIZE = DataCatalog::PACKED_MON_SIZE;
+const size_t RECORD_SIZE = 8 + 6 * MON_SIZE;
+
+void encode_record(const GhostSnapshot &snapshot, uint8_t *out) {
+  put_u16(out, snapshot.round);
+  out[2] = snapshot.tier;
+  out[3] = snapshot.team_size;
+  put_u16(out + 4, snapshot.wins);
+  put_u16(out + 6, snapshot.hearts);
+  for (int i = 0; i < 6; i++)
+    DataCatalog::encode(snapshot.team[i], out + 8 + i * MON_SIZE);
+}
+
+GhostSnapshot decode_record(const uint8_t *in) {
+  GhostSnapshot snapshot;
+  snapshot.round = get_u16(in);
+  snapshot.tier = in[2];
+  snapshot.team_size = std::min<uint8_t>(in[3], 6);
+  snapshot.wins = get_u16(in + 4);
+  snapshot.hearts = get_u16(in + 6);
+  for (int i = 0; i < 6; i++)
+    snapshot.team[i] = DataCatalog::decode(in + 8 + i * MON_SIZE);
+  return snapshot;
+}
+
+} // namespace
+
+GhostPool::GhostPool(const std::string &path)
+    : path_(path), mapped_records_(0),
+      buckets_(static_cast<size_t>(MAX_ROUND + 1) * (MAX_TIER + 1)),
+      persistent_(false), file_(nullptr), writing_(false),
+      stopping_(false) {
+  if (path_.empty())
+    return;
+
+  // Drop a record torn by a crash so new appends stay aligned
+  std::error_code error;
+  uintmax_t file_size = std::filesystem::file_size(path_, error);
+  if (!error && file_size > HEADER_SIZE &&
+      (file_size - HEADER_SIZE) % RECORD_SIZE != 0) {
+    std::filesystem::resize_file(
+        path_, file_size - (file_size - HEADER_SIZE) % RECORD_SIZE, error);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  map_file();
+  if (!persistent_)
+    return;
+
+  file_ = std::fopen(path_.c_str(), "ab");
+  if (!file_) {
+    std::cerr << "[Ghosts] Cannot append to " << path_
+              << ", keeping ghosts in memory\n";
+    persistent_ = false;
+    return;
+  }
+  if (mapped_.size() == 0) {
+    uint8_t header[HEADER_SIZE] = {};
+    std::memcpy(header, GHOST_MAGIC, sizeof(GHOST_MAGIC));
+    put_u32(header + 8, GHOST_FORMAT_VERSION);
+    put_u32(header + 12, static_cast<uint32_t>(RECORD_SIZE));
+    put_u64(header + 16, catalog_.fingerprint());
+    std::fwrite(header, 1, sizeof(header), file_);
+    std::fflush(file_);
+  }
+  writer_ = std::thread([this]() { writer_loop(); });
+}
+
+GhostPool::~GhostPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  writer_cv_.notify_all();
+  if (writer_.joinable())
+    writer_.join();
+  if (file_)
+    std::fclose(file_);
+}
+
+size_t GhostPool::bucket_index(int round, int tier) {
+  round = std::max(1, std::min(round, static_cast<int>(MAX_ROUND)));
+  tier = std::max(1, std::min(tier, static_cast<int>(MAX_TIER)));
+  return static_cast<size_t>(round) * (MAX_TIER + 1) +
+         static_cast<size_t>(tier);
+}
+
+void GhostPool::map_file() {
+  mapped_.close();
+  mapped_records_ = 0;
+  added_.clear();
+  for (auto &bucket : buckets_)
+    bucket.clear();
+
+  if (!mapped_.open(path_)) {
+    persistent_ = true; // No file yet; it is created on first use
+    return;
+  }
+  if (mapped_.size() == 0) {
+    persistent_ = true;
+    return;
+  }
+
+  const uint8_t *data = mapped_.data();
+  bool valid = mapped_.size() >= HEADER_SIZE &&
+               std::memcmp(data, GHOST_MAGIC, sizeof(GHOST_MAGIC)) == 0 &&
+               get_u32(data + 8) == GHOST_FORMAT_VERSION &&
+               get_u32(data + 12) == RECORD_SIZE;
+  if (!valid) {
+    std::cerr << "[Ghosts] " << path_
+              << " is not a ghost file, keeping ghosts in memory\n";
+    mapped_.close();
+    persistent_ = false;
+    return;
+  }
+  if (get_u64(data + 16) != catalog_.fingerprint()) {
+    std::cerr << "[Ghosts] " << path_
+              << " was recorded with different game data, keeping ghosts "
+                 "in memory\n";
+    mapped_.close();
+    persistent_ = false;
+    return;
+  }
+
+  mapped_records_ = (mapped_.size() - HEADER_SIZE) / RECORD_SIZE;
+  for (size_t i = 0; i < mapped_records_; i++) {
+    const uint8_t *record = data + HEADER_SIZE + i * RECORD_SIZE;
+    // Only the round and tier are needed to index
+    buckets_[bucket_index(get_u16(record), record[2])].push_back(
+        static_cast<uint32_t>(i));
+  }
+  persistent_ = true;
+}
+
+void GhostPool::index(const GhostSnapshot &snapshot, uint32_t record) {
+  buckets_[bucket_index(snapshot.round, snapshot.tier)].push_back(record);
+}
+
+GhostSnapshot GhostPool::read(uint32_t record) const {
+  if (record < mapped_records_) {
+    return decode_record(mapped_.data() + HEADER_SIZE + record * RECORD_SIZE);
+  }
+  return added_[record - mapped_records_];
+}
+
+void GhostPool::writer_loop() {
+  std::vector<GhostSnapshot> batch;
+  std::vector<uint8_t> bytes;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    writer_cv_.wait(lock, [this]() { return stopping_ || !unwritten_.empty(); });
+    if (unwritten_.empty() && stopping_)
+      break;
+
+    batch.swap(unwritten_);
+    writing_ = true;
+    lock.unlock();
+
+    bytes.resize(batch.size() * RECORD_SIZE);
+    for (size_t i = 0; i < batch.size(); i++) {
+      encode_record(batch[i], bytes.data() + i * RECORD_SIZE);
+    }
+    std::fwrite(bytes.data(), 1, bytes.size(), file_);
+    std::fflush(file_);
+    batch.clear();
+
+    lock.lock();
+    writing_ = false;
+    flushed_cv_.notify_all();
+  }
+}
+
+GhostSnapshot GhostPool::snapshot(const PlayerState &player) const {
+  GhostSnapshot snapshot;
+  snapshot.round = static_cast<uint16_t>(player.round());
+  snapshot.tier = static_cast<uint8_t>(player.tier());
+  snapshot.wins = static_cast<uint16_t>(player.wins());
+  snapshot.hearts = static_cast<uint16_t>(player.hearts());
+  std::memset(snapshot.team, 0, sizeof(snapshot.team));
+
+  for (const Pokemon &mon : player.team()) {
+    if (snapshot.team_size == 6)
+      break;
+    if (catalog_.pack(mon, snapshot.team[snapshot.team_size]))
+      snapshot.team_size++;
+  }
+  return snapshot;
+}
+
+std::vector<Pokemon>
+GhostPool::build_team(const GhostSnapshot &snapshot) const {
+  std::vector<Pokemon> team;
+  for (int i = 0; i < snapshot.team_size; i++)
+    catalog_.unpack(snapshot.team[i], team);
+  return team;
+}
+
+void GhostPool::record(const PlayerState &player) { record(snapshot(player)); }
+
+void GhostPool::record(const GhostSnapshot &snapshot) {
+  if (snapshot.team_size == 0)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    index(snapshot, static_cast<uint32_t>(mapped_records_ + added_.size()));
+    added_.push_back(snapshot);
+    if (!persistent_)
+      return;
+    unwritten_.push_back(snapshot);
+  }
+  writer_cv_.notify_one();
+}
+
+bool GhostPool::draw(int round, int tier, std::mt19937 &rng,
+                     std::vector<Pokemon> &team) {
+  GhostSnapshot chosen;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int start = std::max(1, std::min(round, static_cast<int>(MAX_ROUND)));
+    const std::vector<uint32_t> *bucket = nullptr;
+    for (int r = start; r >= 1 && !bucket; r--) {
+      const auto &candidates = buckets_[bucket_index(r, tier)];
+      if (!candidates.empty())
+        bucket = &candidates;
+    }
+    if (!bucket)
+      return false;
+    chosen = read((*bucket)[std::uniform_int_distribution<size_t>(
+        0, bucket->size() - 1)(rng)]);
+  }
+  team = build_team(chosen);
+  return !team.empty();
+}
+
+void GhostPool::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  flushed_cv_.wait(lock,
+                   [this]() { return unwritten_.empty() && !writing_; });
+}
+
+void GhostPool::reload() {
+  if (path_.empty())
+    return;
+  // Everything recorded so far must be on disk before the remap forgets it
+  std::unique_lock<std::mutex> lock(mutex_);
+  flushed_cv_.wait(lock,
+                   [this]() { return unwritten_.empty() && !writing_; });
+  if (persistent_)
+    map_file();
+}
+
+size_t GhostPool::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return mapped_records_ + added_.size();
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "../data/catalog.hpp"
+#include "../data/mapped_file.hpp"
+#include "player_state.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A player's team as it entered a round
+struct GhostSnapshot {
+  uint16_t round = 0;
+  uint8_t tier = 0;
+  uint8_t team_size = 0;
+  uint16_t wins = 0;
+  uint16_t hearts = 0;
+  PackedMon team[6];
+};
+
+// Teams real players brought to each round, kept as an append-only file of
+// fixed-size records so ghosts survive restarts and build up over time.
+//
+// File: 32-byte header (magic, format version, record size, fingerprint of
+// the species/move lists) followed by 80-byte little-endian records. The
+// file is memory-mapped once when opened and indexed by (round, tier), so
+// drawing an opponent is a bucket lookup plus one random index. Recording
+// is asynchronous: snapshots are drawable at once and a writer thread
+// appends them to disk in batches.
+class GhostPool {
+public:
+  static const int MAX_ROUND = 64;
+  static const int MAX_TIER = 8;
+
+private:
+  std::string path_;
+  MappedFile mapped_;
+  size_t mapped_records_;            // Records served from the mapping
+  std::vector<GhostSnapshot> added_; // Recorded since the file was mapped
+
+  // Record number per (round, tier); numbers >= mapped_records_ are added_
+  std::vector<std::vector<uint32_t>> buckets_;
+
+  DataCatalog catalog_; // Species and moves as indexed in the file
+  bool persistent_; // False when the file is unusable; pool is memory-only
+
+  std::mutex mutex_; // Guards everything above
+  std::FILE *file_;  // Opened for appending; only the writer thread writes
+  std::vector<GhostSnapshot> unwritten_;
+  std::condition_variable writer_cv_;
+  std::condition_variable flushed_cv_;
+  bool writing_;
+  bool stopping_;
+  std::thread writer_;
+
+  static size_t bucket_index(int round, int tier);
+  void map_file(); // Caller holds mutex_
+  void index(const GhostSnapshot &snapshot, uint32_t record);
+  GhostSnapshot read(uint32_t record) const;
+  void writer_loop();
+
+public:
+  // Empty path keeps the pool in memory only
+  explicit GhostPool(const std::string &path);
+  ~GhostPool(); // Writes out everything recorded
+
+  GhostPool(const GhostPool &) = delete;
+  GhostPool &operator=(const GhostPool &) = delete;
+
+  // Snapshot the player's team as it enters the current round
+  void record(const PlayerState &player);
+  void record(const GhostSnapshot &snapshot);
+
+  // A team recorded for this round and tier, falling back to the closest
+  // earlier round at the same tier. False if there is none.
+  bool draw(int round, int tier, std::mt19937 &rng,
+            std::vector<Pokemon> &team);
+
+  GhostSnapshot snapshot(const PlayerState &player) const;
+  std::vector<Pokemon> build_team(const GhostSnapshot &snapshot) const;
+
+  // Block until every recorded snapshot is on disk
+  void flush();
+  // Flush, then remap the file to pick up other processes' appends
+  void reload();
+
+  size_t size();
+  bool persistent() const { return persistent_; }
+};
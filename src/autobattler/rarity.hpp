@@ -41,6 +41,19 @@ inline Rarity string_to_rarity(const std::string &str) {
   return Rarity::Common;
 }
 
+// Shop rarity is derived from a species' base stat total
+inline Rarity rarity_for_stat_total(int stat_total) {
+  if (stat_total >= 600)
+    return Rarity::Legendary;
+  if (stat_total >= 500)
+    return Rarity::Epic;
+  if (stat_total >= 450)
+    return Rarity::Rare;
+  if (stat_total >= 400)
+    return Rarity::Uncommon;
+  return Rarity::Common;
+}
+
 // Get base cost for a rarity tier
 inline int get_base_cost(Rarity rarity) {
   switch (rarity) {
@@ -0,0 +1,44 @@
+#pragma once
+#include "auto_battle.hpp"
+#include "player_state.hpp"
+#include <algorithm>
+
+// Round rules shared by the interactive game and the run simulator
+
+// Opponents grow from 3 Pokemon to a full team of 6 as rounds go on
+inline int opponent_team_size(int round) { return std::min(3 + round / 3, 6); }
+
+inline int opponent_level(int /*round*/) { return 50; }
+
+inline int win_reward(int round) { return 3 + round / 2; }
+
+// What applying a battle result did to the player
+struct RoundOutcome {
+  int gold_earned = 0;
+  bool tier_up = false;
+  bool heart_lost = false;
+};
+
+// Apply rewards or penalties for this round's battle and advance the round
+inline RoundOutcome apply_round_result(PlayerState &player,
+                                       BattleResult result) {
+  RoundOutcome outcome;
+  if (result == BattleResult::Win) {
+    player.record_win();
+    outcome.gold_earned = win_reward(player.round());
+    player.add_gold(outcome.gold_earned);
+
+    // Unlock tier every 3 rounds
+    if (player.round() % 3 == 0) {
+      player.unlock_tier();
+      outcome.tier_up = true;
+    }
+  } else if (result == BattleResult::Loss) {
+    player.record_loss();
+    player.lose_heart();
+    outcome.heart_lost = true;
+  }
+
+  player.next_round();
+  return outcome;
+}
@@ -0,0 +1,201 @@
+#include "run_simulator.hpp"
+#include "../core/rng.hpp"
+#include "../core/timeline.hpp"
+#include "../server/battle_executor.hpp"
+#include "../server/team_generator.hpp"
+#include "round_rules.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <set>
+
+static void count_picks(std::map<std::string, PickCount> &picks,
+                        const std::vector<const SpeciesData *> &species,
+                        bool won) {
+  std::set<const SpeciesData *> distinct(species.begin(), species.end());
+  for (const SpeciesData *entry : distinct) {
+    PickCount &count = picks[entry->name];
+    count.runs++;
+    if (won)
+      count.winning_runs++;
+  }
+}
+
+void SimulationReport::add(const RunRecord &record) {
+  runs++;
+  if (record.won)
+    winning_runs++;
+  rounds_survived += static_cast<uint64_t>(record.rounds_survived);
+  wins += static_cast<uint64_t>(record.wins);
+  battles += record.gold_by_round.size();
+
+  if (gold_by_round.size() < record.gold_by_round.size()) {
+    gold_by_round.resize(record.gold_by_round.size(), 0);
+    runs_by_round.resize(record.gold_by_round.size(), 0);
+  }
+  for (size_t i = 0; i < record.gold_by_round.size(); i++) {
+    gold_by_round[i] += static_cast<uint64_t>(record.gold_by_round[i]);
+    runs_by_round[i]++;
+  }
+
+  count_picks(species_picks, record.purchases, record.won);
+  count_picks(evolution_picks, record.evolutions, record.won);
+}
+
+void SimulationReport::merge(const SimulationReport &other) {
+  runs += other.runs;
+  winning_runs += other.winning_runs;
+  rounds_survived += other.rounds_survived;
+  wins += other.wins;
+  battles += other.battles;
+
+  if (gold_by_round.size() < other.gold_by_round.size()) {
+    gold_by_round.resize(other.gold_by_round.size(), 0);
+    runs_by_round.resize(other.runs_by_round.size(), 0);
+  }
+  for (size_t i = 0; i < other.gold_by_round.size(); i++) {
+    gold_by_round[i] += other.gold_by_round[i];
+    runs_by_round[i] += other.runs_by_round[i];
+  }
+
+  for (const auto &entry : other.species_picks) {
+    species_picks[entry.first].runs += entry.second.runs;
+    species_picks[entry.first].winning_runs += entry.second.winning_runs;
+  }
+  for (const auto &entry : other.evolution_picks) {
+    evolution_picks[entry.first].runs += entry.second.runs;
+    evolution_picks[entry.first].winning_runs += entry.second.winning_runs;
+  }
+}
+
+// Highest pick rate among winning runs first; "lift" compares it with the
+// pick rate over all runs, so > 1 means the pick is over-represented in wins
+static void print_picks(std::ostream &out, const char *title,
+                        const std::map<std::string, PickCount> &picks,
+                        uint64_t runs, uint64_t winning_runs, size_t top) {
+  std::vector<std::pair<std::string, PickCount>> rows(picks.begin(),
+                                                      picks.end());
+  std::stable_sort(rows.begin(), rows.end(), [](const auto &a, const auto &b) {
+    return a.second.winning_runs > b.second.winning_runs;
+  });
+
+  out << "\n" << title << " (winning runs / all runs, lift)\n";
+  if (winning_runs == 0 || rows.empty()) {
+    out << "  (no winning runs)\n";
+    return;
+  }
+  for (size_t i = 0; i < rows.size() && i < top; i++) {
+    double win_rate = 100.0 * rows[i].second.winning_runs / winning_runs;
+    double all_rate = 100.0 * rows[i].second.runs / runs;
+    out << "  " << std::left << std::setw(12) << rows[i].first << std::right
+        << std::setw(7) << win_rate << "% " << std::setw(7) << all_rate
+        << "%  x" << (all_rate > 0.0 ? win_rate / all_rate : 0.0) << "\n";
+  }
+}
+
+void SimulationReport::print(std::ostream &out, size_t top) const {
+  double total = runs > 0 ? static_cast<double>(runs) : 1.0;
+  double seconds = elapsed_seconds > 0.0 ? elapsed_seconds : 1.0;
+
+  out << std::fixed << std::setprecision(2);
+  out << "\n=== Simulation Results (" << seconds << " s) ===\n";
+  out << "Runs:             " << runs << " (" << runs / seconds << "/s)\n";
+  out << "Battles:          " << battles << " (" << battles / seconds
+      << "/s)\n";
+  out << "Winning runs:     " << winning_runs << " ("
+      << 100.0 * winning_runs / total << "%)\n";
+  out << "Rounds survived:  " << rounds_survived / total << " avg\n";
+  out << "Wins per run:     " << wins / total << " avg\n";
+
+  out << "\nGold entering each round (avg over runs still alive)\n";
+  for (size_t i = 0; i < gold_by_round.size(); i++) {
+    out << "  Round " << std::setw(2) << i + 1 << ": " << std::setw(6)
+        << static_cast<double>(gold_by_round[i]) / runs_by_round[i]
+        << " gold  (" << runs_by_round[i] << " runs)\n";
+  }
+
+  print_picks(out, "Species picks", species_picks, runs, winning_runs, top);
+  print_picks(out, "Evolutions", evolution_picks, runs, winning_runs, top);
+  out << std::defaultfloat;
+}
+
+RunSimulator::RunSimulator(const SimulationConfig &config)
+    : config_(config), policy_(make_shop_policy(config.policy)) {}
+
+RunRecord RunSimulator::play_run(uint64_t run_index) const {
+  RunRecord record;
+  if (!policy_)
+    return record;
+  timeline::Span run_span("sim", "run", run_index);
+
+  // Every stream this run draws from derives from (seed, run index)
+  std::seed_seq seq{config_.seed, static_cast<uint32_t>(run_index),
+                    static_cast<uint32_t>(run_index >> 32)};
+  std::mt19937 rng(seq);
+  rng_seed(rng());
+
+  PlayerState player("Sim");
+  Shop shop(player.tier(), rng());
+  ShopActions actions(player, shop, record);
+  AutoBattle auto_battle;
+
+  while (!player.is_game_over() && player.wins() < config_.win_target &&
+         player.round() <= config_.max_rounds) {
+    shop.set_tier(player.tier());
+    record.gold_by_round.push_back(player.gold());
+    uint32_t round = static_cast<uint32_t>(player.round());
+    {
+      timeline::Span span("sim", "shop", run_index, round);
+      policy_->play(actions, rng);
+    }
+
+    std::vector<Pokemon> opponents = generate_random_team(
+        opponent_team_size(player.round()), opponent_level(player.round()),
+        rng);
+    BattleResult result = BattleResult::Loss;
+    if (!player.team().empty()) {
+      timeline::Span span("sim", "battle", run_index, round);
+      result = auto_battle.run(player.team(), opponents, false);
+    }
+    apply_round_result(player, result);
+  }
+
+  record.rounds_survived = player.round() - 1;
+  record.wins = player.wins();
+  record.won = player.wins() >= config_.win_target;
+  return record;
+}
+
+SimulationReport RunSimulator::run() const {
+  auto start = std::chrono::steady_clock::now();
+
+  BattleExecutor executor(static_cast<unsigned>(std::max(0, config_.threads)),
+                          config_.pin_threads ? WorkerPlacement::Pinned
+                                              : WorkerPlacement::Floating);
+  std::atomic<uint64_t> next_run(0);
+  uint64_t run_count = static_cast<uint64_t>(std::max(0, config_.runs));
+
+  // Each worker fills a report of its own, allocated by that worker, so
+  // workers never write to the same cache lines until the final merge
+  std::vector<std::future<SimulationReport>> partial;
+  for (unsigned t = 0; t < executor.thread_count(); t++) {
+    partial.push_back(executor.submit([this, run_count, &next_run]() {
+      timeline::name_thread("sim worker");
+      SimulationReport part;
+      for (uint64_t i = next_run++; i < run_count; i = next_run++) {
+        part.add(play_run(i));
+      }
+      return part;
+    }));
+  }
+
+  SimulationReport report;
+  for (auto &part : partial) {
+    report.merge(part.get());
+  }
+  report.elapsed_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  return report;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "shop_policy.hpp"
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct SimulationConfig {
+  int runs = 10000;
+  int threads = 0;        // 0 uses one worker per hardware thread
+  bool pin_threads = false; // Pin workers by NUMA node (WorkerPlacement)
+  uint32_t seed = 1;      // Run i is always played from (seed, i)
+  int win_target = 10;    // Wins that end a run as a victory
+  int max_rounds = 40;    // Hard stop for runs that keep drawing
+  std::string policy = "greedy";
+};
+
+// How many runs picked something, overall and among winning runs
+struct PickCount {
+  uint64_t runs = 0;
+  uint64_t winning_runs = 0;
+};
+
+struct SimulationReport {
+  uint64_t runs = 0;
+  uint64_t winning_runs = 0;
+  uint64_t rounds_survived = 0; // Summed over runs
+  uint64_t wins = 0;
+  uint64_t battles = 0;
+
+  // Index r: summed gold entering round r + 1, and runs that got that far
+  std::vector<uint64_t> gold_by_round;
+  std::vector<uint64_t> runs_by_round;
+
+  // Counted once per run that bought / evolved into the species
+  std::map<std::string, PickCount> species_picks;
+  std::map<std::string, PickCount> evolution_picks;
+
+  double elapsed_seconds = 0.0;
+
+  void add(const RunRecord &record);
+  void merge(const SimulationReport &other);
+  // top: rows shown in each pick-rate table
+  void print(std::ostream &out, size_t top = 15) const;
+};
+
+// Plays complete autobattler runs headlessly: a ShopPolicy shops, AutoBattle
+// fights seeded random opponents, and the round rules of the interactive
+// game apply. Runs are spread over worker threads; each run reseeds its
+// thread's battle RNG, so a report depends only on the config.
+class RunSimulator {
+private:
+  SimulationConfig config_;
+  std::unique_ptr<ShopPolicy> policy_;
+
+public:
+  explicit RunSimulator(const SimulationConfig &config);
+
+  bool valid() const { return policy_ != nullptr; }
+
+  // Play one run; the same index always plays out the same way
+  RunRecord play_run(uint64_t run_index) const;
+
+  SimulationReport run() const;
+};
@@ -3,6 +3,8 @@
 #include "../data/game_data.hpp"
 #include "player_state.hpp"
 #include "rarity.hpp"
+#include "species_pools.hpp"
+#include <memory>
 #include <random>
 #include <vector>
 
@@ -24,85 +26,55 @@ private:
   int refresh_cost_;
   int tier_;
   std::mt19937 rng_;
+  // The pools last sampled, and the GameData version they were built from
+  std::shared_ptr<const SpeciesPools> pools_;
+  uint64_t pools_version_ = 0;
 
   // Get number of shop slots based on tier
   int get_slot_count() const {
     return 3 + tier_; // Tier 1: 4 slots, Tier 2: 5 slots, etc.
   }
 
-  // Select a random species based on rarity weights
-  const SpeciesData *select_random_species(Rarity target_rarity) {
-    std::vector<const SpeciesData *> candidates;
-
-    // Get all species from GameData
-    auto &game_data = GameData::getInstance();
-    auto all_names = game_data.getAllSpeciesNames();
-
-    // Iterate through all species and filter by rarity
-    // For now, assign rarity based on base stats total
-    for (const auto &name : all_names) {
-      const SpeciesData *species = game_data.getSpecies(name);
-      if (!species)
-        continue;
-
-      int stat_total = species->hp + species->attack + species->defense +
-                       species->special + species->speed;
-
-      Rarity species_rarity;
-      if (stat_total >= 600)
-        species_rarity = Rarity::Legendary;
-      else if (stat_total >= 500)
-        species_rarity = Rarity::Epic;
-      else if (stat_total >= 450)
-        species_rarity = Rarity::Rare;
-      else if (stat_total >= 400)
-        species_rarity = Rarity::Uncommon;
-      else
-        species_rarity = Rarity::Common;
-
-      if (species_rarity == target_rarity) {
-        candidates.push_back(species);
-      }
+  // The pools of the snapshot this thread reads. Only a change of version
+  // goes back to the snapshot for them, so parallel shops share no lock.
+  const SpeciesPools &pools() {
+    const GameDataSnapshot &data = GameData::getInstance().view();
+    if (!pools_ || pools_version_ != data.version()) {
+      pools_ = data.derived<SpeciesPools>();
+      pools_version_ = data.version();
     }
+    return *pools_;
+  }
 
-    if (candidates.empty())
-      return nullptr;
-
-    std::uniform_int_distribution<> dist(0, candidates.size() - 1);
-    return candidates[dist(rng_)];
+  // Select a random species of the given rarity
+  const SpeciesData *select_random_species(const SpeciesPools &pools,
+                                           Rarity target_rarity) {
+    return pools.pick(target_rarity, rng_);
   }
 
-  // Roll for a rarity based on weights
-  Rarity roll_rarity() {
-    std::uniform_int_distribution<> dist(1, 100);
-    int roll = dist(rng_);
-
-    if (roll <= 50)
-      return Rarity::Common;
-    if (roll <= 80)
-      return Rarity::Uncommon;
-    if (roll <= 95)
-      return Rarity::Rare;
-    if (roll <= 99)
-      return Rarity::Epic;
-    return Rarity::Legendary;
+  // Roll for a rarity based on spawn weights
+  Rarity roll_rarity(const SpeciesPools &pools) {
+    return pools.roll_rarity(rng_);
   }
 
 public:
-  Shop(int tier = 1)
-      : refresh_cost_(1), tier_(tier), rng_(std::random_device{}()) {
+  Shop(int tier = 1) : Shop(tier, std::random_device{}()) {}
+
+  // Seeded shop: the same seed offers the same Pokemon in the same order
+  Shop(int tier, uint32_t seed) : refresh_cost_(1), tier_(tier), rng_(seed) {
     slots_.resize(get_slot_count());
     refresh();
   }
 
   // Refresh the shop (generate new Pokemon)
   void refresh() {
+    const SpeciesPools &pools = this->pools();
     for (auto &slot : slots_) {
       if (slot.locked)
         continue; // Skip locked slots
 
-      Rarity rarity = roll_rarity();
-      const SpeciesData *species = select_random_species(rarity);
+      Rarity rarity = roll_rarity(pools);
+      const SpeciesData *species = select_random_species(pools, rarity);
 
       if (species) {
         slot.species = species;
@@ -126,14 +98,12 @@ public:
       return false;
 
     // Create Pokemon from species (using species name)
-    Pokemon mon(slot.species->name, 50); // All Pokemon are level 50
+    Pokemon mon(slot.species, 50); // All Pokemon are level 50
 
     // Assign 4 random moves
-    auto all_moves = GameData::getInstance().getAllMoveNames();
-    std::uniform_int_distribution<> move_dist(0, all_moves.size() - 1);
+    const SpeciesPools &pools = this->pools();
     for (int j = 0; j < 4; j++) {
-      std::string move_name = all_moves[move_dist(rng_)];
-      const MoveData *move_data = GameData::getInstance().getMove(move_name);
+      const MoveData *move_data = pools.random_move(rng_);
       if (move_data) {
         mon.add_move(Move(move_data));
       }
@@ -0,0 +1,178 @@
+#include "shop_policy.hpp"
+#include "evolution.hpp"
+#include "species_pools.hpp"
+#include <algorithm>
+
+// Cheapest Pokemon the shop ever offers; below this refreshing is pointless
+static const int MIN_USEFUL_GOLD = 2;
+
+// Bounds a shop phase even if a policy never runs out of gold
+static const int MAX_ACTIONS = 64;
+
+bool ShopActions::buy(size_t slot) {
+  if (slot >= shop_.slots().size())
+    return false;
+  const SpeciesData *species = shop_.slots()[slot].species;
+  if (!species || !shop_.purchase(slot, player_))
+    return false;
+  record_.purchases.push_back(species);
+  return true;
+}
+
+bool ShopActions::refresh() { return shop_.refresh_shop(player_); }
+
+int ShopActions::combine_all() {
+  std::vector<Pokemon> owned = player_.team();
+  owned.insert(owned.end(), player_.bench().begin(), player_.bench().end());
+
+  int combined = 0;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = 0; i < owned.size() && !changed; i++) {
+      for (size_t j = i + 1; j < owned.size(); j++) {
+        if (!EvolutionSystem::can_combine(owned[i], owned[j]))
+          continue;
+        Pokemon evolved =
+            EvolutionSystem::combine_and_evolve(owned[i], owned[j]);
+        record_.evolutions.push_back(evolved.species());
+        owned.erase(owned.begin() + j);
+        owned[i] = evolved;
+        combined++;
+        changed = true;
+        break;
+      }
+    }
+  }
+
+  if (combined > 0) {
+    player_.team().clear();
+    player_.bench() = std::move(owned);
+    arrange_team();
+  }
+  return combined;
+}
+
+void ShopActions::arrange_team() {
+  std::vector<Pokemon> owned = player_.team();
+  owned.insert(owned.end(), player_.bench().begin(), player_.bench().end());
+  std::stable_sort(owned.begin(), owned.end(),
+                   [](const Pokemon &a, const Pokemon &b) {
+                     return species_stat_total(*a.species()) >
+                            species_stat_total(*b.species());
+                   });
+
+  player_.team().clear();
+  player_.bench().clear();
+  for (const Pokemon &mon : owned) {
+    if (!player_.add_to_team(mon))
+      player_.add_to_bench(mon);
+  }
+}
+
+std::vector<size_t> ShopActions::affordable_slots() const {
+  std::vector<size_t> slots;
+  const auto &offered = shop_.slots();
+  for (size_t i = 0; i < offered.size(); i++) {
+    if (offered[i].species && offered[i].cost <= player_.gold())
+      slots.push_back(i);
+  }
+  return slots;
+}
+
+bool ShopActions::owns_evolvable(const SpeciesData *species) const {
+  if (!EvolutionSystem::get_evolution(species))
+    return false;
+  auto same = [species](const Pokemon &mon) {
+    return mon.species() == species;
+  };
+  return std::any_of(player_.team().begin(), player_.team().end(), same) ||
+         std::any_of(player_.bench().begin(), player_.bench().end(), same);
+}
+
+void RandomShopPolicy::play(ShopActions &actions, std::mt19937 &rng) const {
+  for (int step = 0; step < MAX_ACTIONS; step++) {
+    std::vector<size_t> affordable = actions.affordable_slots();
+    int choice = std::uniform_int_distribution<int>(0, 4)(rng);
+
+    if (choice == 0)
+      break; // Done shopping
+    if (affordable.empty() || choice == 1) {
+      if (actions.player().gold() < actions.shop().refresh_cost() +
+                                        MIN_USEFUL_GOLD ||
+          !actions.refresh())
+        break;
+      continue;
+    }
+    actions.buy(affordable[std::uniform_int_distribution<size_t>(
+        0, affordable.size() - 1)(rng)]);
+  }
+  actions.arrange_team();
+}
+
+void GreedyShopPolicy::play(ShopActions &actions, std::mt19937 &) const {
+  for (int step = 0; step < MAX_ACTIONS; step++) {
+    std::vector<size_t> affordable = actions.affordable_slots();
+    if (affordable.empty()) {
+      if (actions.player().gold() <
+              actions.shop().refresh_cost() + MIN_USEFUL_GOLD ||
+          !actions.refresh())
+        break;
+      continue;
+    }
+
+    const auto &slots = actions.shop().slots();
+    size_t best = *std::max_element(
+        affordable.begin(), affordable.end(), [&](size_t a, size_t b) {
+          if (slots[a].cost != slots[b].cost)
+            return slots[a].cost < slots[b].cost;
+          return species_stat_total(*slots[a].species) <
+                 species_stat_total(*slots[b].species);
+        });
+    actions.buy(best);
+  }
+  actions.combine_all();
+  actions.arrange_team();
+}
+
+void EvolveShopPolicy::play(ShopActions &actions, std::mt19937 &) const {
+  for (int step = 0; step < MAX_ACTIONS; step++) {
+    std::vector<size_t> affordable = actions.affordable_slots();
+    if (affordable.empty()) {
+      if (actions.player().gold() <
+              actions.shop().refresh_cost() + MIN_USEFUL_GOLD ||
+          !actions.refresh())
+        break;
+      continue;
+    }
+
+    // Duplicates of what we own first, then the cheapest species that can
+    // evolve at all, then simply the cheapest
+    const auto &slots = actions.shop().slots();
+    auto rank = [&](size_t slot) {
+      const SpeciesData *species = slots[slot].species;
+      if (actions.owns_evolvable(species))
+        return 0;
+      return EvolutionSystem::get_evolution(species) ? 1 : 2;
+    };
+    size_t pick = *std::min_element(
+        affordable.begin(), affordable.end(), [&](size_t a, size_t b) {
+          if (rank(a) != rank(b))
+            return rank(a) < rank(b);
+          return slots[a].cost < slots[b].cost;
+        });
+    actions.buy(pick);
+    actions.combine_all();
+  }
+  actions.arrange_team();
+}
+
+std::unique_ptr<ShopPolicy> make_shop_policy(const std::string &name) {
+  if (name == "random")
+    return std::unique_ptr<ShopPolicy>(new RandomShopPolicy());
+  if (name == "greedy")
+    return std::unique_ptr<ShopPolicy>(new GreedyShopPolicy());
+  if (name == "evolve")
+    return std::unique_ptr<ShopPolicy>(new EvolveShopPolicy());
+  return nullptr;
+}
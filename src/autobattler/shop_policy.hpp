@@ -0,0 +1,77 @@
+#pragma once
+#include "player_state.hpp"
+#include "shop.hpp"
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// What one simulated run did, for aggregation
+struct RunRecord {
+  int rounds_survived = 0;
+  int wins = 0;
+  bool won = false;                        // Reached the win target
+  std::vector<int> gold_by_round;          // Gold entering each shop phase
+  std::vector<const SpeciesData *> purchases;
+  std::vector<const SpeciesData *> evolutions; // Species evolved into
+};
+
+// The shop-phase moves a policy can make. Everything it buys or evolves is
+// written to the run's record.
+class ShopActions {
+private:
+  PlayerState &player_;
+  Shop &shop_;
+  RunRecord &record_;
+
+public:
+  ShopActions(PlayerState &player, Shop &shop, RunRecord &record)
+      : player_(player), shop_(shop), record_(record) {}
+
+  bool buy(size_t slot);
+  bool refresh();
+  // Evolve every pair of matching Pokemon on the team or bench
+  int combine_all();
+  // Strongest Pokemon (by base stat total) on the team, the rest benched
+  void arrange_team();
+
+  // Slots with a Pokemon the player can pay for
+  std::vector<size_t> affordable_slots() const;
+  // Does the player own a Pokemon this species would evolve with?
+  bool owns_evolvable(const SpeciesData *species) const;
+
+  const PlayerState &player() const { return player_; }
+  const Shop &shop() const { return shop_; }
+};
+
+// Plays a shop phase on behalf of a simulated player
+class ShopPolicy {
+public:
+  virtual ~ShopPolicy() = default;
+  virtual const char *name() const = 0;
+  virtual void play(ShopActions &actions, std::mt19937 &rng) const = 0;
+};
+
+// Buys affordable slots at random and never combines (baseline)
+class RandomShopPolicy : public ShopPolicy {
+public:
+  const char *name() const override { return "random"; }
+  void play(ShopActions &actions, std::mt19937 &rng) const override;
+};
+
+// Buys the most expensive affordable slot, refreshing when nothing fits
+class GreedyShopPolicy : public ShopPolicy {
+public:
+  const char *name() const override { return "greedy"; }
+  void play(ShopActions &actions, std::mt19937 &rng) const override;
+};
+
+// Chases duplicates of species it owns and evolves them immediately
+class EvolveShopPolicy : public ShopPolicy {
+public:
+  const char *name() const override { return "evolve"; }
+  void play(ShopActions &actions, std::mt19937 &rng) const override;
+};
+
+// "random", "greedy" or "evolve"; nullptr for anything else
+std::unique_ptr<ShopPolicy> make_shop_policy(const std::string &name);
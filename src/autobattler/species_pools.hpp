@@ -0,0 +1,83 @@
+#pragma once
+#include "../core/alias_table.hpp"
+#include "../data/game_data.hpp"
+#include "rarity.hpp"
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+inline int species_stat_total(const SpeciesData &species) {
+  return species.hp + species.attack + species.defense + species.special +
+         species.speed;
+}
+
+// Shop draw tables for one GameData snapshot: species bucketed by rarity,
+// an alias table per bucket plus one over the rarity spawn weights, and the
+// move list for new purchases. Rolling a slot is then two O(1) samples with
+// no allocation. Never changes once built; a reload gets its own pools,
+// built the first time a shop reads the new snapshot.
+class SpeciesPools {
+private:
+  static constexpr size_t RARITY_COUNT = 5;
+
+  std::array<std::vector<const SpeciesData *>, RARITY_COUNT> pools_;
+  std::array<AliasTable, RARITY_COUNT> pool_tables_;
+  AliasTable rarity_table_;
+  std::vector<const MoveData *> moves_;
+
+public:
+  explicit SpeciesPools(const GameDataSnapshot &data) {
+    for (const SpeciesData *species : data.getAllSpecies()) {
+      Rarity rarity = rarity_for_stat_total(species_stat_total(*species));
+      pools_[static_cast<size_t>(rarity)].push_back(species);
+    }
+
+    // Species are equally likely within their tier
+    for (size_t i = 0; i < RARITY_COUNT; i++) {
+      pool_tables_[i] = AliasTable(std::vector<double>(pools_[i].size(), 1.0));
+    }
+
+    std::vector<double> spawn_weights;
+    for (size_t i = 0; i < RARITY_COUNT; i++) {
+      spawn_weights.push_back(get_spawn_weight(static_cast<Rarity>(i)));
+    }
+    rarity_table_ = AliasTable(spawn_weights);
+
+    moves_ = data.getAllMoves();
+  }
+
+  // The pools of the snapshot this thread reads (see GameData::view), so a
+  // battle pinned to an older snapshot samples from that snapshot's data.
+  // Takes the snapshot's lock; hold on to them (as Shop does, per version)
+  // rather than asking per refresh.
+  static std::shared_ptr<const SpeciesPools> current() {
+    return GameData::getInstance().view().derived<SpeciesPools>();
+  }
+
+  SpeciesPools(const SpeciesPools &) = delete;
+  SpeciesPools &operator=(const SpeciesPools &) = delete;
+
+  Rarity roll_rarity(std::mt19937 &rng) const {
+    return static_cast<Rarity>(rarity_table_.sample(rng));
+  }
+
+  // nullptr when no species falls in this tier
+  const SpeciesData *pick(Rarity rarity, std::mt19937 &rng) const {
+    const auto &pool = pools_[static_cast<size_t>(rarity)];
+    if (pool.empty())
+      return nullptr;
+    return pool[pool_tables_[static_cast<size_t>(rarity)].sample(rng)];
+  }
+
+  const MoveData *random_move(std::mt19937 &rng) const {
+    if (moves_.empty())
+      return nullptr;
+    return moves_[std::uniform_int_distribution<size_t>(
+        0, moves_.size() - 1)(rng)];
+  }
+
+  const std::vector<const SpeciesData *> &pool(Rarity rarity) const {
+    return pools_[static_cast<size_t>(rarity)];
+  }
+};
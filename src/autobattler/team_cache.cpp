@@ -0,0 +1,71 @@
+#include "team_cache.hpp"
+
+namespace {
+
+std::shared_ptr<const InternedTeam> build(const TeamSpec &spec) {
+  std::shared_ptr<InternedTeam> interned(new InternedTeam());
+  interned->spec = spec;
+  if (!spec.to_team(interned->team))
+    return nullptr;
+
+  const GameData &data = GameData::getInstance();
+  for (const Pokemon &pokemon : interned->team)
+    interned->matchups.push_back(
+        data.getMatchup(pokemon.type1(), pokemon.type2()));
+
+  interned->fast = FastAutoBattle::load_side(interned->team, interned->side);
+  if (interned->fast) {
+    for (int i = 0; i < interned->side.size; i++)
+      interned->side.mons[i].matchup = &interned->matchups[i];
+  }
+  return interned;
+}
+
+} // namespace
+
+std::shared_ptr<const InternedTeam> TeamCache::intern(const TeamSpec &spec) {
+  Shard &shard = shards_[spec.hash() % SHARDS];
+  uint64_t version = GameData::getInstance().version();
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (version > shard.version) {
+      shard.teams.clear();
+      shard.version = version;
+    }
+    if (version == shard.version) {
+      auto found = shard.teams.find(spec);
+      if (found != shard.teams.end())
+        return found->second;
+    }
+  }
+
+  std::shared_ptr<const InternedTeam> built = build(spec);
+  if (!built)
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (shard.version != version)
+    return built; // Not the newest data (any more); do not keep it
+  return shard.teams.emplace(spec, built).first->second;
+}
+
+size_t TeamCache::size() const {
+  size_t total = 0;
+  for (const Shard &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    total += shard.teams.size();
+  }
+  return total;
+}
+
+void TeamCache::clear() {
+  for (Shard &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.teams.clear();
+  }
+}
+
+TeamCache &TeamCache::shared() {
+  static TeamCache cache;
+  return cache;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "../data/team_spec.hpp"
+#include "fast_battle.hpp"
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Everything about a team that a battle only reads, worked out once
+struct InternedTeam {
+  TeamSpec spec;
+  std::vector<Pokemon> team;         // Fresh, for the full engine
+  std::vector<TypeMatchup> matchups; // Per member, as a defender
+  bool fast = false;                 // FastAutoBattle can model it
+  FastAutoBattle::Side side;         // Loaded and pointing at matchups
+};
+
+// Interns teams by spec, so every caller asking for the same team shares
+// one InternedTeam instead of rebuilding its Pokemon, stats and type
+// matchups per battle. Safe from any number of threads: a lookup locks one
+// of SHARDS shards, and a team is built outside the lock (if two threads
+// race to build the same one, the first to finish is kept).
+//
+// The cache holds teams for the newest GameData version it has seen:
+// entries built against older data are dropped once a lookup comes from a
+// newer version, and a caller still pinned to an older snapshot gets a
+// team built for it that is not kept, so callers on different versions
+// never take turns emptying the cache.
+class TeamCache {
+public:
+  static const size_t SHARDS = 16;
+
+  // Null if the spec names something GameData does not have
+  std::shared_ptr<const InternedTeam> intern(const TeamSpec &spec);
+
+  size_t size() const;
+  void clear();
+
+  // One cache for the process
+  static TeamCache &shared();
+
+private:
+  struct Shard {
+    mutable std::mutex mutex;
+    uint64_t version = 0;
+    std::unordered_map<TeamSpec, std::shared_ptr<const InternedTeam>,
+                       TeamSpecHash>
+        teams;
+  };
+  std::array<Shard, SHARDS> shards_;
+};
@@ -1,12 +1,18 @@
 #include "autobattler/auto_battle.hpp"
 #include "autobattler/evolution.hpp"
+#include "autobattler/ghost_pool.hpp"
 #include "autobattler/player_state.hpp"
+#include "autobattler/round_rules.hpp"
 #include "autobattler/shop.hpp"
 #include "data/loader.hpp"
 #include "server/team_generator.hpp"
 #include <iostream>
+#include <random>
 #include <string>
 
+// Teams players brought to each round; later players fight them as ghosts
+static const char *GHOST_FILE = "ghosts.bin";
+
 void display_team(const PlayerState &player) {
   std::cout << "\n=== YOUR TEAM ===\n";
   const auto &team = player.team();
@@ -42,7 +48,8 @@ void display_shop(const Shop &shop) {
   std::cout << "\nRefresh cost: " << shop.refresh_cost() << " gold\n";
 }
 
-void shop_phase(PlayerState &player, Shop &shop) {
+// Returns false when the player quits
+bool shop_phase(PlayerState &player, Shop &shop) {
   while (true) {
     std::cout << "\n========================================\n";
     std::cout << "ROUND " << player.round() << " | TIER " << player.tier()
@@ -65,7 +72,8 @@ void shop_phase(PlayerState &player, Shop &shop) {
     std::cout << "\nChoice: ";
 
     std::string input;
-    std::getline(std::cin, input);
+    if (!std::getline(std::cin, input))
+      return false; // End of input
 
     if (input.empty())
       continue;
@@ -73,10 +81,10 @@ void shop_phase(PlayerState &player, Shop &shop) {
     char action = input[0];
 
     if (action == 'b') {
-      break; // Start battle
+      return true; // Start battle
     } else if (action == 'q') {
       std::cout << "Thanks for playing!\n";
-      exit(0);
+      return false; // Unwinds main so recorded ghosts are written out
     } else if (action == 'r') {
       if (shop.refresh_shop(player)) {
         std::cout << "Shop refreshed!\n";
@@ -143,42 +151,37 @@ void shop_phase(PlayerState &player, Shop &shop) {
   }
 }
 
-void battle_phase(PlayerState &player) {
-  // Generate opponent team based on round
-  int opponent_level = 50;
-  int team_size = std::min(3 + player.round() / 3, 6);
-
-  auto opponent_team = generate_random_team(team_size, opponent_level);
+void battle_phase(PlayerState &player, GhostPool &ghosts, std::mt19937 &rng) {
+  // Face a team another player brought to this round, if one was recorded
+  std::vector<Pokemon> opponent_team;
+  bool ghost = ghosts.draw(player.round(), player.tier(), rng, opponent_team);
+  if (!ghost) {
+    opponent_team = generate_random_team(opponent_team_size(player.round()),
+                                         opponent_level(player.round()), rng);
+  }
+  ghosts.record(player);
 
   std::cout << "\n=== BATTLE PHASE ===\n";
-  std::cout << "Opponent has " << opponent_team.size() << " Pokemon!\n";
+  std::cout << (ghost ? "A past player's ghost" : "Opponent") << " has "
+            << opponent_team.size() << " Pokemon!\n";
 
   AutoBattle auto_battle;
   BattleResult result = auto_battle.run(player.team(), opponent_team, true);
 
   // Handle result
+  RoundOutcome outcome = apply_round_result(player, result);
   if (result == BattleResult::Win) {
-    player.record_win();
-    int gold_reward = 3 + player.round() / 2;
-    player.add_gold(gold_reward);
-    std::cout << "You won! Earned " << gold_reward << " gold.\n";
-
-    // Unlock tier every 3 rounds
-    if (player.round() % 3 == 0) {
-      player.unlock_tier();
+    std::cout << "You won! Earned " << outcome.gold_earned << " gold.\n";
+    if (outcome.tier_up) {
       std::cout << "TIER UP! Now at tier " << player.tier() << "\n";
       std::cout << "Max team size increased to " << player.max_team_size()
                 << "\n";
     }
   } else if (result == BattleResult::Loss) {
-    player.record_loss();
-    player.lose_heart();
     std::cout << "You lost! Lost 1 heart.\n";
   } else {
     std::cout << "Draw! No rewards or penalties.\n";
   }
-
-  player.next_round();
 }
 
 int main() {
@@ -186,9 +189,8 @@ int main() {
 
   // Load game data
   std::cout << "Loading game data...\n";
-  load_species("src/data/species.json");
-  load_moves("src/data/moves.json");
-  load_type_chart("src/data/type_chart.json");
+  load_game_data("src/data/species.json", "src/data/moves.json",
+                 "src/data/type_chart.json");
   std::cout << "Game data loaded!\n";
 
   // Get player name
@@ -200,6 +202,8 @@ int main() {
 
   PlayerState player(name);
   Shop shop(player.tier());
+  GhostPool ghosts(GHOST_FILE);
+  std::mt19937 rng(std::random_device{}());
 
   std::cout << "\nWelcome, " << name << "!\n";
   std::cout << "You start with " << player.gold() << " gold and "
@@ -209,14 +213,15 @@ int main() {
   // Main game loop
   while (!player.is_game_over()) {
     shop.set_tier(player.tier());
-    shop_phase(player, shop);
+    if (!shop_phase(player, shop))
+      return 0;
 
     if (player.team().empty()) {
       std::cout << "\nYou need at least 1 Pokemon to battle!\n";
       continue;
     }
 
-    battle_phase(player);
+    battle_phase(player, ghosts, rng);
 
     if (player.is_game_over()) {
       std::cout << "\n=== GAME OVER ===\n";
@@ -0,0 +1,116 @@
+#include "autobattler/run_simulator.hpp"
+#include "core/timeline.hpp"
+#include "data/loader.hpp"
+#include "server/cpu_topology.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The same batch on 1, 2, 4 ... CPUs and then all of them, with workers
+// floating and pinned, as runs per second and speedup over one worker
+void print_scaling(SimulationConfig config) {
+  const CpuTopology &topology = CpuTopology::system();
+  std::vector<int> counts;
+  for (size_t n = 1; n < topology.cpu_count(); n *= 2)
+    counts.push_back(static_cast<int>(n));
+  counts.push_back(static_cast<int>(topology.cpu_count()));
+
+  std::cout << "Scaling " << config.runs << " runs over "
+            << topology.cpu_count() << " CPUs on " << topology.node_count()
+            << " NUMA node(s)\n\n";
+  std::cout << "threads   floating runs/s  speedup   pinned runs/s  speedup\n";
+  double base[2] = {0.0, 0.0};
+  for (int threads : counts) {
+    config.threads = threads;
+    std::cout << std::setw(7) << threads;
+    for (int pinned = 0; pinned < 2; pinned++) {
+      config.pin_threads = pinned != 0;
+      SimulationReport report = RunSimulator(config).run();
+      double rate = report.elapsed_seconds > 0.0
+                        ? static_cast<double>(report.runs) /
+                              report.elapsed_seconds
+                        : 0.0;
+      if (threads == 1)
+        base[pinned] = rate;
+      std::cout << std::fixed << std::setprecision(1) << std::setw(18)
+                << rate << std::setw(8)
+                << (base[pinned] > 0.0 ? rate / base[pinned] : 0.0) << "x";
+    }
+    std::cout << "\n" << std::flush;
+  }
+}
+
+} // namespace
+
+// Usage: autobattler_sim [runs] [policy] [threads] [seed] [--pin]
+//                        [--scaling] [--chrome-trace=FILE]
+//   policy is random, greedy or evolve
+//   e.g. autobattler_sim 100000 evolve 8 42
+// Plays whole auto-battler runs without any input and prints survival,
+// gold and pick-rate statistics for balancing shop costs and rarities.
+// --pin pins each worker to a CPU, filling one NUMA node before the next.
+// --scaling plays the batch on 1 to all CPUs instead, floating and pinned,
+// and prints the throughput of each.
+// --chrome-trace writes each run's shop and battle phases as Chrome trace
+// JSON.
+int main(int argc, char **argv) {
+  std::unique_ptr<timeline::ChromeTraceFile> chrome_trace;
+  bool pin = false;
+  bool scaling = false;
+  std::vector<char *> args;
+  for (int i = 0; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.rfind("--chrome-trace=", 0) == 0) {
+      chrome_trace.reset(new timeline::ChromeTraceFile(arg.substr(15)));
+      continue;
+    }
+    if (arg == "--pin" || arg == "--scaling") {
+      (arg == "--pin" ? pin : scaling) = true;
+      continue;
+    }
+    args.push_back(argv[i]);
+  }
+  argc = static_cast<int>(args.size());
+  argv = args.data();
+
+  SimulationConfig config;
+  if (argc > 1)
+    config.runs = std::max(1, std::atoi(argv[1]));
+  if (argc > 2)
+    config.policy = argv[2];
+  if (argc > 3)
+    config.threads = std::max(0, std::atoi(argv[3]));
+  if (argc > 4)
+    config.seed = static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10));
+  config.pin_threads = pin;
+
+  std::cout << "=== Pokemon Auto-Battler - Run Simulator ===\n\n";
+
+  RunSimulator simulator(config);
+  if (!simulator.valid()) {
+    std::cerr << "Unknown policy '" << config.policy
+              << "' (use random, greedy or evolve)\n";
+    return 1;
+  }
+
+  load_game_data("src/data/species.json", "src/data/moves.json",
+                 "src/data/type_chart.json");
+
+  if (scaling) {
+    print_scaling(config);
+    return 0;
+  }
+
+  std::cout << "Simulating " << config.runs << " runs with the "
+            << config.policy << " policy (seed " << config.seed << ")...\n";
+
+  SimulationReport report = simulator.run();
+  report.print(std::cout);
+  return 0;
+}
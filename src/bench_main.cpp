@@ -0,0 +1,506 @@
+#include "ai/gen1_ai.hpp"
+#include "ai/random_ai.hpp"
+#include "autobattler/team_cache.hpp"
+#include "core/battle.hpp"
+#include "core/battle_output.hpp"
+#include "core/rng.hpp"
+#include "data/data_file.hpp"
+#include "data/loader.hpp"
+#include "engine/damage.hpp"
+#include "engine/move_effects.hpp"
+#include "network/protocol.hpp"
+#include "server/headless_battle.hpp"
+#include "server/team_generator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Results are folded in here so the optimizer cannot drop the work
+volatile uint64_t sink = 0;
+
+// One benchmark: runs its operation `iterations` times and returns
+// something derived from the results
+struct Benchmark {
+  std::string name;
+  std::function<uint64_t(size_t iterations)> run;
+};
+
+struct Measurement {
+  std::string name;
+  size_t iterations = 0; // Per repetition
+  std::vector<double> ns_per_op;
+};
+
+// Takes a handler's events without printing them
+struct CountingSink : BattleEventSink {
+  uint64_t count = 0;
+  void on_event(const BattleEvent &) override { count++; }
+};
+
+double time_ns(const Benchmark &bench, size_t iterations) {
+  Clock::time_point start = Clock::now();
+  sink = sink + bench.run(iterations);
+  return std::chrono::duration<double, std::nano>(Clock::now() - start)
+      .count();
+}
+
+// Grow the batch until it takes a measurable time, size it to min_time,
+// then time it repetitions times
+Measurement measure(const Benchmark &bench, double min_time, int repetitions) {
+  size_t iterations = 1;
+  double elapsed = time_ns(bench, iterations);
+  while (elapsed < 1e7 && iterations < (size_t(1) << 40)) {
+    iterations *= elapsed < 1e6 ? 10 : 2;
+    elapsed = time_ns(bench, iterations);
+  }
+  double per_op = elapsed / static_cast<double>(iterations);
+  iterations = std::max<size_t>(1, static_cast<size_t>(min_time * 1e9 / per_op));
+
+  Measurement result;
+  result.name = bench.name;
+  result.iterations = iterations;
+  for (int i = 0; i < repetitions; i++) {
+    result.ns_per_op.push_back(time_ns(bench, iterations) /
+                               static_cast<double>(iterations));
+  }
+  std::sort(result.ns_per_op.begin(), result.ns_per_op.end());
+  return result;
+}
+
+double median(const std::vector<double> &sorted) {
+  size_t mid = sorted.size() / 2;
+  return sorted.size() % 2 ? sorted[mid]
+                           : (sorted[mid - 1] + sorted[mid]) / 2.0;
+}
+
+const char *const SPECIES_PATH = "src/data/species.json";
+const char *const MOVES_PATH = "src/data/moves.json";
+
+// A modded-size copy of a data file: every record copies times over, each
+// copy's names (and evolution targets) suffixed with its number. Written
+// to the temp directory the first time it is asked for.
+std::string synthetic_file(const std::string &stock_path, int copies) {
+  std::string name = std::filesystem::path(stock_path).stem().string();
+  std::string path = (std::filesystem::temp_directory_path() /
+                      ("battler_bench_" + name + "_x" +
+                       std::to_string(copies) + ".json"))
+                         .string();
+  std::ifstream in(stock_path);
+  json stock;
+  in >> stock;
+  json scaled = json::object();
+  for (int copy = 0; copy < copies; copy++) {
+    std::string suffix = " " + std::to_string(copy);
+    for (auto &[key, record] : stock.items()) {
+      json renamed = record;
+      if (renamed.contains("evolves_to"))
+        renamed["evolves_to"] = renamed["evolves_to"].get<std::string>() + suffix;
+      scaled[key + suffix] = renamed;
+    }
+  }
+  std::ofstream out(path);
+  out << scaled.dump(2) << "\n";
+  return path;
+}
+
+const std::string &species_x100() {
+  static const std::string path = synthetic_file(SPECIES_PATH, 100);
+  return path;
+}
+
+const std::string &moves_x100() {
+  static const std::string path = synthetic_file(MOVES_PATH, 100);
+  return path;
+}
+
+// The first half of what the old loader did, building the whole document
+// before anything was copied out of it
+uint64_t parse_dom(const std::string &path) {
+  std::ifstream in(path);
+  json document;
+  in >> document;
+  return document.size();
+}
+
+uint64_t parse_species(const std::string &path) {
+  std::vector<SpeciesData> species;
+  std::string error;
+  parse_species_file(path, species, error);
+  return species.size();
+}
+
+uint64_t parse_moves(const std::string &path) {
+  std::vector<std::unique_ptr<MoveData>> moves;
+  std::string error;
+  parse_moves_file(path, moves, error);
+  return moves.size();
+}
+
+// Both files at once, as load_game_data reads them
+uint64_t parse_both(const std::string &species_path,
+                    const std::string &moves_path) {
+  uint64_t species = 0;
+  std::thread species_thread(
+      [&]() { species = parse_species(species_path); });
+  uint64_t moves = parse_moves(moves_path);
+  species_thread.join();
+  return species + moves;
+}
+
+// First move with PP left, as a stand-in for a player's choice
+int first_usable_move(const Pokemon &pokemon) {
+  for (int i = 0; i < pokemon.move_count(); i++) {
+    if (pokemon.get_move(i).has_pp())
+      return i;
+  }
+  return 0;
+}
+
+std::vector<Benchmark> make_benchmarks(uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::vector<Pokemon> team1 = generate_random_team(6, 50, gen);
+  std::vector<Pokemon> team2 = generate_random_team(6, 50, gen);
+  const Pokemon attacker = team1[0];
+  const Pokemon defender = team2[0];
+  const GameData &gd = GameData::getInstance();
+
+  std::vector<std::string> species_names = gd.getAllSpeciesNames();
+  std::vector<std::string> move_names = gd.getAllMoveNames();
+  std::vector<const MoveData *> moves = gd.getAllMoves();
+  std::vector<Benchmark> benchmarks;
+
+  benchmarks.push_back({"damage/calculate_damage", [=](size_t n) {
+                          uint64_t total = 0;
+                          const Move &move = attacker.get_move(0);
+                          for (size_t i = 0; i < n; i++)
+                            total += calculate_damage(attacker, defender, move)
+                                         .damage;
+                          return total;
+                        }});
+
+  benchmarks.push_back({"pokemon/get_modified_stat", [=](size_t n) {
+                          Pokemon boosted = attacker;
+                          boosted.modify_stat_stage(PokeStat::Attack, 2);
+                          boosted.modify_stat_stage(PokeStat::Speed, -1);
+                          uint64_t total = 0;
+                          for (size_t i = 0; i < n; i++) {
+                            PokeStat stat = static_cast<PokeStat>(1 + i % 4);
+                            total += boosted.get_modified_stat(stat);
+                          }
+                          return total;
+                        }});
+
+  benchmarks.push_back({"data/getEffectiveness", [](size_t n) {
+                          const GameData &gd = GameData::getInstance();
+                          const int types =
+                              static_cast<int>(PokeType::Dragon) + 1;
+                          float total = 0;
+                          for (size_t i = 0; i < n; i++) {
+                            PokeType attack = static_cast<PokeType>(i % types);
+                            PokeType defend =
+                                static_cast<PokeType>((i / types) % types);
+                            total += gd.getEffectiveness(attack, defend);
+                          }
+                          return static_cast<uint64_t>(total);
+                        }});
+
+  benchmarks.push_back({"data/getMove", [move_names](size_t n) {
+                          const GameData &gd = GameData::getInstance();
+                          uint64_t total = 0;
+                          for (size_t i = 0; i < n; i++) {
+                            const MoveData *move =
+                                gd.getMove(move_names[i % move_names.size()]);
+                            total += move ? move->power : 0;
+                          }
+                          return total;
+                        }});
+
+  benchmarks.push_back({"data/getSpecies", [species_names](size_t n) {
+                          const GameData &gd = GameData::getInstance();
+                          uint64_t total = 0;
+                          for (size_t i = 0; i < n; i++) {
+                            const SpeciesData *species = gd.getSpecies(
+                                species_names[i % species_names.size()]);
+                            total += species ? species->hp : 0;
+                          }
+                          return total;
+                        }});
+
+  benchmarks.push_back({"ai/gen1_choose_move", [=](size_t n) {
+                          Gen1AI ai;
+                          uint64_t total = 0;
+                          for (size_t i = 0; i < n; i++)
+                            total += ai.choose_move(attacker, defender);
+                          return total;
+                        }});
+
+  // The Pokemon are reset before every application so each one sees the
+  // same state; pokemon/copy_assign is that reset on its own
+  benchmarks.push_back({"pokemon/copy_assign", [=](size_t n) {
+                          Pokemon a = attacker;
+                          Pokemon d = defender;
+                          uint64_t total = 0;
+                          for (size_t i = 0; i < n; i++) {
+                            a = attacker;
+                            d = defender;
+                            total += a.hp() + d.hp();
+                          }
+                          return total;
+                        }});
+
+  std::vector<MoveEffectType> seen;
+  for (const MoveData *move : moves) {
+    MoveEffectType type = move->primary_effect.type;
+    if (std::find(seen.begin(), seen.end(), type) != seen.end())
+      continue;
+    seen.push_back(type);
+    benchmarks.push_back(
+        {std::string("effects/") + move_effect_name(type) + " (" + move->name + ")",
+         [=](size_t n) {
+           // The move's handler, as Battle::apply_move calls it
+           CountingSink events;
+           Move m(move);
+           Pokemon a = attacker;
+           Pokemon d = defender;
+           for (size_t i = 0; i < n; i++) {
+             a = attacker;
+             d = defender;
+             move->handler(a, d, m, move->effect, events);
+           }
+           return events.count;
+         }});
+  }
+
+  benchmarks.push_back({"protocol/serialize", [](size_t n) {
+                          Message msg(MessageType::BATTLE_LOG,
+                                      "Pikachu used Thunderbolt! It's super "
+                                      "effective! Gyarados took 84 damage.");
+                          uint64_t total = 0;
+                          for (size_t i = 0; i < n; i++)
+                            total += msg.serialize().size();
+                          return total;
+                        }});
+
+  benchmarks.push_back({"protocol/deserialize", [](size_t n) {
+                          std::vector<uint8_t> frame =
+                              Message(MessageType::BATTLE_LOG,
+                                      "Pikachu used Thunderbolt! It's super "
+                                      "effective! Gyarados took 84 damage.")
+                                  .serialize();
+                          uint64_t total = 0;
+                          for (size_t i = 0; i < n; i++)
+                            total += Message::deserialize(frame).payload.size();
+                          return total;
+                        }});
+
+  // Turns of a running 6v6; a finished battle is replaced by a fresh one,
+  // which is counted in the time
+  benchmarks.push_back({"battle/execute_turn", [=](size_t n) {
+                          QuietBattleOutput quiet;
+                          rng_seed(seed);
+                          Battle battle(team1, team2);
+                          uint64_t total = 0;
+                          for (size_t i = 0; i < n; i++) {
+                            if (battle.over)
+                              battle = Battle(team1, team2);
+                            battle.execute_turn(
+                                first_usable_move(battle.active1),
+                                first_usable_move(battle.active2));
+                            if (battle.active1.hp() <= 0 &&
+                                !battle.is_team_defeated(1))
+                              battle.switch_pokemon(
+                                  1, battle.get_available_pokemon(1)[0]);
+                            if (battle.active2.hp() <= 0 &&
+                                !battle.is_team_defeated(2))
+                              battle.switch_pokemon(
+                                  2, battle.get_available_pokemon(2)[0]);
+                            total += battle.active1.hp();
+                          }
+                          return total;
+                        }});
+
+  benchmarks.push_back({"battle/full_6v6", [=](size_t n) {
+                          Gen1AI gen1_ai;
+                          RandomAI random_ai;
+                          rng_seed(seed);
+                          uint64_t total = 0;
+                          for (size_t i = 0; i < n; i++) {
+                            HeadlessBattleResult result = run_headless_battle(
+                                team1, team2, gen1_ai, random_ai, 500);
+                            total += result.turns;
+                          }
+                          return total;
+                        }});
+
+  // Setting up a quiet auto-battle: copying both teams into the fast
+  // model, against looking them up interned (see TeamCache)
+  benchmarks.push_back({"autobattle/setup_vectors", [=](size_t n) {
+                          uint64_t total = 0;
+                          for (size_t i = 0; i < n; i++) {
+                            FastAutoBattle fast;
+                            total += fast.load(team1, team2);
+                          }
+                          return total;
+                        }});
+
+  benchmarks.push_back({"autobattle/setup_interned", [=](size_t n) {
+                          TeamSpec spec1, spec2;
+                          TeamSpec::from_team(team1, spec1);
+                          TeamSpec::from_team(team2, spec2);
+                          TeamCache cache;
+                          uint64_t total = 0;
+                          for (size_t i = 0; i < n; i++) {
+                            auto interned1 = cache.intern(spec1);
+                            auto interned2 = cache.intern(spec2);
+                            FastAutoBattle fast;
+                            total += fast.load(*interned1, *interned2);
+                          }
+                          return total;
+                        }});
+
+  // Reading the data files, stock and at 100 times the size. dom_parse is
+  // only the JSON document the old loader built before copying fields out
+  // of it; sax is the whole parse into records.
+  auto repeat = [](std::function<uint64_t()> parse) {
+    return [=](size_t n) {
+      uint64_t total = 0;
+      for (size_t i = 0; i < n; i++)
+        total += parse();
+      return total;
+    };
+  };
+  benchmarks.push_back({"loader/species_dom_parse",
+                        repeat([] { return parse_dom(SPECIES_PATH); })});
+  benchmarks.push_back({"loader/species_sax",
+                        repeat([] { return parse_species(SPECIES_PATH); })});
+  benchmarks.push_back({"loader/moves_dom_parse",
+                        repeat([] { return parse_dom(MOVES_PATH); })});
+  benchmarks.push_back({"loader/moves_sax",
+                        repeat([] { return parse_moves(MOVES_PATH); })});
+  benchmarks.push_back(
+      {"loader/both_parallel_sax",
+       repeat([] { return parse_both(SPECIES_PATH, MOVES_PATH); })});
+  benchmarks.push_back({"loader/species_dom_parse_x100",
+                        repeat([] { return parse_dom(species_x100()); })});
+  benchmarks.push_back({"loader/species_sax_x100",
+                        repeat([] { return parse_species(species_x100()); })});
+  benchmarks.push_back({"loader/moves_dom_parse_x100",
+                        repeat([] { return parse_dom(moves_x100()); })});
+  benchmarks.push_back({"loader/moves_sax_x100",
+                        repeat([] { return parse_moves(moves_x100()); })});
+  benchmarks.push_back(
+      {"loader/both_parallel_sax_x100",
+       repeat([] { return parse_both(species_x100(), moves_x100()); })});
+
+  return benchmarks;
+}
+
+std::string utc_timestamp() {
+  std::time_t now = std::time(nullptr);
+  char text[32];
+  std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+  return text;
+}
+
+} // namespace
+
+// Usage: battler_bench [--filter=TEXT] [--min-time=SECONDS]
+//                      [--repetitions=N] [--seed=N] [--json=FILE]
+// Microbenchmarks for the engine's hot paths. Each benchmark is timed
+// repetitions times over a batch sized to take min-time; the table shows
+// the median and fastest ns/op. --json writes every repetition as well, so
+// runs can be kept and compared over time.
+int main(int argc, char **argv) {
+  std::string filter;
+  std::string json_path;
+  double min_time = 0.1;
+  int repetitions = 5;
+  uint32_t seed = 42;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.rfind("--filter=", 0) == 0) {
+      filter = arg.substr(9);
+    } else if (arg.rfind("--min-time=", 0) == 0) {
+      min_time = std::max(0.001, std::atof(arg.c_str() + 11));
+    } else if (arg.rfind("--repetitions=", 0) == 0) {
+      repetitions = std::max(1, std::atoi(arg.c_str() + 14));
+    } else if (arg.rfind("--seed=", 0) == 0) {
+      seed = static_cast<uint32_t>(std::strtoul(arg.c_str() + 7, nullptr, 10));
+    } else if (arg.rfind("--json=", 0) == 0) {
+      json_path = arg.substr(7);
+    } else {
+      std::cerr << "Usage: battler_bench [--filter=TEXT] [--min-time=SECONDS] "
+                   "[--repetitions=N] [--seed=N] [--json=FILE]\n";
+      return 1;
+    }
+  }
+
+  load_game_data("src/data/species.json", "src/data/moves.json",
+                 "src/data/type_chart.json");
+
+  std::vector<Measurement> results;
+  std::cout << std::left << std::setw(40) << "Benchmark" << std::right
+            << std::setw(14) << "median ns/op" << std::setw(14) << "min ns/op"
+            << std::setw(14) << "iterations" << "\n";
+  for (const Benchmark &bench : make_benchmarks(seed)) {
+    if (!filter.empty() && bench.name.find(filter) == std::string::npos)
+      continue;
+    Measurement result = measure(bench, min_time, repetitions);
+    std::cout << std::left << std::setw(40) << result.name << std::right
+              << std::fixed << std::setprecision(1) << std::setw(14)
+              << median(result.ns_per_op) << std::setw(14)
+              << result.ns_per_op.front() << std::setw(14) << result.iterations
+              << "\n";
+    results.push_back(result);
+  }
+
+  if (json_path.empty())
+    return 0;
+
+  json report;
+  report["context"] = {{"date", utc_timestamp()},
+                       {"seed", seed},
+                       {"min_time_s", min_time},
+                       {"repetitions", repetitions},
+#ifdef NDEBUG
+                       {"build", "release"}
+#else
+                       {"build", "debug"}
+#endif
+  };
+  report["benchmarks"] = json::array();
+  for (const Measurement &result : results) {
+    report["benchmarks"].push_back({{"name", result.name},
+                                    {"iterations", result.iterations},
+                                    {"median_ns", median(result.ns_per_op)},
+                                    {"min_ns", result.ns_per_op.front()},
+                                    {"max_ns", result.ns_per_op.back()},
+                                    {"samples_ns", result.ns_per_op}});
+  }
+  std::ofstream out(json_path);
+  out << report.dump(2) << "\n";
+  if (!out) {
+    std::cerr << "Cannot write " << json_path << "\n";
+    return 1;
+  }
+  std::cout << "Wrote " << results.size() << " results to " << json_path
+            << "\n";
+  return 0;
+}
@@ -0,0 +1,238 @@
+#include "bot_player.hpp"
+#include "../data/game_data.hpp"
+#include <cstdio>
+#include <sstream>
+
+// "Name HP: a/b" as used in BATTLE_UPDATE
+static bool parse_name_hp(const std::string &text, std::string &name,
+                          int &hp, int &max_hp) {
+  size_t hp_pos = text.rfind(" HP: ");
+  if (hp_pos == std::string::npos) {
+    return false;
+  }
+  name = text.substr(0, hp_pos);
+  return std::sscanf(text.c_str() + hp_pos + 5, "%d/%d", &hp, &max_hp) == 2;
+}
+
+// Skip the "N. " list prefix; npos if the line is not a numbered entry
+static size_t list_entry_start(const std::string &line) {
+  size_t dot = line.find(". ");
+  if (dot == 0 || dot == std::string::npos) {
+    return std::string::npos;
+  }
+  for (size_t i = 0; i < dot; i++) {
+    if (line[i] < '0' || line[i] > '9') {
+      return std::string::npos;
+    }
+  }
+  return dot + 2;
+}
+
+BotPlayer::BotPlayer(const BattleAI *ai) : ai_(ai) { reset(); }
+
+void BotPlayer::reset() {
+  own_team_.clear();
+  opponent_team_.clear();
+  own_active_ = SeenPokemon{"", 50, 0, 0};
+  opponent_active_ = SeenPokemon{"", 50, 0, 0};
+}
+
+bool BotPlayer::parse_pokemon_line(const std::string &line, std::string &name,
+                                   int &level, int &hp, int &max_hp) {
+  // "1. Pikachu (Lv. 50) HP: 95/110"
+  size_t start = list_entry_start(line);
+  size_t lv_pos = line.find(" (Lv. ");
+  if (start == std::string::npos || lv_pos == std::string::npos ||
+      lv_pos < start) {
+    return false;
+  }
+  name = line.substr(start, lv_pos - start);
+
+  size_t hp_pos = line.find("HP: ", lv_pos);
+  if (hp_pos == std::string::npos) {
+    return false;
+  }
+  return std::sscanf(line.c_str() + lv_pos + 6, "%d", &level) == 1 &&
+         std::sscanf(line.c_str() + hp_pos + 4, "%d/%d", &hp, &max_hp) == 2;
+}
+
+bool BotPlayer::parse_move_line(const std::string &line, std::string &name,
+                                int &pp, int &max_pp) {
+  // "1. Thunderbolt (PP: 15/15)"
+  size_t start = list_entry_start(line);
+  size_t pp_pos = line.rfind(" (PP: ");
+  if (start == std::string::npos || pp_pos == std::string::npos ||
+      pp_pos < start) {
+    return false;
+  }
+  name = line.substr(start, pp_pos - start);
+  return std::sscanf(line.c_str() + pp_pos + 6, "%d/%d", &pp, &max_pp) == 2;
+}
+
+void BotPlayer::observe(const Message &msg) {
+  if (msg.type == MessageType::TEAM_DATA) {
+    std::istringstream lines(msg.get_payload_string());
+    std::string line;
+    std::getline(lines, line);
+    std::vector<SeenPokemon> &team =
+        (line.rfind("Your team", 0) == 0) ? own_team_ : opponent_team_;
+    team.clear();
+
+    while (std::getline(lines, line)) {
+      SeenPokemon seen;
+      if (parse_pokemon_line(line, seen.name, seen.level, seen.hp,
+                             seen.max_hp)) {
+        team.push_back(seen);
+      }
+    }
+  } else if (msg.type == MessageType::BATTLE_UPDATE) {
+    // "Your Pokemon: X HP: a/b | Opponent: Y HP: c/d"
+    std::string text = msg.get_payload_string();
+    const std::string own_prefix = "Your Pokemon: ";
+    const std::string separator = " | Opponent: ";
+    size_t split = text.find(separator);
+    if (text.rfind(own_prefix, 0) != 0 || split == std::string::npos) {
+      return;
+    }
+
+    SeenPokemon own{"", 50, 0, 0};
+    SeenPokemon opponent{"", 50, 0, 0};
+    if (parse_name_hp(text.substr(own_prefix.size(),
+                                  split - own_prefix.size()),
+                      own.name, own.hp, own.max_hp) &&
+        parse_name_hp(text.substr(split + separator.size()), opponent.name,
+                      opponent.hp, opponent.max_hp)) {
+      own.level = level_of(own_team_, own.name);
+      opponent.level = level_of(opponent_team_, opponent.name);
+      own_active_ = own;
+      opponent_active_ = opponent;
+    }
+  }
+}
+
+int BotPlayer::level_of(const std::vector<SeenPokemon> &team,
+                        const std::string &name) const {
+  for (const auto &seen : team) {
+    if (seen.name == name) {
+      return seen.level;
+    }
+  }
+  return 50;
+}
+
+bool BotPlayer::can_build(const SeenPokemon &seen,
+                          const std::vector<SeenMove> &moves) const {
+  const GameData &data = GameData::getInstance();
+  if (!data.getSpecies(seen.name)) {
+    return false; // Game data not loaded (or unknown species)
+  }
+  for (const auto &seen_move : moves) {
+    if (!data.getMove(seen_move.name)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Pokemon BotPlayer::build_pokemon(const SeenPokemon &seen,
+                                 const std::vector<SeenMove> &moves) const {
+  Pokemon pokemon(seen.name, seen.level);
+  for (const auto &seen_move : moves) {
+    Move move(GameData::getInstance().getMove(seen_move.name));
+    move.current_pp = seen_move.pp;
+    pokemon.add_move(move);
+  }
+
+  // Scale to our rebuilt max HP in case the stats differ slightly
+  if (seen.max_hp > 0) {
+    int target = pokemon.max_hp() * seen.hp / seen.max_hp;
+    pokemon.take_damage(pokemon.max_hp() - target);
+  }
+  return pokemon;
+}
+
+int BotPlayer::choose_move(const std::string &request) const {
+  std::vector<SeenMove> moves;
+  std::istringstream lines(request);
+  std::string line;
+  while (std::getline(lines, line)) {
+    SeenMove move;
+    if (parse_move_line(line, move.name, move.pp, move.max_pp)) {
+      moves.push_back(move);
+    }
+  }
+  if (moves.empty()) {
+    return 1;
+  }
+
+  if (ai_ && can_build(own_active_, moves) &&
+      can_build(opponent_active_, {})) {
+    Pokemon own = build_pokemon(own_active_, moves);
+    Pokemon opponent = build_pokemon(opponent_active_, {});
+    int choice = ai_->choose_move(own, opponent);
+    if (choice >= 0 && choice < static_cast<int>(moves.size())) {
+      return choice + 1;
+    }
+  }
+
+  // Fall back to the first move with PP left
+  for (size_t i = 0; i < moves.size(); i++) {
+    if (moves[i].pp > 0) {
+      return static_cast<int>(i) + 1;
+    }
+  }
+  return 1;
+}
+
+int BotPlayer::choose_switch(const std::string &request) const {
+  // Send in whichever healthy Pokemon has the most HP left
+  std::istringstream lines(request);
+  std::string line;
+  int best = 1;
+  int best_hp = -1;
+  int index = 0;
+  while (std::getline(lines, line)) {
+    SeenPokemon seen;
+    if (!parse_pokemon_line(line, seen.name, seen.level, seen.hp,
+                            seen.max_hp)) {
+      continue;
+    }
+    index++;
+    if (seen.hp > best_hp) {
+      best_hp = seen.hp;
+      best = index;
+    }
+  }
+  return best;
+}
+
+std::string BotPlayer::choose_shop_action(const std::string &state) const {
+  std::istringstream lines(state);
+  std::string line;
+  int gold = 0;
+  int team_size = 0;
+  int max_team_size = 0;
+  bool in_shop = false;
+  while (std::getline(lines, line)) {
+    if (line.rfind("Gold: ", 0) == 0) {
+      std::sscanf(line.c_str() + 6, "%d", &gold);
+    } else if (line.rfind("Team (", 0) == 0) {
+      std::sscanf(line.c_str() + 6, "%d/%d", &team_size, &max_team_size);
+    } else if (line == "Shop:") {
+      in_shop = true;
+    } else if (in_shop && team_size < max_team_size) {
+      // "3. Pidgey [Common] - 2 gold"
+      size_t start = list_entry_start(line);
+      size_t cost_pos = line.rfind("] - ");
+      int cost = 0;
+      if (start == std::string::npos || cost_pos == std::string::npos ||
+          std::sscanf(line.c_str() + cost_pos + 4, "%d", &cost) != 1) {
+        continue;
+      }
+      if (cost <= gold) {
+        return "buy " + line.substr(0, start - 2);
+      }
+    }
+  }
+  return "ready";
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "../ai/ai_interface.hpp"
+#include "../network/protocol.hpp"
+#include <string>
+#include <vector>
+
+// Plays a network battle headlessly. The server only sends text, so the bot
+// rebuilds just enough Pokemon state from TEAM_DATA, BATTLE_UPDATE and
+// MOVE_REQUEST messages for a BattleAI to choose moves.
+class BotPlayer {
+private:
+  struct SeenPokemon {
+    std::string name;
+    int level;
+    int hp;
+    int max_hp;
+  };
+
+  struct SeenMove {
+    std::string name;
+    int pp;
+    int max_pp;
+  };
+
+  const BattleAI *ai_;
+  std::vector<SeenPokemon> own_team_;
+  std::vector<SeenPokemon> opponent_team_;
+  SeenPokemon own_active_;
+  SeenPokemon opponent_active_;
+
+  int level_of(const std::vector<SeenPokemon> &team,
+               const std::string &name) const;
+  bool can_build(const SeenPokemon &seen,
+                 const std::vector<SeenMove> &moves) const;
+  Pokemon build_pokemon(const SeenPokemon &seen,
+                        const std::vector<SeenMove> &moves) const;
+
+public:
+  explicit BotPlayer(const BattleAI *ai);
+
+  // Track TEAM_DATA / BATTLE_UPDATE; other message types are ignored
+  void observe(const Message &msg);
+
+  // Answers to MOVE_REQUEST / SWITCH_REQUEST text, 1-indexed like a human
+  int choose_move(const std::string &request) const;
+  int choose_switch(const std::string &request) const;
+
+  // Answer to LOBBY_STATE: buy the first affordable Pokemon while the team
+  // has room, otherwise "ready"
+  std::string choose_shop_action(const std::string &state) const;
+
+  // Forget everything about the previous battle
+  void reset();
+
+  // Text protocol parsing, exposed for tests
+  static bool parse_pokemon_line(const std::string &line, std::string &name,
+                                 int &level, int &hp, int &max_hp);
+  static bool parse_move_line(const std::string &line, std::string &name,
+                              int &pp, int &max_pp);
+};
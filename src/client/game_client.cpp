@@ -2,7 +2,8 @@
 #include <iostream>
 
 GameClient::GameClient(const std::string &name)
-    : player_name_(name), connected_(false), in_game_(false) {}
+    : player_name_(name), connected_(false), in_game_(false),
+      in_tournament_(false), in_lobby_(false), spectator_(false) {}
 
 GameClient::~GameClient() { disconnect(); }
 
@@ -18,13 +19,14 @@ bool GameClient::connect(const std::string &host, int port) {
   std::cout << "[Client] Connected!\n";
 
   // Send connection request with player name
-  Message connect_msg(MessageType::CONNECT_REQUEST, player_name_);
+  Message connect_msg(spectator_ ? MessageType::SPECTATE_REQUEST
+                                 : MessageType::CONNECT_REQUEST,
+                      player_name_);
   socket_.send(connect_msg.serialize());
 
   // Wait for response
-  std::vector<uint8_t> data = socket_.receive();
-  if (!data.empty()) {
-    Message response = Message::deserialize(data);
+  Message response;
+  if (receive_message(socket_, response)) {
     if (response.type == MessageType::CONNECT_RESPONSE) {
       std::cout << "[Server] " << response.get_payload_string() << "\n";
     }
@@ -47,7 +49,15 @@ void GameClient::display_message(const std::string &msg) {
   std::cout << msg << "\n";
 }
 
+void GameClient::set_bot(const BattleAI *ai) {
+  bot_.reset(new BotPlayer(ai));
+}
+
 void GameClient::handle_message(const Message &msg) {
+  if (bot_) {
+    bot_->observe(msg);
+  }
+
   switch (msg.type) {
   case MessageType::GAME_START:
     std::cout << "\n=== GAME STARTING ===\n";
@@ -69,13 +79,15 @@ void GameClient::handle_message(const Message &msg) {
   case MessageType::MOVE_REQUEST: {
     // Just display the move request, don't prompt yet
     // The prompt will happen in the run() loop after all messages are processed
+    last_request_ = msg.get_payload_string();
     std::cout << "\n" << msg.get_payload_string() << "\n";
     break;
   }
 
   case MessageType::SWITCH_REQUEST: {
     // Display the switch request message from server (includes Pokemon list)
-    std::cout << msg.get_payload_string();
+    last_request_ = msg.get_payload_string();
+    std::cout << last_request_;
     int switch_choice = prompt_switch_choice();
 
     Message response(MessageType::SWITCH_RESPONSE);
@@ -91,6 +103,44 @@ void GameClient::handle_message(const Message &msg) {
     in_game_ = false;
     break;
 
+  case MessageType::TOURNAMENT_START:
+    std::cout << "\n=== TOURNAMENT ===\n" << msg.get_payload_string() << "\n";
+    in_tournament_ = true;
+    break;
+
+  case MessageType::MATCH_START:
+    std::cout << "\n=== MATCH START ===\n" << msg.get_payload_string() << "\n";
+    break;
+
+  case MessageType::BRACKET_UPDATE:
+    std::cout << "[Bracket] " << msg.get_payload_string() << "\n";
+    break;
+
+  case MessageType::ROUND_COMPLETE:
+    std::cout << "\n[Standings] " << msg.get_payload_string();
+    break;
+
+  case MessageType::GAME_OVER:
+    std::cout << (in_lobby_ ? "\n=== LOBBY OVER ===\n"
+                            : "\n=== TOURNAMENT OVER ===\n")
+              << msg.get_payload_string() << "\n";
+    in_tournament_ = false;
+    in_game_ = false;
+    break;
+
+  case MessageType::LOBBY_STATE: {
+    in_lobby_ = true;
+    last_request_ = msg.get_payload_string();
+    std::cout << "\n" << last_request_;
+    Message response(MessageType::SHOP_ACTION, prompt_shop_action());
+    socket_.send(response.serialize());
+    break;
+  }
+
+  case MessageType::LOBBY_RESULT:
+    std::cout << "[Battle] " << msg.get_payload_string();
+    break;
+
   case MessageType::ERROR_MSG:
     std::cerr << "[Error] " << msg.get_payload_string() << "\n";
     break;
@@ -102,6 +152,12 @@ void GameClient::handle_message(const Message &msg) {
 }
 
 int GameClient::prompt_move_choice() {
+  if (bot_) {
+    int choice = bot_->choose_move(last_request_);
+    std::cout << "[Bot] Using move " << choice << "\n";
+    return choice;
+  }
+
   int choice;
   std::cout << "Your choice: ";
   std::cin >> choice;
@@ -109,12 +165,30 @@ int GameClient::prompt_move_choice() {
 }
 
 int GameClient::prompt_switch_choice() {
+  if (bot_) {
+    return bot_->choose_switch(last_request_);
+  }
+
   int choice;
   std::cout << "Your choice: ";
   std::cin >> choice;
   return choice;
 }
 
+std::string GameClient::prompt_shop_action() {
+  if (bot_) {
+    std::string action = bot_->choose_shop_action(last_request_);
+    std::cout << "[Bot] " << action << "\n";
+    return action;
+  }
+
+  std::string action;
+  std::cout << "> ";
+  std::cin >> std::ws;
+  std::getline(std::cin, action);
+  return action;
+}
+
 void GameClient::run() {
   std::cout << "[Client] Waiting for game to start...\n";
 
@@ -122,16 +196,13 @@ void GameClient::run() {
 
   while (connected_) {
     // Receive message from server
-    std::vector<uint8_t> data = socket_.receive();
-
-    if (data.empty()) {
+    Message msg;
+    if (!receive_message(socket_, msg)) {
       std::cout << "[Client] Connection lost\n";
       connected_ = false;
       break;
     }
 
-    Message msg = Message::deserialize(data);
-
     // Check if this is a move request
     if (msg.type == MessageType::MOVE_REQUEST) {
       waiting_for_move = true;
@@ -149,8 +220,10 @@ void GameClient::run() {
       socket_.send(response.serialize());
     }
 
-    // Exit if game is over
-    if (!in_game_ && msg.type == MessageType::WINNER_DECLARED) {
+    // Exit if game is over (tournament players wait for the final result)
+    if (!in_game_ && !in_tournament_ &&
+        (msg.type == MessageType::WINNER_DECLARED ||
+         msg.type == MessageType::GAME_OVER)) {
       break;
     }
   }
@@ -1,6 +1,8 @@
 #pragma once
 #include "../network/protocol.hpp"
 #include "../network/socket.hpp"
+#include "bot_player.hpp"
+#include <memory>
 #include <string>
 
 // Client that connects to game server
@@ -10,6 +12,11 @@ private:
   std::string player_name_;
   bool connected_;
   bool in_game_;
+  bool in_tournament_; // Stay connected between tournament matches
+  bool in_lobby_;      // Autobattler lobby: GAME_OVER ends the game
+  bool spectator_;     // Watch a battle instead of playing
+  std::unique_ptr<BotPlayer> bot_; // Set for headless play
+  std::string last_request_;       // Text of the pending move/switch request
 
   // Message handling
   void handle_message(const Message &msg);
@@ -26,9 +33,16 @@ public:
   // Main loop
   void run();
 
+  // Connect as a spectator (call before connect)
+  void set_spectator(bool spectator) { spectator_ = spectator; }
+
+  // Let an AI answer move/switch requests instead of stdin
+  void set_bot(const BattleAI *ai);
+
   // Input
   int prompt_move_choice();
   int prompt_switch_choice();
+  std::string prompt_shop_action();
 
   // State
   bool is_connected() const { return connected_; }
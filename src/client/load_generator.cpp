@@ -0,0 +1,344 @@
+#include "load_generator.hpp"
+#include "../network/protocol.hpp"
+#include "../network/socket.hpp"
+#include "bot_player.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+typedef WSAPOLLFD PollFd;
+static int poll_sockets(PollFd *fds, size_t count, int timeout_ms) {
+  return WSAPoll(fds, static_cast<ULONG>(count), timeout_ms);
+}
+#else
+typedef pollfd PollFd;
+static int poll_sockets(PollFd *fds, size_t count, int timeout_ms) {
+  return ::poll(fds, static_cast<nfds_t>(count), timeout_ms);
+}
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// One simulated player: socket, framing state and the bot playing for it
+struct BotConnection {
+  enum class State { Idle, Connecting, Connected };
+
+  State state = State::Idle;
+  std::unique_ptr<Socket> socket;
+  FrameDecoder decoder;
+  std::vector<uint8_t> outbox;
+  size_t outbox_offset = 0;
+  BotPlayer bot;
+  std::string name;
+
+  bool awaiting_reply = false; // Sent something, timing the server's answer
+  bool game_over = false;      // Server closing now is expected
+  Clock::time_point sent_at;
+  Clock::time_point connect_started;
+  Clock::time_point retry_at;
+
+  explicit BotConnection(const BattleAI *ai) : bot(ai) {}
+
+  void queue(const Message &msg, Clock::time_point now) {
+    std::vector<uint8_t> bytes = msg.serialize();
+    outbox.insert(outbox.end(), bytes.begin(), bytes.end());
+    sent_at = now;
+    awaiting_reply = true;
+  }
+
+  // Write as much of the outbox as the socket takes; false on error
+  bool flush() {
+    while (outbox_offset < outbox.size()) {
+      long sent = socket->send_some(outbox.data() + outbox_offset,
+                                    outbox.size() - outbox_offset);
+      if (sent < 0)
+        return false;
+      if (sent == 0)
+        return true; // Kernel buffer full, wait for POLLOUT
+      outbox_offset += static_cast<size_t>(sent);
+    }
+    outbox.clear();
+    outbox_offset = 0;
+    return true;
+  }
+
+  void close() {
+    socket.reset();
+    decoder.reset();
+    outbox.clear();
+    outbox_offset = 0;
+    bot.reset();
+    awaiting_reply = false;
+    game_over = false;
+    state = State::Idle;
+  }
+};
+
+} // namespace
+
+void LoadGenReport::merge(const LoadGenReport &other) {
+  rtt_us.merge(other.rtt_us);
+  connections_opened += other.connections_opened;
+  messages_received += other.messages_received;
+  moves_sent += other.moves_sent;
+  switches_sent += other.switches_sent;
+  shop_actions_sent += other.shop_actions_sent;
+  games_finished += other.games_finished;
+  connect_errors += other.connect_errors;
+  disconnect_errors += other.disconnect_errors;
+  protocol_errors += other.protocol_errors;
+  server_errors += other.server_errors;
+  elapsed_seconds = std::max(elapsed_seconds, other.elapsed_seconds);
+}
+
+void LoadGenReport::print(std::ostream &out) const {
+  double seconds = elapsed_seconds > 0.0 ? elapsed_seconds : 1.0;
+  auto ms = [](uint64_t us) { return static_cast<double>(us) / 1000.0; };
+
+  out << std::fixed << std::setprecision(3);
+  out << "\n=== Load Test Results (" << seconds << " s) ===\n";
+  out << "Connections opened: " << connections_opened << "\n";
+  out << "Messages received:  " << messages_received << " ("
+      << messages_received / seconds << "/s)\n";
+  out << "Moves sent:         " << moves_sent << " (" << moves_sent / seconds
+      << "/s)\n";
+  // Each battle turn asks both players for a move
+  out << "Turns/sec:          " << moves_sent / 2.0 / seconds << "\n";
+  out << "Switches sent:      " << switches_sent << "\n";
+  out << "Shop actions sent:  " << shop_actions_sent << "\n";
+  out << "Games finished:     " << games_finished << " (player results)\n";
+  out << "Round trip (ms):    p50=" << ms(rtt_us.percentile(0.50))
+      << " p99=" << ms(rtt_us.percentile(0.99))
+      << " p999=" << ms(rtt_us.percentile(0.999))
+      << " max=" << ms(rtt_us.max()) << " mean=" << rtt_us.mean() / 1000.0
+      << " (" << rtt_us.count() << " samples)\n";
+  out << "Errors:             connect=" << connect_errors
+      << " disconnect=" << disconnect_errors
+      << " protocol=" << protocol_errors << " server=" << server_errors
+      << "\n";
+  out << std::defaultfloat;
+}
+
+LoadGenerator::LoadGenerator(const LoadGenConfig &config) : config_(config) {}
+
+const BattleAI *LoadGenerator::ai_for(int connection) const {
+  if (config_.ai == "gen1")
+    return &gen1_ai_;
+  if (config_.ai == "mixed" && connection % 2 == 0)
+    return &gen1_ai_;
+  return &random_ai_;
+}
+
+void LoadGenerator::run_worker(int first, int count,
+                               LoadGenReport &report) const {
+  std::vector<std::unique_ptr<BotConnection>> conns;
+  for (int i = 0; i < count; i++) {
+    conns.emplace_back(new BotConnection(ai_for(first + i)));
+    conns.back()->name = "LoadBot" + std::to_string(first + i + 1);
+  }
+
+  std::vector<PollFd> fds;
+  std::vector<BotConnection *> polled;
+  std::vector<uint8_t> read_buffer(64 * 1024);
+
+  Clock::time_point start = Clock::now();
+  Clock::time_point deadline =
+      start + std::chrono::seconds(config_.duration_seconds);
+  auto connect_timeout = std::chrono::milliseconds(config_.connect_timeout_ms);
+
+  auto handle = [&](BotConnection &conn, const Message &msg,
+                    Clock::time_point now) {
+    report.messages_received++;
+    if (conn.awaiting_reply) {
+      auto waited =
+          std::chrono::duration_cast<std::chrono::microseconds>(now -
+                                                                conn.sent_at);
+      report.rtt_us.record(static_cast<uint64_t>(waited.count()));
+      conn.awaiting_reply = false;
+    }
+    conn.bot.observe(msg);
+
+    switch (msg.type) {
+    case MessageType::MOVE_REQUEST: {
+      Message response(MessageType::MOVE_RESPONSE);
+      response.set_payload_int(conn.bot.choose_move(msg.get_payload_string()));
+      conn.queue(response, now);
+      report.moves_sent++;
+      break;
+    }
+    case MessageType::SWITCH_REQUEST: {
+      Message response(MessageType::SWITCH_RESPONSE);
+      response.set_payload_int(
+          conn.bot.choose_switch(msg.get_payload_string()));
+      conn.queue(response, now);
+      report.switches_sent++;
+      break;
+    }
+    case MessageType::LOBBY_STATE: {
+      conn.queue(Message(MessageType::SHOP_ACTION,
+                         conn.bot.choose_shop_action(msg.get_payload_string())),
+                 now);
+      report.shop_actions_sent++;
+      break;
+    }
+    case MessageType::WINNER_DECLARED:
+    case MessageType::GAME_OVER: // Autobattler lobby placement
+      report.games_finished++;
+      conn.game_over = true;
+      break;
+    case MessageType::ERROR_MSG:
+      report.server_errors++;
+      break;
+    default:
+      break;
+    }
+  };
+
+  while (true) {
+    Clock::time_point now = Clock::now();
+    if (now >= deadline)
+      break;
+
+    // Open (or reopen) idle connections
+    for (auto &conn : conns) {
+      if (conn->state != BotConnection::State::Idle || now < conn->retry_at)
+        continue;
+
+      conn->socket.reset(new Socket());
+      if (!conn->socket->start_connect(config_.host, config_.port)) {
+        report.connect_errors++;
+        conn->close();
+        conn->retry_at = now + std::chrono::milliseconds(100);
+        continue;
+      }
+      report.connections_opened++;
+      conn->state = BotConnection::State::Connecting;
+      conn->connect_started = now;
+    }
+
+    fds.clear();
+    polled.clear();
+    for (auto &conn : conns) {
+      if (conn->state == BotConnection::State::Idle)
+        continue;
+
+      if (conn->state == BotConnection::State::Connecting &&
+          now - conn->connect_started > connect_timeout) {
+        report.connect_errors++;
+        conn->close();
+        continue;
+      }
+
+      PollFd pfd{};
+      pfd.fd = conn->socket->get_fd();
+      pfd.events = (conn->state == BotConnection::State::Connecting)
+                       ? POLLOUT
+                       : static_cast<short>(POLLIN | (conn->outbox.empty()
+                                                          ? 0
+                                                          : POLLOUT));
+      fds.push_back(pfd);
+      polled.push_back(conn.get());
+    }
+
+    if (fds.empty()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+    if (poll_sockets(fds.data(), fds.size(), 10) <= 0)
+      continue;
+
+    now = Clock::now();
+    for (size_t i = 0; i < fds.size(); i++) {
+      if (fds[i].revents == 0)
+        continue;
+      BotConnection &conn = *polled[i];
+
+      if (conn.state == BotConnection::State::Connecting) {
+        if (!conn.socket->finish_connect()) {
+          report.connect_errors++;
+          conn.close();
+          conn.retry_at = now + std::chrono::milliseconds(100);
+          continue;
+        }
+        conn.state = BotConnection::State::Connected;
+        conn.queue(Message(MessageType::CONNECT_REQUEST, conn.name), now);
+        if (!conn.flush()) {
+          report.disconnect_errors++;
+          conn.close();
+        }
+        continue;
+      }
+
+      bool closed = false;
+      if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+        while (true) {
+          long received =
+              conn.socket->receive_some(read_buffer.data(), read_buffer.size());
+          if (received < 0) {
+            closed = true;
+            break;
+          }
+          if (received == 0)
+            break;
+          conn.decoder.feed(read_buffer.data(),
+                            static_cast<size_t>(received));
+        }
+
+        Message msg;
+        while (conn.decoder.next(msg)) {
+          handle(conn, msg, now);
+        }
+        if (conn.decoder.failed()) {
+          report.protocol_errors++;
+          conn.close();
+          continue;
+        }
+      }
+
+      if (!closed && !conn.flush()) {
+        closed = true;
+      }
+
+      if (closed) {
+        // The server disconnects both players once a battle is decided
+        if (!conn.game_over)
+          report.disconnect_errors++;
+        conn.close();
+      }
+    }
+  }
+
+  report.elapsed_seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+LoadGenReport LoadGenerator::run() {
+  int threads = std::max(1, std::min(config_.threads, config_.connections));
+  std::vector<LoadGenReport> reports(threads);
+  std::vector<std::thread> workers;
+
+  int first = 0;
+  for (int t = 0; t < threads; t++) {
+    int count = config_.connections / threads +
+                (t < config_.connections % threads ? 1 : 0);
+    workers.emplace_back([this, first, count, &reports, t]() {
+      run_worker(first, count, reports[t]);
+    });
+    first += count;
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  LoadGenReport total;
+  for (const auto &report : reports) {
+    total.merge(report);
+  }
+  return total;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "../ai/gen1_ai.hpp"
+#include "../ai/random_ai.hpp"
+#include "../network/latency_histogram.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+struct LoadGenConfig {
+  std::string host = "127.0.0.1";
+  int port = 8888;
+  int connections = 1000;    // Kept open concurrently; reconnect after games
+  int duration_seconds = 30;
+  int threads = 1;           // Poll loops; connections are split evenly
+  std::string ai = "random"; // "random", "gen1" or "mixed"
+  int connect_timeout_ms = 5000;
+};
+
+struct LoadGenReport {
+  LatencyHistogram rtt_us; // From our response to the next server message
+  uint64_t connections_opened = 0;
+  uint64_t messages_received = 0;
+  uint64_t moves_sent = 0;
+  uint64_t switches_sent = 0;
+  uint64_t shop_actions_sent = 0; // Answers to autobattler LOBBY_STATE
+  uint64_t games_finished = 0; // Counted per player, so ~2 per battle
+
+  uint64_t connect_errors = 0;    // Refused, reset or timed out connecting
+  uint64_t disconnect_errors = 0; // Server hung up before the game ended
+  uint64_t protocol_errors = 0;   // Oversized or malformed frames
+  uint64_t server_errors = 0;     // ERROR_MSG received
+
+  double elapsed_seconds = 0.0;
+
+  void merge(const LoadGenReport &other);
+  void print(std::ostream &out) const;
+};
+
+// Opens many concurrent bot connections from one process. Every connection
+// is a non-blocking socket with its own framing state, driven from a poll()
+// loop, and plays with RandomAI or Gen1AI through BotPlayer.
+class LoadGenerator {
+private:
+  LoadGenConfig config_;
+  Gen1AI gen1_ai_;
+  RandomAI random_ai_;
+
+  const BattleAI *ai_for(int connection) const;
+  void run_worker(int first, int count, LoadGenReport &report) const;
+
+public:
+  explicit LoadGenerator(const LoadGenConfig &config);
+
+  // Blocks for the configured duration
+  LoadGenReport run();
+};
@@ -1,21 +1,60 @@
+#include "ai/gen1_ai.hpp"
+#include "ai/random_ai.hpp"
 #include "client/game_client.hpp"
+#include "data/loader.hpp"
+#include "network/protocol.hpp"
+#include "network/socket.hpp"
 #include <iostream>
 
+// Ask the server for its instrumentation totals and print them
+int print_server_stats(const std::string &host, int port) {
+  Socket socket;
+  if (!socket.connect(host, port)) {
+    std::cerr << "Failed to connect to server\n";
+    return 1;
+  }
+  Message reply;
+  if (!send_message(socket, Message(MessageType::STATS_REQUEST)) ||
+      !receive_message(socket, reply) || reply.type != MessageType::STATS) {
+    std::cerr << "The server did not answer the stats request\n";
+    return 1;
+  }
+  std::cout << reply.get_payload_string();
+  return 0;
+}
+
+// Usage: battler_client [host] [port] [bot] [name]
+//   bot is "random" or "gen1" to play headlessly instead of reading stdin,
+//   or "spectate" to watch a live battle
+//        battler_client [host] [port] --stats   print the server's counters
 int main(int argc, char **argv) {
   std::string host = "127.0.0.1"; // Default to localhost
   int port = 8888;                // Default port
+  std::string bot;
 
   if (argc > 1)
     host = argv[1];
   if (argc > 2)
     port = std::atoi(argv[2]);
+  if (argc > 3)
+    bot = argv[3];
+  if (bot == "--stats")
+    return print_server_stats(host, port);
 
   std::cout << "=== Pokemon Gen 1 Battler - Client ===\n\n";
 
   // Get player name
   std::string name;
-  std::cout << "Enter your name: ";
-  std::getline(std::cin, name);
+  bool spectate = (bot == "spectate");
+  if (spectate) {
+    name = argc > 4 ? argv[4] : "Spectator";
+    bot.clear();
+  } else if (!bot.empty()) {
+    name = argc > 4 ? argv[4] : (bot == "gen1" ? "Gen1Bot" : "RandomBot");
+  } else {
+    std::cout << "Enter your name: ";
+    std::getline(std::cin, name);
+  }
 
   if (name.empty()) {
     name = "Player";
@@ -23,6 +62,17 @@ int main(int argc, char **argv) {
 
   // Create and connect client
   GameClient client(name);
+  client.set_spectator(spectate);
+
+  Gen1AI gen1_ai;
+  RandomAI random_ai;
+  if (!bot.empty()) {
+    // The bot rebuilds Pokemon from the server's text, so it needs the data
+    load_game_data("src/data/species.json", "src/data/moves.json",
+                   "src/data/type_chart.json");
+    client.set_bot(bot == "gen1" ? static_cast<const BattleAI *>(&gen1_ai)
+                                 : &random_ai);
+  }
 
   if (!client.connect(host, port)) {
     std::cerr << "Failed to connect to server\n";
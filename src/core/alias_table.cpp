@@ -0,0 +1,52 @@
+#include "alias_table.hpp"
+
+AliasTable::AliasTable(const std::vector<double> &weights)
+    : threshold_(weights.size()), alias_(weights.size()) {
+  size_t n = weights.size();
+  if (n == 0)
+    return;
+
+  double total = 0.0;
+  for (double weight : weights) {
+    if (weight > 0.0)
+      total += weight;
+  }
+
+  // Scale so the average column holds exactly 1.0
+  std::vector<double> scaled(n);
+  for (size_t i = 0; i < n; i++) {
+    double weight = total > 0.0 ? (weights[i] > 0.0 ? weights[i] : 0.0) : 1.0;
+    scaled[i] = weight * static_cast<double>(n) / (total > 0.0 ? total : n);
+  }
+
+  std::vector<uint32_t> small, large;
+  for (size_t i = 0; i < n; i++) {
+    (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+  }
+
+  const double one = 4294967296.0; // 2^32
+  while (!small.empty() && !large.empty()) {
+    uint32_t less = small.back();
+    uint32_t more = large.back();
+    small.pop_back();
+
+    // Column `less` is topped up from `more`
+    threshold_[less] = static_cast<uint64_t>(scaled[less] * one);
+    alias_[less] = more;
+    scaled[more] -= 1.0 - scaled[less];
+    if (scaled[more] < 1.0) {
+      large.pop_back();
+      small.push_back(more);
+    }
+  }
+
+  // Leftovers are full columns (up to rounding error)
+  for (uint32_t i : large) {
+    threshold_[i] = static_cast<uint64_t>(one);
+    alias_[i] = i;
+  }
+  for (uint32_t i : small) {
+    threshold_[i] = static_cast<uint64_t>(one);
+    alias_[i] = i;
+  }
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Walker's alias method (Vose's construction): O(n) to build from a list of
+// weights, then O(1) and allocation-free to sample. Each column keeps its
+// own index with probability threshold / 2^32 and otherwise yields alias.
+class AliasTable {
+private:
+  std::vector<uint64_t> threshold_;
+  std::vector<uint32_t> alias_;
+
+public:
+  AliasTable() = default;
+  // Non-positive weights are never drawn; all-zero weights sample uniformly
+  explicit AliasTable(const std::vector<double> &weights);
+
+  // Rng must produce uniform 32-bit values (e.g. std::mt19937)
+  template <class Rng> size_t sample(Rng &rng) const {
+    static_assert(Rng::min() == 0 && Rng::max() == 0xFFFFFFFFu,
+                  "AliasTable needs a 32-bit generator");
+    uint64_t column = (static_cast<uint64_t>(rng()) * threshold_.size()) >> 32;
+    return static_cast<uint64_t>(rng()) < threshold_[column]
+               ? static_cast<size_t>(column)
+               : alias_[column];
+  }
+
+  size_t size() const { return threshold_.size(); }
+  bool empty() const { return threshold_.empty(); }
+};
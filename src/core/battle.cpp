@@ -1,9 +1,45 @@
 #include "battle.hpp"
-#include "../engine/damage.hpp"
 #include "../engine/move_effects.hpp"
+#include "battle_output.hpp"
+#include "instrument.hpp"
 #include <iostream>
 
-void Battle::log(const std::string &message) { std::cout << message; }
+namespace {
+
+// Concatenates parts into a string on the turn arena
+template <typename... Parts>
+std::pmr::string join(TurnArena &arena, const Parts &...parts) {
+  std::pmr::string text(arena.resource());
+  (text.append(parts), ...);
+  return text;
+}
+
+} // namespace
+
+void Battle::reset(const std::vector<Pokemon> &t1,
+                   const std::vector<Pokemon> &t2) {
+  team1 = t1;
+  team2 = t2;
+  active1 = team1[0];
+  active2 = team2[0];
+  active1_index = 0;
+  active2_index = 0;
+  turn = 0;
+  over = false;
+  arena_.reset();
+  data_ = GameData::getInstance().snapshot();
+}
+
+void Battle::log(std::string_view message) { battle_out() << message; }
+
+void Battle::on_event(const BattleEvent &event) {
+  if (event.type == BattleEventType::MoveUsed) {
+    log(join(arena_, event.pokemon->name(), " used ", event.move->name,
+             "!\n"));
+    return;
+  }
+  write_event(battle_out(), event);
+}
 
 void Battle::execute_turn(int player_move_index, int ai_move_index) {
   turn++;
@@ -12,14 +48,32 @@ void Battle::execute_turn(int player_move_index, int ai_move_index) {
   active1.reset_turn_data();
   active2.reset_turn_data();
 
+  execute_moves(player_move_index, ai_move_index);
+  apply_end_of_turn();
+
+  // Sync active Pokemon back to teams
+  sync_active_to_team();
+
+  // Check if battle is over
+  if (is_team_defeated(1) || is_team_defeated(2)) {
+    over = true;
+  }
+}
+
+void Battle::execute_moves(int move1, int move2) {
+  BATTLER_COUNT(Turns);
+  BATTLER_TIME(Turn);
+  GameDataScope pinned(*data_);
+  arena_.reset(); // Nothing from the last turn is still in use
+
   // Determine turn order based on Speed
   bool player_first = active1.get_modified_stat(PokeStat::Speed) >=
                       active2.get_modified_stat(PokeStat::Speed);
 
   Pokemon *first = player_first ? &active1 : &active2;
   Pokemon *second = player_first ? &active2 : &active1;
-  int first_move_idx = player_first ? player_move_index : ai_move_index;
-  int second_move_idx = player_first ? ai_move_index : player_move_index;
+  int first_move_idx = player_first ? move1 : move2;
+  int second_move_idx = player_first ? move2 : move1;
 
   // Set move order flags
   first->set_moved_first(true);
@@ -32,11 +86,13 @@ void Battle::execute_turn(int player_move_index, int ai_move_index) {
 
   // Second Pokemon attacks (if both alive)
   if (second->hp() > 0 && first->hp() > 0) {
-    std::cout << "\n"; // Add spacing between Pokemon moves
+    battle_out() << "\n"; // Add spacing between Pokemon moves
     execute_pokemon_move(*second, *first, second_move_idx);
   }
+}
 
-  // End of turn updates
+void Battle::apply_end_of_turn() {
+  GameDataScope pinned(*data_);
   active1.update_disable();
   active2.update_disable();
   active1.update_bide();
@@ -51,14 +107,6 @@ void Battle::execute_turn(int player_move_index, int ai_move_index) {
   if (active2.hp() > 0) {
     apply_end_of_turn_status_damage(active2);
   }
-
-  // Sync active Pokemon back to teams
-  sync_active_to_team();
-
-  // Check if battle is over
-  if (is_team_defeated(1) || is_team_defeated(2)) {
-    over = true;
-  }
 }
 
 void Battle::execute_pokemon_move(Pokemon &attacker, Pokemon &defender,
@@ -67,20 +115,22 @@ void Battle::execute_pokemon_move(Pokemon &attacker, Pokemon &defender,
 
   // Check if move is disabled
   if (attacker.is_move_disabled(move_index)) {
-    log(attacker.name() + "'s move is disabled!\n");
+    log(join(arena_, attacker.name(), "'s move is disabled!\n"));
     return;
   }
 
   // Check PP
   if (!move.has_pp()) {
-    log(attacker.name() + " has no PP left for " + move.data->name + "!\n");
+    log(join(arena_, attacker.name(), " has no PP left for ", move.data->name,
+             "!\n"));
     return;
   }
 
   // Check status conditions
-  std::string status_message;
+  std::pmr::string status_message(arena_.resource());
   if (!can_move_with_status(attacker, status_message)) {
-    log(status_message + "\n");
+    status_message += "\n";
+    log(status_message);
     return;
   }
 
@@ -88,104 +138,42 @@ void Battle::execute_pokemon_move(Pokemon &attacker, Pokemon &defender,
   move.deduct_pp();
 
   // Apply move with battle context
-  apply_move(attacker, defender, move, this);
+  apply_move(attacker, defender, move);
 }
 
-void Battle::apply_move(Pokemon &attacker, Pokemon &defender, const Move &move,
-                        Battle *battle) {
+void Battle::apply_move(Pokemon &attacker, Pokemon &defender,
+                        const Move &move) {
   if (!move.data) {
-    log(attacker.name() + " has no move!\n");
+    log(join(arena_, attacker.name(), " has no move!\n"));
     return;
   }
 
-  log(attacker.name() + " used " + move.data->name + "!\n");
-
-  // Get the move effect type
-  const MoveEffect &effect = move.data->primary_effect;
-
-  // Handle based on effect type
-  if (effect.type == MoveEffectType::Damage ||
-      effect.type == MoveEffectType::None) {
-    // Standard damage move
-    DamageResult result = calculate_damage(attacker, defender, move);
-
-    if (result.type_effectiveness == 0.0f) {
-      std::cout << "It doesn't affect " << defender.name() << "...\n";
-      return;
-    }
-
-    defender.take_damage(result.damage);
-    std::cout << defender.name() << " took " << result.damage << " damage!\n";
-
-    // Record damage for Counter mechanic
-    defender.record_damage_taken(result.damage, move.data);
-
-    // Store damage for Bide if active
-    defender.store_bide_damage(result.damage);
-
-    if (result.critical) {
-      std::cout << "Critical hit!\n";
-    }
-
-    if (result.type_effectiveness > 1.0f) {
-      std::cout << "It's super effective!\n";
-    } else if (result.type_effectiveness < 1.0f &&
-               result.type_effectiveness > 0.0f) {
-      std::cout << "It's not very effective...\n";
-    }
-  } else if (effect.type == MoveEffectType::StatChange) {
-    // Stat-changing move
-    Pokemon &target =
-        effect.stat_change.target == EffectTarget::Self ? attacker : defender;
-    apply_stat_change(target, effect.stat_change);
-  } else if (effect.type == MoveEffectType::StatusInflict) {
-    // Status-inflicting move
-    Pokemon &target = effect.status_inflict.target == EffectTarget::Self
-                          ? attacker
-                          : defender;
-    apply_status_effect(target, effect.status_inflict.status);
-  } else {
-    // For other effects, use the effects engine
-    EffectResult eff_result =
-        apply_move_effect(attacker, defender, move.data, battle);
-
-    // Apply damage from effect
-    if (eff_result.damage > 0) {
-      defender.take_damage(eff_result.damage);
-      std::cout << defender.name() << " took " << eff_result.damage
-                << " damage!\n";
-
-      // Record damage for Counter mechanic
-      defender.record_damage_taken(eff_result.damage, move.data);
-    }
-
-    // Apply recoil damage to attacker
-    if (eff_result.recoil_damage > 0) {
-      attacker.take_damage(eff_result.recoil_damage);
-      std::cout << attacker.name() << " is hit with recoil!\n";
-      if (attacker.hp() <= 0) {
-        std::cout << attacker.name() << " fainted from recoil!\n";
-      }
-    }
-
-    // Apply drain healing to attacker
-    if (eff_result.drain_amount > 0) {
-      attacker.heal(eff_result.drain_amount);
-      std::cout << attacker.name() << " drained HP!\n";
-    }
-
-    if (!eff_result.message.empty()) {
-      std::cout << eff_result.message << "\n";
-    }
+  BattleEvent used(BattleEventType::MoveUsed, &attacker);
+  used.move = move.data;
+  on_event(used);
+  BATTLER_COUNT_EFFECT(move.data->primary_effect.type);
+
+  // Compiled when the move was loaded; moves built by hand compile here
+  MoveHandler handler = move.data->handler;
+  const CompiledEffect *effect = &move.data->effect;
+  const CompiledEffect *secondary = &move.data->secondary;
+  CompiledEffect unloaded;
+  CompiledEffect unloaded_secondary;
+  if (!handler) {
+    handler = resolve_move_handler(move.data->primary_effect.type);
+    unloaded = compile_move_effect(move.data->primary_effect);
+    unloaded_secondary =
+        compile_secondary_effect(move.data->secondary_effect.get());
+    effect = &unloaded;
+    secondary = &unloaded_secondary;
   }
+  if (!handler(attacker, defender, move, *effect, *this))
+    return;
 
-  // Apply secondary effects if they exist
-  if (move.data->secondary_effect) {
-    apply_secondary_effect(attacker, defender, *move.data->secondary_effect);
-  }
+  apply_secondary_effect(attacker, defender, *secondary, *this);
 
   if (defender.hp() <= 0) {
-    std::cout << defender.name() << " fainted!\n";
+    on_event(BattleEvent(BattleEventType::Fainted, &defender));
   }
 }
 
@@ -212,10 +200,10 @@ int Battle::get_remaining_pokemon(int team_num) const {
   return count;
 }
 
-std::vector<int> Battle::get_available_pokemon(int team_num) const {
+std::pmr::vector<int> Battle::get_available_pokemon(int team_num) {
   const std::vector<Pokemon> &team = (team_num == 1) ? team1 : team2;
   int active_index = (team_num == 1) ? active1_index : active2_index;
-  std::vector<int> available;
+  std::pmr::vector<int> available(arena_.resource());
 
   for (size_t i = 0; i < team.size(); i++) {
     if (team[i].hp() > 0 && static_cast<int>(i) != active_index) {
@@ -226,20 +214,25 @@ std::vector<int> Battle::get_available_pokemon(int team_num) const {
 }
 
 void Battle::switch_pokemon(int team_num, int new_index) {
+  send_in(team_num, new_index);
+  if (team_num == 1) {
+    battle_out() << "Go, " << active1.name() << "!\n";
+  } else {
+    battle_out() << "Opponent sent out " << active2.name() << "!\n";
+  }
+}
+
+void Battle::send_in(int team_num, int new_index) {
   if (team_num == 1) {
     // Sync current active back to team
     team1[active1_index] = active1;
     // Switch to new Pokemon
     active1_index = new_index;
     active1 = team1[new_index];
-    std::cout << "Go, " << active1.name() << "!\n";
   } else {
-    // Sync current active back to team
     team2[active2_index] = active2;
-    // Switch to new Pokemon
     active2_index = new_index;
     active2 = team2[new_index];
-    std::cout << "Opponent sent out " << active2.name() << "!\n";
   }
 }
 
@@ -1,14 +1,25 @@
 #pragma once
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
 #include <vector>
 
+#include "../data/game_data.hpp"
+#include "battle_event.hpp"
 #include "pokemon.hpp"
+#include "turn_arena.hpp"
 
-class Battle {
+class Battle : public BattleEventSink {
 public:
   Battle(std::vector<Pokemon> t1, std::vector<Pokemon> t2)
       : team1(t1), team2(t2), active1(t1[0]), active2(t2[0]), active1_index(0),
-        active2_index(0) {}
+        active2_index(0), data_(GameData::getInstance().snapshot()) {}
+
+  // Start over with new teams, reusing this battle's storage: a team no
+  // bigger than the last one costs no allocation (see BattlePool). Pins
+  // the latest game data, as a new battle would.
+  void reset(const std::vector<Pokemon> &t1, const std::vector<Pokemon> &t2);
 
   // Execute a turn with both Pokemon's moves
   void execute_turn(int player_move_index, int ai_move_index);
@@ -16,7 +27,8 @@ public:
   // Team management
   bool is_team_defeated(int team_num) const;
   int get_remaining_pokemon(int team_num) const;
-  std::vector<int> get_available_pokemon(int team_num) const;
+  // Allocated from the turn arena: valid until the next turn starts
+  std::pmr::vector<int> get_available_pokemon(int team_num);
   void switch_pokemon(int team_num, int new_index);
   const Pokemon &get_team_pokemon(int team_num, int index) const;
 
@@ -26,7 +38,19 @@ public:
   Pokemon active2;
 
   // Virtual logging method for output (can be overridden for network battles)
-  virtual void log(const std::string &message);
+  virtual void log(std::string_view message);
+
+  // Prints what a move did: "used" lines through log(), the rest to
+  // battle_out()
+  void on_event(const BattleEvent &event) override;
+
+  // Scratch memory for the current turn, released when the next one starts
+  TurnArena &turn_arena() { return arena_; }
+
+  // The game data this battle started with. Its turns read GameData
+  // through it (see GameDataScope), so a reload mid-battle only affects
+  // battles that start afterwards.
+  const GameDataSnapshot &game_data() const { return *data_; }
 
 protected:
   // Protected for NetworkBattle inheritance
@@ -35,13 +59,19 @@ protected:
   int active1_index;
   int active2_index;
   int turn = 0;
+  TurnArena arena_;
+  std::shared_ptr<const GameDataSnapshot> data_;
 
   void execute_pokemon_move(Pokemon &attacker, Pokemon &defender,
                             int move_index);
+  // The phases of execute_turn, for battles that ask for a replacement
+  // between the moves and the end of the turn (see NetworkBattle)
+  void execute_moves(int move1, int move2); // Faster Pokemon goes first
+  void apply_end_of_turn();
+  void send_in(int team_num, int new_index); // switch_pokemon without text
   void sync_active_to_team();
   int get_next_available_pokemon(int team_num) const;
 
 private:
-  void apply_move(Pokemon &attacker, Pokemon &defender, const Move &move,
-                  Battle *battle);
+  void apply_move(Pokemon &attacker, Pokemon &defender, const Move &move);
 };
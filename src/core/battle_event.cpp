@@ -0,0 +1,133 @@
+#include "battle_event.hpp"
+#include "move.hpp"
+#include "pokemon.hpp"
+
+namespace {
+
+const char *status_text(PokeStatus status) {
+  switch (status) {
+  case PokeStatus::Burn:
+    return "burned";
+  case PokeStatus::Freeze:
+    return "frozen";
+  case PokeStatus::Paralysis:
+    return "paralyzed";
+  case PokeStatus::Poison:
+    return "poisoned";
+  case PokeStatus::Sleep:
+    return "fell asleep";
+  case PokeStatus::Toxic:
+    return "badly poisoned";
+  default:
+    return "affected";
+  }
+}
+
+const char *stat_text(PokeStat stat) {
+  switch (stat) {
+  case PokeStat::Attack:
+    return "Attack";
+  case PokeStat::Defense:
+    return "Defense";
+  case PokeStat::Speed:
+    return "Speed";
+  case PokeStat::Special:
+    return "Special";
+  default:
+    return "stat";
+  }
+}
+
+} // namespace
+
+void write_event(std::ostream &out, const BattleEvent &event) {
+  switch (event.type) {
+  case BattleEventType::MoveUsed:
+    out << event.pokemon->name() << " used " << event.move->name << "!\n";
+    break;
+  case BattleEventType::Damage:
+    out << event.pokemon->name() << " took " << event.amount << " damage!\n";
+    break;
+  case BattleEventType::NoEffect:
+    out << "It doesn't affect " << event.pokemon->name() << "...\n";
+    break;
+  case BattleEventType::CriticalHit:
+    out << "Critical hit!\n";
+    break;
+  case BattleEventType::SuperEffective:
+    out << "It's super effective!\n";
+    break;
+  case BattleEventType::NotVeryEffective:
+    out << "It's not very effective...\n";
+    break;
+  case BattleEventType::Recoil:
+    out << event.pokemon->name() << " is hit with recoil!\n";
+    break;
+  case BattleEventType::FaintedFromRecoil:
+    out << event.pokemon->name() << " fainted from recoil!\n";
+    break;
+  case BattleEventType::Drained:
+    out << event.pokemon->name() << " drained HP!\n";
+    break;
+  case BattleEventType::Fainted:
+    out << event.pokemon->name() << " fainted!\n";
+    break;
+  case BattleEventType::Failed:
+    out << "But it failed!\n";
+    break;
+  case BattleEventType::StatChanged:
+    if (event.amount == 0)
+      break;
+    out << event.pokemon->name() << "'s " << stat_text(event.stat);
+    if (event.amount > 0)
+      out << (event.amount == 1 ? " rose!\n" : " rose sharply!\n");
+    else
+      out << (event.amount == -1 ? " fell!\n" : " fell sharply!\n");
+    break;
+  case BattleEventType::StatusInflicted:
+    out << event.pokemon->name() << " was " << status_text(event.status)
+        << "!\n";
+    break;
+  case BattleEventType::OneHitKO:
+    out << "It's a one-hit KO!\n";
+    break;
+  case BattleEventType::Recovered:
+    out << event.pokemon->name() << " recovered HP!\n";
+    break;
+  case BattleEventType::Confused:
+    out << event.pokemon->name() << " became confused!\n";
+    break;
+  case BattleEventType::Flinched:
+    out << event.pokemon->name() << " flinched!\n";
+    break;
+  case BattleEventType::Charging: {
+    const std::string &message =
+        event.move->primary_effect.two_turn.charge_message;
+    if (!message.empty())
+      out << message << "\n";
+    break;
+  }
+  case BattleEventType::Disabled:
+    out << "Disabled a move!\n";
+    break;
+  case BattleEventType::StoringEnergy:
+    out << event.pokemon->name() << " is storing energy!\n";
+    break;
+  case BattleEventType::UnleashedEnergy:
+    out << event.pokemon->name() << " unleashed energy!\n";
+    break;
+  case BattleEventType::Reflect:
+    out << event.pokemon->name() << "'s Reflect raised physical defense!\n";
+    break;
+  case BattleEventType::LightScreen:
+    out << event.pokemon->name()
+        << "'s Light Screen raised special defense!\n";
+    break;
+  case BattleEventType::Haze:
+    out << "All stat changes were eliminated!\n";
+    break;
+  case BattleEventType::NotImplemented:
+    out << "Effect not yet implemented!\n";
+    break;
+  }
+}
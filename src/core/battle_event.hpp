@@ -0,0 +1,61 @@
+#pragma once
+#include <ostream>
+
+#include "enums.hpp"
+
+class Pokemon;
+struct MoveData;
+
+// Something a move did. Move handlers report what happened as a stream of
+// these instead of building text, and whoever is listening decides what
+// to do with them: Battle prints each one as its line of battle text.
+enum class BattleEventType {
+  MoveUsed,          // pokemon used move
+  Damage,            // pokemon took amount damage over hits hits
+  NoEffect,          // The move does not affect pokemon
+  CriticalHit,
+  SuperEffective,
+  NotVeryEffective,
+  Recoil,            // pokemon took amount recoil damage
+  FaintedFromRecoil, // pokemon
+  Drained,           // pokemon drained amount HP
+  Fainted,           // pokemon
+  Failed,
+  StatChanged,       // pokemon's stat moved by amount stages
+  StatusInflicted,   // pokemon was given status
+  OneHitKO,
+  Recovered,         // pokemon
+  Confused,          // pokemon
+  Flinched,          // pokemon
+  Charging,          // move's charge message, if it has one
+  Disabled,
+  StoringEnergy,     // pokemon started Bide
+  UnleashedEnergy,   // pokemon ended Bide
+  Reflect,           // pokemon put up Reflect
+  LightScreen,       // pokemon put up Light Screen
+  Haze,
+  NotImplemented
+};
+
+struct BattleEvent {
+  BattleEventType type;
+  const Pokemon *pokemon = nullptr;
+  const MoveData *move = nullptr;
+  int amount = 0;
+  int hits = 1;
+  PokeStat stat = PokeStat::HP;
+  PokeStatus status = PokeStatus::None;
+
+  BattleEvent(BattleEventType t, const Pokemon *p = nullptr, int a = 0)
+      : type(t), pokemon(p), amount(a) {}
+};
+
+class BattleEventSink {
+public:
+  virtual ~BattleEventSink() = default;
+  virtual void on_event(const BattleEvent &event) = 0;
+};
+
+// The battle text for an event, newline included ("Onix took 12 damage!\n").
+// Writes nothing for an event with no text, such as a silent charge.
+void write_event(std::ostream &out, const BattleEvent &event);
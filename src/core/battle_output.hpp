@@ -0,0 +1,30 @@
+#pragma once
+#include <iostream>
+#include <ostream>
+
+// Stream that battle and engine text is written to. Defaults to std::cout;
+// headless battles (tournaments, simulations) silence it per thread so many
+// battles can run in parallel without interleaving output.
+inline std::ostream *&battle_out_ptr() {
+  static thread_local std::ostream *out = &std::cout;
+  return out;
+}
+
+inline std::ostream &battle_out() { return *battle_out_ptr(); }
+
+// Silences battle output on the current thread while in scope
+class QuietBattleOutput {
+private:
+  std::ostream null_stream_;
+  std::ostream *previous_;
+
+public:
+  QuietBattleOutput() : null_stream_(nullptr), previous_(battle_out_ptr()) {
+    battle_out_ptr() = &null_stream_;
+  }
+
+  ~QuietBattleOutput() { battle_out_ptr() = previous_; }
+
+  QuietBattleOutput(const QuietBattleOutput &) = delete;
+  QuietBattleOutput &operator=(const QuietBattleOutput &) = delete;
+};
@@ -0,0 +1,21 @@
+#include "battle_pool.hpp"
+
+BattlePool::Lease BattlePool::acquire(const std::vector<Pokemon> &team1,
+                                      const std::vector<Pokemon> &team2) {
+  if (idle_.empty())
+    return Lease(this, std::unique_ptr<Battle>(new Battle(team1, team2)));
+
+  std::unique_ptr<Battle> battle = std::move(idle_.back());
+  idle_.pop_back();
+  battle->reset(team1, team2);
+  return Lease(this, std::move(battle));
+}
+
+void BattlePool::release(std::unique_ptr<Battle> battle) {
+  idle_.push_back(std::move(battle));
+}
+
+BattlePool &BattlePool::local() {
+  static thread_local BattlePool pool;
+  return pool;
+}
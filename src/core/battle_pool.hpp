@@ -0,0 +1,44 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "battle.hpp"
+
+// Battles kept for reuse. Acquiring one resets an idle battle in place
+// rather than building a new one, so once a thread has played a battle
+// with teams this big, starting another allocates nothing.
+class BattlePool {
+public:
+  // A battle on loan; it goes back to the pool when the lease ends
+  class Lease {
+  private:
+    BattlePool *pool_;
+    std::unique_ptr<Battle> battle_;
+
+  public:
+    Lease(BattlePool *pool, std::unique_ptr<Battle> battle)
+        : pool_(pool), battle_(std::move(battle)) {}
+    Lease(Lease &&other) = default;
+    Lease &operator=(Lease &&other) = delete;
+    ~Lease() {
+      if (battle_)
+        pool_->release(std::move(battle_));
+    }
+
+    Battle &operator*() const { return *battle_; }
+    Battle *operator->() const { return battle_.get(); }
+  };
+
+  Lease acquire(const std::vector<Pokemon> &team1,
+                const std::vector<Pokemon> &team2);
+
+  size_t idle() const { return idle_.size(); }
+
+  // The calling thread's pool, for headless battles run on any thread
+  static BattlePool &local();
+
+private:
+  std::vector<std::unique_ptr<Battle>> idle_;
+
+  void release(std::unique_ptr<Battle> battle);
+};
@@ -0,0 +1,254 @@
+#include "instrument.hpp"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace instrument {
+namespace {
+
+// Counters owned by one thread. Only that thread writes them, so a relaxed
+// load and store is enough; readers may see a count one update late.
+struct ThreadBlock {
+  std::array<std::atomic<uint64_t>, COUNTERS> counters{};
+  struct TimerBlock {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+    std::array<std::atomic<uint64_t>, TIME_BUCKETS> buckets{};
+  };
+  std::array<TimerBlock, TIMERS> timers{};
+  std::array<std::atomic<uint64_t>, EFFECT_TYPES> effects{};
+  std::array<std::atomic<uint64_t>, MESSAGE_TYPES> sent{};
+  std::array<std::atomic<uint64_t>, MESSAGE_TYPES> bytes_sent{};
+  std::array<std::atomic<uint64_t>, MESSAGE_TYPES> received{};
+  std::array<std::atomic<uint64_t>, MESSAGE_TYPES> bytes_received{};
+};
+
+inline void add(std::atomic<uint64_t> &value, uint64_t amount) {
+  value.store(value.load(std::memory_order_relaxed) + amount,
+              std::memory_order_relaxed);
+}
+
+// Every block ever handed out. A thread's block goes back on the free list
+// when it exits and the next new thread carries on from its totals, so
+// blocks are never freed and the totals never go down.
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadBlock>> blocks;
+  std::vector<ThreadBlock *> free;
+};
+
+Registry &registry() {
+  static Registry *instance = new Registry(); // Outlives thread exits
+  return *instance;
+}
+
+ThreadBlock *&current_block() {
+  static thread_local ThreadBlock *block = nullptr;
+  return block;
+}
+
+// Returns the thread's block to the registry when the thread exits
+struct BlockRelease {
+  ~BlockRelease() {
+    ThreadBlock *block = current_block();
+    if (!block)
+      return;
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.free.push_back(block);
+    current_block() = nullptr;
+  }
+};
+
+ThreadBlock &thread_block() {
+  ThreadBlock *block = current_block();
+  if (block)
+    return *block;
+
+  static thread_local BlockRelease release;
+  (void)release;
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  if (!reg.free.empty()) {
+    block = reg.free.back();
+    reg.free.pop_back();
+  } else {
+    reg.blocks.push_back(std::unique_ptr<ThreadBlock>(new ThreadBlock()));
+    block = reg.blocks.back().get();
+  }
+  current_block() = block;
+  return *block;
+}
+
+size_t time_bucket(uint64_t ns) {
+  size_t bucket = 0;
+  while (ns > 1 && bucket + 1 < TIME_BUCKETS) {
+    ns >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+uint64_t load(const std::atomic<uint64_t> &value) {
+  return value.load(std::memory_order_relaxed);
+}
+
+std::string format_ns(double ns) {
+  std::stringstream ss;
+  ss.precision(3);
+  if (ns >= 1e6)
+    ss << ns / 1e6 << " ms";
+  else if (ns >= 1e3)
+    ss << ns / 1e3 << " us";
+  else
+    ss << ns << " ns";
+  return ss.str();
+}
+
+void format_timer(std::stringstream &ss, const TimerStats &timer) {
+  if (!timer.count)
+    return;
+  ss << " (mean " << format_ns(timer.mean_ns()) << ", p50 <= "
+     << format_ns(static_cast<double>(timer.percentile_ns(0.5))) << ", p99 <= "
+     << format_ns(static_cast<double>(timer.percentile_ns(0.99))) << ", max "
+     << format_ns(static_cast<double>(timer.max_ns)) << ")";
+}
+
+} // namespace
+
+uint64_t TimerStats::percentile_ns(double q) const {
+  if (count == 0)
+    return 0;
+  uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count - 1));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < TIME_BUCKETS; i++) {
+    seen += buckets[i];
+    if (seen > rank)
+      return std::min<uint64_t>(max_ns, (uint64_t(2) << i) - 1);
+  }
+  return max_ns;
+}
+
+Snapshot Snapshot::since(const Snapshot &earlier) const {
+  Snapshot delta = *this;
+  for (size_t i = 0; i < COUNTERS; i++)
+    delta.counters[i] -= earlier.counters[i];
+  for (size_t i = 0; i < TIMERS; i++) {
+    delta.timers[i].count -= earlier.timers[i].count;
+    delta.timers[i].total_ns -= earlier.timers[i].total_ns;
+    for (size_t b = 0; b < TIME_BUCKETS; b++)
+      delta.timers[i].buckets[b] -= earlier.timers[i].buckets[b];
+  }
+  for (size_t i = 0; i < EFFECT_TYPES; i++)
+    delta.effects[i] -= earlier.effects[i];
+  for (size_t i = 0; i < MESSAGE_TYPES; i++) {
+    delta.messages[i].sent -= earlier.messages[i].sent;
+    delta.messages[i].bytes_sent -= earlier.messages[i].bytes_sent;
+    delta.messages[i].received -= earlier.messages[i].received;
+    delta.messages[i].bytes_received -= earlier.messages[i].bytes_received;
+  }
+  return delta;
+}
+
+void count(Counter counter, uint64_t amount) {
+  add(thread_block().counters[static_cast<size_t>(counter)], amount);
+}
+
+void count_effect(MoveEffectType type) {
+  size_t index = static_cast<size_t>(type);
+  if (index < EFFECT_TYPES)
+    add(thread_block().effects[index], 1);
+}
+
+void count_sent(uint8_t message_type, uint64_t bytes) {
+  ThreadBlock &block = thread_block();
+  add(block.sent[message_type], 1);
+  add(block.bytes_sent[message_type], bytes);
+}
+
+void count_received(uint8_t message_type, uint64_t bytes) {
+  ThreadBlock &block = thread_block();
+  add(block.received[message_type], 1);
+  add(block.bytes_received[message_type], bytes);
+}
+
+void record_time(Timer timer, uint64_t ns) {
+  ThreadBlock::TimerBlock &stats =
+      thread_block().timers[static_cast<size_t>(timer)];
+  add(stats.count, 1);
+  add(stats.total_ns, ns);
+  add(stats.buckets[time_bucket(ns)], 1);
+  if (ns > load(stats.max_ns))
+    stats.max_ns.store(ns, std::memory_order_relaxed);
+}
+
+Snapshot snapshot() {
+  Snapshot total;
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex); // Guards the block list only
+  for (const auto &block : reg.blocks) {
+    for (size_t i = 0; i < COUNTERS; i++)
+      total.counters[i] += load(block->counters[i]);
+    for (size_t i = 0; i < TIMERS; i++) {
+      const ThreadBlock::TimerBlock &from = block->timers[i];
+      TimerStats &to = total.timers[i];
+      to.count += load(from.count);
+      to.total_ns += load(from.total_ns);
+      to.max_ns = std::max(to.max_ns, load(from.max_ns));
+      for (size_t b = 0; b < TIME_BUCKETS; b++)
+        to.buckets[b] += load(from.buckets[b]);
+    }
+    for (size_t i = 0; i < EFFECT_TYPES; i++)
+      total.effects[i] += load(block->effects[i]);
+    for (size_t i = 0; i < MESSAGE_TYPES; i++) {
+      total.messages[i].sent += load(block->sent[i]);
+      total.messages[i].bytes_sent += load(block->bytes_sent[i]);
+      total.messages[i].received += load(block->received[i]);
+      total.messages[i].bytes_received += load(block->bytes_received[i]);
+    }
+  }
+  return total;
+}
+
+std::string format(const Snapshot &snapshot) {
+  std::stringstream ss;
+  if (!enabled()) {
+    ss << "Instrumentation is off (configure with -DBATTLER_INSTRUMENT=ON)\n";
+    return ss.str();
+  }
+
+  ss << "Turns:        " << snapshot.counter(Counter::Turns);
+  format_timer(ss, snapshot.timer(Timer::Turn));
+  ss << "\nDamage calcs: " << snapshot.counter(Counter::DamageCalcs);
+  ss << "\nAI decisions: " << snapshot.counter(Counter::AiDecisions);
+  format_timer(ss, snapshot.timer(Timer::AiDecision));
+  ss << "\n";
+
+  bool any = false;
+  for (size_t i = 0; i < EFFECT_TYPES; i++) {
+    if (!snapshot.effects[i])
+      continue;
+    ss << (any ? ", " : "Effects:      ")
+       << move_effect_name(static_cast<MoveEffectType>(i)) << " "
+       << snapshot.effects[i];
+    any = true;
+  }
+  if (any)
+    ss << "\n";
+
+  // Types are the MessageType values from network/protocol.hpp
+  for (size_t i = 0; i < MESSAGE_TYPES; i++) {
+    const MessageStats &stats = snapshot.messages[i];
+    if (!stats.sent && !stats.received)
+      continue;
+    ss << "Message type " << i << ": sent " << stats.sent << " ("
+       << stats.bytes_sent << " B), received " << stats.received << " ("
+       << stats.bytes_received << " B)\n";
+  }
+  return ss.str();
+}
+
+} // namespace instrument
@@ -0,0 +1,130 @@
+#pragma once
+#include "move_effect.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Hot-path counters and timers. Each thread writes only to its own block,
+// so recording is a plain load and store with no locking or shared cache
+// lines; snapshot() sums the blocks of every thread that has recorded.
+//
+// The BATTLER_* macros below compile to nothing unless the build is
+// configured with -DBATTLER_INSTRUMENT=ON, so uninstrumented builds pay
+// nothing. The functions themselves are always available.
+namespace instrument {
+
+enum class Counter { Turns, DamageCalcs, AiDecisions, COUNT };
+enum class Timer { Turn, AiDecision, COUNT };
+
+const size_t COUNTERS = static_cast<size_t>(Counter::COUNT);
+const size_t TIMERS = static_cast<size_t>(Timer::COUNT);
+const size_t EFFECT_TYPES = static_cast<size_t>(MoveEffectType::Conversion) + 1;
+const size_t MESSAGE_TYPES = 256; // Indexed by the MessageType byte
+const size_t TIME_BUCKETS = 40;   // Bucket i holds [2^i, 2^(i+1)) ns
+
+struct TimerStats {
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+  std::array<uint64_t, TIME_BUCKETS> buckets{};
+
+  double mean_ns() const {
+    return count ? static_cast<double>(total_ns) / count : 0.0;
+  }
+  // Upper bound of the bucket holding the q-th sample, q in [0, 1]
+  uint64_t percentile_ns(double q) const;
+};
+
+// Traffic for one message type
+struct MessageStats {
+  uint64_t sent = 0;
+  uint64_t bytes_sent = 0;
+  uint64_t received = 0;
+  uint64_t bytes_received = 0;
+};
+
+// Totals across all threads since the process started
+struct Snapshot {
+  std::array<uint64_t, COUNTERS> counters{};
+  std::array<TimerStats, TIMERS> timers{};
+  std::array<uint64_t, EFFECT_TYPES> effects{};
+  std::array<MessageStats, MESSAGE_TYPES> messages{};
+
+  uint64_t counter(Counter c) const {
+    return counters[static_cast<size_t>(c)];
+  }
+  const TimerStats &timer(Timer t) const {
+    return timers[static_cast<size_t>(t)];
+  }
+
+  // What was recorded between earlier and this snapshot (max is kept
+  // whole, since it cannot be split)
+  Snapshot since(const Snapshot &earlier) const;
+};
+
+constexpr bool enabled() {
+#ifdef BATTLER_INSTRUMENT
+  return true;
+#else
+  return false;
+#endif
+}
+
+void count(Counter counter, uint64_t amount = 1);
+void count_effect(MoveEffectType type);
+void count_sent(uint8_t message_type, uint64_t bytes);
+void count_received(uint8_t message_type, uint64_t bytes);
+void record_time(Timer timer, uint64_t ns);
+
+Snapshot snapshot();
+
+// Multi-line text for logs and the server's STATS reply; zero rows left out
+std::string format(const Snapshot &snapshot);
+
+// Records the time from construction to destruction
+class ScopedTimer {
+private:
+  Timer timer_;
+  std::chrono::steady_clock::time_point start_;
+
+public:
+  explicit ScopedTimer(Timer timer)
+      : timer_(timer), start_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedTimer() {
+    record_time(timer_, static_cast<uint64_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start_)
+                                .count()));
+  }
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+};
+
+} // namespace instrument
+
+#define BATTLER_INSTRUMENT_CONCAT2(a, b) a##b
+#define BATTLER_INSTRUMENT_CONCAT(a, b) BATTLER_INSTRUMENT_CONCAT2(a, b)
+
+#ifdef BATTLER_INSTRUMENT
+#define BATTLER_COUNT(counter)                                                 \
+  ::instrument::count(::instrument::Counter::counter)
+#define BATTLER_COUNT_EFFECT(type) ::instrument::count_effect(type)
+#define BATTLER_COUNT_SENT(type, bytes)                                        \
+  ::instrument::count_sent(static_cast<uint8_t>(type), bytes)
+#define BATTLER_COUNT_RECEIVED(type, bytes)                                    \
+  ::instrument::count_received(static_cast<uint8_t>(type), bytes)
+#define BATTLER_TIME(timer)                                                    \
+  ::instrument::ScopedTimer BATTLER_INSTRUMENT_CONCAT(battler_timer_,         \
+                                                      __LINE__)(               \
+      ::instrument::Timer::timer)
+#else
+#define BATTLER_COUNT(counter) ((void)0)
+#define BATTLER_COUNT_EFFECT(type) ((void)0)
+#define BATTLER_COUNT_SENT(type, bytes) ((void)0)
+#define BATTLER_COUNT_RECEIVED(type, bytes) ((void)0)
+#define BATTLER_TIME(timer) ((void)0)
+#endif
@@ -1,5 +1,6 @@
 #pragma once
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -8,6 +9,21 @@
 
 enum class MoveCategory { Physical, Special, Status };
 
+// Dense index assigned to each move in the order it was first added
+typedef uint16_t MoveId;
+const MoveId NO_MOVE = 0xFFFF;
+
+class BattleEventSink;
+class Pokemon;
+struct Move;
+
+// Carries out a move's primary effect, as compiled into effect, and
+// reports it to events. Returns false when the move stopped short (the
+// target was immune), which skips the secondary effect and the faint check.
+typedef bool (*MoveHandler)(Pokemon &attacker, Pokemon &defender,
+                            const Move &move, const CompiledEffect &effect,
+                            BattleEventSink &events);
+
 struct MoveData {
   std::string name;
   PokeType type;
@@ -20,7 +36,19 @@ struct MoveData {
   MoveEffect primary_effect;
   std::unique_ptr<SecondaryEffect> secondary_effect;
 
-  MoveData() : power(0), accuracy(100), max_pp(0), secondary_effect(nullptr) {}
+  // Resolved from primary_effect when the move is loaded or added to
+  // GameData (see compile_move), so using a move is one indirect call on
+  // an effect with nothing left to look up
+  MoveHandler handler;
+  CompiledEffect effect;
+  // secondary_effect, compiled the same way with its chance folded in
+  // (kind None if the move has none)
+  CompiledEffect secondary;
+  MoveId id; // Set by GameData::addMove
+
+  MoveData()
+      : power(0), accuracy(100), max_pp(0), secondary_effect(nullptr),
+        handler(nullptr), id(NO_MOVE) {}
 };
 
 struct Move {
@@ -45,3 +73,20 @@ struct Move {
     }
   }
 };
+
+// The handler for an effect type (defined with the handlers, in
+// engine/move_effects.cpp)
+MoveHandler resolve_move_handler(MoveEffectType type);
+
+// An effect flattened for its handler, keeping only the fields its type
+// reads. Nothing is checked here; the loader rejects bad data before it
+// gets this far (see compile_moves).
+CompiledEffect compile_move_effect(const MoveEffect &effect);
+
+// A secondary effect flattened the same way. Its chance is the secondary's
+// own; apply_secondary_effect rolls that once and nothing else.
+CompiledEffect compile_secondary_effect(const SecondaryEffect *secondary);
+
+// Sets move.handler and move.effect from move.primary_effect, and
+// move.secondary from move.secondary_effect
+void compile_move(MoveData &move);
@@ -1,5 +1,7 @@
 #pragma once
 #include "enums.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 // Types of move effects
@@ -39,9 +41,68 @@ enum class MoveEffectType {
   Bide,          // Bide mechanic
   Counter,       // Counter physical damage
   PayDay,        // Scatter coins
-  Conversion     // Change type to match move
+  Conversion,    // Change type to match move
+  NotImplemented // In the data on purpose, but the engine has no handler yet
 };
 
+const size_t MOVE_EFFECT_TYPE_COUNT =
+    static_cast<size_t>(MoveEffectType::NotImplemented) + 1;
+
+// Short name of an effect type, as moves.json spells it ("other" for the
+// types the data has no name for)
+inline const char *move_effect_name(MoveEffectType type) {
+  switch (type) {
+  case MoveEffectType::None:
+    return "none";
+  case MoveEffectType::Damage:
+    return "damage";
+  case MoveEffectType::StatChange:
+    return "stat_change";
+  case MoveEffectType::StatusInflict:
+    return "status";
+  case MoveEffectType::Heal:
+    return "heal";
+  case MoveEffectType::Recoil:
+    return "recoil";
+  case MoveEffectType::Drain:
+    return "drain";
+  case MoveEffectType::MultiHit:
+    return "multi_hit";
+  case MoveEffectType::TwoHit:
+    return "two_hit";
+  case MoveEffectType::OHKO:
+    return "ohko";
+  case MoveEffectType::FixedDamage:
+    return "fixed_damage";
+  case MoveEffectType::Confusion:
+    return "confusion";
+  case MoveEffectType::Flinch:
+    return "flinch";
+  case MoveEffectType::Counter:
+    return "counter";
+  case MoveEffectType::TwoTurn:
+    return "two_turn";
+  case MoveEffectType::Rage:
+    return "rage";
+  case MoveEffectType::Disable:
+    return "disable";
+  case MoveEffectType::Haze:
+    return "haze";
+  case MoveEffectType::Reflect:
+    return "reflect";
+  case MoveEffectType::LightScreen:
+    return "light_screen";
+  case MoveEffectType::Bide:
+    return "bide";
+  case MoveEffectType::HighCritRatio:
+    return "high_crit";
+  case MoveEffectType::NotImplemented:
+    return "not_implemented";
+  default:
+    return "other";
+  }
+}
+
 // Target of the effect
 enum class EffectTarget { Opponent, Self, Both, Field };
 
@@ -145,3 +206,23 @@ struct SecondaryEffect {
   SecondaryEffect() : chance(0) {}
   SecondaryEffect(int ch, const MoveEffect &eff) : chance(ch), effect(eff) {}
 };
+
+// A primary effect as the handlers read it: every field of every effect
+// type in one flat block, with the defaults already applied, so using a
+// move never looks at which parts of its MoveEffect were filled in. Built
+// once per move by compile_move_effect (see move.hpp).
+struct CompiledEffect {
+  MoveEffectType kind = MoveEffectType::Damage;
+  EffectTarget target = EffectTarget::Opponent; // StatChange, StatusInflict
+  PokeStat stat = PokeStat::Attack;             // StatChange
+  PokeStatus status = PokeStatus::None;         // StatusInflict
+  FixedDamageData::Type fixed = FixedDamageData::Type::Level;
+  int16_t fixed_value = 0; // FixedDamage Constant
+  int8_t stages = 0;       // StatChange
+  uint8_t chance = 100;    // StatChange, StatusInflict, Flinch
+  uint8_t percent = 0;     // Recoil, Drain, Heal
+  uint8_t min_hits = 1;    // MultiHit
+  uint8_t max_hits = 1;
+};
+static_assert(sizeof(CompiledEffect) <= 32,
+              "CompiledEffect should stay within half a cache line");
@@ -1,25 +1,21 @@
 #include "pokemon.hpp"
-#include <cmath>
+#include "rng.hpp"
+#include "stat_cache.hpp"
 #include <iostream>
 
 Pokemon::Pokemon(const std::string &species_name, int level)
-    : level_(level), status_(PokeStatus::None),
-      volatile_status_(VolatileStatus::None), confusion_turns_(0),
-      sleep_turns_(0), toxic_counter_(0), move_count_(0), bide_active_(false),
-      bide_turns_remaining_(0), bide_damage_stored_(0), reflect_active_(false),
-      reflect_turns_remaining_(0), light_screen_active_(false),
-      light_screen_turns_remaining_(0) {
-
-  species_ = GameData::getInstance().getSpecies(species_name);
-  if (!species_) {
-    // Fallback or error handling
+    : Pokemon(GameData::getInstance().getSpecies(species_name), level) {
+  if (species_ == missing_species())
     std::cerr << "Error: Species " << species_name << " not found!\n";
-    // Create a dummy species to prevent crash
-    static SpeciesData dummy = {
-        "MissingNo", 33, 136, 0, 29, 6, PokeType::Normal, PokeType::Normal};
-    species_ = &dummy;
-  }
+}
 
+Pokemon::Pokemon(const SpeciesData *species, int level)
+    : species_(species ? species : missing_species()), level_(level),
+      status_(PokeStatus::None), volatile_status_(VolatileStatus::None),
+      confusion_turns_(0), sleep_turns_(0), toxic_counter_(0), move_count_(0),
+      bide_active_(false), bide_turns_remaining_(0), bide_damage_stored_(0),
+      reflect_active_(false), reflect_turns_remaining_(0),
+      light_screen_active_(false), light_screen_turns_remaining_(0) {
   nickname_ = species_->name;
 
   // Initialize IVs (random 0-15 in Gen 1, simplified here to max)
@@ -34,41 +30,27 @@ Pokemon::Pokemon(const std::string &species_name, int level)
   current_hp_ = current_stats_[static_cast<int>(PokeStat::HP)];
 }
 
+const SpeciesData *Pokemon::missing_species() {
+  // Stands in for an unknown species to prevent a crash
+  static SpeciesData dummy = {
+      "MissingNo", 33, 136, 0, 29, 6, PokeType::Normal, PokeType::Normal};
+  return &dummy;
+}
+
+void Pokemon::set_dvs(int attack, int defense, int speed, int special) {
+  ivs_[static_cast<int>(PokeStat::Attack)] = attack;
+  ivs_[static_cast<int>(PokeStat::Defense)] = defense;
+  ivs_[static_cast<int>(PokeStat::Speed)] = speed;
+  ivs_[static_cast<int>(PokeStat::Special)] = special;
+  ivs_[static_cast<int>(PokeStat::HP)] = ((attack & 1) << 3) |
+                                         ((defense & 1) << 2) |
+                                         ((speed & 1) << 1) | (special & 1);
+  calculate_stats();
+  current_hp_ = current_stats_[static_cast<int>(PokeStat::HP)];
+}
+
 void Pokemon::calculate_stats() {
-  // Gen 1 Stat Formula:
-  // HP: (((Base + IV) * 2 + sqrt(EV)/4) * Level) / 100 + Level + 10
-  // Other: (((Base + IV) * 2 + sqrt(EV)/4) * Level) / 100 + 5
-
-  int base_hp = species_->hp;
-  int iv_hp = ivs_[static_cast<int>(PokeStat::HP)];
-  int ev_hp = evs_[static_cast<int>(PokeStat::HP)];
-
-  current_stats_[static_cast<int>(PokeStat::HP)] =
-      (((base_hp + iv_hp) * 2 + std::sqrt(static_cast<double>(ev_hp)) / 4) *
-       level_) /
-          100 +
-      level_ + 10;
-
-  // Helper lambda for other stats
-  auto calc_stat = [&](int base, int iv, int ev) {
-    return (((base + iv) * 2 + std::sqrt(static_cast<double>(ev)) / 4) *
-            level_) /
-               100 +
-           5;
-  };
-
-  current_stats_[static_cast<int>(PokeStat::Attack)] =
-      calc_stat(species_->attack, ivs_[static_cast<int>(PokeStat::Attack)],
-                evs_[static_cast<int>(PokeStat::Attack)]);
-  current_stats_[static_cast<int>(PokeStat::Defense)] =
-      calc_stat(species_->defense, ivs_[static_cast<int>(PokeStat::Defense)],
-                evs_[static_cast<int>(PokeStat::Defense)]);
-  current_stats_[static_cast<int>(PokeStat::Speed)] =
-      calc_stat(species_->speed, ivs_[static_cast<int>(PokeStat::Speed)],
-                evs_[static_cast<int>(PokeStat::Speed)]);
-  current_stats_[static_cast<int>(PokeStat::Special)] =
-      calc_stat(species_->special, ivs_[static_cast<int>(PokeStat::Special)],
-                evs_[static_cast<int>(PokeStat::Special)]);
+  current_stats_ = cached_stats(*species_, level_, ivs_, evs_);
 }
 
 const std::string &Pokemon::name() const { return nickname_; }
@@ -119,6 +101,14 @@ PokeType Pokemon::type1() const { return species_->type1; }
 PokeType Pokemon::type2() const { return species_->type2; }
 PokeStatus Pokemon::status() const { return status_; }
 VolatileStatus Pokemon::volatile_status() const { return volatile_status_; }
+int Pokemon::toxic_counter() const { return toxic_counter_; }
+
+int Pokemon::advance_toxic_counter() {
+  int counter = toxic_counter_;
+  if (toxic_counter_ < 15)
+    toxic_counter_++;
+  return counter;
+}
 int Pokemon::stat_stage(PokeStat stat) const {
   return stat_stages_[static_cast<int>(stat)];
 }
@@ -179,7 +169,7 @@ bool Pokemon::apply_status(PokeStatus new_status) {
 
   // Initialize status-specific counters
   if (new_status == PokeStatus::Sleep) {
-    sleep_turns_ = 1 + (rand() % 7); // 1-7 turns in Gen 1
+    sleep_turns_ = rng_int(1, 7); // 1-7 turns in Gen 1
   } else if (new_status == PokeStatus::Toxic) {
     toxic_counter_ = 1;
   }
@@ -191,7 +181,7 @@ void Pokemon::apply_volatile_status(VolatileStatus vstatus) {
   volatile_status_ = vstatus;
 
   if (vstatus == VolatileStatus::Confusion) {
-    confusion_turns_ = 2 + (rand() % 4); // 2-5 turns
+    confusion_turns_ = rng_int(2, 5); // 2-5 turns
   }
 }
 
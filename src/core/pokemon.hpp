@@ -10,6 +10,8 @@
 class Pokemon {
 public:
   Pokemon(const std::string &species_name, int level);
+  // Skips the lookup by name; a null species becomes MissingNo
+  Pokemon(const SpeciesData *species, int level);
 
   const std::string &name() const;
   int hp() const;
@@ -27,6 +29,11 @@ public:
   VolatileStatus volatile_status() const;
   int stat_stage(PokeStat stat) const;
   const SpeciesData *species() const { return species_; }
+  const std::array<int, 5> &ivs() const { return ivs_; } // Indexed by PokeStat
+
+  // Gen 1 DVs, 0-15 each; the HP DV follows from their low bits. Meant for
+  // a fresh Pokemon: stats are recomputed and HP refilled.
+  void set_dvs(int attack, int defense, int speed, int special);
 
   // Status and stat modification
   bool apply_status(PokeStatus new_status);
@@ -36,6 +43,11 @@ public:
   void reset_stat_stages();
   int get_modified_stat(PokeStat stat) const;
 
+  // Toxic's N: damage is N/16 of max HP on the Nth turn since it was
+  // inflicted (up to 15/16). advance returns N and moves on to N + 1.
+  int toxic_counter() const;
+  int advance_toxic_counter();
+
   // Move management
   void add_move(const Move &move);
   const Move &get_move(int index) const;
@@ -43,6 +55,7 @@ public:
 
 private:
   void calculate_stats();
+  static const SpeciesData *missing_species();
 
   const SpeciesData *species_;
   std::string nickname_;
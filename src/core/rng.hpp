@@ -1,8 +1,42 @@
 #pragma once
+#include <cstdint>
 #include <random>
 
-inline int rng_int(int lo, int hi) {
+// Engine that stands in for this thread's own while an RngScope is open
+inline std::mt19937 *&rng_override() {
+    static thread_local std::mt19937 *engine = nullptr;
+    return engine;
+}
+
+// Engine behind every battle roll on this thread. Seeded from the OS by
+// default; headless simulations reseed it per run to make runs repeatable.
+inline std::mt19937 &rng_engine() {
     static thread_local std::mt19937 gen{std::random_device{}()};
+    std::mt19937 *engine = rng_override();
+    return engine ? *engine : gen;
+}
+
+inline void rng_seed(uint32_t seed) { rng_engine().seed(seed); }
+
+inline int rng_int(int lo, int hi) {
     std::uniform_int_distribution<int> dist(lo, hi);
-    return dist(gen);
+    return dist(rng_engine());
 }
+
+// Sends this thread's rolls to another engine while in scope. Recorded
+// battles draw AI decisions this way, so the battle's own stream holds only
+// engine rolls and replays from the seed alone.
+class RngScope {
+private:
+    std::mt19937 *previous_;
+
+public:
+    explicit RngScope(std::mt19937 &engine) : previous_(rng_override()) {
+        rng_override() = &engine;
+    }
+
+    ~RngScope() { rng_override() = previous_; }
+
+    RngScope(const RngScope &) = delete;
+    RngScope &operator=(const RngScope &) = delete;
+};
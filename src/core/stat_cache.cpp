@@ -0,0 +1,89 @@
+#include "stat_cache.hpp"
+#include "../data/game_data.hpp"
+#include "enums.hpp"
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+namespace {
+
+struct StatKey {
+  const SpeciesData *species;
+  int level;
+  StatBlock ivs;
+  StatBlock evs;
+
+  bool operator==(const StatKey &other) const {
+    return species == other.species && level == other.level &&
+           ivs == other.ivs && evs == other.evs;
+  }
+};
+
+struct StatKeyHash {
+  size_t operator()(const StatKey &key) const {
+    uint64_t hash = 1469598103934665603ull; // FNV-1a over the fields
+    auto mix = [&](uint64_t value) {
+      hash ^= value;
+      hash *= 1099511628211ull;
+    };
+    mix(reinterpret_cast<uintptr_t>(key.species));
+    mix(static_cast<uint64_t>(key.level));
+    for (int iv : key.ivs)
+      mix(static_cast<uint64_t>(iv));
+    for (int ev : key.evs)
+      mix(static_cast<uint64_t>(ev));
+    return static_cast<size_t>(hash);
+  }
+};
+
+// Keyed by the species entry, which GameData never edits or frees (a
+// reload adds a new entry instead), so a block never goes stale and the
+// cache serves every snapshot at once
+typedef std::unordered_map<StatKey, StatBlock, StatKeyHash> StatCache;
+
+StatCache &thread_cache() {
+  static thread_local StatCache cache;
+  return cache;
+}
+
+StatBlock compute_stats(const SpeciesData &species, int level,
+                        const StatBlock &ivs, const StatBlock &evs) {
+  // Gen 1 Stat Formula:
+  // HP: (((Base + IV) * 2 + sqrt(EV)/4) * Level) / 100 + Level + 10
+  // Other: (((Base + IV) * 2 + sqrt(EV)/4) * Level) / 100 + 5
+  auto calc = [&](int base, PokeStat stat) -> int {
+    int i = static_cast<int>(stat);
+    return (((base + ivs[i]) * 2 +
+             std::sqrt(static_cast<double>(evs[i])) / 4) *
+            level) /
+           100;
+  };
+
+  StatBlock stats;
+  stats[static_cast<int>(PokeStat::HP)] =
+      calc(species.hp, PokeStat::HP) + level + 10;
+  stats[static_cast<int>(PokeStat::Attack)] =
+      calc(species.attack, PokeStat::Attack) + 5;
+  stats[static_cast<int>(PokeStat::Defense)] =
+      calc(species.defense, PokeStat::Defense) + 5;
+  stats[static_cast<int>(PokeStat::Speed)] =
+      calc(species.speed, PokeStat::Speed) + 5;
+  stats[static_cast<int>(PokeStat::Special)] =
+      calc(species.special, PokeStat::Special) + 5;
+  return stats;
+}
+
+} // namespace
+
+const StatBlock &cached_stats(const SpeciesData &species, int level,
+                              const StatBlock &ivs, const StatBlock &evs) {
+  StatCache &cache = thread_cache();
+  StatKey key{&species, level, ivs, evs};
+  auto found = cache.find(key);
+  if (found != cache.end())
+    return found->second;
+  return cache.emplace(key, compute_stats(species, level, ivs, evs))
+      .first->second;
+}
+
+size_t stat_cache_size() { return thread_cache().size(); }
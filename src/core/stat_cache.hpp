@@ -0,0 +1,18 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+struct SpeciesData;
+
+typedef std::array<int, 5> StatBlock; // Indexed by PokeStat
+
+// The stats of a species at a level with the given IVs and EVs, computed
+// with the Gen 1 formula the first time a thread asks and looked up after
+// that, so building a Pokemon does no floating-point math once its stats
+// have been seen. Keyed by the species entry, which a reload never edits,
+// so one cache serves every GameData snapshot.
+const StatBlock &cached_stats(const SpeciesData &species, int level,
+                              const StatBlock &ivs, const StatBlock &evs);
+
+// Stat blocks the calling thread holds
+size_t stat_cache_size();
@@ -0,0 +1,233 @@
+#include "timeline.hpp"
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace timeline {
+namespace detail {
+std::atomic<bool> recording(false);
+}
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const size_t CHUNK_EVENTS = 4096;
+
+// Written by one thread; `used` is released after each event so a reader
+// that acquires it sees complete events only
+struct Chunk {
+  std::array<Event, CHUNK_EVENTS> events;
+  std::atomic<size_t> used{0};
+  std::atomic<Chunk *> next{nullptr};
+};
+
+struct ThreadBuffer {
+  uint32_t tid = 0;
+  std::string name; // Guarded by the registry mutex
+  Chunk head;
+  Chunk *tail = &head; // Owner thread only
+  size_t events = 0;   // Owner thread only
+  std::atomic<uint64_t> dropped{0};
+  std::vector<std::unique_ptr<Chunk>> owned;
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers; // Never shrinks
+  std::atomic<int64_t> origin_ns{0};
+  std::atomic<size_t> max_events{0};
+};
+
+Registry &registry() {
+  static Registry *instance = new Registry(); // Outlives thread exits
+  return *instance;
+}
+
+ThreadBuffer *&current_buffer() {
+  static thread_local ThreadBuffer *buffer = nullptr;
+  return buffer;
+}
+
+// Kept apart from the buffer so naming a thread allocates nothing
+std::string &thread_label() {
+  static thread_local std::string label;
+  return label;
+}
+
+ThreadBuffer &thread_buffer() {
+  ThreadBuffer *&buffer = current_buffer();
+  if (buffer)
+    return *buffer;
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.buffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer()));
+  buffer = reg.buffers.back().get();
+  buffer->tid = static_cast<uint32_t>(reg.buffers.size());
+  buffer->name = thread_label();
+  return *buffer;
+}
+
+int64_t clock_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+void write_string(std::ostream &out, const std::string &text) {
+  out << '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\')
+      out << '\\' << c;
+    else if (static_cast<unsigned char>(c) >= 0x20)
+      out << c;
+  }
+  out << '"';
+}
+
+// Calls visit(tid, event) for every complete event of every thread
+template <typename Visit> void for_each_event(Visit visit) {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  for (const auto &buffer : reg.buffers) {
+    for (const Chunk *chunk = &buffer->head; chunk;
+         chunk = chunk->next.load(std::memory_order_acquire)) {
+      size_t used = chunk->used.load(std::memory_order_acquire);
+      for (size_t i = 0; i < used; i++)
+        visit(buffer->tid, chunk->events[i]);
+    }
+  }
+}
+
+} // namespace
+
+void start(size_t max_events_per_thread) {
+  Registry &reg = registry();
+  reg.max_events.store(max_events_per_thread, std::memory_order_relaxed);
+  int64_t expected = 0;
+  reg.origin_ns.compare_exchange_strong(expected, clock_ns());
+  detail::recording.store(true, std::memory_order_release);
+}
+
+void stop() { detail::recording.store(false, std::memory_order_release); }
+
+uint64_t now_us() {
+  int64_t origin = registry().origin_ns.load(std::memory_order_relaxed);
+  return static_cast<uint64_t>((clock_ns() - origin) / 1000);
+}
+
+void record(const char *category, const char *name, uint64_t start_us,
+            uint64_t id, uint32_t step) {
+  ThreadBuffer &buffer = thread_buffer();
+  if (buffer.events >=
+      registry().max_events.load(std::memory_order_relaxed)) {
+    buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+    return;
+  }
+
+  Chunk *chunk = buffer.tail;
+  size_t used = chunk->used.load(std::memory_order_relaxed);
+  if (used == CHUNK_EVENTS) {
+    buffer.owned.push_back(std::unique_ptr<Chunk>(new Chunk()));
+    Chunk *next = buffer.owned.back().get();
+    chunk->next.store(next, std::memory_order_release);
+    buffer.tail = chunk = next;
+    used = 0;
+  }
+
+  uint64_t end_us = now_us();
+  chunk->events[used] = Event{name, category, start_us,
+                              end_us > start_us ? end_us - start_us : 0, id,
+                              step};
+  chunk->used.store(used + 1, std::memory_order_release);
+  buffer.events++;
+}
+
+void name_thread(const std::string &name) {
+  thread_label() = name;
+  ThreadBuffer *buffer = current_buffer();
+  if (buffer) {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer->name = name;
+  }
+}
+
+size_t event_count() {
+  size_t count = 0;
+  for_each_event([&](uint32_t, const Event &) { count++; });
+  return count;
+}
+
+uint64_t dropped_count() {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  uint64_t dropped = 0;
+  for (const auto &buffer : reg.buffers)
+    dropped += buffer->dropped.load(std::memory_order_relaxed);
+  return dropped;
+}
+
+bool write_chrome_trace(const std::string &path) {
+  std::ofstream out(path);
+  if (!out)
+    return false;
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  bool first = true;
+  {
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto &buffer : reg.buffers) {
+      if (buffer->name.empty())
+        continue;
+      out << (first ? "" : ",\n")
+          << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+          << buffer->tid << ",\"args\":{\"name\":";
+      write_string(out, buffer->name);
+      out << "}}";
+      first = false;
+    }
+  }
+
+  for_each_event([&](uint32_t tid, const Event &event) {
+    out << (first ? "" : ",\n") << "{\"ph\":\"X\",\"name\":";
+    write_string(out, event.name);
+    out << ",\"cat\":";
+    write_string(out, event.category);
+    out << ",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << event.start_us
+        << ",\"dur\":" << event.duration_us;
+    if (event.id || event.step) {
+      out << ",\"args\":{\"id\":" << event.id << ",\"step\":" << event.step
+          << "}";
+    }
+    out << "}";
+    first = false;
+  });
+  out << "\n]}\n";
+  return static_cast<bool>(out);
+}
+
+ChromeTraceFile::ChromeTraceFile(const std::string &path) : path_(path) {
+  name_thread("main");
+  start();
+}
+
+ChromeTraceFile::~ChromeTraceFile() {
+  stop();
+  if (!write_chrome_trace(path_)) {
+    std::cerr << "[Timeline] Cannot write " << path_ << "\n";
+    return;
+  }
+  std::cout << "[Timeline] Wrote " << event_count() << " spans to " << path_;
+  uint64_t dropped = dropped_count();
+  if (dropped)
+    std::cout << " (" << dropped << " dropped, buffers full)";
+  std::cout << "\n";
+}
+
+} // namespace timeline
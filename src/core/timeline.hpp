@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Optional timeline of named spans (a turn's phases, a simulator round),
+// written out in Chrome trace JSON for chrome://tracing or Perfetto.
+//
+// Nothing is recorded until start() is called; until then a span costs
+// one relaxed load. Each thread appends to its own buffer, so recording
+// takes no locks: a span is one store into the thread's current chunk
+// and a release of its count, which write_chrome_trace() reads while
+// threads carry on.
+namespace timeline {
+
+struct Event {
+  const char *name; // String literal; never copied
+  const char *category;
+  uint64_t start_us; // Since start()
+  uint64_t duration_us;
+  uint64_t id;   // Battle seed or run index, 0 if none
+  uint32_t step; // Turn or round, 0 if none
+};
+
+namespace detail {
+extern std::atomic<bool> recording;
+}
+
+inline bool enabled() {
+  return detail::recording.load(std::memory_order_relaxed);
+}
+
+// Begin recording. Each thread keeps at most max_events_per_thread; later
+// spans are counted as dropped rather than growing without bound.
+void start(size_t max_events_per_thread = size_t(1) << 20);
+void stop();
+
+uint64_t now_us(); // Microseconds since start()
+void record(const char *category, const char *name, uint64_t start_us,
+            uint64_t id = 0, uint32_t step = 0);
+
+// Label the calling thread in the output ("event loop", "battle worker")
+void name_thread(const std::string &name);
+
+// Everything recorded so far, as {"traceEvents": [...]}. False if the file
+// cannot be written.
+bool write_chrome_trace(const std::string &path);
+size_t event_count();
+uint64_t dropped_count();
+
+// Records the time from construction to destruction, if recording
+class Span {
+private:
+  const char *category_;
+  const char *name_;
+  uint64_t id_;
+  uint32_t step_;
+  uint64_t start_us_;
+  bool active_;
+
+public:
+  Span(const char *category, const char *name, uint64_t id = 0,
+       uint32_t step = 0)
+      : category_(category), name_(name), id_(id), step_(step),
+        start_us_(0), active_(enabled()) {
+    if (active_)
+      start_us_ = now_us();
+  }
+
+  ~Span() {
+    if (active_)
+      record(category_, name_, start_us_, id_, step_);
+  }
+
+  Span(const Span &) = delete;
+  Span &operator=(const Span &) = delete;
+};
+
+// Starts recording when constructed and writes everything recorded to
+// path when destroyed, so every way out of main() leaves a trace behind
+class ChromeTraceFile {
+private:
+  std::string path_;
+
+public:
+  explicit ChromeTraceFile(const std::string &path);
+  ~ChromeTraceFile();
+
+  ChromeTraceFile(const ChromeTraceFile &) = delete;
+  ChromeTraceFile &operator=(const ChromeTraceFile &) = delete;
+};
+
+} // namespace timeline
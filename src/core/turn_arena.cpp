@@ -0,0 +1,43 @@
+#include "turn_arena.hpp"
+
+TurnArena::TurnArena(size_t initial_bytes)
+    : buffer_(new std::byte[initial_bytes]), capacity_(initial_bytes) {
+  arena_.emplace(buffer_.get(), capacity_, &heap_);
+}
+
+TurnArena &TurnArena::operator=(const TurnArena &other) {
+  if (this != &other) {
+    arena_.reset();
+    capacity_ = other.capacity_;
+    buffer_.reset(new std::byte[capacity_]);
+    arena_.emplace(buffer_.get(), capacity_, &heap_);
+  }
+  return *this;
+}
+
+void TurnArena::reset() {
+  arena_->release();
+  if (heap_.bytes == 0)
+    return;
+
+  // Room for everything the last turn needed, with some to spare
+  size_t needed = capacity_ + heap_.bytes;
+  while (capacity_ < needed)
+    capacity_ = capacity_ ? capacity_ * 2 : 64;
+  heap_.bytes = 0;
+  arena_.reset();
+  buffer_.reset(new std::byte[capacity_]);
+  arena_.emplace(buffer_.get(), capacity_, &heap_);
+}
+
+void *TurnArena::CountingResource::do_allocate(size_t bytes,
+                                               size_t alignment) {
+  allocations++;
+  this->bytes += bytes;
+  return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void TurnArena::CountingResource::do_deallocate(void *ptr, size_t bytes,
+                                                size_t alignment) {
+  std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+// Scratch memory for the turn in progress: the log lines, status messages
+// and index lists a turn builds and throws away. Allocating is a pointer
+// bump in one buffer and reset() takes everything back at once.
+//
+// A turn that outgrows the buffer gets the rest from the heap, and the
+// next reset() grows the buffer to cover it, so a battle soon settles
+// into making no heap allocations for its turns at all.
+class TurnArena {
+public:
+  explicit TurnArena(size_t initial_bytes = 1024);
+
+  // A copy is a new, empty arena of the same size; scratch is never shared
+  TurnArena(const TurnArena &other) : TurnArena(other.capacity_) {}
+  TurnArena &operator=(const TurnArena &other);
+
+  std::pmr::memory_resource *resource() { return &*arena_; }
+
+  // Frees everything allocated since the last reset
+  void reset();
+
+  size_t capacity() const { return capacity_; }
+  // Times the arena went to the heap since it was created
+  uint64_t heap_allocations() const { return heap_.allocations; }
+
+private:
+  // The heap, counting what it hands out
+  class CountingResource : public std::pmr::memory_resource {
+  public:
+    uint64_t allocations = 0;
+    size_t bytes = 0; // Since the last reset
+
+  private:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const memory_resource &other) const noexcept override {
+      return this == &other;
+    }
+  };
+
+  CountingResource heap_;
+  std::unique_ptr<std::byte[]> buffer_;
+  size_t capacity_;
+  std::optional<std::pmr::monotonic_buffer_resource> arena_;
+};
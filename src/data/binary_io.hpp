@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+
+// Little-endian fields for the binary files (ghosts, replays), so they read
+// back the same on any host
+
+inline void put_u16(uint8_t *out, uint16_t value) {
+  out[0] = static_cast<uint8_t>(value);
+  out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+inline uint16_t get_u16(const uint8_t *in) {
+  return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+inline void put_u32(uint8_t *out, uint32_t value) {
+  for (int i = 0; i < 4; i++)
+    out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+inline uint32_t get_u32(const uint8_t *in) {
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++)
+    value |= static_cast<uint32_t>(in[i]) << (8 * i);
+  return value;
+}
+
+inline void put_u64(uint8_t *out, uint64_t value) {
+  for (int i = 0; i < 8; i++)
+    out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+inline uint64_t get_u64(const uint8_t *in) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; i++)
+    value |= static_cast<uint64_t>(in[i]) << (8 * i);
+  return value;
+}
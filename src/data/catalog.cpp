@@ -0,0 +1,95 @@
+#include "catalog.hpp"
+#include "binary_io.hpp"
+#include <algorithm>
+
+namespace {
+
+// FNV-1a over the names, so a file is only read against the same data
+uint64_t catalog_fingerprint(const std::vector<const SpeciesData *> &species,
+                             const std::vector<const MoveData *> &moves) {
+  uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](const std::string &text) {
+    for (unsigned char c : text) {
+      hash ^= c;
+      hash *= 1099511628211ull;
+    }
+    hash *= 1099511628211ull; // Terminator, so "ab","c" != "a","bc"
+  };
+  for (const SpeciesData *entry : species)
+    mix(entry->name);
+  for (const MoveData *entry : moves)
+    mix(entry->name);
+  return hash;
+}
+
+template <class T>
+uint16_t catalog_index(const std::vector<const T *> &catalog,
+                       const std::string &name) {
+  auto found = std::lower_bound(
+      catalog.begin(), catalog.end(), name,
+      [](const T *entry, const std::string &key) { return entry->name < key; });
+  if (found == catalog.end() || (*found)->name != name)
+    return DataCatalog::NOT_FOUND;
+  return static_cast<uint16_t>(found - catalog.begin());
+}
+
+} // namespace
+
+DataCatalog::DataCatalog()
+    : species_(GameData::getInstance().getAllSpecies()),
+      moves_(GameData::getInstance().getAllMoves()),
+      fingerprint_(catalog_fingerprint(species_, moves_)) {}
+
+uint16_t DataCatalog::species_index(const std::string &name) const {
+  return catalog_index(species_, name);
+}
+
+uint16_t DataCatalog::move_index(const std::string &name) const {
+  return catalog_index(moves_, name);
+}
+
+bool DataCatalog::pack(const Pokemon &pokemon, PackedMon &packed) const {
+  packed = PackedMon();
+  packed.species = species_index(pokemon.name());
+  if (packed.species == NOT_FOUND)
+    return false;
+  packed.level = static_cast<uint8_t>(pokemon.level());
+  for (int i = 0; i < pokemon.move_count() && packed.move_count < 4; i++) {
+    const MoveData *move = pokemon.get_move(i).data;
+    uint16_t index = move ? move_index(move->name) : NOT_FOUND;
+    if (index != NOT_FOUND)
+      packed.moves[packed.move_count++] = index;
+  }
+  return true;
+}
+
+bool DataCatalog::unpack(const PackedMon &packed,
+                         std::vector<Pokemon> &team) const {
+  if (packed.species >= species_.size())
+    return false;
+  Pokemon pokemon(species_[packed.species], packed.level);
+  for (int m = 0; m < packed.move_count; m++) {
+    if (packed.moves[m] < moves_.size())
+      pokemon.add_move(Move(moves_[packed.moves[m]]));
+  }
+  team.push_back(pokemon);
+  return true;
+}
+
+void DataCatalog::encode(const PackedMon &packed, uint8_t *out) {
+  put_u16(out, packed.species);
+  for (int m = 0; m < 4; m++)
+    put_u16(out + 2 + m * 2, packed.moves[m]);
+  out[10] = packed.move_count;
+  out[11] = packed.level;
+}
+
+PackedMon DataCatalog::decode(const uint8_t *in) {
+  PackedMon packed;
+  packed.species = get_u16(in);
+  for (int m = 0; m < 4; m++)
+    packed.moves[m] = get_u16(in + 2 + m * 2);
+  packed.move_count = std::min<uint8_t>(in[10], 4);
+  packed.level = in[11];
+  return packed;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "../core/pokemon.hpp"
+#include "game_data.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One Pokemon stored by index: species and moves are positions in the
+// catalog's name-sorted lists, and it is rebuilt at full HP and PP
+struct PackedMon {
+  uint16_t species;
+  uint16_t moves[4];
+  uint8_t move_count;
+  uint8_t level;
+};
+
+// The name-sorted species and move lists at the time it was built, for
+// files that store teams by index. The fingerprint changes whenever either
+// list does, so a file is only read back against the data that wrote it.
+class DataCatalog {
+private:
+  std::vector<const SpeciesData *> species_;
+  std::vector<const MoveData *> moves_;
+  uint64_t fingerprint_;
+
+public:
+  static const uint16_t NOT_FOUND = 0xFFFF;
+  static const size_t PACKED_MON_SIZE = 12;
+
+  DataCatalog(); // Snapshot of GameData as it is now
+
+  uint16_t species_index(const std::string &name) const;
+  uint16_t move_index(const std::string &name) const;
+
+  // False if the species is unknown; unknown moves are dropped
+  bool pack(const Pokemon &pokemon, PackedMon &packed) const;
+  // Appends the rebuilt Pokemon to team; false (and nothing appended) if
+  // the species is out of range. Bad moves are dropped.
+  bool unpack(const PackedMon &packed, std::vector<Pokemon> &team) const;
+
+  static void encode(const PackedMon &packed, uint8_t *out);
+  static PackedMon decode(const uint8_t *in);
+
+  uint64_t fingerprint() const { return fingerprint_; }
+  size_t species_count() const { return species_.size(); }
+  size_t move_count() const { return moves_.size(); }
+};
@@ -0,0 +1,516 @@
+#include "data_file.hpp"
+#include "enum_table.hpp"
+#include "mapped_file.hpp"
+#include "move_parser.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+
+// A value as the SAX parser hands it over
+struct JsonScalar {
+  enum class Kind { Null, Bool, Number, String };
+  Kind kind = Kind::Null;
+  bool flag = false;
+  int number = 0;
+  const std::string *text = nullptr;
+};
+
+// Walks { "name": { "field": value, "object": { "field": value } } },
+// handing each record's fields to the reader as they go by. Arrays, and
+// objects nested deeper than that, are skipped whole.
+class RecordSax : public nlohmann::json_sax<json> {
+public:
+  const std::string &error() const { return error_; }
+
+  bool null() override { return scalar(JsonScalar()); }
+  bool boolean(bool value) override {
+    JsonScalar scalar_value;
+    scalar_value.kind = JsonScalar::Kind::Bool;
+    scalar_value.flag = value;
+    return scalar(scalar_value);
+  }
+  bool number_integer(number_integer_t value) override {
+    if (value < std::numeric_limits<int>::min() ||
+        value > std::numeric_limits<int>::max())
+      return bad_number();
+    return number(static_cast<int>(value));
+  }
+  bool number_unsigned(number_unsigned_t value) override {
+    if (value > static_cast<number_unsigned_t>(std::numeric_limits<int>::max()))
+      return bad_number();
+    return number(static_cast<int>(value));
+  }
+  bool number_float(number_float_t value, const string_t &) override {
+    // 40.0 is fine; 40.5 or 1e12 is a mistake in the data
+    if (value != std::floor(value) ||
+        value < std::numeric_limits<int>::min() ||
+        value > std::numeric_limits<int>::max())
+      return bad_number();
+    return number(static_cast<int>(value));
+  }
+  bool string(string_t &value) override {
+    JsonScalar scalar_value;
+    scalar_value.kind = JsonScalar::Kind::String;
+    scalar_value.text = &value;
+    return scalar(scalar_value);
+  }
+  bool binary(binary_t &) override { return fail("unexpected binary value"); }
+
+  bool start_object(std::size_t) override {
+    if (skip_) {
+      skip_++;
+      return true;
+    }
+    switch (depth_) {
+    case 0:
+      break;
+    case 1:
+      record_ = key_;
+      on_record_start();
+      break;
+    case 2:
+      if (!on_object_start()) {
+        skip_ = 1;
+        return true;
+      }
+      break;
+    default:
+      skip_ = 1;
+      return true;
+    }
+    depth_++;
+    return true;
+  }
+
+  bool end_object() override {
+    if (skip_) {
+      skip_--;
+      return true;
+    }
+    depth_--;
+    if (depth_ == 2)
+      return true;
+    if (depth_ == 1) {
+      bool ok = on_record_end();
+      record_.clear();
+      return ok;
+    }
+    return true;
+  }
+
+  bool start_array(std::size_t) override {
+    if (skip_) {
+      skip_++;
+      return true;
+    }
+    if (depth_ < 2)
+      return fail(depth_ == 0 ? "expected an object of records"
+                              : "expected an object");
+    skip_ = 1;
+    return true;
+  }
+
+  bool end_array() override {
+    skip_--;
+    return true;
+  }
+
+  bool key(string_t &value) override {
+    if (!skip_)
+      key_ = value;
+    if (depth_ == 2 && !skip_)
+      field_ = value;
+    return true;
+  }
+
+  bool parse_error(std::size_t, const std::string &,
+                   const nlohmann::detail::exception &ex) override {
+    error_ = ex.what();
+    return false;
+  }
+
+protected:
+  std::string record_; // Name of the record being read
+  std::string field_;  // Its field being read, or the object being read
+
+  virtual void on_record_start() = 0;
+  virtual bool on_record_end() = 0;
+  // A scalar field of the record
+  virtual bool on_field(const JsonScalar &value) = 0;
+  // field_ is an object; false to skip it
+  virtual bool on_object_start() = 0;
+  // A scalar inside that object
+  virtual bool on_object_field(const std::string &name,
+                               const JsonScalar &value) = 0;
+
+  bool fail(const std::string &message) {
+    error_ = record_.empty() ? message : record_ + ": " + message;
+    return false;
+  }
+
+private:
+  int depth_ = 0; // 1 inside the file's object, 2 a record, 3 a field's
+  int skip_ = 0;  // Containers open inside one being skipped
+  std::string key_;
+  std::string error_;
+
+  // Every number the data holds is an int; anything else is rejected
+  // rather than truncated or wrapped. Skipped and misplaced values are
+  // left to the usual handling.
+  bool bad_number() {
+    if (skip_ || depth_ < 2)
+      return number(0);
+    return fail(key_ + " must be a whole number");
+  }
+
+  bool number(int value) {
+    JsonScalar scalar_value;
+    scalar_value.kind = JsonScalar::Kind::Number;
+    scalar_value.number = value;
+    return scalar(scalar_value);
+  }
+
+  bool scalar(const JsonScalar &value) {
+    if (skip_)
+      return true;
+    switch (depth_) {
+    case 0:
+      return fail("expected an object of records");
+    case 1:
+      record_ = key_;
+      return fail("expected an object");
+    case 2:
+      return on_field(value);
+    default:
+      return on_object_field(key_, value);
+    }
+  }
+};
+
+// Sort by name, then keep only the last of each run of equal names
+template <typename T, typename GetName>
+void keep_last_by_name(std::vector<T> &records, GetName name) {
+  std::stable_sort(records.begin(), records.end(),
+                   [&](const T &a, const T &b) { return name(a) < name(b); });
+  size_t kept = 0;
+  for (size_t i = 0; i < records.size(); i++) {
+    if (i + 1 < records.size() && name(records[i]) == name(records[i + 1]))
+      continue;
+    if (kept != i)
+      records[kept] = std::move(records[i]);
+    kept++;
+  }
+  records.resize(kept);
+}
+
+enum class SpeciesField {
+  Hp,
+  Attack,
+  Defense,
+  Speed,
+  Special,
+  Type1,
+  Type2,
+  EvolvesTo
+};
+
+const EnumTable<SpeciesField> &species_fields() {
+  static const EnumTable<SpeciesField> table{
+      {"hp", SpeciesField::Hp},           {"attack", SpeciesField::Attack},
+      {"defense", SpeciesField::Defense}, {"speed", SpeciesField::Speed},
+      {"special", SpeciesField::Special}, {"type1", SpeciesField::Type1},
+      {"type2", SpeciesField::Type2},     {"evolves_to", SpeciesField::EvolvesTo}};
+  return table;
+}
+
+// Every field but evolves_to
+const unsigned REQUIRED_SPECIES_FIELDS = 0x7F;
+
+class SpeciesSax : public RecordSax {
+public:
+  explicit SpeciesSax(std::vector<SpeciesData> &species) : species_(species) {}
+
+protected:
+  void on_record_start() override {
+    current_ = SpeciesData();
+    current_.name = record_;
+    seen_ = 0;
+  }
+
+  bool on_record_end() override {
+    if ((seen_ & REQUIRED_SPECIES_FIELDS) != REQUIRED_SPECIES_FIELDS)
+      return fail("needs hp, attack, defense, speed, special, type1 and type2");
+    species_.push_back(std::move(current_));
+    return true;
+  }
+
+  bool on_field(const JsonScalar &value) override {
+    SpeciesField field;
+    if (!species_fields().find(field_, field))
+      return true;
+    bool is_text = field == SpeciesField::Type1 ||
+                   field == SpeciesField::Type2 ||
+                   field == SpeciesField::EvolvesTo;
+    if (value.kind !=
+        (is_text ? JsonScalar::Kind::String : JsonScalar::Kind::Number))
+      return fail(field_ + (is_text ? " must be a string" : " must be a number"));
+
+    switch (field) {
+    case SpeciesField::Hp:
+      current_.hp = value.number;
+      break;
+    case SpeciesField::Attack:
+      current_.attack = value.number;
+      break;
+    case SpeciesField::Defense:
+      current_.defense = value.number;
+      break;
+    case SpeciesField::Speed:
+      current_.speed = value.number;
+      break;
+    case SpeciesField::Special:
+      current_.special = value.number;
+      break;
+    case SpeciesField::Type1:
+      if (!parseType(*value.text, current_.type1))
+        return fail("unknown type \"" + *value.text + "\"");
+      break;
+    case SpeciesField::Type2:
+      // "None" for a single-typed species
+      if (*value.text == "None")
+        current_.type2 = PokeType::None;
+      else if (!parseType(*value.text, current_.type2))
+        return fail("unknown type \"" + *value.text + "\"");
+      break;
+    case SpeciesField::EvolvesTo:
+      current_.evolves_to = *value.text;
+      break;
+    }
+    seen_ |= 1u << static_cast<unsigned>(field);
+    return true;
+  }
+
+  bool on_object_start() override { return false; }
+  bool on_object_field(const std::string &, const JsonScalar &) override {
+    return true;
+  }
+
+private:
+  std::vector<SpeciesData> &species_;
+  SpeciesData current_;
+  unsigned seen_ = 0;
+};
+
+enum class MoveField {
+  Type,
+  Category,
+  Power,
+  Accuracy,
+  Pp,
+  Effect,
+  SecondaryEffect
+};
+
+const EnumTable<MoveField> &move_fields() {
+  static const EnumTable<MoveField> table{
+      {"type", MoveField::Type},
+      {"category", MoveField::Category},
+      {"power", MoveField::Power},
+      {"accuracy", MoveField::Accuracy},
+      {"pp", MoveField::Pp},
+      {"effect", MoveField::Effect},
+      {"secondary_effect", MoveField::SecondaryEffect}};
+  return table;
+}
+
+// type, category, power, accuracy and pp
+const unsigned REQUIRED_MOVE_FIELDS = 0x1F;
+
+class MoveSax : public RecordSax {
+public:
+  explicit MoveSax(std::vector<std::unique_ptr<MoveData>> &moves)
+      : moves_(moves) {}
+
+protected:
+  void on_record_start() override {
+    current_ = std::make_unique<MoveData>();
+    current_->name = record_;
+    effect_ = EffectFields();
+    secondary_ = EffectFields();
+    reading_ = nullptr;
+    seen_ = 0;
+  }
+
+  bool on_record_end() override {
+    if ((seen_ & REQUIRED_MOVE_FIELDS) != REQUIRED_MOVE_FIELDS)
+      return fail("needs type, category, power, accuracy and pp");
+
+    std::string error;
+    if (seen(MoveField::Effect)) {
+      if (!parseMoveEffect(current_->primary_effect, effect_, error))
+        return fail(error);
+    } else {
+      // Initialize default effect based on category
+      current_->primary_effect.type = current_->category == MoveCategory::Status
+                                          ? MoveEffectType::None
+                                          : MoveEffectType::Damage;
+    }
+
+    if (seen(MoveField::SecondaryEffect)) {
+      auto secondary = std::make_unique<SecondaryEffect>();
+      secondary->chance = secondary_.chance.value_or(30);
+      if (!parseMoveEffect(secondary->effect, secondary_, error))
+        return fail("secondary_effect: " + error);
+      current_->secondary_effect = std::move(secondary);
+    }
+
+    moves_.push_back(std::move(current_));
+    return true;
+  }
+
+  bool on_field(const JsonScalar &value) override {
+    MoveField field;
+    if (!move_fields().find(field_, field))
+      return true;
+
+    switch (field) {
+    case MoveField::Type:
+    case MoveField::Category:
+      if (value.kind != JsonScalar::Kind::String)
+        return fail(field_ + " must be a string");
+      if (field == MoveField::Type && !parseType(*value.text, current_->type))
+        return fail("unknown type \"" + *value.text + "\"");
+      if (field == MoveField::Category &&
+          !parseCategory(*value.text, current_->category))
+        return fail("unknown category \"" + *value.text + "\"");
+      break;
+    case MoveField::Power:
+    case MoveField::Accuracy:
+    case MoveField::Pp:
+      if (value.kind != JsonScalar::Kind::Number)
+        return fail(field_ + " must be a number");
+      if (field == MoveField::Power)
+        current_->power = value.number;
+      else if (field == MoveField::Accuracy)
+        current_->accuracy = value.number;
+      else
+        current_->max_pp = value.number;
+      break;
+    case MoveField::Effect:
+    case MoveField::SecondaryEffect:
+      return fail(field_ + " must be an object");
+    }
+    seen_ |= 1u << static_cast<unsigned>(field);
+    return true;
+  }
+
+  bool on_object_start() override {
+    MoveField field;
+    if (!move_fields().find(field_, field) ||
+        (field != MoveField::Effect && field != MoveField::SecondaryEffect))
+      return false;
+    reading_ = field == MoveField::Effect ? &effect_ : &secondary_;
+    seen_ |= 1u << static_cast<unsigned>(field);
+    return true;
+  }
+
+  bool on_object_field(const std::string &name,
+                       const JsonScalar &value) override {
+    bool wrong_kind = false;
+    switch (value.kind) {
+    case JsonScalar::Kind::String:
+      reading_->set_string(name, *value.text, wrong_kind);
+      break;
+    case JsonScalar::Kind::Number:
+      reading_->set_number(name, value.number, wrong_kind);
+      break;
+    case JsonScalar::Kind::Bool:
+      reading_->set_bool(name, value.flag, wrong_kind);
+      break;
+    case JsonScalar::Kind::Null:
+      break;
+    }
+    if (wrong_kind)
+      return fail(field_ + "." + name + " has the wrong type");
+    return true;
+  }
+
+private:
+  std::vector<std::unique_ptr<MoveData>> &moves_;
+  std::unique_ptr<MoveData> current_;
+  EffectFields effect_;
+  EffectFields secondary_;
+  EffectFields *reading_ = nullptr;
+  unsigned seen_ = 0;
+
+  bool seen(MoveField field) const {
+    return seen_ & (1u << static_cast<unsigned>(field));
+  }
+};
+
+// Runs the reader over the text; on failure, out is left empty
+template <typename Sax, typename Record>
+bool parse_records(const char *text, size_t size, std::vector<Record> &out,
+                   std::string &error) {
+  std::vector<Record> records;
+  Sax sax(records);
+  if (!json::sax_parse(text, text + size, &sax)) {
+    error = sax.error();
+    out.clear();
+    return false;
+  }
+  out = std::move(records);
+  return true;
+}
+
+} // namespace
+
+bool parse_species_text(const char *text, size_t size,
+                        std::vector<SpeciesData> &species, std::string &error) {
+  if (!parse_records<SpeciesSax>(text, size, species, error))
+    return false;
+  keep_last_by_name(species,
+                    [](const SpeciesData &s) -> const std::string & {
+                      return s.name;
+                    });
+  return true;
+}
+
+bool parse_moves_text(const char *text, size_t size,
+                      std::vector<std::unique_ptr<MoveData>> &moves,
+                      std::string &error) {
+  if (!parse_records<MoveSax>(text, size, moves, error))
+    return false;
+  keep_last_by_name(moves,
+                    [](const std::unique_ptr<MoveData> &m)
+                        -> const std::string & { return m->name; });
+  return true;
+}
+
+bool parse_species_file(const std::string &path,
+                        std::vector<SpeciesData> &species, std::string &error) {
+  MappedFile file;
+  if (!file.open(path)) {
+    error = "cannot be opened";
+    return false;
+  }
+  return parse_species_text(reinterpret_cast<const char *>(file.data()),
+                            file.size(), species, error);
+}
+
+bool parse_moves_file(const std::string &path,
+                      std::vector<std::unique_ptr<MoveData>> &moves,
+                      std::string &error) {
+  MappedFile file;
+  if (!file.open(path)) {
+    error = "cannot be opened";
+    return false;
+  }
+  return parse_moves_text(reinterpret_cast<const char *>(file.data()),
+                          file.size(), moves, error);
+}
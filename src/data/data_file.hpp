@@ -0,0 +1,29 @@
+#pragma once
+#include "game_data.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Readers for species.json and moves.json that stream the file through a
+// SAX parser and fill in each record as its fields go by, without
+// building a JSON document first. They only parse: nothing is added to
+// GameData, so both files can be read at once on different threads.
+//
+// Records come back sorted by name with each name once (the last one in
+// the file wins), the order the document-based loader always added them
+// in, so species and move IDs do not depend on how the file is laid out.
+// False, with the reason and where in the file in error, if the file
+// cannot be read or a record is missing a field or has one of the wrong
+// kind. Fields nobody reads are skipped, whatever they hold.
+bool parse_species_file(const std::string &path,
+                        std::vector<SpeciesData> &species, std::string &error);
+bool parse_moves_file(const std::string &path,
+                      std::vector<std::unique_ptr<MoveData>> &moves,
+                      std::string &error);
+
+// The same over text already in memory
+bool parse_species_text(const char *text, size_t size,
+                        std::vector<SpeciesData> &species, std::string &error);
+bool parse_moves_text(const char *text, size_t size,
+                      std::vector<std::unique_ptr<MoveData>> &moves,
+                      std::string &error);
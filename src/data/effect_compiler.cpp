@@ -0,0 +1,179 @@
+#include "data/effect_compiler.hpp"
+#include <chrono>
+#include <sstream>
+
+namespace {
+
+bool in_range(int value, int low, int high) {
+  return value >= low && value <= high;
+}
+
+bool fail(std::string &error, const std::string &message) {
+  error = message;
+  return false;
+}
+
+// The handlers only tell "self" from everyone else
+bool check_target(EffectTarget target, std::string &error) {
+  if (target == EffectTarget::Self || target == EffectTarget::Opponent)
+    return true;
+  return fail(error, "target must be self or opponent");
+}
+
+// Effect types that roll damage from the move's power
+bool rolls_damage(MoveEffectType type) {
+  switch (type) {
+  case MoveEffectType::Damage:
+  case MoveEffectType::Recoil:
+  case MoveEffectType::Drain:
+  case MoveEffectType::HighCritRatio:
+  case MoveEffectType::MultiHit:
+  case MoveEffectType::TwoHit:
+  case MoveEffectType::TwoTurn:
+  case MoveEffectType::Rage:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool check_effect(const MoveEffect &effect, std::string &error) {
+  switch (effect.type) {
+  case MoveEffectType::StatChange:
+    if (effect.stat_change.stat == PokeStat::HP)
+      return fail(error, "stat_change cannot change HP");
+    if (effect.stat_change.stages == 0 ||
+        !in_range(effect.stat_change.stages, -6, 6))
+      return fail(error, "stat_change stages must be -6..6 and not 0");
+    if (!in_range(effect.stat_change.chance, 1, 100))
+      return fail(error, "stat_change chance must be 1..100");
+    return check_target(effect.stat_change.target, error);
+  case MoveEffectType::StatusInflict:
+    if (effect.status_inflict.status == PokeStatus::None ||
+        effect.status_inflict.status == PokeStatus::Fainted)
+      return fail(error, "status effect needs a status to inflict");
+    if (!in_range(effect.status_inflict.chance, 1, 100))
+      return fail(error, "status chance must be 1..100");
+    return check_target(effect.status_inflict.target, error);
+  case MoveEffectType::Recoil:
+    if (!in_range(effect.recoil_percent, 1, 100))
+      return fail(error, "recoil percent must be 1..100");
+    return true;
+  case MoveEffectType::Drain:
+    if (!in_range(effect.drain_percent, 1, 100))
+      return fail(error, "drain percent must be 1..100");
+    return true;
+  case MoveEffectType::Heal:
+    if (!in_range(effect.heal_percent, 1, 100))
+      return fail(error, "heal percent must be 1..100");
+    return true;
+  case MoveEffectType::MultiHit:
+    // The engine rolls Gen 1's 2-5 distribution whatever the data says
+    if (effect.min_hits != 2 || effect.max_hits != 5)
+      return fail(error, "multi_hit must be min 2, max 5");
+    return true;
+  case MoveEffectType::FixedDamage:
+    if (effect.fixed_damage.type == FixedDamageData::Type::Constant &&
+        !in_range(effect.fixed_damage.value, 1, 999))
+      return fail(error, "constant fixed_damage value must be 1..999");
+    return true;
+  case MoveEffectType::Flinch:
+    if (!in_range(effect.flinch_chance, 1, 100))
+      return fail(error, "flinch chance must be 1..100");
+    return true;
+  default:
+    return true;
+  }
+}
+
+} // namespace
+
+std::string EffectCompileReport::summary() const {
+  std::ostringstream out;
+  out << "Compiled " << moves << " move effects in " << microseconds
+      << " us:";
+  const char *separator = " ";
+  for (size_t i = 0; i < by_type.size(); i++) {
+    if (!by_type[i])
+      continue;
+    out << separator << move_effect_name(static_cast<MoveEffectType>(i))
+        << " " << by_type[i];
+    separator = ", ";
+  }
+  separator = "; secondary ";
+  for (size_t i = 0; i < secondary_by_type.size(); i++) {
+    if (!secondary_by_type[i])
+      continue;
+    out << separator << move_effect_name(static_cast<MoveEffectType>(i))
+        << " " << secondary_by_type[i];
+    separator = ", ";
+  }
+  return out.str();
+}
+
+bool check_move(const MoveData &move, std::string &error) {
+  if (move.type == PokeType::None)
+    return fail(error, "has no type");
+  if (!in_range(move.power, 0, 255))
+    return fail(error, "power must be 0..255");
+  if (!in_range(move.accuracy, 1, 100))
+    return fail(error, "accuracy must be 1..100");
+  if (!in_range(move.max_pp, 1, 64))
+    return fail(error, "pp must be 1..64");
+
+  const MoveEffect &effect = move.primary_effect;
+  if (move.category == MoveCategory::Status &&
+      effect.type == MoveEffectType::None)
+    return fail(error, "Status move needs an effect (not_implemented if the "
+                       "engine has none for it yet)");
+  if (rolls_damage(effect.type) &&
+      (move.category == MoveCategory::Status || move.power == 0))
+    return fail(error, std::string(move_effect_name(effect.type)) +
+                           " effect needs a Physical or Special move with "
+                           "power");
+  if (!check_effect(effect, error))
+    return false;
+
+  if (move.secondary_effect) {
+    const SecondaryEffect &secondary = *move.secondary_effect;
+    if (!in_range(secondary.chance, 1, 100))
+      return fail(error, "secondary_effect chance must be 1..100");
+    switch (secondary.effect.type) {
+    case MoveEffectType::StatChange:
+    case MoveEffectType::StatusInflict:
+    case MoveEffectType::Confusion:
+    case MoveEffectType::Flinch:
+      break;
+    default:
+      return fail(error, std::string("secondary_effect cannot be ") +
+                             move_effect_name(secondary.effect.type));
+    }
+    if (!check_effect(secondary.effect, error)) {
+      error = "secondary_effect: " + error;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool compile_moves(std::vector<std::unique_ptr<MoveData>> &moves,
+                   EffectCompileReport &report, std::string &error) {
+  auto start = std::chrono::steady_clock::now();
+  report = EffectCompileReport();
+  for (std::unique_ptr<MoveData> &move : moves) {
+    if (!check_move(*move, error)) {
+      error = move->name + ": " + error;
+      return false;
+    }
+    compile_move(*move);
+    report.by_type[static_cast<size_t>(move->primary_effect.type)]++;
+    if (move->secondary_effect)
+      report.secondary_by_type[static_cast<size_t>(
+          move->secondary_effect->effect.type)]++;
+  }
+  report.moves = moves.size();
+  report.microseconds = std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+  return true;
+}
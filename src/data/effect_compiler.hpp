@@ -0,0 +1,36 @@
+#pragma once
+#include "core/move.hpp"
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+// What one compile_moves pass did: how many moves it compiled, how many of
+// them have each primary and each secondary effect type, and how long it
+// took
+struct EffectCompileReport {
+  size_t moves = 0;
+  std::array<size_t, MOVE_EFFECT_TYPE_COUNT> by_type{};
+  std::array<size_t, MOVE_EFFECT_TYPE_COUNT> secondary_by_type{};
+  double microseconds = 0;
+
+  // "Compiled 165 move effects in 12.5 us: damage 88, stat_change 16, ...;
+  // secondary status 23, ..."
+  std::string summary() const;
+};
+
+// False, with the reason in error, if a move as read from moves.json is
+// not something the engine can run as it stands: a number out of range
+// (stages outside -6..6, a chance or percent outside 1..100, hit counts
+// other than Gen 1's 2-5), a status or target the handlers do not take,
+// a damaging effect on a move with no power, or a Status move with no
+// effect at all
+bool check_move(const MoveData &move, std::string &error);
+
+// The pass between reading moves.json and adding its moves to GameData:
+// checks every move, then compiles its handler and its flat primary and
+// secondary effects (see compile_move) so the engine never meets a field
+// left unset. False, with "Move: reason" in error, at the first move it
+// rejects.
+bool compile_moves(std::vector<std::unique_ptr<MoveData>> &moves,
+                   EffectCompileReport &report, std::string &error);
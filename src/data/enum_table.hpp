@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Names to enum values through a perfect hash. The table is sized and
+// seeded when it is built so that no two names share a slot, so a lookup
+// is one hash of the string and at most one compare, whatever the number
+// of names.
+template <typename T> class EnumTable {
+private:
+  struct Slot {
+    std::string name;
+    T value;
+    bool used = false;
+  };
+
+  std::vector<Slot> slots_;
+  size_t mask_ = 0;
+  uint32_t seed_ = 0;
+
+  static uint32_t hash(uint32_t seed, const char *text, size_t length) {
+    uint32_t h = 2166136261u ^ seed; // FNV-1a, offset by the seed
+    for (size_t i = 0; i < length; i++) {
+      h ^= static_cast<uint8_t>(text[i]);
+      h *= 16777619u;
+    }
+    return h ^ (h >> 15);
+  }
+
+  // False if two names land in the same slot at this size and seed
+  bool place(std::initializer_list<std::pair<const char *, T>> entries,
+             size_t size, uint32_t seed) {
+    std::vector<Slot> slots(size);
+    for (const auto &entry : entries) {
+      std::string name = entry.first;
+      Slot &slot = slots[hash(seed, name.data(), name.size()) & (size - 1)];
+      if (slot.used)
+        return false;
+      slot.name = name;
+      slot.value = entry.second;
+      slot.used = true;
+    }
+    slots_ = std::move(slots);
+    mask_ = size - 1;
+    seed_ = seed;
+    return true;
+  }
+
+public:
+  // Names must be distinct. Starts at a table twice the number of names
+  // and tries seeds, doubling the table if none of them fit.
+  EnumTable(std::initializer_list<std::pair<const char *, T>> entries) {
+    size_t size = 1;
+    while (size < entries.size() * 2)
+      size *= 2;
+    for (;; size *= 2) {
+      for (uint32_t seed = 0; seed < 256; seed++) {
+        if (place(entries, size, seed))
+          return;
+      }
+    }
+  }
+
+  // Sets value and returns true if name is in the table
+  bool find(const char *name, size_t length, T &value) const {
+    const Slot &slot = slots_[hash(seed_, name, length) & mask_];
+    if (!slot.used || slot.name.size() != length ||
+        slot.name.compare(0, length, name, length) != 0)
+      return false;
+    value = slot.value;
+    return true;
+  }
+  bool find(const std::string &name, T &value) const {
+    return find(name.data(), name.size(), value);
+  }
+
+  // The value for name, or fallback if it is not in the table
+  T get(const std::string &name, T fallback) const {
+    find(name, fallback);
+    return fallback;
+  }
+
+  size_t slot_count() const { return slots_.size(); }
+};
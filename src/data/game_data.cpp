@@ -0,0 +1,163 @@
+#include "game_data.hpp"
+
+namespace {
+
+bool same_effect(const MoveEffect &a, const MoveEffect &b) {
+  return a.type == b.type && a.stat_change.stat == b.stat_change.stat &&
+         a.stat_change.stages == b.stat_change.stages &&
+         a.stat_change.target == b.stat_change.target &&
+         a.stat_change.chance == b.stat_change.chance &&
+         a.status_inflict.status == b.status_inflict.status &&
+         a.status_inflict.chance == b.status_inflict.chance &&
+         a.status_inflict.target == b.status_inflict.target &&
+         a.volatile_inflict.status == b.volatile_inflict.status &&
+         a.volatile_inflict.chance == b.volatile_inflict.chance &&
+         a.volatile_inflict.duration == b.volatile_inflict.duration &&
+         a.fixed_damage.type == b.fixed_damage.type &&
+         a.fixed_damage.value == b.fixed_damage.value &&
+         a.two_turn.invulnerable == b.two_turn.invulnerable &&
+         a.two_turn.charge_message == b.two_turn.charge_message &&
+         a.recoil_percent == b.recoil_percent &&
+         a.drain_percent == b.drain_percent &&
+         a.heal_percent == b.heal_percent && a.min_hits == b.min_hits &&
+         a.max_hits == b.max_hits && a.flinch_chance == b.flinch_chance &&
+         a.high_crit == b.high_crit;
+}
+
+bool same_move(const MoveData &a, const MoveData &b) {
+  if (a.name != b.name || a.type != b.type || a.category != b.category ||
+      a.power != b.power || a.accuracy != b.accuracy || a.max_pp != b.max_pp ||
+      !same_effect(a.primary_effect, b.primary_effect))
+    return false;
+  if (!a.secondary_effect || !b.secondary_effect)
+    return !a.secondary_effect && !b.secondary_effect;
+  return a.secondary_effect->chance == b.secondary_effect->chance &&
+         same_effect(a.secondary_effect->effect, b.secondary_effect->effect);
+}
+
+} // namespace
+
+void GameDataSnapshot::link_evolutions(const std::string &name,
+                                       const SpeciesData &species) {
+  evolution_by_id[species.id] = NO_SPECIES;
+  if (!species.evolves_to.empty()) {
+    auto target = species_map.find(species.evolves_to);
+    if (target != species_map.end()) {
+      evolution_by_id[species.id] = target->second->id;
+    } else {
+      unresolved_evolutions[species.evolves_to].push_back(species.id);
+    }
+  }
+
+  auto waiting = unresolved_evolutions.find(name);
+  if (waiting != unresolved_evolutions.end()) {
+    for (SpeciesId from : waiting->second) {
+      if (species_by_id[from]->evolves_to == name)
+        evolution_by_id[from] = species.id;
+    }
+    unresolved_evolutions.erase(waiting);
+  }
+}
+
+GameData::GameData() : current_(std::make_shared<GameDataSnapshot>()) {}
+
+GameData::Edit::Edit(GameData &owner)
+    : owner_(owner), lock_(owner.write_mutex_),
+      draft_(std::make_shared<GameDataSnapshot>(
+          *std::atomic_load(&owner.current_))) {}
+
+GameData::Edit::~Edit() {
+  if (!draft_ || !changed_)
+    return;
+  draft_->version_++;
+  owner_.publish(std::move(draft_));
+}
+
+void GameData::Edit::addSpecies(const std::string &name,
+                                const SpeciesData &data) {
+  GameDataSnapshot &draft = *draft_;
+  auto found = draft.species_map.find(name);
+  if (found != draft.species_map.end() && found->second->same_as(data))
+    return; // Reloading an unchanged species keeps its entry
+
+  SpeciesId id = found != draft.species_map.end()
+                     ? found->second->id
+                     : static_cast<SpeciesId>(draft.species_by_id.size());
+  owner_.species_entries_.push_back(std::make_unique<SpeciesData>(data));
+  SpeciesData *stored = owner_.species_entries_.back().get();
+  stored->id = id;
+
+  draft.species_map[name] = stored;
+  if (id == draft.species_by_id.size()) {
+    draft.species_by_id.push_back(stored);
+    draft.evolution_by_id.push_back(NO_SPECIES);
+  } else {
+    draft.species_by_id[id] = stored;
+  }
+  draft.link_evolutions(name, *stored);
+  changed_ = true;
+}
+
+void GameData::Edit::addMove(const std::string &name,
+                             std::unique_ptr<MoveData> data) {
+  GameDataSnapshot &draft = *draft_;
+  auto found = draft.move_map.find(name);
+  if (found != draft.move_map.end() && same_move(*found->second, *data))
+    return; // Reloading an unchanged move keeps its entry
+
+  // The loader compiles its moves as it checks them; moves built by hand
+  // are compiled here
+  if (!data->handler)
+    compile_move(*data);
+  data->id = found != draft.move_map.end()
+                 ? found->second->id
+                 : static_cast<MoveId>(draft.move_by_id.size());
+  const MoveData *stored = data.get();
+  owner_.move_entries_.push_back(std::move(data));
+
+  if (stored->id == draft.move_by_id.size())
+    draft.move_by_id.push_back(stored);
+  else
+    draft.move_by_id[stored->id] = stored;
+  draft.move_map[name] = stored;
+  changed_ = true;
+}
+
+void GameData::Edit::setTypeEffectiveness(PokeType attack, PokeType defend,
+                                          float effectiveness) {
+  float &entry = draft_->type_chart[static_cast<size_t>(attack)]
+                                   [static_cast<size_t>(defend)];
+  if (entry == effectiveness)
+    return;
+  entry = effectiveness;
+  changed_ = true;
+}
+
+std::shared_ptr<const GameDataSnapshot> GameData::snapshot() const {
+  return std::atomic_load(&current_);
+}
+
+const GameDataSnapshot &GameData::latest_view() const {
+  // This thread's reference to the latest snapshot. Checking the published
+  // version is one load of a line that only changes on publish, so reads
+  // stay off the shared pointer's reference count.
+  struct LatestView {
+    uint64_t version = 0;
+    std::shared_ptr<const GameDataSnapshot> snapshot;
+  };
+  static thread_local LatestView latest;
+
+  uint64_t published = published_version_.load(std::memory_order_acquire);
+  if (!latest.snapshot || latest.version != published) {
+    latest.snapshot = std::atomic_load(&current_);
+    latest.version = latest.snapshot->version();
+  }
+  return *latest.snapshot;
+}
+
+void GameData::publish(std::shared_ptr<GameDataSnapshot> next) {
+  uint64_t version = next->version();
+  std::atomic_store(&current_,
+                    std::shared_ptr<const GameDataSnapshot>(std::move(next)));
+  published_version_.store(version, std::memory_order_release);
+}
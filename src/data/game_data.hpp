@@ -1,11 +1,25 @@
 #pragma once
 #include "../core/enums.hpp"
 #include "../core/move.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <typeindex>
 #include <unordered_map>
 #include <vector>
 
+// Dense index assigned to each species in the order it was first added
+typedef uint16_t SpeciesId;
+const SpeciesId NO_SPECIES = 0xFFFF;
+
+const size_t TYPE_COUNT = static_cast<size_t>(PokeType::Dragon) + 1;
+// Damage multiplier of each attacking type (indexed by PokeType) against
+// one defender
+typedef std::array<float, TYPE_COUNT> TypeMatchup;
 
 struct SpeciesData {
   std::string name;
@@ -16,52 +30,77 @@ struct SpeciesData {
   int special;
   PokeType type1;
   PokeType type2;
-  // In a full game, we'd have learnsets, evolution data, etc.
+  std::string evolves_to{}; // Species name, empty if it does not evolve
+  SpeciesId id = NO_SPECIES; // Set by GameData::addSpecies
+  // In a full game, we'd have learnsets, etc.
+
+  bool same_as(const SpeciesData &other) const {
+    return name == other.name && hp == other.hp && attack == other.attack &&
+           defense == other.defense && speed == other.speed &&
+           special == other.special && type1 == other.type1 &&
+           type2 == other.type2 && evolves_to == other.evolves_to;
+  }
 };
 
-class GameData {
+// One published version of the game data: species, moves and the type
+// chart. It never changes once published; GameData builds the next
+// version as a copy and swaps it in, so whoever holds a snapshot keeps
+// seeing the same data for as long as they hold it. Entries are shared
+// between versions and never freed (see GameData), so the pointers a
+// snapshot hands out outlive it.
+class GameDataSnapshot {
 public:
-  static GameData &getInstance() {
-    static GameData instance;
-    return instance;
+  GameDataSnapshot() {
+    for (auto &row : type_chart)
+      row.fill(1.0f);
   }
 
-  void addSpecies(const std::string &name, const SpeciesData &data) {
-    species_map[name] = data;
+  const SpeciesData *getSpecies(SpeciesId id) const {
+    return id < species_by_id.size() ? species_by_id[id] : nullptr;
+  }
+
+  // What this species evolves into (nullptr if nothing)
+  const SpeciesData *getEvolution(const SpeciesData *species) const {
+    if (!species || species->id >= evolution_by_id.size())
+      return nullptr;
+    return getSpecies(evolution_by_id[species->id]);
   }
 
+  size_t speciesCount() const { return species_by_id.size(); }
+
   const SpeciesData *getSpecies(const std::string &name) const {
     auto it = species_map.find(name);
-    if (it != species_map.end()) {
-      return &it->second;
-    }
-    return nullptr;
+    return it != species_map.end() ? it->second : nullptr;
   }
 
-  void addMove(const std::string &name, std::unique_ptr<MoveData> data) {
-    move_map[name] = std::move(data);
+  const MoveData *getMove(MoveId id) const {
+    return id < move_by_id.size() ? move_by_id[id] : nullptr;
   }
 
+  size_t moveCount() const { return move_by_id.size(); }
+
   const MoveData *getMove(const std::string &name) const {
     auto it = move_map.find(name);
-    if (it != move_map.end()) {
-      return it->second.get();
-    }
-    return nullptr;
-  }
-
-  void setTypeEffectiveness(PokeType attack, PokeType defend,
-                            float effectiveness) {
-    type_chart[attack][defend] = effectiveness;
+    return it != move_map.end() ? it->second : nullptr;
   }
 
   float getEffectiveness(PokeType attack, PokeType defend) const {
     if (attack == PokeType::None || defend == PokeType::None)
       return 1.0f;
-    if (type_chart.count(attack) && type_chart.at(attack).count(defend)) {
-      return type_chart.at(attack).at(defend);
+    return type_chart[static_cast<size_t>(attack)][static_cast<size_t>(defend)];
+  }
+
+  // How every attacking type fares against a defender of these types
+  TypeMatchup getMatchup(PokeType type1, PokeType type2) const {
+    TypeMatchup matchup;
+    for (size_t attack = 0; attack < TYPE_COUNT; attack++) {
+      PokeType type = static_cast<PokeType>(attack);
+      float type2_eff = 1.0f;
+      if (type2 != PokeType::None)
+        type2_eff = getEffectiveness(type, type2);
+      matchup[attack] = getEffectiveness(type, type1) * type2_eff;
     }
-    return 1.0f;
+    return matchup;
   }
 
   std::vector<std::string> getAllSpeciesNames() const {
@@ -80,9 +119,226 @@ public:
     return names;
   }
 
+  // Stable pointers to every species / move, ordered by name
+  std::vector<const SpeciesData *> getAllSpecies() const {
+    std::vector<const SpeciesData *> all;
+    for (const auto &pair : species_map) {
+      all.push_back(pair.second);
+    }
+    std::sort(all.begin(), all.end(),
+              [](const SpeciesData *a, const SpeciesData *b) {
+                return a->name < b->name;
+              });
+    return all;
+  }
+
+  std::vector<const MoveData *> getAllMoves() const {
+    std::vector<const MoveData *> all;
+    for (const auto &pair : move_map) {
+      all.push_back(pair.second);
+    }
+    std::sort(all.begin(), all.end(), [](const MoveData *a, const MoveData *b) {
+      return a->name < b->name;
+    });
+    return all;
+  }
+
+  // Bumped by every publish that changed something, so caches built from
+  // this data (e.g. TeamCache) know to rebuild
+  uint64_t version() const { return version_; }
+
+  // Something worked out from this snapshot alone (e.g. the shop's species
+  // pools), built as T(*this) by the first caller and shared with every
+  // caller after. The next version starts without it, so whoever pinned
+  // this snapshot never sees one built from other data. Safe from any
+  // thread.
+  template <typename T> std::shared_ptr<const T> derived() const {
+    std::lock_guard<std::mutex> lock(derived_.mutex);
+    std::shared_ptr<const void> &slot =
+        derived_.built[std::type_index(typeid(T))];
+    if (!slot)
+      slot = std::make_shared<const T>(*this);
+    return std::static_pointer_cast<const T>(slot);
+  }
+
 private:
-  GameData() {}
-  std::unordered_map<std::string, SpeciesData> species_map;
-  std::unordered_map<std::string, std::unique_ptr<MoveData>> move_map;
-  std::unordered_map<PokeType, std::unordered_map<PokeType, float>> type_chart;
+  friend class GameData;
+
+  // Copying a snapshot (to edit it into the next version) copies none of
+  // what was built from it
+  struct Derived {
+    std::mutex mutex;
+    std::unordered_map<std::type_index, std::shared_ptr<const void>> built;
+
+    Derived() = default;
+    Derived(const Derived &) {}
+    Derived &operator=(const Derived &) {
+      std::lock_guard<std::mutex> lock(mutex);
+      built.clear();
+      return *this;
+    }
+  };
+  mutable Derived derived_;
+
+  std::unordered_map<std::string, const SpeciesData *> species_map;
+  std::unordered_map<std::string, const MoveData *> move_map;
+  std::vector<const MoveData *> move_by_id;
+  // Indexed [attack][defend]; every pairing not set is neutral
+  std::array<std::array<float, TYPE_COUNT>, TYPE_COUNT> type_chart;
+  uint64_t version_ = 0;
+
+  // Species ID -> data, and species ID -> evolved species ID
+  std::vector<const SpeciesData *> species_by_id;
+  std::vector<SpeciesId> evolution_by_id;
+  // Evolutions naming a species that has not been added yet
+  std::unordered_map<std::string, std::vector<SpeciesId>> unresolved_evolutions;
+
+  // Resolve the species' own evolution and any that were waiting on it
+  void link_evolutions(const std::string &name, const SpeciesData &species);
+};
+
+// Makes GameData reads on this thread come from one snapshot while in
+// scope. Battles read through their pinned snapshot this way (see Battle),
+// so a reload part way through a battle changes nothing it sees.
+inline const GameDataSnapshot *&scoped_game_data() {
+  static thread_local const GameDataSnapshot *snapshot = nullptr;
+  return snapshot;
+}
+
+class GameDataScope {
+private:
+  const GameDataSnapshot *previous_;
+
+public:
+  explicit GameDataScope(const GameDataSnapshot &snapshot)
+      : previous_(scoped_game_data()) {
+    scoped_game_data() = &snapshot;
+  }
+
+  ~GameDataScope() { scoped_game_data() = previous_; }
+
+  GameDataScope(const GameDataScope &) = delete;
+  GameDataScope &operator=(const GameDataScope &) = delete;
+};
+
+// The game data everything reads, published RCU style. Readers never
+// lock: the current GameDataSnapshot sits behind an atomic shared pointer,
+// and each thread keeps its own reference to it, refreshed only when the
+// published version moves on. Writers copy the current snapshot, change
+// the copy and publish it in one store, so a reload never pauses anyone
+// and anyone holding an older snapshot carries on with it.
+//
+// A changed species or move becomes a new entry rather than being edited
+// in place, and entries are kept until exit, so a Pokemon built from any
+// version can still point at its species and moves. Reloads only ever add
+// entries for what actually changed.
+class GameData {
+public:
+  static GameData &getInstance() {
+    static GameData instance;
+    return instance;
+  }
+
+  // Changes published together as one snapshot when the Edit ends. Only
+  // one Edit is open at a time; the next one waits for it.
+  class Edit {
+  private:
+    GameData &owner_;
+    std::unique_lock<std::mutex> lock_;
+    std::shared_ptr<GameDataSnapshot> draft_;
+    bool changed_ = false;
+
+    friend class GameData;
+    explicit Edit(GameData &owner);
+
+  public:
+    Edit(Edit &&other) = default;
+    ~Edit(); // Publishes, if anything changed
+
+    // A species or move with a name already present keeps its ID
+    void addSpecies(const std::string &name, const SpeciesData &data);
+    void addMove(const std::string &name, std::unique_ptr<MoveData> data);
+    void setTypeEffectiveness(PokeType attack, PokeType defend,
+                              float effectiveness);
+
+    // Everything so far, this Edit's changes included
+    const GameDataSnapshot &draft() const { return *draft_; }
+
+    // Drop every change instead of publishing it
+    void discard() { changed_ = false; }
+  };
+
+  Edit edit() { return Edit(*this); }
+
+  // Single changes, each published on its own
+  void addSpecies(const std::string &name, const SpeciesData &data) {
+    edit().addSpecies(name, data);
+  }
+  void addMove(const std::string &name, std::unique_ptr<MoveData> data) {
+    edit().addMove(name, std::move(data));
+  }
+  void setTypeEffectiveness(PokeType attack, PokeType defend,
+                            float effectiveness) {
+    edit().setTypeEffectiveness(attack, defend, effectiveness);
+  }
+
+  // The latest published snapshot, to hold on to
+  std::shared_ptr<const GameDataSnapshot> snapshot() const;
+
+  // The snapshot this thread reads: its GameDataScope's, or the latest.
+  // Only valid until the thread next reads GameData outside a scope.
+  const GameDataSnapshot &view() const {
+    const GameDataSnapshot *scoped = scoped_game_data();
+    return scoped ? *scoped : latest_view();
+  }
+
+  // Reads, from view()
+  const SpeciesData *getSpecies(SpeciesId id) const {
+    return view().getSpecies(id);
+  }
+  const SpeciesData *getEvolution(const SpeciesData *species) const {
+    return view().getEvolution(species);
+  }
+  size_t speciesCount() const { return view().speciesCount(); }
+  const SpeciesData *getSpecies(const std::string &name) const {
+    return view().getSpecies(name);
+  }
+  const MoveData *getMove(MoveId id) const { return view().getMove(id); }
+  size_t moveCount() const { return view().moveCount(); }
+  const MoveData *getMove(const std::string &name) const {
+    return view().getMove(name);
+  }
+  float getEffectiveness(PokeType attack, PokeType defend) const {
+    return view().getEffectiveness(attack, defend);
+  }
+  TypeMatchup getMatchup(PokeType type1, PokeType type2) const {
+    return view().getMatchup(type1, type2);
+  }
+  std::vector<std::string> getAllSpeciesNames() const {
+    return view().getAllSpeciesNames();
+  }
+  std::vector<std::string> getAllMoveNames() const {
+    return view().getAllMoveNames();
+  }
+  std::vector<const SpeciesData *> getAllSpecies() const {
+    return view().getAllSpecies();
+  }
+  std::vector<const MoveData *> getAllMoves() const {
+    return view().getAllMoves();
+  }
+  uint64_t version() const { return view().version(); }
+
+private:
+  GameData();
+
+  std::mutex write_mutex_; // Held by the open Edit
+  // Only touched through std::atomic_load / std::atomic_store
+  std::shared_ptr<const GameDataSnapshot> current_;
+  std::atomic<uint64_t> published_version_{0};
+  // Every entry ever published; guarded by write_mutex_
+  std::vector<std::unique_ptr<SpeciesData>> species_entries_;
+  std::vector<std::unique_ptr<MoveData>> move_entries_;
+
+  const GameDataSnapshot &latest_view() const;
+  void publish(std::shared_ptr<GameDataSnapshot> next);
 };
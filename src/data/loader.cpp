@@ -1,210 +1,195 @@
 #include "data/loader.hpp"
+#include "data/data_file.hpp"
+#include "data/effect_compiler.hpp"
 #include "data/game_data.hpp"
-#include "data/move_parser.hpp"
-#include <fstream>
 #include <iostream>
-#include <nlohmann/json.hpp>
-
-using json = nlohmann::json;
-
-// Helper function to parse type string to enum
-PokeType parseType(const std::string &typeStr) {
-  if (typeStr == "Normal")
-    return PokeType::Normal;
-  if (typeStr == "Fire")
-    return PokeType::Fire;
-  if (typeStr == "Water")
-    return PokeType::Water;
-  if (typeStr == "Grass")
-    return PokeType::Grass;
-  if (typeStr == "Electric")
-    return PokeType::Electric;
-  if (typeStr == "Ice")
-    return PokeType::Ice;
-  if (typeStr == "Fighting")
-    return PokeType::Fighting;
-  if (typeStr == "Poison")
-    return PokeType::Poison;
-  if (typeStr == "Ground")
-    return PokeType::Ground;
-  if (typeStr == "Flying")
-    return PokeType::Flying;
-  if (typeStr == "Psychic")
-    return PokeType::Psychic;
-  if (typeStr == "Bug")
-    return PokeType::Bug;
-  if (typeStr == "Rock")
-    return PokeType::Rock;
-  if (typeStr == "Ghost")
-    return PokeType::Ghost;
-  if (typeStr == "Dragon")
-    return PokeType::Dragon;
-  return PokeType::None;
+#include <thread>
+
+namespace {
+
+void add_fallback_species(GameData::Edit &edit) {
+  edit.addSpecies("Pikachu", {"Pikachu", 35, 55, 30, 90, 50,
+                              PokeType::Electric, PokeType::None});
+  edit.addSpecies("Bulbasaur", {"Bulbasaur", 45, 49, 49, 45, 65,
+                                PokeType::Grass, PokeType::Poison});
 }
 
-// Helper to parse move category
-MoveCategory parseCategory(const std::string &catStr) {
-  if (catStr == "Physical")
-    return MoveCategory::Physical;
-  if (catStr == "Special")
-    return MoveCategory::Special;
-  return MoveCategory::Status;
+void add_fallback_moves(GameData::Edit &edit) {
+  auto tackle = std::make_unique<MoveData>();
+  tackle->name = "Tackle";
+  tackle->type = PokeType::Normal;
+  tackle->category = MoveCategory::Physical;
+  tackle->power = 35;
+  tackle->accuracy = 95;
+  tackle->max_pp = 35;
+  tackle->primary_effect.type = MoveEffectType::Damage;
+  edit.addMove("Tackle", std::move(tackle));
+
+  auto thunder_shock = std::make_unique<MoveData>();
+  thunder_shock->name = "Thunder Shock";
+  thunder_shock->type = PokeType::Electric;
+  thunder_shock->category = MoveCategory::Special;
+  thunder_shock->power = 40;
+  thunder_shock->accuracy = 100;
+  thunder_shock->max_pp = 30;
+  thunder_shock->primary_effect.type = MoveEffectType::Damage;
+  edit.addMove("Thunder Shock", std::move(thunder_shock));
 }
 
-void load_species(const std::string &path) {
-  std::cout << "Loading species from: " << path << "\n";
-  auto &gd = GameData::getInstance();
-
-  std::ifstream file(path);
-  if (!file.is_open()) {
-    std::cerr << "Warning: Could not open " << path
-              << ", using fallback data\n";
-    // Fallback to hardcoded data
-    gd.addSpecies("Pikachu", {"Pikachu", 35, 55, 30, 90, 50, PokeType::Electric,
-                              PokeType::None});
-    gd.addSpecies("Bulbasaur", {"Bulbasaur", 45, 49, 49, 45, 65,
-                                PokeType::Grass, PokeType::Poison});
-    return;
+void add_species(const std::vector<SpeciesData> &species,
+                 GameData::Edit &edit) {
+  for (const SpeciesData &data : species)
+    edit.addSpecies(data.name, data);
+}
+
+void add_moves(std::vector<std::unique_ptr<MoveData>> &moves,
+               GameData::Edit &edit) {
+  for (std::unique_ptr<MoveData> &move : moves) {
+    std::string name = move->name;
+    edit.addMove(name, std::move(move));
   }
+}
+
+// moves.json parsed, then checked and compiled, so that nothing is added
+// to GameData unless every move in the file can be run as it stands
+bool read_moves(const std::string &path,
+                std::vector<std::unique_ptr<MoveData>> &moves,
+                EffectCompileReport &report, std::string &error) {
+  if (parse_moves_file(path, moves, error) &&
+      compile_moves(moves, report, error))
+    return true;
+  moves.clear();
+  return false;
+}
+
+void warn(const std::string &path, const std::string &error) {
+  std::cerr << "Warning: " << path << ": " << error << "\n";
+}
+
+// Both files, parsed at the same time: species on a thread of its own,
+// moves on this one
+struct ParsedData {
+  std::vector<SpeciesData> species;
+  std::vector<std::unique_ptr<MoveData>> moves;
+  EffectCompileReport moves_report;
+  bool species_ok = false;
+  bool moves_ok = false;
+  std::string species_error;
+  std::string moves_error;
+};
+
+void parse_both(const std::string &species_path, const std::string &moves_path,
+                ParsedData &parsed) {
+  std::thread species_thread([&]() {
+    parsed.species_ok =
+        parse_species_file(species_path, parsed.species, parsed.species_error);
+  });
+  parsed.moves_ok = read_moves(moves_path, parsed.moves, parsed.moves_report,
+                               parsed.moves_error);
+  species_thread.join();
+}
+
+} // namespace
 
-  try {
-    json j;
-    file >> j;
-
-    int count = 0;
-    for (auto &[name, data] : j.items()) {
-      SpeciesData species;
-      species.name = name;
-      species.hp = data["hp"];
-      species.attack = data["attack"];
-      species.defense = data["defense"];
-      species.speed = data["speed"];
-      species.special = data["special"];
-      species.type1 = parseType(data["type1"]);
-      species.type2 = parseType(data["type2"]);
-
-      gd.addSpecies(name, species);
-      count++;
-    }
-
-    std::cout << "Loaded " << count << " species successfully\n";
-  } catch (const std::exception &e) {
-    std::cerr << "Error parsing JSON: " << e.what() << "\n";
+void load_species(const std::string &path) {
+  GameData::Edit edit = GameData::getInstance().edit();
+  load_species(path, edit);
+}
+
+void load_species(const std::string &path, GameData::Edit &edit) {
+  std::cout << "Loading species from: " << path << "\n";
+  std::vector<SpeciesData> species;
+  std::string error;
+  if (!parse_species_file(path, species, error)) {
+    warn(path, error);
     std::cerr << "Using fallback data\n";
-    gd.addSpecies("Pikachu", {"Pikachu", 35, 55, 30, 90, 50, PokeType::Electric,
-                              PokeType::None});
-    gd.addSpecies("Bulbasaur", {"Bulbasaur", 45, 49, 49, 45, 65,
-                                PokeType::Grass, PokeType::Poison});
+    add_fallback_species(edit);
+    return;
   }
-
-  file.close();
+  add_species(species, edit);
+  std::cout << "Loaded " << species.size() << " species successfully\n";
 }
 
 void load_moves(const std::string &path) {
+  GameData::Edit edit = GameData::getInstance().edit();
+  load_moves(path, edit);
+}
+
+void load_moves(const std::string &path, GameData::Edit &edit) {
   std::cout << "Loading moves from: " << path << "\n";
-  auto &gd = GameData::getInstance();
-
-  std::ifstream file(path);
-  if (!file.is_open()) {
-    std::cerr << "Warning: Could not open " << path
-              << ", using fallback data\n";
-    // Fallback to hardcoded data
-    auto tackle = std::make_unique<MoveData>();
-    tackle->name = "Tackle";
-    tackle->type = PokeType::Normal;
-    tackle->category = MoveCategory::Physical;
-    tackle->power = 35;
-    tackle->accuracy = 95;
-    tackle->max_pp = 35;
-    tackle->primary_effect.type = MoveEffectType::Damage;
-    gd.addMove("Tackle", std::move(tackle));
-
-    auto thunder_shock = std::make_unique<MoveData>();
-    thunder_shock->name = "Thunder Shock";
-    thunder_shock->type = PokeType::Electric;
-    thunder_shock->category = MoveCategory::Special;
-    thunder_shock->power = 40;
-    thunder_shock->accuracy = 100;
-    thunder_shock->max_pp = 30;
-    thunder_shock->primary_effect.type = MoveEffectType::Damage;
-    gd.addMove("Thunder Shock", std::move(thunder_shock));
+  std::vector<std::unique_ptr<MoveData>> moves;
+  EffectCompileReport report;
+  std::string error;
+  if (!read_moves(path, moves, report, error)) {
+    warn(path, error);
+    std::cerr << "Using fallback data\n";
+    add_fallback_moves(edit);
     return;
   }
+  add_moves(moves, edit);
+  std::cout << "Loaded " << report.moves << " moves successfully\n";
+  std::cout << report.summary() << "\n";
+}
 
-  try {
-    json j;
-    file >> j;
-
-    int count = 0;
-    for (auto &[name, data] : j.items()) {
-      auto move = std::make_unique<MoveData>();
-      move->name = name;
-      move->type = parseType(data["type"]);
-      move->category = parseCategory(data["category"]);
-      move->power = data["power"];
-      move->accuracy = data["accuracy"];
-      move->max_pp = data["pp"];
-
-      // Parse primary effect if present
-      if (data.contains("effect")) {
-        parseMoveEffect(move->primary_effect, data["effect"]);
-      } else {
-        // Initialize default effect based on category
-        if (move->category == MoveCategory::Status) {
-          move->primary_effect.type = MoveEffectType::None;
-        } else {
-          move->primary_effect.type = MoveEffectType::Damage;
-        }
-      }
-
-      // Parse secondary effect if present
-      if (data.contains("secondary_effect")) {
-        auto secondary = std::make_unique<SecondaryEffect>();
-        secondary->chance = data["secondary_effect"].value("chance", 30);
-        parseMoveEffect(secondary->effect, data["secondary_effect"]);
-        move->secondary_effect = std::move(secondary);
-      }
-
-      gd.addMove(name, std::move(move));
-      count++;
-    }
-
-    std::cout << "Loaded " << count << " moves successfully\n";
-  } catch (const std::exception &e) {
-    std::cerr << "Error parsing JSON: " << e.what() << "\n";
+void load_game_data(const std::string &species_path,
+                    const std::string &moves_path,
+                    const std::string &type_chart_path) {
+  std::cout << "Loading species from: " << species_path << "\n";
+  std::cout << "Loading moves from: " << moves_path << "\n";
+  ParsedData parsed;
+  parse_both(species_path, moves_path, parsed);
+
+  GameData::Edit edit = GameData::getInstance().edit();
+  if (parsed.species_ok) {
+    add_species(parsed.species, edit);
+    std::cout << "Loaded " << parsed.species.size()
+              << " species successfully\n";
+  } else {
+    warn(species_path, parsed.species_error);
     std::cerr << "Using fallback data\n";
-
-    auto tackle = std::make_unique<MoveData>();
-    tackle->name = "Tackle";
-    tackle->type = PokeType::Normal;
-    tackle->category = MoveCategory::Physical;
-    tackle->power = 35;
-    tackle->accuracy = 95;
-    tackle->max_pp = 35;
-    tackle->primary_effect.type = MoveEffectType::Damage;
-    gd.addMove("Tackle", std::move(tackle));
-
-    auto thunder_shock = std::make_unique<MoveData>();
-    thunder_shock->name = "Thunder Shock";
-    thunder_shock->type = PokeType::Electric;
-    thunder_shock->category = MoveCategory::Special;
-    thunder_shock->power = 40;
-    thunder_shock->accuracy = 100;
-    thunder_shock->max_pp = 30;
-    thunder_shock->primary_effect.type = MoveEffectType::Damage;
-    gd.addMove("Thunder Shock", std::move(thunder_shock));
+    add_fallback_species(edit);
+  }
+  if (parsed.moves_ok) {
+    add_moves(parsed.moves, edit);
+    std::cout << "Loaded " << parsed.moves_report.moves
+              << " moves successfully\n";
+    std::cout << parsed.moves_report.summary() << "\n";
+  } else {
+    warn(moves_path, parsed.moves_error);
+    std::cerr << "Using fallback data\n";
+    add_fallback_moves(edit);
   }
+  load_type_chart(type_chart_path, edit);
+}
 
-  file.close();
+bool reload_game_data(const std::string &species_path,
+                      const std::string &moves_path) {
+  ParsedData parsed;
+  parse_both(species_path, moves_path, parsed);
+  if (!parsed.species_ok)
+    warn(species_path, parsed.species_error);
+  if (!parsed.moves_ok)
+    warn(moves_path, parsed.moves_error);
+  if (!parsed.species_ok || !parsed.moves_ok)
+    return false;
+
+  GameData::Edit edit = GameData::getInstance().edit();
+  add_species(parsed.species, edit);
+  add_moves(parsed.moves, edit);
+  return true;
 }
 
 void load_type_chart(const std::string &path) {
+  GameData::Edit edit = GameData::getInstance().edit();
+  load_type_chart(path, edit);
+}
+
+void load_type_chart(const std::string &path, GameData::Edit &edit) {
   std::cout << "Loading type chart (hardcoded Gen 1) from: " << path << "\n";
-  auto &gd = GameData::getInstance();
 
 // Helper macro to make it readable
 #define SET_EFF(atk, def, val)                                                 \
-  gd.setTypeEffectiveness(PokeType::atk, PokeType::def, val)
+  edit.setTypeEffectiveness(PokeType::atk, PokeType::def, val)
 
   // Normal
   SET_EFF(Normal, Rock, 0.5f);
@@ -1,8 +1,32 @@
 #pragma once
+#include "game_data.hpp"
 #include <string>
 
-// Loader functions are placeholders. For a real project you may use nlohmann/json
-// or another parser to load the JSON files from disk.
+// Each file is streamed straight into records (see data_file.hpp) and
+// published as one snapshot; a file that cannot be read is replaced by a
+// couple of fallback entries so the game still starts. Moves are checked
+// and compiled before any of them is added (see effect_compiler.hpp), so
+// one bad move replaces the whole file with the fallback.
 void load_species(const std::string &path);
 void load_moves(const std::string &path);
 void load_type_chart(const std::string &path);
+
+// The same, adding to an open edit so that several files are published
+// as one snapshot
+void load_species(const std::string &path, GameData::Edit &edit);
+void load_moves(const std::string &path, GameData::Edit &edit);
+void load_type_chart(const std::string &path, GameData::Edit &edit);
+
+// Everything a program needs at startup, as one snapshot. The species and
+// moves files are parsed at the same time on two threads.
+void load_game_data(const std::string &species_path,
+                    const std::string &moves_path,
+                    const std::string &type_chart_path);
+
+// Read both files again (in parallel, as load_game_data) and publish what
+// changed (balance changes) as one snapshot. Battles already running keep
+// the data they started with. Species and moves missing from the files
+// are left as they were. False, with nothing published, if either file
+// cannot be read or parsed.
+bool reload_game_data(const std::string &species_path,
+                      const std::string &moves_path);
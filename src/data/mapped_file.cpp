@@ -0,0 +1,91 @@
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : data_(nullptr), size_(0)
+#ifdef _WIN32
+      ,
+      file_(INVALID_HANDLE_VALUE), mapping_(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::open(const std::string &path) {
+  close();
+#ifdef _WIN32
+  file_ = CreateFileA(path.c_str(), GENERIC_READ,
+                      FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_ == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file_, &size)) {
+    close();
+    return false;
+  }
+  size_ = static_cast<size_t>(size.QuadPart);
+  if (size_ == 0)
+    return true;
+  mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping_) {
+    close();
+    return false;
+  }
+  data_ = static_cast<const uint8_t *>(
+      MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (!data_) {
+    close();
+    return false;
+  }
+  return true;
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    ::close(fd);
+    return false;
+  }
+  size_ = static_cast<size_t>(info.st_size);
+  if (size_ > 0) {
+    void *mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+      ::close(fd);
+      size_ = 0;
+      return false;
+    }
+    data_ = static_cast<const uint8_t *>(mapped);
+  }
+  ::close(fd); // The mapping keeps the file alive
+  return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+  if (data_)
+    UnmapViewOfFile(data_);
+  if (mapping_)
+    CloseHandle(mapping_);
+  if (file_ != INVALID_HANDLE_VALUE)
+    CloseHandle(file_);
+  mapping_ = nullptr;
+  file_ = INVALID_HANDLE_VALUE;
+#else
+  if (data_)
+    munmap(const_cast<uint8_t *>(data_), size_);
+#endif
+  data_ = nullptr;
+  size_ = 0;
+}
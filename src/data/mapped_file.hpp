@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory map of a whole file (empty if it cannot be mapped)
+class MappedFile {
+private:
+  const uint8_t *data_;
+  size_t size_;
+#ifdef _WIN32
+  void *file_;
+  void *mapping_;
+#endif
+
+public:
+  MappedFile();
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool open(const std::string &path);
+  void close();
+
+  const uint8_t *data() const { return data_; }
+  size_t size() const { return size_; }
+};
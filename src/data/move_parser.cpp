@@ -1,112 +1,319 @@
 #include "move_parser.hpp"
-#include "core/enums.hpp"
+#include "enum_table.hpp"
 
-using json = nlohmann::json;
+namespace {
+
+const EnumTable<PokeType> &type_table() {
+  static const EnumTable<PokeType> table{
+      {"Normal", PokeType::Normal},     {"Fire", PokeType::Fire},
+      {"Water", PokeType::Water},       {"Grass", PokeType::Grass},
+      {"Electric", PokeType::Electric}, {"Ice", PokeType::Ice},
+      {"Fighting", PokeType::Fighting}, {"Poison", PokeType::Poison},
+      {"Ground", PokeType::Ground},     {"Flying", PokeType::Flying},
+      {"Psychic", PokeType::Psychic},   {"Bug", PokeType::Bug},
+      {"Rock", PokeType::Rock},         {"Ghost", PokeType::Ghost},
+      {"Dragon", PokeType::Dragon}};
+  return table;
+}
+
+const EnumTable<MoveCategory> &category_table() {
+  static const EnumTable<MoveCategory> table{
+      {"Physical", MoveCategory::Physical},
+      {"Special", MoveCategory::Special},
+      {"Status", MoveCategory::Status}};
+  return table;
+}
+
+const EnumTable<PokeStat> &stat_table() {
+  static const EnumTable<PokeStat> table{{"Attack", PokeStat::Attack},
+                                         {"Defense", PokeStat::Defense},
+                                         {"Speed", PokeStat::Speed},
+                                         {"Special", PokeStat::Special}};
+  return table;
+}
+
+const EnumTable<PokeStatus> &status_table() {
+  static const EnumTable<PokeStatus> table{
+      {"Burn", PokeStatus::Burn},           {"Freeze", PokeStatus::Freeze},
+      {"Paralysis", PokeStatus::Paralysis}, {"Poison", PokeStatus::Poison},
+      {"Sleep", PokeStatus::Sleep},         {"Toxic", PokeStatus::Toxic}};
+  return table;
+}
+
+const EnumTable<EffectTarget> &target_table() {
+  static const EnumTable<EffectTarget> table{
+      {"self", EffectTarget::Self},
+      {"opponent", EffectTarget::Opponent},
+      {"both", EffectTarget::Both}};
+  return table;
+}
+
+const EnumTable<MoveEffectType> &effect_table() {
+  static const EnumTable<MoveEffectType> table{
+      {"damage", MoveEffectType::Damage},
+      {"stat_change", MoveEffectType::StatChange},
+      {"status", MoveEffectType::StatusInflict},
+      {"heal", MoveEffectType::Heal},
+      {"recoil", MoveEffectType::Recoil},
+      {"drain", MoveEffectType::Drain},
+      {"multi_hit", MoveEffectType::MultiHit},
+      {"two_hit", MoveEffectType::TwoHit},
+      {"ohko", MoveEffectType::OHKO},
+      {"fixed_damage", MoveEffectType::FixedDamage},
+      {"confusion", MoveEffectType::Confusion},
+      {"flinch", MoveEffectType::Flinch},
+      {"counter", MoveEffectType::Counter},
+      {"two_turn", MoveEffectType::TwoTurn},
+      {"rage", MoveEffectType::Rage},
+      {"disable", MoveEffectType::Disable},
+      {"haze", MoveEffectType::Haze},
+      {"reflect", MoveEffectType::Reflect},
+      {"light_screen", MoveEffectType::LightScreen},
+      {"bide", MoveEffectType::Bide},
+      {"high_crit", MoveEffectType::HighCritRatio},
+      {"not_implemented", MoveEffectType::NotImplemented}};
+  return table;
+}
+
+const EnumTable<FixedDamageData::Type> &damage_type_table() {
+  static const EnumTable<FixedDamageData::Type> table{
+      {"level", FixedDamageData::Type::Level},
+      {"constant", FixedDamageData::Type::Constant},
+      {"half_hp", FixedDamageData::Type::HalfHP}};
+  return table;
+}
+
+// Looks name up in table, or says which kind of name it is not
+template <typename T>
+bool lookup(const EnumTable<T> &table, const std::string &name,
+            const char *kind, T &value, std::string &error) {
+  if (table.find(name, value))
+    return true;
+  error = std::string("unknown ") + kind + " \"" + name + "\"";
+  return false;
+}
+
+// Which member of EffectFields a name is
+enum class EffectField {
+  Type,
+  Stat,
+  Status,
+  Target,
+  DamageType,
+  ChargeMessage,
+  Stages,
+  Chance,
+  Percent,
+  Min,
+  Max,
+  Value,
+  Invulnerable
+};
+
+const EnumTable<EffectField> &field_table() {
+  static const EnumTable<EffectField> table{
+      {"type", EffectField::Type},
+      {"stat", EffectField::Stat},
+      {"status", EffectField::Status},
+      {"target", EffectField::Target},
+      {"damage_type", EffectField::DamageType},
+      {"charge_message", EffectField::ChargeMessage},
+      {"stages", EffectField::Stages},
+      {"chance", EffectField::Chance},
+      {"percent", EffectField::Percent},
+      {"min", EffectField::Min},
+      {"max", EffectField::Max},
+      {"value", EffectField::Value},
+      {"invulnerable", EffectField::Invulnerable}};
+  return table;
+}
+
+} // namespace
+
+PokeType parseType(const std::string &typeStr) {
+  return type_table().get(typeStr, PokeType::None);
+}
+
+MoveCategory parseCategory(const std::string &catStr) {
+  return category_table().get(catStr, MoveCategory::Status);
+}
 
-// Helper to parse PokeStat from string
 PokeStat parseStat(const std::string &statStr) {
-  if (statStr == "Attack")
-    return PokeStat::Attack;
-  if (statStr == "Defense")
-    return PokeStat::Defense;
-  if (statStr == "Speed")
-    return PokeStat::Speed;
-  if (statStr == "Special")
-    return PokeStat::Special;
-  return PokeStat::HP;
-}
-
-// Helper to parse PokeStatus from string
+  return stat_table().get(statStr, PokeStat::HP);
+}
+
 PokeStatus parseStatus(const std::string &statusStr) {
-  if (statusStr == "Burn")
-    return PokeStatus::Burn;
-  if (statusStr == "Freeze")
-    return PokeStatus::Freeze;
-  if (statusStr == "Paralysis")
-    return PokeStatus::Paralysis;
-  if (statusStr == "Poison")
-    return PokeStatus::Poison;
-  if (statusStr == "Sleep")
-    return PokeStatus::Sleep;
-  if (statusStr == "Toxic")
-    return PokeStatus::Toxic;
-  return PokeStatus::None;
-}
-
-// Helper to parse effect target
+  return status_table().get(statusStr, PokeStatus::None);
+}
+
 EffectTarget parseEffectTarget(const std::string &targetStr) {
-  if (targetStr == "self")
-    return EffectTarget::Self;
-  if (targetStr == "opponent")
-    return EffectTarget::Opponent;
-  if (targetStr == "both")
-    return EffectTarget::Both;
-  return EffectTarget::Opponent;
-}
-
-// Parse move effect from JSON
-void parseMoveEffect(MoveEffect &effect, const json &effectData) {
-  if (!effectData.contains("type"))
-    return;
-
-  std::string effectType = effectData["type"];
-
-  if (effectType == "damage") {
-    effect.type = MoveEffectType::Damage;
-  } else if (effectType == "stat_change") {
-    effect.type = MoveEffectType::StatChange;
-    effect.stat_change.stat = parseStat(effectData["stat"]);
-    effect.stat_change.stages = effectData["stages"];
-    effect.stat_change.target =
-        parseEffectTarget(effectData.value("target", "self"));
-    effect.stat_change.chance = effectData.value("chance", 100);
-  } else if (effectType == "status") {
-    effect.type = MoveEffectType::StatusInflict;
-    effect.status_inflict.status = parseStatus(effectData["status"]);
-    effect.status_inflict.chance = effectData.value("chance", 100);
-    effect.status_inflict.target =
-        parseEffectTarget(effectData.value("target", "opponent"));
-  } else if (effectType == "recoil") {
-    effect.type = MoveEffectType::Recoil;
-    effect.recoil_percent = effectData.value("percent", 25);
-  } else if (effectType == "drain") {
-    effect.type = MoveEffectType::Drain;
-    effect.drain_percent = effectData.value("percent", 50);
-  } else if (effectType == "multi_hit") {
-    effect.type = MoveEffectType::MultiHit;
-    effect.min_hits = effectData.value("min", 2);
-    effect.max_hits = effectData.value("max", 5);
-  } else if (effectType == "two_hit") {
-    effect.type = MoveEffectType::TwoHit;
-  } else if (effectType == "ohko") {
-    effect.type = MoveEffectType::OHKO;
-  } else if (effectType == "fixed_damage") {
-    effect.type = MoveEffectType::FixedDamage;
-    std::string damageType = effectData.value("damage_type", "level");
-    if (damageType == "level") {
-      effect.fixed_damage.type = FixedDamageData::Type::Level;
-    } else if (damageType == "constant") {
-      effect.fixed_damage.type = FixedDamageData::Type::Constant;
-      effect.fixed_damage.value = effectData.value("value", 40);
+  return target_table().get(targetStr, EffectTarget::Opponent);
+}
+
+bool parseType(const std::string &typeStr, PokeType &type) {
+  return type_table().find(typeStr, type);
+}
+
+bool parseCategory(const std::string &catStr, MoveCategory &category) {
+  return category_table().find(catStr, category);
+}
+
+bool EffectFields::set_string(const std::string &name, const std::string &text,
+                              bool &wrong_kind) {
+  EffectField field;
+  if (!field_table().find(name, field))
+    return false;
+  switch (field) {
+  case EffectField::Type:
+    type = text;
+    break;
+  case EffectField::Stat:
+    stat = text;
+    break;
+  case EffectField::Status:
+    status = text;
+    break;
+  case EffectField::Target:
+    target = text;
+    break;
+  case EffectField::DamageType:
+    damage_type = text;
+    break;
+  case EffectField::ChargeMessage:
+    charge_message = text;
+    break;
+  default:
+    wrong_kind = true;
+  }
+  return true;
+}
+
+bool EffectFields::set_number(const std::string &name, int number,
+                              bool &wrong_kind) {
+  EffectField field;
+  if (!field_table().find(name, field))
+    return false;
+  switch (field) {
+  case EffectField::Stages:
+    stages = number;
+    break;
+  case EffectField::Chance:
+    chance = number;
+    break;
+  case EffectField::Percent:
+    percent = number;
+    break;
+  case EffectField::Min:
+    min = number;
+    break;
+  case EffectField::Max:
+    max = number;
+    break;
+  case EffectField::Value:
+    value = number;
+    break;
+  default:
+    wrong_kind = true;
+  }
+  return true;
+}
+
+bool EffectFields::set_bool(const std::string &name, bool flag,
+                            bool &wrong_kind) {
+  EffectField field;
+  if (!field_table().find(name, field))
+    return false;
+  if (field == EffectField::Invulnerable)
+    invulnerable = flag;
+  else
+    wrong_kind = true;
+  return true;
+}
+
+bool parseMoveEffect(MoveEffect &effect, const EffectFields &fields,
+                     std::string &error) {
+  if (!fields.type) {
+    error = "effect has no type";
+    return false;
+  }
+  MoveEffectType type;
+  if (!lookup(effect_table(), *fields.type, "effect type", type, error))
+    return false;
+
+  effect.type = type;
+  switch (type) {
+  case MoveEffectType::StatChange:
+    if (!fields.stat || !fields.stages || !fields.target) {
+      error = "stat_change effect needs a stat, stages and a target";
+      return false;
+    }
+    if (!lookup(stat_table(), *fields.stat, "stat", effect.stat_change.stat,
+                error) ||
+        !lookup(target_table(), *fields.target, "target",
+                effect.stat_change.target, error))
+      return false;
+    effect.stat_change.stages = *fields.stages;
+    effect.stat_change.chance = fields.chance.value_or(100);
+    break;
+  case MoveEffectType::StatusInflict:
+    if (!fields.status) {
+      error = "status effect needs a status";
+      return false;
+    }
+    if (!lookup(status_table(), *fields.status, "status",
+                effect.status_inflict.status, error) ||
+        !lookup(target_table(), fields.target.value_or("opponent"), "target",
+                effect.status_inflict.target, error))
+      return false;
+    effect.status_inflict.chance = fields.chance.value_or(100);
+    break;
+  case MoveEffectType::Recoil:
+  case MoveEffectType::Drain:
+  case MoveEffectType::Heal:
+    if (!fields.percent) {
+      error = *fields.type + " effect needs a percent";
+      return false;
+    }
+    if (type == MoveEffectType::Recoil)
+      effect.recoil_percent = *fields.percent;
+    else if (type == MoveEffectType::Drain)
+      effect.drain_percent = *fields.percent;
+    else
+      effect.heal_percent = *fields.percent;
+    break;
+  case MoveEffectType::MultiHit:
+    if (!fields.min || !fields.max) {
+      error = "multi_hit effect needs a min and a max";
+      return false;
+    }
+    effect.min_hits = *fields.min;
+    effect.max_hits = *fields.max;
+    break;
+  case MoveEffectType::FixedDamage:
+    if (!fields.damage_type) {
+      error = "fixed_damage effect needs a damage_type";
+      return false;
+    }
+    if (!lookup(damage_type_table(), *fields.damage_type, "damage_type",
+                effect.fixed_damage.type, error))
+      return false;
+    if (effect.fixed_damage.type == FixedDamageData::Type::Constant) {
+      if (!fields.value) {
+        error = "constant fixed_damage effect needs a value";
+        return false;
+      }
+      effect.fixed_damage.value = *fields.value;
     }
-  } else if (effectType == "confusion") {
-    effect.type = MoveEffectType::Confusion;
-  } else if (effectType == "flinch") {
-    effect.type = MoveEffectType::Flinch;
-    effect.flinch_chance = effectData.value("chance", 100);
-  } else if (effectType == "counter") {
-    effect.type = MoveEffectType::Counter;
-  } else if (effectType == "two_turn") {
-    effect.type = MoveEffectType::TwoTurn;
-    effect.two_turn.invulnerable = effectData.value("invulnerable", false);
-    effect.two_turn.charge_message = effectData.value("charge_message", "");
-  } else if (effectType == "rage") {
-    effect.type = MoveEffectType::Rage;
-  } else if (effectType == "disable") {
-    effect.type = MoveEffectType::Disable;
-  } else if (effectType == "haze") {
-    effect.type = MoveEffectType::Haze;
-  } else if (effectType == "high_crit") {
-    effect.type = MoveEffectType::HighCritRatio;
+    break;
+  case MoveEffectType::Flinch:
+    effect.flinch_chance = fields.chance.value_or(100);
+    break;
+  case MoveEffectType::TwoTurn:
+    effect.two_turn.invulnerable = fields.invulnerable.value_or(false);
+    effect.two_turn.charge_message = fields.charge_message.value_or("");
+    break;
+  default:
+    break;
   }
+  return true;
 }
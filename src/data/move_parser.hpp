@@ -1,11 +1,54 @@
 #pragma once
 
+#include "core/enums.hpp"
+#include "core/move.hpp"
 #include "core/move_effect.hpp"
-#include <nlohmann/json.hpp>
+#include <optional>
 #include <string>
 
-// Helper functions to parse move effects from JSON
-PokeStat parseStat(const std::string &statStr);
-PokeStatus parseStatus(const std::string &statusStr);
-EffectTarget parseEffectTarget(const std::string &targetStr);
-void parseMoveEffect(MoveEffect &effect, const nlohmann::json &effectData);
+// Names in the data files to enums, each through a perfect-hash table.
+// Unknown names get the same fallbacks as ever.
+PokeType parseType(const std::string &typeStr);          // None
+MoveCategory parseCategory(const std::string &catStr);   // Status
+PokeStat parseStat(const std::string &statStr);          // HP
+PokeStatus parseStatus(const std::string &statusStr);    // None
+EffectTarget parseEffectTarget(const std::string &targetStr); // Opponent
+
+// The same without the fallback: false if the name is not one of them
+bool parseType(const std::string &typeStr, PokeType &type);
+bool parseCategory(const std::string &catStr, MoveCategory &category);
+
+// An effect object's fields as read from moves.json, before its type says
+// which of them matter
+struct EffectFields {
+  std::optional<std::string> type;
+  std::optional<std::string> stat;
+  std::optional<std::string> status;
+  std::optional<std::string> target;
+  std::optional<std::string> damage_type;
+  std::optional<std::string> charge_message;
+  std::optional<int> stages;
+  std::optional<int> chance;
+  std::optional<int> percent;
+  std::optional<int> min;
+  std::optional<int> max;
+  std::optional<int> value;
+  std::optional<bool> invulnerable;
+
+  // Stores a field this struct has a place for. Returns false if name is
+  // not one of them; sets wrong_kind if it is but the value is the wrong
+  // kind of JSON value.
+  bool set_string(const std::string &name, const std::string &text,
+                  bool &wrong_kind);
+  bool set_number(const std::string &name, int number, bool &wrong_kind);
+  bool set_bool(const std::string &name, bool flag, bool &wrong_kind);
+};
+
+// Fill in effect from its fields. False (with the reason in error) if there
+// is no type, the type or any name in the fields is unknown, or a field the
+// type needs is missing. The only defaults
+// left are the ones Gen 1 has no exceptions to spell out: a chance of
+// 100, a status effect aimed at the opponent, and a two_turn move with
+// no charge message that is not invulnerable.
+bool parseMoveEffect(MoveEffect &effect, const EffectFields &fields,
+                     std::string &error);
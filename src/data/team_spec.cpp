@@ -0,0 +1,113 @@
+#include "team_spec.hpp"
+
+namespace {
+
+// Position of a stat's DV within a member's 16 DV bits
+int dv_shift(PokeStat stat) {
+  switch (stat) {
+  case PokeStat::Attack:
+    return 12;
+  case PokeStat::Defense:
+    return 8;
+  case PokeStat::Speed:
+    return 4;
+  default:
+    return 0; // Special
+  }
+}
+
+} // namespace
+
+bool TeamSpec::from_team(const std::vector<Pokemon> &team, TeamSpec &spec) {
+  spec = TeamSpec();
+  if (team.empty() || team.size() > static_cast<size_t>(MAX_MEMBERS))
+    return false;
+
+  for (size_t i = 0; i < team.size(); i++) {
+    const Pokemon &pokemon = team[i];
+    SpeciesId species = pokemon.species()->id;
+    if (species >= ID_LIMIT || pokemon.level() < 1 || pokemon.level() > 0x7F) {
+      spec = TeamSpec();
+      return false;
+    }
+
+    uint64_t word = species | (static_cast<uint64_t>(pokemon.level()) << 10);
+    for (int slot = 0; slot < 4; slot++) {
+      uint64_t id = ID_LIMIT;
+      if (slot < pokemon.move_count() && pokemon.get_move(slot).data) {
+        id = pokemon.get_move(slot).data->id;
+        if (id >= ID_LIMIT) {
+          spec = TeamSpec();
+          return false;
+        }
+      }
+      word |= id << (17 + 10 * slot);
+    }
+    spec.members[i] = word;
+
+    uint16_t dvs = 0;
+    for (PokeStat stat : {PokeStat::Attack, PokeStat::Defense, PokeStat::Speed,
+                          PokeStat::Special}) {
+      int dv = pokemon.ivs()[static_cast<int>(stat)] & 0xF;
+      dvs |= static_cast<uint16_t>(dv << dv_shift(stat));
+    }
+    spec.dvs[i] = dvs;
+  }
+  spec.size = static_cast<uint8_t>(team.size());
+  return true;
+}
+
+bool TeamSpec::to_team(std::vector<Pokemon> &team) const {
+  const GameData &data = GameData::getInstance();
+  size_t first = team.size();
+  for (int i = 0; i < size; i++) {
+    const SpeciesData *species = data.getSpecies(this->species(i));
+    if (!species) {
+      team.erase(team.begin() + first, team.end());
+      return false;
+    }
+    Pokemon pokemon(species, level(i));
+    pokemon.set_dvs(dv(i, PokeStat::Attack), dv(i, PokeStat::Defense),
+                    dv(i, PokeStat::Speed), dv(i, PokeStat::Special));
+    for (int slot = 0; slot < 4; slot++) {
+      MoveId id = move(i, slot);
+      if (id == NO_MOVE)
+        continue;
+      const MoveData *move_data = data.getMove(id);
+      if (!move_data) {
+        team.erase(team.begin() + first, team.end());
+        return false;
+      }
+      pokemon.add_move(Move(move_data));
+    }
+    team.push_back(pokemon);
+  }
+  return true;
+}
+
+int TeamSpec::dv(int member, PokeStat stat) const {
+  if (stat != PokeStat::HP)
+    return (dvs[member] >> dv_shift(stat)) & 0xF;
+  return ((dv(member, PokeStat::Attack) & 1) << 3) |
+         ((dv(member, PokeStat::Defense) & 1) << 2) |
+         ((dv(member, PokeStat::Speed) & 1) << 1) |
+         (dv(member, PokeStat::Special) & 1);
+}
+
+uint64_t TeamSpec::hash() const {
+  // Fold each word in with a 64-bit mix (splitmix64's finalizer)
+  uint64_t hash = size;
+  auto mix = [&hash](uint64_t word) {
+    hash ^= word + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ull;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBull;
+    hash ^= hash >> 31;
+  };
+  for (int i = 0; i < size; i++) {
+    mix(members[i]);
+    mix(dvs[i]);
+  }
+  return hash;
+}
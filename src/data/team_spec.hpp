@@ -0,0 +1,56 @@
+#pragma once
+#include "../core/pokemon.hpp"
+#include "game_data.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// A team of up to six by GameData ID, packed into 64 bytes so it can be
+// copied, compared and hashed as a plain value. Each member is one word:
+// species (bits 0-9), level (10-16) and four move slots (10 bits each from
+// bit 17), with its four DVs (Attack, Defense, Speed, Special; 4 bits
+// each) alongside. The team it describes is fresh: full HP and PP.
+struct TeamSpec {
+  static const int MAX_MEMBERS = 6;
+  static const uint32_t ID_LIMIT = 0x3FF; // IDs must be below; marks empty
+
+  std::array<uint64_t, MAX_MEMBERS> members{};
+  std::array<uint16_t, MAX_MEMBERS> dvs{};
+  uint8_t size = 0;
+
+  // False if the team is empty, too big, or uses an ID at or past
+  // ID_LIMIT; spec is left empty then
+  static bool from_team(const std::vector<Pokemon> &team, TeamSpec &spec);
+
+  // Appends the members to team; false if the spec names a species or
+  // move GameData does not have (team is left as it was)
+  bool to_team(std::vector<Pokemon> &team) const;
+
+  SpeciesId species(int member) const {
+    return static_cast<SpeciesId>(members[member] & ID_LIMIT);
+  }
+  int level(int member) const {
+    return static_cast<int>((members[member] >> 10) & 0x7F);
+  }
+  // NO_MOVE for an empty slot
+  MoveId move(int member, int slot) const {
+    uint32_t id = (members[member] >> (17 + 10 * slot)) & ID_LIMIT;
+    return id == ID_LIMIT ? NO_MOVE : static_cast<MoveId>(id);
+  }
+  int dv(int member, PokeStat stat) const; // 0-15; HP derived as in Gen 1
+
+  uint64_t hash() const;
+
+  bool operator==(const TeamSpec &other) const {
+    return size == other.size && members == other.members && dvs == other.dvs;
+  }
+  bool operator!=(const TeamSpec &other) const { return !(*this == other); }
+};
+
+static_assert(sizeof(TeamSpec) == 64, "TeamSpec should fill one cache line");
+
+struct TeamSpecHash {
+  size_t operator()(const TeamSpec &spec) const {
+    return static_cast<size_t>(spec.hash());
+  }
+};
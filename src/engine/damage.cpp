@@ -1,4 +1,5 @@
 #include "damage.hpp"
+#include "../core/instrument.hpp"
 #include "../core/rng.hpp"
 #include "../data/game_data.hpp"
 #include <cmath>
@@ -6,6 +7,7 @@
 
 DamageResult calculate_damage(const Pokemon &attacker, const Pokemon &defender,
                               const Move &move) {
+  BATTLER_COUNT(DamageCalcs);
   DamageResult result = {0, false, 1.0f};
 
   if (!move.data)
@@ -1,298 +1,522 @@
 #include "move_effects.hpp"
+#include "../core/battle_output.hpp"
 #include "../core/rng.hpp"
 #include "damage.hpp"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <sstream>
 
-EffectResult apply_move_effect(Pokemon &attacker, Pokemon &defender,
-                               const MoveData *move_data, Battle *battle) {
-  EffectResult result;
+namespace {
 
-  if (!move_data) {
-    result.message = "No move data!";
-    return result;
-  }
+void emit(BattleEventSink &events, BattleEventType type,
+          const Pokemon *pokemon = nullptr, int amount = 0) {
+  events.on_event(BattleEvent(type, pokemon, amount));
+}
 
-  const MoveEffect &effect = move_data->primary_effect;
+// Deals the damage of a move that is more than a plain hit, then its
+// recoil and drain, in that order
+void land_hit(Pokemon &attacker, Pokemon &defender, const Move &move,
+              BattleEventSink &events, int damage, int hits = 1,
+              int recoil = 0, int drain = 0) {
+  if (damage > 0) {
+    defender.take_damage(damage);
+    BattleEvent event(BattleEventType::Damage, &defender, damage);
+    event.hits = hits;
+    events.on_event(event);
+
+    // Record damage for Counter mechanic
+    defender.record_damage_taken(damage, move.data);
+  }
 
-  switch (effect.type) {
-  case MoveEffectType::Damage:
-  case MoveEffectType::Recoil:
-  case MoveEffectType::Drain:
-  case MoveEffectType::HighCritRatio: {
-    // Calculate damage normally
-    Move temp_move(move_data);
-    DamageResult dmg_result = calculate_damage(attacker, defender, temp_move);
-    result.damage = dmg_result.damage;
-    result.success = true;
-
-    // Handle recoil
-    if (effect.type == MoveEffectType::Recoil && result.damage > 0) {
-      result.recoil_damage =
-          calculate_recoil_damage(result.damage, effect.recoil_percent);
-    }
+  if (recoil > 0) {
+    attacker.take_damage(recoil);
+    emit(events, BattleEventType::Recoil, &attacker, recoil);
+    if (attacker.hp() <= 0)
+      emit(events, BattleEventType::FaintedFromRecoil, &attacker);
+  }
 
-    // Handle drain
-    if (effect.type == MoveEffectType::Drain && result.damage > 0) {
-      result.drain_amount =
-          calculate_drain_amount(result.damage, effect.drain_percent);
-    }
-    break;
+  if (drain > 0) {
+    attacker.heal(drain);
+    emit(events, BattleEventType::Drained, &attacker, drain);
   }
+}
 
-  case MoveEffectType::MultiHit: {
-    int num_hits = calculate_multi_hit_count(effect.min_hits, effect.max_hits);
-    result.hits = num_hits;
-    result.success = true;
+// Damage, None
+bool hit(Pokemon &attacker, Pokemon &defender, const Move &move,
+         const CompiledEffect &, BattleEventSink &events) {
+  DamageResult result = calculate_damage(attacker, defender, move);
 
-    // Calculate damage for each hit
-    Move temp_move(move_data);
-    for (int i = 0; i < num_hits; i++) {
-      DamageResult dmg_result = calculate_damage(attacker, defender, temp_move);
-      result.damage += dmg_result.damage;
-    }
-    break;
+  if (result.type_effectiveness == 0.0f) {
+    emit(events, BattleEventType::NoEffect, &defender);
+    return false;
   }
 
-  case MoveEffectType::TwoHit: {
-    result.hits = 2;
-    result.success = true;
+  defender.take_damage(result.damage);
+  emit(events, BattleEventType::Damage, &defender, result.damage);
 
-    Move temp_move(move_data);
-    for (int i = 0; i < 2; i++) {
-      DamageResult dmg_result = calculate_damage(attacker, defender, temp_move);
-      result.damage += dmg_result.damage;
-    }
-    break;
-  }
+  // Record damage for Counter mechanic
+  defender.record_damage_taken(result.damage, move.data);
 
-  case MoveEffectType::OHKO: {
-    if (check_ohko(attacker, defender)) {
-      result.damage = defender.hp();
-      result.ohko = true;
-      result.success = true;
-      result.message = "It's a one-hit KO!";
-    } else {
-      result.success = false;
-      result.message = "But it failed!";
-    }
-    break;
-  }
+  // Store damage for Bide if active
+  defender.store_bide_damage(result.damage);
 
-  case MoveEffectType::FixedDamage: {
-    result.damage = calculate_fixed_damage(attacker, effect.fixed_damage);
-    result.success = true;
-    break;
-  }
+  if (result.critical)
+    emit(events, BattleEventType::CriticalHit);
 
-  case MoveEffectType::StatChange: {
-    apply_stat_change(
-        effect.stat_change.target == EffectTarget::Self ? attacker : defender,
-        effect.stat_change);
-    result.success = true;
-    break;
-  }
+  if (result.type_effectiveness > 1.0f)
+    emit(events, BattleEventType::SuperEffective);
+  else if (result.type_effectiveness < 1.0f && result.type_effectiveness > 0.0f)
+    emit(events, BattleEventType::NotVeryEffective);
+  return true;
+}
 
-  case MoveEffectType::StatusInflict: {
-    Pokemon &target = effect.status_inflict.target == EffectTarget::Self
-                          ? attacker
-                          : defender;
-    result.success = apply_status_effect(target, effect.status_inflict.status);
-    break;
+// Recoil, Drain, HighCritRatio
+bool hit_with_side_effect(Pokemon &attacker, Pokemon &defender,
+                          const Move &move, const CompiledEffect &effect,
+                          BattleEventSink &events) {
+  int damage = calculate_damage(attacker, defender, move).damage;
+  int recoil = 0;
+  int drain = 0;
+  if (effect.kind == MoveEffectType::Recoil && damage > 0)
+    recoil = calculate_recoil_damage(damage, effect.percent);
+  if (effect.kind == MoveEffectType::Drain && damage > 0)
+    drain = calculate_drain_amount(damage, effect.percent);
+  land_hit(attacker, defender, move, events, damage, 1, recoil, drain);
+  return true;
+}
+
+bool multi_hit(Pokemon &attacker, Pokemon &defender, const Move &move,
+               const CompiledEffect &effect, BattleEventSink &events) {
+  int hits = calculate_multi_hit_count(effect.min_hits, effect.max_hits);
+  int damage = 0;
+  for (int i = 0; i < hits; i++)
+    damage += calculate_damage(attacker, defender, move).damage;
+  land_hit(attacker, defender, move, events, damage, hits);
+  return true;
+}
+
+bool two_hit(Pokemon &attacker, Pokemon &defender, const Move &move,
+             const CompiledEffect &, BattleEventSink &events) {
+  int damage = 0;
+  for (int i = 0; i < 2; i++)
+    damage += calculate_damage(attacker, defender, move).damage;
+  land_hit(attacker, defender, move, events, damage, 2);
+  return true;
+}
+
+bool ohko(Pokemon &attacker, Pokemon &defender, const Move &move,
+          const CompiledEffect &, BattleEventSink &events) {
+  if (!check_ohko(attacker, defender)) {
+    emit(events, BattleEventType::Failed);
+    return true;
   }
+  land_hit(attacker, defender, move, events, defender.hp());
+  emit(events, BattleEventType::OneHitKO, &defender);
+  return true;
+}
 
-  case MoveEffectType::Heal: {
-    int heal_amount = (attacker.max_hp() * effect.heal_percent) / 100;
-    // Note: Would need to add a heal method to Pokemon
-    result.success = true;
-    result.message = attacker.name() + " recovered HP!";
-    break;
+bool fixed_damage(Pokemon &attacker, Pokemon &defender, const Move &move,
+                  const CompiledEffect &effect, BattleEventSink &events) {
+  land_hit(attacker, defender, move, events,
+           calculate_fixed_damage(attacker, defender,
+                                  FixedDamageData(effect.fixed,
+                                                  effect.fixed_value)));
+  return true;
+}
+
+bool stat_change(Pokemon &attacker, Pokemon &defender, const Move &,
+                 const CompiledEffect &effect, BattleEventSink &events) {
+  apply_stat_change(effect.target == EffectTarget::Self ? attacker : defender,
+                    StatChange(effect.stat, effect.stages, effect.target,
+                               effect.chance),
+                    events);
+  return true;
+}
+
+bool status_inflict(Pokemon &attacker, Pokemon &defender, const Move &,
+                    const CompiledEffect &effect, BattleEventSink &events) {
+  apply_status_effect(effect.target == EffectTarget::Self ? attacker
+                                                           : defender,
+                      effect.status, events);
+  return true;
+}
+
+bool heal(Pokemon &attacker, Pokemon &, const Move &,
+          const CompiledEffect &effect, BattleEventSink &events) {
+  // Gen 1: Recover and Soft-Boiled fail at full HP
+  if (attacker.hp() >= attacker.max_hp()) {
+    emit(events, BattleEventType::Failed);
+    return true;
   }
+  int amount = attacker.max_hp() * effect.percent / 100;
+  attacker.heal(amount);
+  emit(events, BattleEventType::Recovered, &attacker, amount);
+  return true;
+}
 
-  case MoveEffectType::Confusion: {
-    result.success = apply_volatile_effect(defender, VolatileStatus::Confusion);
-    if (result.success) {
-      result.message = defender.name() + " became confused!";
-    }
-    break;
+bool confusion(Pokemon &, Pokemon &defender, const Move &,
+               const CompiledEffect &, BattleEventSink &events) {
+  if (apply_volatile_effect(defender, VolatileStatus::Confusion))
+    emit(events, BattleEventType::Confused, &defender);
+  return true;
+}
+
+bool flinch(Pokemon &, Pokemon &defender, const Move &,
+            const CompiledEffect &effect, BattleEventSink &events) {
+  int roll = rng_int(1, 100);
+  if (roll <= effect.chance &&
+      apply_volatile_effect(defender, VolatileStatus::Flinch))
+    emit(events, BattleEventType::Flinched, &defender);
+  return true;
+}
+
+bool counter(Pokemon &attacker, Pokemon &defender, const Move &move,
+             const CompiledEffect &, BattleEventSink &events) {
+  const auto &turn_data = defender.get_turn_data();
+
+  // Counter fails if opponent didn't move first or no damage taken
+  if (!turn_data.moved_first || turn_data.damage_taken == 0) {
+    emit(events, BattleEventType::Failed);
+    return true;
   }
 
-  case MoveEffectType::Flinch: {
-    // Check flinch chance
-    int roll = rng_int(1, 100);
-    if (roll <= effect.flinch_chance) {
-      result.success = apply_volatile_effect(defender, VolatileStatus::Flinch);
-      if (result.success) {
-        result.message = defender.name() + " flinched!";
-      }
+  // Gen 1: Counter only works on Normal/Fighting type moves
+  if (turn_data.last_move_hit_by) {
+    PokeType move_type = turn_data.last_move_hit_by->type;
+    if (move_type != PokeType::Normal && move_type != PokeType::Fighting) {
+      emit(events, BattleEventType::Failed);
+      return true;
     }
-    break;
   }
 
-  case MoveEffectType::Counter: {
-    const auto &turn_data = defender.get_turn_data();
+  // Deal 2x damage taken
+  land_hit(attacker, defender, move, events, turn_data.damage_taken * 2);
+  return true;
+}
 
-    // Counter fails if opponent didn't move first or no damage taken
-    if (!turn_data.moved_first || turn_data.damage_taken == 0) {
-      result.success = false;
-      result.message = "But it failed!";
-      break;
-    }
+bool two_turn(Pokemon &attacker, Pokemon &defender, const Move &move,
+              const CompiledEffect &, BattleEventSink &events) {
+  if (attacker.volatile_status() == VolatileStatus::Charging) {
+    // Turn 2: Execute attack
+    int damage = calculate_damage(attacker, defender, move).damage;
+    attacker.clear_volatile_status();
+    land_hit(attacker, defender, move, events, damage);
+  } else {
+    // Turn 1: Charge
+    attacker.apply_volatile_status(VolatileStatus::Charging);
+    BattleEvent event(BattleEventType::Charging, &attacker);
+    event.move = move.data;
+    events.on_event(event);
+  }
+  return true;
+}
 
-    // Gen 1: Counter only works on Normal/Fighting type moves
-    if (turn_data.last_move_hit_by) {
-      PokeType move_type = turn_data.last_move_hit_by->type;
-      if (move_type != PokeType::Normal && move_type != PokeType::Fighting) {
-        result.success = false;
-        result.message = "But it failed!";
-        break;
-      }
-    }
+bool rage(Pokemon &attacker, Pokemon &defender, const Move &move,
+          const CompiledEffect &, BattleEventSink &events) {
+  int damage = calculate_damage(attacker, defender, move).damage;
 
-    // Deal 2x damage taken
-    result.damage = turn_data.damage_taken * 2;
-    result.success = true;
-    break;
-  }
+  // Lock into Rage (until switched out)
+  attacker.lock_into_move(move.data, 999);
+  land_hit(attacker, defender, move, events, damage);
+  return true;
+}
 
-  case MoveEffectType::TwoTurn: {
-    if (attacker.volatile_status() == VolatileStatus::Charging) {
-      // Turn 2: Execute attack
-      Move temp_move(move_data);
-      DamageResult dmg = calculate_damage(attacker, defender, temp_move);
-      result.damage = dmg.damage;
-      result.success = true;
-      attacker.clear_volatile_status();
-    } else {
-      // Turn 1: Charge
-      attacker.apply_volatile_status(VolatileStatus::Charging);
-      result.success = true;
-      result.message = effect.two_turn.charge_message;
-    }
-    break;
+bool disable(Pokemon &, Pokemon &defender, const Move &,
+             const CompiledEffect &, BattleEventSink &events) {
+  int move_count = defender.move_count();
+  if (move_count == 0) {
+    emit(events, BattleEventType::Failed);
+    return true;
   }
 
-  case MoveEffectType::Rage: {
-    // Deal damage
-    Move temp_move(move_data);
-    DamageResult dmg = calculate_damage(attacker, defender, temp_move);
-    result.damage = dmg.damage;
+  int random_move = rng_int(0, move_count - 1);
+  int duration = rng_int(1, 7); // Gen 1: 1-7 turns
+  defender.disable_move(random_move, duration);
+  emit(events, BattleEventType::Disabled, &defender);
+  return true;
+}
 
-    // Lock into Rage (until switched out)
-    attacker.lock_into_move(move_data, 999);
-    result.success = true;
-    break;
+bool bide(Pokemon &attacker, Pokemon &defender, const Move &move,
+          const CompiledEffect &, BattleEventSink &events) {
+  if (attacker.is_bide_active()) {
+    // Bide is ending - unleash stored damage
+    land_hit(attacker, defender, move, events, attacker.release_bide());
+    emit(events, BattleEventType::UnleashedEnergy, &attacker);
+  } else {
+    // Start Bide - store damage for 2-3 turns
+    int turns = rng_int(2, 3); // Gen 1: 2-3 turns
+    attacker.start_bide(turns);
+    emit(events, BattleEventType::StoringEnergy, &attacker);
   }
+  return true;
+}
 
-  case MoveEffectType::Disable: {
-    if (!battle) {
-      result.success = false;
-      break;
-    }
+bool reflect(Pokemon &attacker, Pokemon &, const Move &,
+             const CompiledEffect &, BattleEventSink &events) {
+  attacker.activate_reflect(5); // Gen 1: Reflect lasts 5 turns
+  emit(events, BattleEventType::Reflect, &attacker);
+  return true;
+}
+
+bool light_screen(Pokemon &attacker, Pokemon &, const Move &,
+                  const CompiledEffect &, BattleEventSink &events) {
+  attacker.activate_light_screen(5); // Gen 1: Light Screen lasts 5 turns
+  emit(events, BattleEventType::LightScreen, &attacker);
+  return true;
+}
+
+bool haze(Pokemon &attacker, Pokemon &defender, const Move &,
+          const CompiledEffect &, BattleEventSink &events) {
+  attacker.reset_stat_stages();
+  defender.reset_stat_stages();
+  emit(events, BattleEventType::Haze);
+  return true;
+}
+
+bool not_implemented(Pokemon &, Pokemon &, const Move &,
+                     const CompiledEffect &, BattleEventSink &events) {
+  emit(events, BattleEventType::NotImplemented);
+  return true;
+}
 
-    int move_count = defender.move_count();
-    if (move_count == 0) {
-      result.success = false;
-      result.message = "But it failed!";
+// Sums a handler's events into an EffectResult for apply_move_effect
+class EffectCollector : public BattleEventSink {
+public:
+  EffectResult result;
+
+  void on_event(const BattleEvent &event) override {
+    switch (event.type) {
+    case BattleEventType::Damage:
+      result.damage += event.amount;
+      result.hits = event.hits;
+      break;
+    case BattleEventType::Recoil:
+      result.recoil_damage = event.amount;
+      break;
+    case BattleEventType::Drained:
+      result.drain_amount = event.amount;
+      break;
+    case BattleEventType::OneHitKO:
+      result.ohko = true;
+      set_message(event);
+      break;
+    case BattleEventType::Failed:
+    case BattleEventType::NotImplemented:
+      failed_ = true;
+      set_message(event);
+      break;
+    case BattleEventType::NoEffect:
+    case BattleEventType::CriticalHit:
+    case BattleEventType::SuperEffective:
+    case BattleEventType::NotVeryEffective:
+    case BattleEventType::StatChanged:
+    case BattleEventType::StatusInflicted:
+    case BattleEventType::FaintedFromRecoil:
+      break;
+    default:
+      set_message(event);
       break;
     }
-
-    int random_move = rng_int(0, move_count - 1);
-    int duration = rng_int(1, 7); // Gen 1: 1-7 turns
-    defender.disable_move(random_move, duration);
-    result.success = true;
-    result.message = "Disabled a move!";
-    break;
+    result.success = !failed_;
   }
 
-  case MoveEffectType::Bide: {
-    if (attacker.is_bide_active()) {
-      // Bide is ending - unleash stored damage
-      result.damage = attacker.release_bide();
-      result.success = true;
-      result.message = attacker.name() + " unleashed energy!";
-    } else {
-      // Start Bide - store damage for 2-3 turns
-      int turns = rng_int(2, 3); // Gen 1: 2-3 turns
-      attacker.start_bide(turns);
-      result.success = true;
-      result.message = attacker.name() + " is storing energy!";
-    }
-    break;
+private:
+  bool failed_ = false;
+
+  void set_message(const BattleEvent &event) {
+    std::ostringstream text;
+    write_event(text, event);
+    result.message = text.str();
+    if (!result.message.empty() && result.message.back() == '\n')
+      result.message.pop_back();
   }
+};
 
-  case MoveEffectType::Reflect: {
-    attacker.activate_reflect(5); // Gen 1: Reflect lasts 5 turns
-    result.success = true;
-    result.message = attacker.name() + "'s Reflect raised physical defense!";
-    break;
+} // namespace
+
+MoveHandler resolve_move_handler(MoveEffectType type) {
+  switch (type) {
+  case MoveEffectType::None:
+  case MoveEffectType::Damage:
+    return hit;
+  case MoveEffectType::Recoil:
+  case MoveEffectType::Drain:
+  case MoveEffectType::HighCritRatio:
+    return hit_with_side_effect;
+  case MoveEffectType::MultiHit:
+    return multi_hit;
+  case MoveEffectType::TwoHit:
+    return two_hit;
+  case MoveEffectType::OHKO:
+    return ohko;
+  case MoveEffectType::FixedDamage:
+    return fixed_damage;
+  case MoveEffectType::StatChange:
+    return stat_change;
+  case MoveEffectType::StatusInflict:
+    return status_inflict;
+  case MoveEffectType::Heal:
+    return heal;
+  case MoveEffectType::Confusion:
+    return confusion;
+  case MoveEffectType::Flinch:
+    return flinch;
+  case MoveEffectType::Counter:
+    return counter;
+  case MoveEffectType::TwoTurn:
+    return two_turn;
+  case MoveEffectType::Rage:
+    return rage;
+  case MoveEffectType::Disable:
+    return disable;
+  case MoveEffectType::Bide:
+    return bide;
+  case MoveEffectType::Reflect:
+    return reflect;
+  case MoveEffectType::LightScreen:
+    return light_screen;
+  case MoveEffectType::Haze:
+    return haze;
+  default:
+    return not_implemented;
   }
+}
 
-  case MoveEffectType::LightScreen: {
-    attacker.activate_light_screen(5); // Gen 1: Light Screen lasts 5 turns
-    result.success = true;
-    result.message =
-        attacker.name() + "'s Light Screen raised special defense!";
+CompiledEffect compile_move_effect(const MoveEffect &effect) {
+  CompiledEffect compiled;
+  compiled.kind = effect.type;
+  switch (effect.type) {
+  case MoveEffectType::StatChange:
+    compiled.stat = effect.stat_change.stat;
+    compiled.stages = static_cast<int8_t>(effect.stat_change.stages);
+    compiled.target = effect.stat_change.target;
+    compiled.chance = static_cast<uint8_t>(effect.stat_change.chance);
+    break;
+  case MoveEffectType::StatusInflict:
+    compiled.status = effect.status_inflict.status;
+    compiled.target = effect.status_inflict.target;
+    compiled.chance = static_cast<uint8_t>(effect.status_inflict.chance);
+    break;
+  case MoveEffectType::Recoil:
+    compiled.percent = static_cast<uint8_t>(effect.recoil_percent);
+    break;
+  case MoveEffectType::Drain:
+    compiled.percent = static_cast<uint8_t>(effect.drain_percent);
+    break;
+  case MoveEffectType::Heal:
+    compiled.percent = static_cast<uint8_t>(effect.heal_percent);
+    break;
+  case MoveEffectType::MultiHit:
+    compiled.min_hits = static_cast<uint8_t>(effect.min_hits);
+    compiled.max_hits = static_cast<uint8_t>(effect.max_hits);
+    break;
+  case MoveEffectType::FixedDamage:
+    compiled.fixed = effect.fixed_damage.type;
+    compiled.fixed_value = static_cast<int16_t>(effect.fixed_damage.value);
+    break;
+  case MoveEffectType::Flinch:
+    compiled.chance = static_cast<uint8_t>(effect.flinch_chance);
+    break;
+  default:
     break;
   }
+  return compiled;
+}
 
-  case MoveEffectType::Haze: {
-    attacker.reset_stat_stages();
-    defender.reset_stat_stages();
-    result.success = true;
-    result.message = "All stat changes were eliminated!";
-    break;
+CompiledEffect compile_secondary_effect(const SecondaryEffect *secondary) {
+  if (!secondary) {
+    CompiledEffect none;
+    none.kind = MoveEffectType::None;
+    return none;
   }
+  CompiledEffect compiled = compile_move_effect(secondary->effect);
+  compiled.chance = static_cast<uint8_t>(secondary->chance);
+  return compiled;
+}
 
-  default:
-    result.message = "Effect not yet implemented!";
-    break;
+void compile_move(MoveData &move) {
+  move.handler = resolve_move_handler(move.primary_effect.type);
+  move.effect = compile_move_effect(move.primary_effect);
+  move.secondary = compile_secondary_effect(move.secondary_effect.get());
+}
+
+EffectResult apply_move_effect(Pokemon &attacker, Pokemon &defender,
+                               const MoveData *move_data, Battle *battle) {
+  EffectResult result;
+
+  if (!move_data) {
+    result.message = "No move data!";
+    return result;
   }
 
-  return result;
+  // Disable needs a battle to pick the move from
+  if (move_data->primary_effect.type == MoveEffectType::Disable && !battle)
+    return result;
+
+  // Moves that were never added to GameData are compiled for the call
+  EffectCollector collector;
+  Move move(move_data);
+  if (move_data->handler) {
+    move_data->handler(attacker, defender, move, move_data->effect, collector);
+  } else {
+    resolve_move_handler(move_data->primary_effect.type)(
+        attacker, defender, move,
+        compile_move_effect(move_data->primary_effect), collector);
+  }
+  return collector.result;
 }
 
 void apply_secondary_effect(Pokemon &attacker, Pokemon &defender,
-                            const SecondaryEffect &effect) {
-  // Check if secondary effect triggers
+                            const CompiledEffect &effect,
+                            BattleEventSink &events) {
+  if (effect.kind == MoveEffectType::None)
+    return;
   int roll = rng_int(1, 100);
-  if (roll <= effect.chance) {
-    apply_move_effect(attacker, defender, nullptr,
-                      nullptr); // Would need to pass effect data differently
+  if (roll > effect.chance)
+    return;
+
+  // Nothing is printed when it does not take (the target already has a
+  // status, say): the move itself worked
+  Pokemon &target = effect.target == EffectTarget::Self ? attacker : defender;
+  switch (effect.kind) {
+  case MoveEffectType::StatChange: {
+    target.modify_stat_stage(effect.stat, effect.stages);
+    BattleEvent event(BattleEventType::StatChanged, &target, effect.stages);
+    event.stat = effect.stat;
+    events.on_event(event);
+    break;
+  }
+  case MoveEffectType::StatusInflict:
+    if (target.apply_status(effect.status)) {
+      BattleEvent event(BattleEventType::StatusInflicted, &target);
+      event.status = effect.status;
+      events.on_event(event);
+    }
+    break;
+  case MoveEffectType::Confusion:
+    if (apply_volatile_effect(defender, VolatileStatus::Confusion))
+      emit(events, BattleEventType::Confused, &defender);
+    break;
+  case MoveEffectType::Flinch:
+    if (apply_volatile_effect(defender, VolatileStatus::Flinch))
+      emit(events, BattleEventType::Flinched, &defender);
+    break;
+  default:
+    break; // compile_moves only lets the four above through
   }
 }
 
-bool apply_status_effect(Pokemon &target, PokeStatus status) {
+bool apply_status_effect(Pokemon &target, PokeStatus status,
+                         BattleEventSink &events) {
   bool success = target.apply_status(status);
 
   if (success) {
-    std::string status_name;
-    switch (status) {
-    case PokeStatus::Burn:
-      status_name = "burned";
-      break;
-    case PokeStatus::Freeze:
-      status_name = "frozen";
-      break;
-    case PokeStatus::Paralysis:
-      status_name = "paralyzed";
-      break;
-    case PokeStatus::Poison:
-      status_name = "poisoned";
-      break;
-    case PokeStatus::Sleep:
-      status_name = "fell asleep";
-      break;
-    case PokeStatus::Toxic:
-      status_name = "badly poisoned";
-      break;
-    default:
-      status_name = "affected";
-      break;
-    }
-    std::cout << target.name() << " was " << status_name << "!\n";
+    BattleEvent event(BattleEventType::StatusInflicted, &target);
+    event.status = status;
+    events.on_event(event);
   } else {
-    std::cout << "But it failed!\n";
+    emit(events, BattleEventType::Failed);
   }
 
   return success;
@@ -303,7 +527,8 @@ bool apply_volatile_effect(Pokemon &target, VolatileStatus vstatus) {
   return true;
 }
 
-void apply_stat_change(Pokemon &target, const StatChange &change) {
+void apply_stat_change(Pokemon &target, const StatChange &change,
+                       BattleEventSink &events) {
   // Check chance
   int roll = rng_int(1, 100);
   if (roll > change.chance) {
@@ -312,38 +537,9 @@ void apply_stat_change(Pokemon &target, const StatChange &change) {
 
   target.modify_stat_stage(change.stat, change.stages);
 
-  std::string stat_name;
-  switch (change.stat) {
-  case PokeStat::Attack:
-    stat_name = "Attack";
-    break;
-  case PokeStat::Defense:
-    stat_name = "Defense";
-    break;
-  case PokeStat::Speed:
-    stat_name = "Speed";
-    break;
-  case PokeStat::Special:
-    stat_name = "Special";
-    break;
-  default:
-    stat_name = "stat";
-    break;
-  }
-
-  if (change.stages > 0) {
-    std::cout << target.name() << "'s " << stat_name;
-    if (change.stages == 1)
-      std::cout << " rose!\n";
-    else
-      std::cout << " rose sharply!\n";
-  } else if (change.stages < 0) {
-    std::cout << target.name() << "'s " << stat_name;
-    if (change.stages == -1)
-      std::cout << " fell!\n";
-    else
-      std::cout << " fell sharply!\n";
-  }
+  BattleEvent event(BattleEventType::StatChanged, &target, change.stages);
+  event.stat = change.stat;
+  events.on_event(event);
 }
 
 int calculate_multi_hit_count(int min_hits, int max_hits) {
@@ -382,7 +578,7 @@ bool check_ohko(const Pokemon &attacker, const Pokemon &defender) {
   return roll <= accuracy;
 }
 
-int calculate_fixed_damage(const Pokemon &attacker,
+int calculate_fixed_damage(const Pokemon &attacker, const Pokemon &defender,
                            const FixedDamageData &data) {
   switch (data.type) {
   case FixedDamageData::Type::Level:
@@ -390,36 +586,36 @@ int calculate_fixed_damage(const Pokemon &attacker,
   case FixedDamageData::Type::Constant:
     return data.value;
   case FixedDamageData::Type::HalfHP:
-    // Would need target HP, not implemented here
-    return 0;
+    // Super Fang: half the target's current HP, at least 1
+    return std::max(1, defender.hp() / 2);
   default:
     return 0;
   }
 }
 
-bool can_move_with_status(Pokemon &pokemon, std::string &message) {
+bool can_move_with_status(Pokemon &pokemon, std::pmr::string &message) {
   PokeStatus status = pokemon.status();
 
   switch (status) {
   case PokeStatus::Sleep:
     // Check if still asleep (would need sleep counter in Pokemon)
-    message = pokemon.name() + " is fast asleep!";
+    message.assign(pokemon.name()).append(" is fast asleep!");
     return false;
 
   case PokeStatus::Freeze:
     // 20% chance to thaw in Gen 1
     if (rng_int(1, 100) <= 20) {
-      message = pokemon.name() + " thawed out!";
+      message.assign(pokemon.name()).append(" thawed out!");
       pokemon.apply_status(PokeStatus::None);
       return true;
     }
-    message = pokemon.name() + " is frozen solid!";
+    message.assign(pokemon.name()).append(" is frozen solid!");
     return false;
 
   case PokeStatus::Paralysis:
     // 25% chance to be fully paralyzed
     if (rng_int(1, 100) <= 25) {
-      message = pokemon.name() + " is fully paralyzed!";
+      message.assign(pokemon.name()).append(" is fully paralyzed!");
       return false;
     }
     return true;
@@ -439,23 +635,23 @@ void apply_end_of_turn_status_damage(Pokemon &pokemon) {
     if (damage < 1)
       damage = 1;
     pokemon.take_damage(damage);
-    std::cout << pokemon.name() << " is hurt by ";
+    battle_out() << pokemon.name() << " is hurt by ";
     if (status == PokeStatus::Burn)
-      std::cout << "its burn";
+      battle_out() << "its burn";
     else
-      std::cout << "poison";
-    std::cout << "! (" << damage << " damage)\n";
+      battle_out() << "poison";
+    battle_out() << "! (" << damage << " damage)\n";
     break;
   }
 
   case PokeStatus::Toxic: {
-    // Toxic damage increases each turn
-    // Would need toxic_counter from Pokemon
+    // N/16 of max HP on the Nth turn since it was inflicted
     int damage = pokemon.max_hp() / 16;
     if (damage < 1)
       damage = 1;
+    damage *= pokemon.advance_toxic_counter();
     pokemon.take_damage(damage);
-    std::cout << pokemon.name() << " is hurt by poison! (" << damage
+    battle_out() << pokemon.name() << " is hurt by poison! (" << damage
               << " damage)\n";
     break;
   }
@@ -1,6 +1,8 @@
 #pragma once
+#include "../core/battle_event.hpp"
 #include "../core/move.hpp"
 #include "../core/pokemon.hpp"
+#include <memory_resource>
 #include <string>
 
 // Forward declaration
@@ -21,25 +23,31 @@ struct EffectResult {
         ohko(false), message("") {}
 };
 
-// Apply a move's primary effect
+// Run a move's primary effect outside a battle and sum up what it did.
+// Damage is dealt to defender as in a battle, but nothing is printed.
+// Battles call the move's handler directly (see resolve_move_handler).
 EffectResult apply_move_effect(Pokemon &attacker, Pokemon &defender,
                                const MoveData *move_data, Battle *battle);
 
-// Apply secondary effects (chance-based)
+// Roll a move's compiled secondary effect (see compile_secondary_effect)
+// and apply it if the roll comes in; does nothing for kind None
 void apply_secondary_effect(Pokemon &attacker, Pokemon &defender,
-                            const SecondaryEffect &effect);
+                            const CompiledEffect &effect,
+                            BattleEventSink &events);
 
 // Specific effect handlers
-bool apply_status_effect(Pokemon &target, PokeStatus status);
+bool apply_status_effect(Pokemon &target, PokeStatus status,
+                         BattleEventSink &events);
 bool apply_volatile_effect(Pokemon &target, VolatileStatus vstatus);
-void apply_stat_change(Pokemon &target, const StatChange &change);
+void apply_stat_change(Pokemon &target, const StatChange &change,
+                       BattleEventSink &events);
 int calculate_multi_hit_count(int min_hits, int max_hits);
 int calculate_recoil_damage(int damage_dealt, int recoil_percent);
 int calculate_drain_amount(int damage_dealt, int drain_percent);
 bool check_ohko(const Pokemon &attacker, const Pokemon &defender);
-int calculate_fixed_damage(const Pokemon &attacker,
+int calculate_fixed_damage(const Pokemon &attacker, const Pokemon &defender,
                            const FixedDamageData &data);
 
 // Status condition checks
-bool can_move_with_status(Pokemon &pokemon, std::string &message);
+bool can_move_with_status(Pokemon &pokemon, std::pmr::string &message);
 void apply_end_of_turn_status_damage(Pokemon &pokemon);
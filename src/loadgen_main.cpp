@@ -0,0 +1,57 @@
+#include "client/load_generator.hpp"
+#include "data/loader.hpp"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+// Usage: battler_loadgen [host] [port] [connections] [seconds] [ai] [threads]
+//   ai is random, gen1 or mixed
+//   e.g. battler_loadgen 127.0.0.1 8888 2000 60 mixed 2
+// Point it at a server running ranked matchmaking (mode 3), which keeps
+// pairing the bots and disconnects them after each battle so they requeue.
+int main(int argc, char **argv) {
+  LoadGenConfig config;
+  if (argc > 1)
+    config.host = argv[1];
+  if (argc > 2)
+    config.port = std::atoi(argv[2]);
+  if (argc > 3)
+    config.connections = std::max(1, std::atoi(argv[3]));
+  if (argc > 4)
+    config.duration_seconds = std::max(1, std::atoi(argv[4]));
+  if (argc > 5)
+    config.ai = argv[5];
+  if (argc > 6)
+    config.threads = std::max(1, std::atoi(argv[6]));
+
+  std::cout << "=== Pokemon Gen 1 Battler - Load Generator ===\n\n";
+
+#ifndef _WIN32
+  // Thousands of sockets need more than the default descriptor limit
+  rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+  std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+  // Bots rebuild Pokemon from the server's text to feed the AI
+  load_game_data("src/data/species.json", "src/data/moves.json",
+                 "src/data/type_chart.json");
+
+  std::cout << "Connecting " << config.connections << " " << config.ai
+            << " bots to " << config.host << ":" << config.port << " for "
+            << config.duration_seconds << "s on " << config.threads
+            << " thread(s)...\n";
+
+  LoadGenerator generator(config);
+  LoadGenReport report = generator.run();
+  report.print(std::cout);
+  return 0;
+}
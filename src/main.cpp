@@ -9,9 +9,8 @@
 int main() {
   std::cout << "Pokemon Gen 1 Battler\n";
 
-  load_species("src/data/species.json");
-  load_moves("src/data/moves.json");
-  load_type_chart("src/data/type_chart.json");
+  load_game_data("src/data/species.json", "src/data/moves.json",
+                 "src/data/type_chart.json");
 
   // Get all available species and moves
   auto all_species = GameData::getInstance().getAllSpeciesNames();
@@ -0,0 +1,157 @@
+#include "core/timeline.hpp"
+#include "data/loader.hpp"
+#include "server/battle_executor.hpp"
+#include "server/matchup_matrix.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+bool take_value(const std::string &arg, const char *name, std::string &value) {
+  std::string prefix = std::string(name) + "=";
+  if (arg.rfind(prefix, 0) != 0)
+    return false;
+  value = arg.substr(prefix.size());
+  return true;
+}
+
+} // namespace
+
+// Usage: battler_matrix [--teams=FILE] [--games=N] [--threads=N] [--seed=N]
+//                       [--tile=N] [--level=N] [--engine=ai|auto]
+//                       [--results=FILE] [--csv=FILE] [--pin]
+//                       [--chrome-trace=FILE]
+//   e.g. battler_matrix --games=100 --results=dex.bin --csv=dex.csv
+// Plays every ordered pair of teams --games times (default 10) on all
+// cores and writes the K x K win-rate matrix. Without --teams the teams
+// are every species alone at --level (default 50) with its fixed moveset;
+// a teams file has one team per line (see parse_matrix_team).
+//
+// Results stream to --results (default matrix.bin) one tile at a time.
+// Running the same command again after an interruption resumes from it,
+// and once it is complete only rewrites --csv (default matrix.csv).
+// --engine=auto plays AutoBattle instead of Gen1AI on the full engine.
+// --pin pins each worker to a CPU, filling one NUMA node before the next.
+int main(int argc, char **argv) {
+  std::unique_ptr<timeline::ChromeTraceFile> chrome_trace;
+  MatrixConfig config;
+  std::string teams_path;
+  std::string results_path = "matrix.bin";
+  std::string csv_path = "matrix.csv";
+  unsigned threads = 0;
+  WorkerPlacement placement = WorkerPlacement::Floating;
+  int level = 50;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    std::string value;
+    if (take_value(arg, "--teams", value)) {
+      teams_path = value;
+    } else if (take_value(arg, "--games", value)) {
+      config.games = std::max(1, std::atoi(value.c_str()));
+    } else if (take_value(arg, "--threads", value)) {
+      threads = static_cast<unsigned>(std::max(0, std::atoi(value.c_str())));
+    } else if (take_value(arg, "--seed", value)) {
+      config.seed = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+    } else if (take_value(arg, "--tile", value)) {
+      config.tile = std::max(1, std::atoi(value.c_str()));
+    } else if (take_value(arg, "--level", value)) {
+      level = std::min(100, std::max(1, std::atoi(value.c_str())));
+    } else if (take_value(arg, "--engine", value) &&
+               (value == "ai" || value == "auto")) {
+      config.engine = value == "ai" ? MatrixEngine::Ai : MatrixEngine::Auto;
+    } else if (take_value(arg, "--results", value)) {
+      results_path = value;
+    } else if (take_value(arg, "--csv", value)) {
+      csv_path = value;
+    } else if (arg == "--pin") {
+      placement = WorkerPlacement::Pinned;
+    } else if (take_value(arg, "--chrome-trace", value)) {
+      chrome_trace.reset(new timeline::ChromeTraceFile(value));
+    } else {
+      std::cerr << "Unknown option " << arg << "\n";
+      return 1;
+    }
+  }
+
+  std::cout << "=== Pokemon Battle Simulator - Matchup Matrix ===\n\n";
+
+  load_game_data("src/data/species.json", "src/data/moves.json",
+                 "src/data/type_chart.json");
+
+  std::vector<MatrixTeam> teams;
+  if (teams_path.empty()) {
+    teams = single_species_teams(level);
+  } else {
+    std::string error;
+    if (!load_matrix_teams(teams_path, teams, error)) {
+      std::cerr << error << "\n";
+      return 1;
+    }
+  }
+  if (teams.empty()) {
+    std::cerr << "No teams to play\n";
+    return 1;
+  }
+
+  MatchupMatrix matrix(std::move(teams), config);
+  if (!matrix.open(results_path)) {
+    std::cerr << matrix.error() << "\n";
+    return 1;
+  }
+
+  BattleExecutor executor(threads, placement);
+  size_t resumed = matrix.tiles_done();
+  std::cout << matrix.size() << " teams, " << config.games
+            << " games per ordered pair, " << matrix.tile_count()
+            << " tiles on " << executor.thread_count() << " threads\n";
+  if (resumed)
+    std::cout << "Resuming from " << results_path << ": " << resumed << "/"
+              << matrix.tile_count() << " tiles already done\n";
+
+  size_t report_every = std::max<size_t>(1, matrix.tile_count() / 10);
+  matrix.set_progress([&](size_t done, size_t total) {
+    if (done % report_every == 0 || done == total)
+      std::cout << "  " << done << "/" << total << " tiles\n" << std::flush;
+  });
+
+  Clock::time_point start = Clock::now();
+  if (!matrix.run(executor)) {
+    std::cerr << matrix.error() << "\n";
+    return 1;
+  }
+  double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  if (matrix.games_played()) {
+    std::cout << "Played " << matrix.games_played() << " games in " << elapsed
+              << "s ("
+              << (elapsed > 0 ? static_cast<double>(matrix.games_played()) /
+                                    elapsed
+                              : 0)
+              << " games/s)\n";
+  }
+
+  if (!matrix.write_csv(csv_path)) {
+    std::cerr << "Cannot write " << csv_path << "\n";
+    return 1;
+  }
+  std::cout << "Wrote the win-rate matrix to " << csv_path << "\n\n";
+
+  std::vector<size_t> order(matrix.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return matrix.overall_win_rate(a) > matrix.overall_win_rate(b);
+  });
+  std::cout << "Best overall:\n";
+  for (size_t i = 0; i < std::min<size_t>(10, order.size()); i++)
+    std::cout << "  " << (i + 1) << ". " << matrix.team(order[i]).label << " ("
+              << matrix.overall_win_rate(order[i]) * 100 << "%)\n";
+  return 0;
+}
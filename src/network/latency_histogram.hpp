@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// Log-linear histogram for latency samples (in microseconds). Each power of
+// two is split into 16 linear sub-buckets, so percentiles are accurate to
+// ~6% with constant memory and O(1) recording. Not thread-safe.
+class LatencyHistogram {
+private:
+  static constexpr int kSubBits = 4;
+  static constexpr int kSubBuckets = 1 << kSubBits;
+  static constexpr int kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+  std::array<uint64_t, kBuckets> counts_{};
+  uint64_t total_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t max_ = 0;
+
+  static int bucket_for(uint64_t value) {
+    if (value < kSubBuckets)
+      return static_cast<int>(value);
+    int msb = 63;
+    while (!(value >> msb))
+      msb--;
+    int shift = msb - kSubBits;
+    int sub = static_cast<int>((value >> shift) & (kSubBuckets - 1));
+    return (shift + 1) * kSubBuckets + sub;
+  }
+
+  // Largest value that lands in a bucket
+  static uint64_t bucket_upper(int bucket) {
+    if (bucket < kSubBuckets)
+      return static_cast<uint64_t>(bucket);
+    int shift = bucket / kSubBuckets - 1;
+    uint64_t sub = static_cast<uint64_t>(bucket % kSubBuckets);
+    return ((kSubBuckets + sub + 1) << shift) - 1;
+  }
+
+public:
+  void record(uint64_t value) {
+    counts_[bucket_for(value)]++;
+    total_++;
+    sum_ += value;
+    if (value > max_)
+      max_ = value;
+  }
+
+  void merge(const LatencyHistogram &other) {
+    for (int i = 0; i < kBuckets; i++)
+      counts_[i] += other.counts_[i];
+    total_ += other.total_;
+    sum_ += other.sum_;
+    if (other.max_ > max_)
+      max_ = other.max_;
+  }
+
+  // q in [0, 1], e.g. 0.99 for p99
+  uint64_t percentile(double q) const {
+    if (total_ == 0)
+      return 0;
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total_));
+    if (rank >= total_)
+      rank = total_ - 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; i++) {
+      seen += counts_[i];
+      if (seen > rank)
+        return bucket_upper(i) < max_ ? bucket_upper(i) : max_;
+    }
+    return max_;
+  }
+
+  uint64_t count() const { return total_; }
+  uint64_t max() const { return max_; }
+  double mean() const {
+    return total_ ? static_cast<double>(sum_) / static_cast<double>(total_)
+                  : 0.0;
+  }
+};
@@ -1,4 +1,6 @@
 #include "protocol.hpp"
+#include "../core/instrument.hpp"
+#include "socket.hpp"
 #include <cstring>
 
 Message::Message(MessageType t, const std::string &str) : type(t) {
@@ -72,3 +74,83 @@ Message Message::deserialize(const std::vector<uint8_t> &data) {
 
   return Message(msg_type, payload);
 }
+
+void FrameDecoder::feed(const uint8_t *data, size_t size) {
+  // Drop consumed bytes once they make up most of the buffer
+  if (read_offset_ > 0 && read_offset_ * 2 >= buffer_.size()) {
+    buffer_.erase(buffer_.begin(), buffer_.begin() + read_offset_);
+    read_offset_ = 0;
+  }
+  buffer_.insert(buffer_.end(), data, data + size);
+}
+
+bool FrameDecoder::next(Message &msg) {
+  if (failed_ || buffer_.size() - read_offset_ < 5) {
+    return false;
+  }
+
+  const uint8_t *header = buffer_.data() + read_offset_;
+  uint32_t payload_len = (static_cast<uint32_t>(header[0]) << 24) |
+                         (static_cast<uint32_t>(header[1]) << 16) |
+                         (static_cast<uint32_t>(header[2]) << 8) |
+                         static_cast<uint32_t>(header[3]);
+  if (payload_len > MAX_MESSAGE_PAYLOAD) {
+    failed_ = true;
+    return false;
+  }
+  if (buffer_.size() - read_offset_ < 5 + payload_len) {
+    return false;
+  }
+
+  msg.type = static_cast<MessageType>(header[4]);
+  msg.payload.assign(header + 5, header + 5 + payload_len);
+  read_offset_ += 5 + payload_len;
+  BATTLER_COUNT_RECEIVED(msg.type, 5 + payload_len);
+  return true;
+}
+
+void FrameDecoder::reset() {
+  buffer_.clear();
+  read_offset_ = 0;
+  failed_ = false;
+}
+
+SharedFrame encode_frame(const Message &msg) {
+  return std::make_shared<const std::vector<uint8_t>>(msg.serialize());
+}
+
+bool send_message(Socket &socket, const Message &msg) {
+  BATTLER_COUNT_SENT(msg.type, 5 + msg.payload.size());
+  return socket.send(msg.serialize());
+}
+
+bool send_frame(Socket &socket, const SharedFrame &frame) {
+  if (!frame)
+    return false;
+  BATTLER_COUNT_SENT((*frame)[4], frame->size());
+  return socket.send(*frame);
+}
+
+bool receive_message(Socket &socket, Message &msg) {
+  std::vector<uint8_t> header;
+  if (!socket.receive_exact(header, 5)) {
+    return false;
+  }
+
+  uint32_t payload_len = (static_cast<uint32_t>(header[0]) << 24) |
+                         (static_cast<uint32_t>(header[1]) << 16) |
+                         (static_cast<uint32_t>(header[2]) << 8) |
+                         static_cast<uint32_t>(header[3]);
+  if (payload_len > MAX_MESSAGE_PAYLOAD) {
+    socket.close();
+    return false;
+  }
+
+  msg.type = static_cast<MessageType>(header[4]);
+  msg.payload.clear();
+  if (payload_len > 0 && !socket.receive_exact(msg.payload, payload_len)) {
+    return false;
+  }
+  BATTLER_COUNT_RECEIVED(msg.type, 5 + payload_len);
+  return true;
+}
@@ -1,13 +1,17 @@
 #pragma once
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
+class Socket;
+
 // Message types for client-server communication
 enum class MessageType : uint8_t {
   // Connection
   CONNECT_REQUEST = 0,
   CONNECT_RESPONSE = 1,
+  SPECTATE_REQUEST = 2, // Sent instead of CONNECT_REQUEST to only watch
 
   // Game Setup
   GAME_START = 10,
@@ -27,6 +31,11 @@ enum class MessageType : uint8_t {
   ROUND_COMPLETE = 32,
   BRACKET_UPDATE = 33,
 
+  // Autobattler lobby
+  LOBBY_STATE = 35,  // Gold, team and shop; the player answers SHOP_ACTION
+  SHOP_ACTION = 36,  // "buy N", "refresh", "lock N", "sell N", "ready", ...
+  LOBBY_RESULT = 37, // One battle of the round, streamed as it finishes
+
   // Results
   GAME_OVER = 40,
   WINNER_DECLARED = 41,
@@ -35,7 +44,11 @@ enum class MessageType : uint8_t {
   ERROR_MSG = 50,
   DISCONNECT = 51,
   PING = 52,
-  PONG = 53
+  PONG = 53,
+
+  // Admin
+  STATS_REQUEST = 54, // Sent instead of CONNECT_REQUEST; answered with STATS
+  STATS = 55          // Instrumentation totals as text, then the server hangs up
 };
 
 // Message structure
@@ -59,3 +72,32 @@ struct Message {
   void set_payload_int(int value);
   int get_payload_int() const;
 };
+
+// A serialized message shared by every recipient, so fan-out encodes once
+typedef std::shared_ptr<const std::vector<uint8_t>> SharedFrame;
+SharedFrame encode_frame(const Message &msg);
+
+// Largest payload accepted for a single message
+const uint32_t MAX_MESSAGE_PAYLOAD = 1 << 20;
+
+// Incremental decoder for non-blocking readers: feed whatever bytes arrived
+// and pop complete messages as they become available.
+class FrameDecoder {
+private:
+  std::vector<uint8_t> buffer_;
+  size_t read_offset_ = 0;
+  bool failed_ = false;
+
+public:
+  void feed(const uint8_t *data, size_t size);
+  bool next(Message &msg); // False until a whole message is buffered
+  bool failed() const { return failed_; } // Oversized frame seen
+  void reset();
+};
+
+// Framed transport: read/write exactly one whole message. A single recv()
+// can return several coalesced messages (or part of one), so anything that
+// may receive more than one message in a row should use these.
+bool send_message(Socket &socket, const Message &msg);
+bool send_frame(Socket &socket, const SharedFrame &frame);
+bool receive_message(Socket &socket, Message &msg);
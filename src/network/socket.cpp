@@ -1,7 +1,39 @@
 #include "socket.hpp"
+#include <cerrno>
 #include <cstring>
 #include <iostream>
 
+#ifdef MSG_NOSIGNAL
+// A peer that hangs up mid-write must not raise SIGPIPE and kill the process
+static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static const int SEND_FLAGS = 0;
+#endif
+
+// True if the last socket call failed only because it would have blocked
+static bool would_block() {
+#ifdef _WIN32
+  int err = WSAGetLastError();
+  return err == WSAEWOULDBLOCK || err == WSAEINPROGRESS;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS;
+#endif
+}
+
+// Parse a dotted IPv4 address into addr
+static bool resolve_address(const std::string &host, int port,
+                            sockaddr_in &addr) {
+  addr = sockaddr_in{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+#ifdef _WIN32
+  addr.sin_addr.s_addr = inet_addr(host.c_str());
+  return addr.sin_addr.s_addr != INADDR_NONE;
+#else
+  return inet_pton(AF_INET, host.c_str(), &addr.sin_addr) > 0;
+#endif
+}
+
 bool Socket::winsock_initialized_ = false;
 
 void Socket::initialize_winsock() {
@@ -137,6 +169,199 @@ bool Socket::connect(const std::string &host, int port) {
   return true;
 }
 
+bool Socket::start_connect(const std::string &host, int port) {
+  socket_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+  if (socket_fd_ == INVALID_SOCKET) {
+    return false;
+  }
+
+  sockaddr_in server_addr;
+  if (!resolve_address(host, port, server_addr) || !set_non_blocking(true)) {
+    close();
+    return false;
+  }
+
+  if (::connect(socket_fd_, (sockaddr *)&server_addr, sizeof(server_addr)) ==
+      SOCKET_ERROR) {
+    if (!would_block()) {
+      close();
+      return false;
+    }
+    return true; // In progress
+  }
+
+  is_connected_ = true;
+  return true;
+}
+
+bool Socket::finish_connect() {
+  if (is_connected_) {
+    return true;
+  }
+  if (socket_fd_ == INVALID_SOCKET) {
+    return false;
+  }
+
+  int err = 0;
+  socklen_t len = sizeof(err);
+#ifdef _WIN32
+  getsockopt(socket_fd_, SOL_SOCKET, SO_ERROR, (char *)&err, &len);
+#else
+  getsockopt(socket_fd_, SOL_SOCKET, SO_ERROR, &err, &len);
+#endif
+  if (err != 0) {
+    close();
+    return false;
+  }
+
+  is_connected_ = true;
+  return true;
+}
+
+bool Socket::set_non_blocking(bool enabled) {
+  if (socket_fd_ == INVALID_SOCKET) {
+    return false;
+  }
+#ifdef _WIN32
+  u_long mode = enabled ? 1 : 0;
+  return ioctlsocket(socket_fd_, FIONBIO, &mode) == 0;
+#else
+  int flags = fcntl(socket_fd_, F_GETFL, 0);
+  if (flags < 0) {
+    return false;
+  }
+  flags = enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+  return fcntl(socket_fd_, F_SETFL, flags) == 0;
+#endif
+}
+
+long Socket::send_some(const uint8_t *data, size_t size) {
+  if (!is_connected_) {
+    return -1;
+  }
+
+#ifdef _WIN32
+  int sent = ::send(socket_fd_, (const char *)data, static_cast<int>(size),
+                    SEND_FLAGS);
+#else
+  ssize_t sent = ::send(socket_fd_, data, size, SEND_FLAGS);
+#endif
+  if (sent == SOCKET_ERROR) {
+    if (would_block()) {
+      return 0;
+    }
+    is_connected_ = false;
+    return -1;
+  }
+  return static_cast<long>(sent);
+}
+
+long Socket::receive_available(uint8_t *data, size_t size) {
+  if (!is_connected_) {
+    return -1;
+  }
+
+#ifdef _WIN32
+  u_long pending = 0;
+  if (ioctlsocket(socket_fd_, FIONREAD, &pending) != 0) {
+    is_connected_ = false;
+    return -1;
+  }
+  if (pending == 0 && !wait_readable(0)) {
+    return 0;
+  }
+  // Readable with nothing pending means the peer closed; recv returns 0
+  size_t wanted = pending == 0 ? 1 : (pending < size ? pending : size);
+  int received = ::recv(socket_fd_, (char *)data, static_cast<int>(wanted), 0);
+#else
+  ssize_t received = ::recv(socket_fd_, data, size, MSG_DONTWAIT);
+#endif
+  if (received == SOCKET_ERROR) {
+    if (would_block()) {
+      return 0;
+    }
+    is_connected_ = false;
+    return -1;
+  }
+  if (received == 0) {
+    is_connected_ = false;
+    return -1; // Peer closed
+  }
+  return static_cast<long>(received);
+}
+
+long Socket::send_vectored(const IoSlice *slices, size_t count) {
+  if (!is_connected_) {
+    return -1;
+  }
+  if (count == 0) {
+    return 0;
+  }
+
+#ifdef _WIN32
+  std::vector<WSABUF> buffers(count);
+  for (size_t i = 0; i < count; i++) {
+    buffers[i].buf = (char *)slices[i].data;
+    buffers[i].len = static_cast<ULONG>(slices[i].size);
+  }
+  DWORD sent = 0;
+  if (WSASend(socket_fd_, buffers.data(), static_cast<DWORD>(count), &sent, 0,
+              nullptr, nullptr) == SOCKET_ERROR) {
+    if (would_block()) {
+      return 0;
+    }
+    is_connected_ = false;
+    return -1;
+  }
+#else
+  // sendmsg is writev for sockets, but also takes MSG_NOSIGNAL
+  const size_t max_slices = 64;
+  iovec iov[max_slices];
+  size_t used = count < max_slices ? count : max_slices;
+  for (size_t i = 0; i < used; i++) {
+    iov[i].iov_base = const_cast<uint8_t *>(slices[i].data);
+    iov[i].iov_len = slices[i].size;
+  }
+  msghdr header{};
+  header.msg_iov = iov;
+  header.msg_iovlen = used;
+
+  ssize_t sent = ::sendmsg(socket_fd_, &header, SEND_FLAGS);
+  if (sent == SOCKET_ERROR) {
+    if (would_block()) {
+      return 0;
+    }
+    is_connected_ = false;
+    return -1;
+  }
+#endif
+  return static_cast<long>(sent);
+}
+
+long Socket::receive_some(uint8_t *data, size_t size) {
+  if (!is_connected_) {
+    return -1;
+  }
+
+#ifdef _WIN32
+  int received = ::recv(socket_fd_, (char *)data, static_cast<int>(size), 0);
+#else
+  ssize_t received = ::recv(socket_fd_, data, size, 0);
+#endif
+  if (received == SOCKET_ERROR) {
+    if (would_block()) {
+      return 0;
+    }
+    is_connected_ = false;
+    return -1;
+  }
+  if (received == 0) {
+    is_connected_ = false;
+    return -1; // Peer closed
+  }
+  return static_cast<long>(received);
+}
+
 bool Socket::send(const std::vector<uint8_t> &data) {
   if (!is_connected_) {
     return false;
@@ -146,10 +371,10 @@ bool Socket::send(const std::vector<uint8_t> &data) {
   while (total_sent < data.size()) {
 #ifdef _WIN32
     int sent = ::send(socket_fd_, (const char *)(data.data() + total_sent),
-                      data.size() - total_sent, 0);
+                      data.size() - total_sent, SEND_FLAGS);
 #else
     ssize_t sent = ::send(socket_fd_, data.data() + total_sent,
-                          data.size() - total_sent, 0);
+                          data.size() - total_sent, SEND_FLAGS);
 #endif
 
     if (sent == SOCKET_ERROR) {
@@ -214,6 +439,45 @@ bool Socket::receive_exact(std::vector<uint8_t> &buffer, size_t size) {
   return true;
 }
 
+bool Socket::wait_readable(int timeout_ms) {
+  if (socket_fd_ == INVALID_SOCKET) {
+    return false;
+  }
+
+#ifdef _WIN32
+  WSAPOLLFD pfd{};
+  pfd.fd = socket_fd_;
+  pfd.events = POLLRDNORM;
+  return WSAPoll(&pfd, 1, timeout_ms) > 0;
+#else
+  pollfd pfd{};
+  pfd.fd = socket_fd_;
+  pfd.events = POLLIN;
+  return ::poll(&pfd, 1, timeout_ms) > 0;
+#endif
+}
+
+bool Socket::peer_closed() {
+  if (!is_connected_) {
+    return true;
+  }
+  if (!wait_readable(0)) {
+    return false; // Nothing pending, still connected
+  }
+
+  char probe;
+#ifdef _WIN32
+  int received = ::recv(socket_fd_, &probe, 1, MSG_PEEK);
+#else
+  ssize_t received = ::recv(socket_fd_, &probe, 1, MSG_PEEK);
+#endif
+  if (received == 0 || received == SOCKET_ERROR) {
+    is_connected_ = false;
+    return true;
+  }
+  return false;
+}
+
 void Socket::close() {
   if (socket_fd_ != INVALID_SOCKET) {
 #ifdef _WIN32
@@ -10,14 +10,23 @@
 typedef SOCKET socket_t;
 #else
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 typedef int socket_t;
 #define INVALID_SOCKET -1
 #define SOCKET_ERROR -1
 #endif
 
+// One buffer of a scatter/gather write
+struct IoSlice {
+  const uint8_t *data;
+  size_t size;
+};
+
 class Socket {
 private:
   socket_t socket_fd_;
@@ -39,12 +48,31 @@ public:
 
   // Client methods
   bool connect(const std::string &host, int port);
+  // Non-blocking connect: returns false only on immediate failure. Wait for
+  // the socket to become writable, then call finish_connect().
+  bool start_connect(const std::string &host, int port);
+  bool finish_connect();
 
   // Communication
   bool send(const std::vector<uint8_t> &data);
   std::vector<uint8_t> receive(size_t max_size = 4096);
   bool receive_exact(std::vector<uint8_t> &buffer, size_t size);
 
+  // Non-blocking I/O: bytes transferred, 0 if the call would block, or -1 if
+  // the connection failed or was closed by the peer
+  bool set_non_blocking(bool enabled);
+  long send_some(const uint8_t *data, size_t size);
+  long receive_some(uint8_t *data, size_t size);
+  // Reads only what is already buffered, even on a blocking socket
+  long receive_available(uint8_t *data, size_t size);
+  // Gathers several buffers into one system call (writev-style)
+  long send_vectored(const IoSlice *slices, size_t count);
+
+  // Wait up to timeout_ms for data (or a pending connection when listening)
+  bool wait_readable(int timeout_ms);
+  // True if the peer has hung up (checked without consuming any data)
+  bool peer_closed();
+
   // State
   bool is_connected() const { return is_connected_; }
   void close();
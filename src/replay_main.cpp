@@ -0,0 +1,174 @@
+#include "ai/gen1_ai.hpp"
+#include "ai/random_ai.hpp"
+#include "core/battle_output.hpp"
+#include "data/loader.hpp"
+#include "server/network_battle.hpp"
+#include "server/replay.hpp"
+#include "server/team_generator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const int TURN_LIMIT = 500; // Same cap for every recorded bot battle
+
+double seconds_since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Bot battles through NetworkBattle, exactly as the server records them
+int record(const std::string &path, int battles, uint32_t seed, bool trace) {
+  ReplayWriter writer(path, trace);
+  if (!writer.is_open())
+    return 1;
+
+  Gen1AI gen1_ai;
+  RandomAI random_ai;
+  std::mt19937 gen(seed);
+  Clock::time_point start = Clock::now();
+  std::streambuf *console = std::cout.rdbuf(nullptr); // Silence the battles
+  for (int i = 0; i < battles; i++) {
+    NetworkBattle battle(generate_random_team(6, 50, gen),
+                         generate_random_team(6, 50, gen), nullptr, nullptr);
+    battle.set_ai_controller(1, &gen1_ai, "Gen1AI");
+    battle.set_ai_controller(2, &random_ai, "RandomAI");
+    battle.set_turn_limit(TURN_LIMIT);
+    battle.set_seed(seed + static_cast<uint32_t>(i));
+    battle.set_replay_writer(&writer);
+    battle.run();
+  }
+  writer.flush();
+  std::cout.rdbuf(console);
+  std::cout.clear();
+
+  std::cout << "Recorded " << writer.recorded() << " battles to " << path
+            << " in " << seconds_since(start) << "s\n";
+  return 0;
+}
+
+// Replay everything in the file and compare with what was recorded
+int verify(const std::string &path) {
+  DataCatalog catalog;
+  ReplayFile file;
+  if (!file.open(path, catalog)) {
+    std::cerr << file.error() << "\n";
+    return 1;
+  }
+
+  size_t mismatched = 0;
+  size_t turns = 0;
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < file.size(); i++) {
+    Replay replay = file.read(i);
+    ReplayCheck check = check_replay(replay, catalog);
+    turns += check.turns;
+    if (check.matches(replay))
+      continue;
+    if (++mismatched <= 10) {
+      std::cout << "Replay " << i << ": ";
+      if (!check.valid)
+        std::cout << "invalid at turn " << check.turns << "\n";
+      else if (check.diverged_at)
+        std::cout << "diverged at turn " << check.diverged_at << "\n";
+      else
+        std::cout << "winner " << check.winner << ", recorded "
+                  << static_cast<int>(replay.winner) << "\n";
+    }
+  }
+  double elapsed = seconds_since(start);
+
+  std::cout << "Replays:    " << file.size() << " (" << turns << " turns)\n";
+  std::cout << "Matched:    " << file.size() - mismatched << "/"
+            << file.size() << "\n";
+  std::cout << "Replay rate: "
+            << (elapsed > 0 ? static_cast<double>(file.size()) / elapsed : 0)
+            << " replays/s\n";
+  return mismatched == 0 ? 0 : 1;
+}
+
+// One replay, turn by turn
+int show(const std::string &path, size_t index) {
+  DataCatalog catalog;
+  ReplayFile file;
+  if (!file.open(path, catalog)) {
+    std::cerr << file.error() << "\n";
+    return 1;
+  }
+  if (index >= file.size()) {
+    std::cerr << "Only " << file.size() << " replays in " << path << "\n";
+    return 1;
+  }
+
+  Replay replay = file.read(index);
+  std::vector<Pokemon> team1;
+  std::vector<Pokemon> team2;
+  if (!replay_teams(replay, catalog, team1, team2)) {
+    std::cerr << "Replay " << index << " has unknown species\n";
+    return 1;
+  }
+
+  std::cout << "Replay " << index << " (seed " << replay.seed << ", "
+            << replay.turns.size() << " turns)\n";
+  for (int team_num = 1; team_num <= 2; team_num++) {
+    std::cout << "Team " << team_num << ":";
+    for (const Pokemon &pokemon : team_num == 1 ? team1 : team2)
+      std::cout << " " << pokemon.name() << " (Lv. " << pokemon.level() << ")";
+    std::cout << "\n";
+  }
+
+  QuietBattleOutput quiet;
+  ReplayBattle battle(team1, team2, replay);
+  while (battle.step()) {
+    const ReplayTurn &turn = replay.turns[battle.turns_played() - 1];
+    ReplayTraceEntry state = battle.state();
+    std::cout << "Turn " << battle.turns_played() << ": "
+              << battle.active1.name() << " HP " << state.hp[0] << " / "
+              << battle.active2.name() << " HP " << state.hp[1]
+              << " (moves " << turn.move1 + 1 << ", " << turn.move2 + 1
+              << ")\n";
+  }
+  std::cout << "Winner: team " << battle.winner() << " (recorded "
+            << static_cast<int>(replay.winner) << ")\n";
+  return battle.winner() == replay.winner ? 0 : 1;
+}
+
+} // namespace
+
+// Usage: battler_replay record FILE [battles] [seed] [--trace]
+//        battler_replay verify FILE
+//        battler_replay show FILE INDEX
+// record plays bot battles through NetworkBattle and appends their replays
+// (the server does the same with --replays=FILE); verify re-simulates every
+// replay in a file and exits 1 if any plays out differently.
+int main(int argc, char **argv) {
+  std::string command = argc > 1 ? argv[1] : "";
+  if (argc < 3 || (command != "record" && command != "verify" &&
+                   command != "show")) {
+    std::cerr << "Usage: battler_replay record FILE [battles] [seed] "
+                 "[--trace]\n"
+                 "       battler_replay verify FILE\n"
+                 "       battler_replay show FILE INDEX\n";
+    return 1;
+  }
+  std::string path = argv[2];
+
+  load_game_data("src/data/species.json", "src/data/moves.json",
+                 "src/data/type_chart.json");
+
+  if (command == "record") {
+    int battles = argc > 3 ? std::max(1, std::atoi(argv[3])) : 1000;
+    uint32_t seed =
+        argc > 4 ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10))
+                 : 42;
+    bool trace = argc > 5 && std::string(argv[5]) == "--trace";
+    return record(path, battles, seed, trace);
+  }
+  if (command == "verify")
+    return verify(path);
+  return show(path, argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0);
+}
@@ -0,0 +1,482 @@
+#include "autobattler_lobby.hpp"
+#include "../autobattler/evolution.hpp"
+#include "../autobattler/round_rules.hpp"
+#include "team_generator.hpp"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+AutobattlerLobby::AutobattlerLobby(
+    int id, const std::vector<ClientConnection *> &clients,
+    const LobbyConfig &config, ServerEventLoop &loop, BattleExecutor &executor,
+    GhostPool *ghosts)
+    : id_(id), config_(config), loop_(loop), executor_(executor),
+      ghosts_(ghosts), rng_(std::random_device{}()), round_(0),
+      shopping_(false), battles_pending_(0), flushing_(false),
+      finished_(false) {
+  for (ClientConnection *client : clients) {
+    seats_.emplace_back(new Seat(client, rng_()));
+  }
+}
+
+std::string AutobattlerLobby::describe(const PlayerState &player,
+                                       const Shop &shop, int seconds_left) {
+  std::stringstream ss;
+  ss << "=== ROUND " << player.round() << " | TIER " << player.tier()
+     << " ===\n";
+  ss << "Gold: " << player.gold() << " | Hearts: " << player.hearts()
+     << " | Wins: " << player.wins() << "\n";
+
+  ss << "Team (" << player.team().size() << "/" << player.max_team_size()
+     << "):\n";
+  for (size_t i = 0; i < player.team().size(); i++) {
+    const Pokemon &mon = player.team()[i];
+    ss << (i + 1) << ". " << mon.name() << " (Lv. " << mon.level()
+       << ") HP: " << mon.hp() << "/" << mon.max_hp() << "\n";
+  }
+  if (!player.bench().empty()) {
+    ss << "Bench:\n";
+    for (size_t i = 0; i < player.bench().size(); i++) {
+      ss << "  " << (i + 1) << ". " << player.bench()[i].name() << "\n";
+    }
+  }
+
+  ss << "Shop:\n";
+  const auto &slots = shop.slots();
+  for (size_t i = 0; i < slots.size(); i++) {
+    ss << (i + 1) << ". ";
+    if (slots[i].species) {
+      ss << slots[i].species->name << " [" << rarity_to_string(slots[i].rarity)
+         << "] - " << slots[i].cost << " gold";
+      if (slots[i].locked)
+        ss << " [LOCKED]";
+    } else {
+      ss << "(sold)";
+    }
+    ss << "\n";
+  }
+  ss << "Refresh cost: " << shop.refresh_cost() << " gold\n";
+  ss << "Commands: buy N, refresh, lock N, sell N, combine N M, swap TEAM "
+        "BENCH, ready\n";
+  ss << "Time left: " << seconds_left << "s\n";
+  return ss.str();
+}
+
+void AutobattlerLobby::send(Seat &seat, MessageType type,
+                            const std::string &text) {
+  if (seat.connected)
+    seat.outbox.push_back(Message(type, text));
+}
+
+void AutobattlerLobby::send_state(Seat &seat, const std::string &feedback) {
+  auto left = std::chrono::duration_cast<std::chrono::seconds>(
+                  phase_deadline_ - Clock::now())
+                  .count();
+  std::string text = describe(seat.player, seat.shop,
+                              static_cast<int>(std::max<long long>(0, left)));
+  send(seat, MessageType::LOBBY_STATE,
+       feedback.empty() ? text : feedback + "\n" + text);
+  seat.await = seat.connected;
+}
+
+bool AutobattlerLobby::all_ready() const {
+  for (const auto &seat : seats_) {
+    if (!seat->eliminated && !seat->ready)
+      return false;
+  }
+  return true;
+}
+
+int AutobattlerLobby::alive_count() const {
+  int alive = 0;
+  for (const auto &seat : seats_) {
+    if (!seat->eliminated)
+      alive++;
+  }
+  return alive;
+}
+
+void AutobattlerLobby::autoplay_shop(Seat &seat) {
+  RunRecord ignored;
+  ShopActions actions(seat.player, seat.shop, ignored);
+  fallback_policy_.play(actions, rng_);
+  seat.ready = true;
+}
+
+std::string AutobattlerLobby::apply_command(Seat &seat,
+                                            const std::string &command) {
+  std::istringstream in(command);
+  std::string verb;
+  in >> verb;
+  PlayerState &player = seat.player;
+  auto &team = player.team();
+  auto &bench = player.bench();
+
+  if (verb == "ready") {
+    seat.ready = true;
+    return "Ready!";
+  }
+  if (verb == "refresh") {
+    return seat.shop.refresh_shop(player) ? "Shop refreshed!"
+                                          : "Not enough gold!";
+  }
+
+  int first = 0;
+  int second = 0;
+  in >> first >> second;
+  if (verb == "buy") {
+    return seat.shop.purchase(static_cast<size_t>(first - 1), player)
+               ? "Purchased!"
+               : "Cannot purchase (not enough gold or invalid slot)";
+  }
+  if (verb == "lock") {
+    seat.shop.toggle_lock(static_cast<size_t>(first - 1));
+    return "Toggled lock on slot " + std::to_string(first);
+  }
+  if (verb == "sell") {
+    if (first < 1 || first > static_cast<int>(team.size()))
+      return "No Pokemon in that team slot";
+    player.add_gold(1); // Sell for 1 gold
+    team.erase(team.begin() + (first - 1));
+    return "Sold for 1 gold!";
+  }
+  if (verb == "swap") {
+    if (first < 1 || first > static_cast<int>(team.size()) || second < 1 ||
+        second > static_cast<int>(bench.size()))
+      return "Use swap TEAM_SLOT BENCH_SLOT";
+    std::swap(team[first - 1], bench[second - 1]);
+    return "Swapped!";
+  }
+  if (verb == "combine") {
+    int size = static_cast<int>(team.size());
+    if (first < 1 || first > size || second < 1 || second > size ||
+        first == second ||
+        !EvolutionSystem::can_combine(team[first - 1], team[second - 1]))
+      return "Cannot combine these Pokemon!";
+    Pokemon evolved =
+        EvolutionSystem::combine_and_evolve(team[first - 1], team[second - 1]);
+    team.erase(team.begin() + std::max(first, second) - 1);
+    team.erase(team.begin() + std::min(first, second) - 1);
+    team.push_back(evolved);
+    return "Evolved into " + evolved.name() + "!";
+  }
+  return "Unknown command: " + command;
+}
+
+void AutobattlerLobby::begin_shop_phase() {
+  round_++;
+  shopping_ = true;
+  phase_deadline_ = Clock::now() + std::chrono::seconds(config_.shop_seconds);
+
+  for (auto &seat : seats_) {
+    if (seat->eliminated)
+      continue;
+    seat->ready = false;
+    seat->shop.set_tier(seat->player.tier());
+    if (seat->connected) {
+      send_state(*seat, "");
+    } else {
+      autoplay_shop(*seat);
+    }
+  }
+
+  if (all_ready())
+    start_battle_phase();
+}
+
+void AutobattlerLobby::start_battle_phase() {
+  shopping_ = false;
+
+  std::vector<size_t> alive;
+  for (size_t i = 0; i < seats_.size(); i++) {
+    if (!seats_[i]->eliminated)
+      alive.push_back(i);
+  }
+  std::shuffle(alive.begin(), alive.end(), rng_);
+
+  // Everyone's ghost goes in before anyone draws one
+  if (ghosts_) {
+    for (size_t i : alive)
+      ghosts_->record(seats_[i]->player);
+  }
+
+  battles_pending_ = static_cast<int>((alive.size() + 1) / 2);
+  for (size_t i = 0; i < alive.size(); i += 2) {
+    size_t a = alive[i];
+    int b = i + 1 < alive.size() ? static_cast<int>(alive[i + 1]) : -1;
+    std::vector<Pokemon> team_a = seats_[a]->player.team();
+    std::vector<Pokemon> team_b;
+    std::string ghost_name;
+
+    if (b >= 0) {
+      team_b = seats_[b]->player.team();
+    } else {
+      // The odd one out fights a past player's ghost, or a wild team
+      const PlayerState &player = seats_[a]->player;
+      if (ghosts_ &&
+          ghosts_->draw(player.round(), player.tier(), rng_, team_b)) {
+        ghost_name = "a ghost";
+      } else {
+        team_b = generate_random_team(opponent_team_size(player.round()),
+                                      opponent_level(player.round()), rng_);
+        ghost_name = "a wild team";
+      }
+    }
+
+    executor_.submit([this, a, b, ghost_name, team_a, team_b]() {
+      AutoBattle auto_battle;
+      on_battle_done(a, b, ghost_name,
+                     auto_battle.run(team_a, team_b, false));
+    });
+  }
+}
+
+void AutobattlerLobby::on_battle_done(size_t seat_a, int seat_b,
+                                      const std::string &ghost_name,
+                                      BattleResult result) {
+  bool owner;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Seat &a = *seats_[seat_a];
+    std::string opponent = seat_b >= 0 ? seats_[seat_b]->player.name()
+                                       : ghost_name;
+
+    auto report = [this](Seat &seat, const std::string &opponent,
+                         BattleResult outcome) {
+      int round = seat.player.round();
+      RoundOutcome applied = apply_round_result(seat.player, outcome);
+      std::stringstream ss;
+      ss << "Round " << round << ": ";
+      if (outcome == BattleResult::Win) {
+        ss << "You defeated " << opponent << "! +" << applied.gold_earned
+           << " gold";
+        if (applied.tier_up)
+          ss << ", TIER UP to " << seat.player.tier();
+      } else if (outcome == BattleResult::Loss) {
+        ss << "You lost to " << opponent << ". " << seat.player.hearts()
+           << " hearts left";
+      } else {
+        ss << "Draw with " << opponent;
+      }
+      send(seat, MessageType::LOBBY_RESULT, ss.str() + "\n");
+    };
+
+    report(a, opponent, result);
+    if (seat_b >= 0) {
+      BattleResult mirrored = result == BattleResult::Win    ? BattleResult::Loss
+                              : result == BattleResult::Loss ? BattleResult::Win
+                                                             : result;
+      report(*seats_[seat_b], a.player.name(), mirrored);
+    }
+
+    if (--battles_pending_ == 0)
+      end_round();
+    owner = claim_flush();
+  }
+  if (owner)
+    flush();
+}
+
+void AutobattlerLobby::end_round() {
+  int alive_before = alive_count();
+  std::vector<Seat *> knocked_out;
+  for (auto &seat : seats_) {
+    if (!seat->eliminated && seat->player.is_game_over())
+      knocked_out.push_back(seat.get());
+  }
+
+  // Players knocked out together share a placement
+  int placement = alive_before - static_cast<int>(knocked_out.size()) + 1;
+  for (Seat *seat : knocked_out) {
+    seat->eliminated = true;
+    seat->placement = placement;
+    send(*seat, MessageType::GAME_OVER,
+         "Out of hearts! You placed #" + std::to_string(placement) + " of " +
+             std::to_string(seats_.size()));
+  }
+
+  if (alive_count() <= 1 || round_ >= config_.max_rounds) {
+    finish_lobby();
+  } else {
+    begin_shop_phase();
+  }
+}
+
+void AutobattlerLobby::finish_lobby() {
+  // Survivors are ranked by hearts, then wins
+  std::vector<Seat *> survivors;
+  for (auto &seat : seats_) {
+    if (!seat->eliminated)
+      survivors.push_back(seat.get());
+  }
+  auto score = [](const Seat *seat) {
+    return std::make_pair(seat->player.hearts(), seat->player.wins());
+  };
+  std::sort(survivors.begin(), survivors.end(),
+            [&](const Seat *a, const Seat *b) { return score(a) > score(b); });
+
+  for (size_t i = 0; i < survivors.size(); i++) {
+    Seat *seat = survivors[i];
+    seat->placement = (i > 0 && score(seat) == score(survivors[i - 1]))
+                          ? survivors[i - 1]->placement
+                          : static_cast<int>(i) + 1;
+    seat->eliminated = true;
+    send(*seat, MessageType::GAME_OVER,
+         seat->placement == 1
+             ? std::string("You won the lobby!")
+             : "You placed #" + std::to_string(seat->placement) + " of " +
+                   std::to_string(seats_.size()));
+  }
+
+  finished_ = true; // Reported once the final messages are flushed
+}
+
+void AutobattlerLobby::on_decision(size_t index, const DecisionResult &result) {
+  bool owner;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Seat &seat = *seats_[index];
+    if (!shopping_ || seat.ready || seat.eliminated)
+      return;
+
+    switch (result.status) {
+    case DecisionStatus::Received:
+      if (result.message.type == MessageType::SHOP_ACTION) {
+        std::string feedback =
+            apply_command(seat, result.message.get_payload_string());
+        if (seat.ready) {
+          send(seat, MessageType::BATTLE_LOG,
+               "Waiting for the other players...\n");
+        } else {
+          send_state(seat, feedback);
+        }
+      } else {
+        seat.await = true; // Not a shop action; keep listening
+      }
+      break;
+
+    case DecisionStatus::TimedOut:
+      seat.client->stale_responses++;
+      send(seat, MessageType::BATTLE_LOG,
+           "Time's up! The AI finished your shop phase.\n");
+      autoplay_shop(seat);
+      break;
+
+    case DecisionStatus::Disconnected:
+      std::cout << "[Lobby " << id_ << "] " << seat.player.name()
+                << " disconnected; the AI takes over\n";
+      seat.connected = false;
+      seat.outbox.clear();
+      autoplay_shop(seat);
+      break;
+    }
+
+    if (all_ready())
+      start_battle_phase();
+    owner = claim_flush();
+  }
+  if (owner)
+    flush();
+}
+
+bool AutobattlerLobby::claim_flush() {
+  if (flushing_)
+    return false; // That thread picks up whatever we queued
+  flushing_ = true;
+  return true;
+}
+
+void AutobattlerLobby::flush() {
+  while (true) {
+    std::vector<std::pair<ClientConnection *, std::deque<Message>>> sends;
+    std::vector<size_t> waits;
+    int timeout_ms = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (size_t i = 0; i < seats_.size(); i++) {
+        Seat &seat = *seats_[i];
+        if (!seat.outbox.empty()) {
+          sends.emplace_back(seat.client, std::move(seat.outbox));
+          seat.outbox.clear();
+        }
+        if (seat.await) {
+          seat.await = false;
+          waits.push_back(i);
+        }
+      }
+      if (sends.empty() && waits.empty()) {
+        flushing_ = false;
+        if (finished_)
+          finished_cv_.notify_all();
+        return;
+      }
+      timeout_ms = static_cast<int>(std::max<long long>(
+          1, std::chrono::duration_cast<std::chrono::milliseconds>(
+                 phase_deadline_ - Clock::now())
+                 .count()));
+    }
+
+    for (auto &entry : sends) {
+      std::lock_guard<std::mutex> lock(entry.first->send_mutex);
+      for (const Message &msg : entry.second) {
+        send_message(*entry.first->socket, msg);
+      }
+    }
+    // A wait may resolve right here from buffered input; its callback only
+    // queues work, which the next pass of this loop sends
+    for (size_t i : waits) {
+      loop_.await_message(seats_[i]->client, timeout_ms,
+                          [this, i](const DecisionResult &result) {
+                            on_decision(i, result);
+                          });
+    }
+  }
+}
+
+void AutobattlerLobby::start() {
+  bool owner;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &seat : seats_) {
+      send(*seat, MessageType::GAME_START,
+           "Lobby " + std::to_string(id_) + ": " +
+               std::to_string(seats_.size()) +
+               " players. Last one standing wins!");
+    }
+    begin_shop_phase();
+    owner = claim_flush();
+  }
+  if (owner)
+    flush();
+}
+
+bool AutobattlerLobby::finished() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return finished_ && !flushing_;
+}
+
+bool AutobattlerLobby::wait(int timeout_ms) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return finished_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                               [this]() { return finished_ && !flushing_; });
+}
+
+int AutobattlerLobby::round() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return round_;
+}
+
+std::vector<ClientConnection *> AutobattlerLobby::clients() const {
+  std::vector<ClientConnection *> clients;
+  for (const auto &seat : seats_)
+    clients.push_back(seat->client);
+  return clients;
+}
+
+std::vector<int> AutobattlerLobby::placements() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<int> result;
+  for (const auto &seat : seats_)
+    result.push_back(seat->placement);
+  return result;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "../autobattler/auto_battle.hpp"
+#include "../autobattler/ghost_pool.hpp"
+#include "../autobattler/player_state.hpp"
+#include "../autobattler/shop.hpp"
+#include "../autobattler/shop_policy.hpp"
+#include "battle_executor.hpp"
+#include "game_server.hpp"
+#include "server_event_loop.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+struct LobbyConfig {
+  int players = 8;       // Seats per lobby
+  int shop_seconds = 30; // Shop phase length; late players get the AI
+  int max_rounds = 30;   // Stop even if several players are still alive
+};
+
+// One multi-player auto-battler game. Every player's PlayerState and Shop
+// live here. Shop phases run for all players at once: each SHOP_ACTION is
+// applied as it arrives through the event loop, and a player who runs out
+// of time or disconnects has the rest of their phase played by a
+// GreedyShopPolicy. Once everyone is ready, all pairings of the round are
+// fought as headless AutoBattles on the executor and each result is sent
+// as soon as its battle ends. No thread is tied to a lobby or a player, so
+// one server can host hundreds of lobbies.
+class AutobattlerLobby {
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Seat {
+    ClientConnection *client;
+    PlayerState player;
+    Shop shop;
+    bool connected = true;
+    bool ready = false;
+    bool eliminated = false;
+    int placement = 0;
+    std::deque<Message> outbox; // Sent in order by flush()
+    bool await = false;         // Arm a wait for the next SHOP_ACTION
+
+    Seat(ClientConnection *c, uint32_t seed)
+        : client(c), player(c->player_name), shop(1, seed) {}
+  };
+
+  int id_;
+  LobbyConfig config_;
+  ServerEventLoop &loop_;
+  BattleExecutor &executor_;
+  GhostPool *ghosts_;
+  GreedyShopPolicy fallback_policy_;
+
+  std::vector<std::unique_ptr<Seat>> seats_;
+  std::mt19937 rng_;
+  int round_;
+  bool shopping_;
+  Clock::time_point phase_deadline_;
+  int battles_pending_;
+  bool flushing_; // Some thread is already draining outboxes
+  bool finished_;
+
+  std::mutex mutex_; // Guards everything above
+  std::condition_variable finished_cv_;
+
+  // State changes, called with mutex_ held. They queue messages and waits
+  // on the seats; flush() performs them once the lock is released.
+  void begin_shop_phase();
+  void start_battle_phase();
+  void end_round();
+  void finish_lobby();
+  void autoplay_shop(Seat &seat);
+  std::string apply_command(Seat &seat, const std::string &command);
+  void send_state(Seat &seat, const std::string &feedback);
+  void send(Seat &seat, MessageType type, const std::string &text);
+  bool all_ready() const;
+  int alive_count() const;
+
+  void on_decision(size_t seat, const DecisionResult &result);
+  void on_battle_done(size_t seat_a, int seat_b, const std::string &ghost_name,
+                      BattleResult result);
+  // Called with mutex_ held after queuing work; true if the caller must
+  // now flush(). Whoever owns the flush keeps the lobby from finishing.
+  bool claim_flush();
+  void flush();
+
+public:
+  AutobattlerLobby(int id, const std::vector<ClientConnection *> &clients,
+                   const LobbyConfig &config, ServerEventLoop &loop,
+                   BattleExecutor &executor, GhostPool *ghosts = nullptr);
+
+  AutobattlerLobby(const AutobattlerLobby &) = delete;
+  AutobattlerLobby &operator=(const AutobattlerLobby &) = delete;
+
+  void start();
+  bool finished();
+  // False if the lobby is still running after timeout_ms
+  bool wait(int timeout_ms);
+
+  int id() const { return id_; }
+  int round();
+  std::vector<ClientConnection *> clients() const;
+  // Final standing per seat (1 = winner), 0 while still playing
+  std::vector<int> placements();
+
+  // Text the client sees in LOBBY_STATE, exposed for tests and bots
+  static std::string describe(const PlayerState &player, const Shop &shop,
+                              int seconds_left);
+};
@@ -0,0 +1,72 @@
+#include "battle_executor.hpp"
+#include "../core/battle_pool.hpp"
+#include "../core/rng.hpp"
+#include "../core/timeline.hpp"
+#include "cpu_topology.hpp"
+
+namespace {
+
+int &worker_node() {
+  static thread_local int node = -1;
+  return node;
+}
+
+} // namespace
+
+BattleExecutor::BattleExecutor(unsigned thread_count,
+                               WorkerPlacement placement)
+    : stopping_(false), placement_(placement) {
+  if (thread_count == 0 && placement == WorkerPlacement::Pinned)
+    thread_count = static_cast<unsigned>(CpuTopology::system().cpu_count());
+  if (thread_count == 0) {
+    thread_count = std::thread::hardware_concurrency();
+    if (thread_count == 0)
+      thread_count = 1;
+  }
+
+  workers_.reserve(thread_count);
+  for (unsigned i = 0; i < thread_count; i++) {
+    workers_.emplace_back([this, i]() { worker_loop(i); });
+  }
+}
+
+int BattleExecutor::current_node() { return worker_node(); }
+
+BattleExecutor::~BattleExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+
+  for (auto &worker : workers_) {
+    if (worker.joinable())
+      worker.join();
+  }
+}
+
+void BattleExecutor::worker_loop(unsigned index) {
+  if (placement_ == WorkerPlacement::Pinned) {
+    CpuSlot slot = CpuTopology::system().slot(index);
+    if (pin_current_thread(slot.cpu))
+      worker_node() = slot.node;
+    // First touch from here puts this thread's state on its own node
+    rng_engine();
+    BattlePool::local();
+  }
+  timeline::name_thread("battle worker");
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+
+      if (tasks_.empty())
+        return; // Stopping and drained
+
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Where an executor's workers run
+enum class WorkerPlacement {
+  Floating, // Wherever the OS schedules them
+  // Each on its own CPU, filling one NUMA node before the next (see
+  // CpuTopology::slot). A worker pins itself before it allocates anything,
+  // so its battle pool, RNG and other per-thread state land on its node.
+  Pinned
+};
+
+// Fixed-size worker pool that battles (network or headless) are run on
+class BattleExecutor {
+private:
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_;
+  WorkerPlacement placement_;
+
+  void worker_loop(unsigned index);
+
+public:
+  // thread_count == 0 uses one worker per hardware thread (per CPU this
+  // process may use, when pinned)
+  explicit BattleExecutor(unsigned thread_count = 0,
+                          WorkerPlacement placement = WorkerPlacement::Floating);
+  ~BattleExecutor(); // Finishes queued tasks, then joins workers
+
+  BattleExecutor(const BattleExecutor &) = delete;
+  BattleExecutor &operator=(const BattleExecutor &) = delete;
+
+  // Queue a task; the returned future carries its result (or exception)
+  template <typename F> auto submit(F &&task) -> std::future<decltype(task())> {
+    using Result = decltype(task());
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(
+        std::forward<F>(task));
+    std::future<Result> result = packaged->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push([packaged]() { (*packaged)(); });
+    }
+    cv_.notify_one();
+    return result;
+  }
+
+  unsigned thread_count() const {
+    return static_cast<unsigned>(workers_.size());
+  }
+  WorkerPlacement placement() const { return placement_; }
+
+  // NUMA node (CpuTopology index) of the calling pinned worker, -1 on any
+  // other thread
+  static int current_node();
+};
@@ -0,0 +1,127 @@
+#include "cpu_topology.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+// The system's nodes, keeping only CPUs in this process's affinity mask
+std::vector<std::vector<int>> read_nodes() {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+  std::vector<std::vector<int>> nodes;
+  // Node numbers can have gaps; stop after a run of missing ones
+  for (int node = 0, missing = 0; missing < 64; node++) {
+    std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) +
+                     "/cpulist");
+    if (!in) {
+      missing++;
+      continue;
+    }
+    missing = 0;
+    std::string text;
+    std::getline(in, text);
+    std::vector<int> cpus;
+    for (int cpu : parse_cpu_list(text)) {
+      if (!have_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)))
+        cpus.push_back(cpu);
+    }
+    nodes.push_back(cpus);
+  }
+
+  if (nodes.empty() && have_mask) {
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+      if (CPU_ISSET(cpu, &allowed))
+        cpus.push_back(cpu);
+    nodes.push_back(cpus);
+  }
+  return nodes;
+}
+#else
+std::vector<std::vector<int>> read_nodes() {
+  std::vector<int> cpus;
+  unsigned count = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned cpu = 0; cpu < count; cpu++)
+    cpus.push_back(static_cast<int>(cpu));
+  return {cpus};
+}
+#endif
+
+} // namespace
+
+std::vector<int> parse_cpu_list(const std::string &text) {
+  std::vector<int> cpus;
+  std::stringstream ss(text);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    range.erase(std::remove_if(range.begin(), range.end(),
+                               [](char c) { return c == ' ' || c == '\n'; }),
+                range.end());
+    if (range.empty())
+      continue;
+    char *end = nullptr;
+    long first = std::strtol(range.c_str(), &end, 10);
+    long last = first;
+    if (*end == '-')
+      last = std::strtol(end + 1, &end, 10);
+    if (*end != '\0' || first < 0 || last < first)
+      return {};
+    for (long cpu = first; cpu <= last; cpu++)
+      cpus.push_back(static_cast<int>(cpu));
+  }
+  return cpus;
+}
+
+CpuTopology::CpuTopology(std::vector<std::vector<int>> nodes) : cpus_(0) {
+  for (std::vector<int> &cpus : nodes) {
+    if (cpus.empty())
+      continue;
+    std::sort(cpus.begin(), cpus.end());
+    cpus_ += cpus.size();
+    nodes_.push_back(std::move(cpus));
+  }
+  if (nodes_.empty()) {
+    nodes_.push_back({0});
+    cpus_ = 1;
+  }
+}
+
+const CpuTopology &CpuTopology::system() {
+  static const CpuTopology topology(read_nodes());
+  return topology;
+}
+
+CpuSlot CpuTopology::slot(size_t worker) const {
+  size_t index = worker % cpus_;
+  for (size_t node = 0; node < nodes_.size(); node++) {
+    if (index < nodes_[node].size())
+      return {nodes_[node][index], static_cast<int>(node)};
+    index -= nodes_[node].size();
+  }
+  return {nodes_[0][0], 0}; // Unreachable: index < cpus_
+}
+
+bool pin_current_thread(int cpu) {
+#ifdef __linux__
+  if (cpu < 0 || cpu >= CPU_SETSIZE)
+    return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Where one worker runs
+struct CpuSlot {
+  int cpu;
+  int node; // Index into CpuTopology's nodes, not the kernel's node number
+};
+
+// The CPUs this process may run on, grouped by NUMA node. On Linux the
+// nodes come from /sys/devices/system/node, filtered by the process's
+// affinity mask; anywhere else (or if that is unreadable) every CPU is
+// on one node.
+class CpuTopology {
+private:
+  std::vector<std::vector<int>> nodes_; // Non-empty, each sorted
+  size_t cpus_;
+
+public:
+  // Nodes with no CPUs are dropped; no CPUs at all becomes one node with
+  // CPU 0
+  explicit CpuTopology(std::vector<std::vector<int>> nodes);
+
+  // Read once, the first time it is asked for
+  static const CpuTopology &system();
+
+  size_t node_count() const { return nodes_.size(); }
+  size_t cpu_count() const { return cpus_; }
+  const std::vector<int> &node_cpus(size_t node) const { return nodes_[node]; }
+
+  // Worker i fills node 0's CPUs first, then node 1's, and so on, wrapping
+  // once every CPU has a worker. A run on fewer workers than CPUs then
+  // stays on as few nodes as it can.
+  CpuSlot slot(size_t worker) const;
+};
+
+// CPUs in a kernel cpulist ("0-3,8,10-11"); empty if it does not parse
+std::vector<int> parse_cpu_list(const std::string &text);
+
+// Pin the calling thread to one CPU; false if that is not supported here
+// or the CPU is not available to the process
+bool pin_current_thread(int cpu);
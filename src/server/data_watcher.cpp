@@ -0,0 +1,65 @@
+#include "data_watcher.hpp"
+#include "../data/game_data.hpp"
+#include "../data/loader.hpp"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// min() if the file is missing, so it reloads once it appears
+std::filesystem::file_time_type write_time(const std::string &path) {
+  std::error_code ec;
+  std::filesystem::file_time_type time =
+      std::filesystem::last_write_time(path, ec);
+  return ec ? std::filesystem::file_time_type::min() : time;
+}
+
+} // namespace
+
+GameDataWatcher::GameDataWatcher(const std::string &species_path,
+                                 const std::string &moves_path,
+                                 int interval_seconds)
+    : species_path_(species_path), moves_path_(moves_path),
+      interval_seconds_(interval_seconds),
+      species_time_(write_time(species_path)),
+      moves_time_(write_time(moves_path)), stopping_(false),
+      thread_(&GameDataWatcher::run, this) {}
+
+GameDataWatcher::~GameDataWatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void GameDataWatcher::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!cv_.wait_for(lock, std::chrono::seconds(interval_seconds_),
+                       [this]() { return stopping_; })) {
+    std::filesystem::file_time_type species_time = write_time(species_path_);
+    std::filesystem::file_time_type moves_time = write_time(moves_path_);
+    if (species_time == species_time_ && moves_time == moves_time_)
+      continue;
+
+    // A half-written file fails to parse; the times are left alone so
+    // the next check tries it again
+    uint64_t before = GameData::getInstance().snapshot()->version();
+    std::stringstream report;
+    if (reload_game_data(species_path_, moves_path_)) {
+      species_time_ = species_time;
+      moves_time_ = moves_time;
+      uint64_t after = GameData::getInstance().snapshot()->version();
+      if (after == before)
+        report << "[Data] Reloaded game data, nothing changed\n";
+      else
+        report << "[Data] Reloaded game data, now version " << after << "\n";
+    } else {
+      report << "[Data] Could not reload " << species_path_ << " and "
+             << moves_path_ << ", keeping the current data\n";
+    }
+    std::cout << report.str() << std::flush;
+  }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Checks species.json and moves.json every interval and reloads them when
+// either has been written since, so balance changes go live without a
+// restart. Battles already running finish on the data they started with.
+class GameDataWatcher {
+private:
+  std::string species_path_;
+  std::string moves_path_;
+  int interval_seconds_;
+  std::filesystem::file_time_type species_time_;
+  std::filesystem::file_time_type moves_time_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_;
+  std::thread thread_;
+
+  void run();
+
+public:
+  GameDataWatcher(const std::string &species_path,
+                  const std::string &moves_path, int interval_seconds);
+  ~GameDataWatcher();
+
+  GameDataWatcher(const GameDataWatcher &) = delete;
+  GameDataWatcher &operator=(const GameDataWatcher &) = delete;
+};
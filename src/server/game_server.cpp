@@ -1,5 +1,7 @@
 #include "game_server.hpp"
+#include "../core/instrument.hpp"
 #include "../network/protocol.hpp"
+#include <algorithm>
 #include <iostream>
 
 GameServer::GameServer(int port) : port_(port), next_player_id_(1) {}
@@ -15,7 +17,7 @@ GameServer::~GameServer() {
 bool GameServer::start() {
   std::cout << "[Server] Starting on port " << port_ << "...\n";
 
-  if (!listen_socket_.listen(port_)) {
+  if (!listen_socket_.listen(port_, SOMAXCONN)) {
     std::cerr << "[Server] Failed to start listening\n";
     return false;
   }
@@ -43,9 +45,8 @@ ClientConnection *GameServer::accept_client() {
       new ClientConnection(client_socket, next_player_id_++);
 
   // Receive connection request with player name
-  std::vector<uint8_t> data = client_socket->receive();
-  if (!data.empty()) {
-    Message msg = Message::deserialize(data);
+  Message msg;
+  if (receive_message(*client_socket, msg)) {
     if (msg.type == MessageType::CONNECT_REQUEST) {
       client->player_name = msg.get_payload_string();
       std::cout << "[Server] Player '" << client->player_name
@@ -53,10 +54,27 @@ ClientConnection *GameServer::accept_client() {
 
       // Send connection response
       Message response(MessageType::CONNECT_RESPONSE, "Welcome to the server!");
-      client_socket->send(response.serialize());
+      send_message(*client_socket, response);
+    } else if (msg.type == MessageType::SPECTATE_REQUEST) {
+      client->player_name = msg.get_payload_string();
+      client->spectator = true;
+      std::cout << "[Server] Spectator '" << client->player_name
+                << "' connected (ID: " << client->player_id << ")\n";
+
+      Message response(MessageType::CONNECT_RESPONSE,
+                       "Welcome! You will be watching the next live battle.");
+      send_message(*client_socket, response);
+    } else if (msg.type == MessageType::STATS_REQUEST) {
+      // Admin query: answer and hang up without becoming a client
+      Message response(MessageType::STATS,
+                       instrument::format(instrument::snapshot()));
+      send_message(*client_socket, response);
+      delete client;
+      return nullptr;
     }
   }
 
+  std::lock_guard<std::mutex> lock(clients_mutex_);
   clients_.push_back(client);
   return client;
 }
@@ -64,9 +82,14 @@ ClientConnection *GameServer::accept_client() {
 void GameServer::wait_for_clients(int count) {
   std::cout << "[Server] Waiting for " << count << " clients...\n";
 
-  while (clients_.size() < static_cast<size_t>(count)) {
-    accept_client();
-    std::cout << "[Server] " << clients_.size() << "/" << count
+  // Spectators may connect too but don't count towards the players needed
+  int players = 0;
+  while (players < count) {
+    ClientConnection *client = accept_client();
+    if (client && !client->spectator) {
+      players++;
+    }
+    std::cout << "[Server] " << players << "/" << count
               << " clients connected\n";
   }
 
@@ -74,6 +97,7 @@ void GameServer::wait_for_clients(int count) {
 }
 
 void GameServer::disconnect_client(ClientConnection *client) {
+  std::lock_guard<std::mutex> lock(clients_mutex_);
   auto it = std::find(clients_.begin(), clients_.end(), client);
   if (it != clients_.end()) {
     std::cout << "[Server] Disconnecting player '" << client->player_name
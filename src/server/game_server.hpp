@@ -1,5 +1,8 @@
 #pragma once
+#include "../network/protocol.hpp"
 #include "../network/socket.hpp"
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -9,9 +12,16 @@ struct ClientConnection {
   std::string player_name;
   int player_id;
   bool ready;
+  bool spectator; // Connected with SPECTATE_REQUEST: watches, never plays
+  std::mutex send_mutex; // Serializes writes from battle/tournament threads
+
+  // Used by the ServerEventLoop while a decision is awaited
+  FrameDecoder inbox;               // Bytes read ahead of the next message
+  std::atomic<int> stale_responses; // Answers to requests that timed out
 
   ClientConnection(Socket *s, int id)
-      : socket(s), player_id(id), ready(false) {}
+      : socket(s), player_id(id), ready(false), spectator(false),
+        stale_responses(0) {}
 
   ~ClientConnection() {
     if (socket) {
@@ -25,6 +35,7 @@ class GameServer {
 private:
   Socket listen_socket_;
   std::vector<ClientConnection *> clients_;
+  std::mutex clients_mutex_; // accept/disconnect may run on different threads
   int port_;
   int next_player_id_;
 
@@ -38,6 +49,9 @@ public:
 
   // Client management
   ClientConnection *accept_client();
+  bool has_pending_client(int timeout_ms) {
+    return listen_socket_.wait_readable(timeout_ms);
+  }
   void wait_for_clients(int count);
   void disconnect_client(ClientConnection *client);
 
@@ -0,0 +1,45 @@
+#include "headless_battle.hpp"
+#include "../core/battle.hpp"
+#include "../core/battle_output.hpp"
+#include "../core/battle_pool.hpp"
+
+HeadlessBattleResult run_headless_battle(const std::vector<Pokemon> &team1,
+                                         const std::vector<Pokemon> &team2,
+                                         const BattleAI &ai1,
+                                         const BattleAI &ai2, int max_turns) {
+  QuietBattleOutput quiet;
+  BattlePool::Lease lease = BattlePool::local().acquire(team1, team2);
+  Battle &battle = *lease;
+  GameDataScope pinned(battle.game_data()); // For the AIs' choices too
+
+  int turns = 0;
+  while (!battle.over && turns < max_turns) {
+    turns++;
+
+    int move1 = ai1.choose_move(battle.active1, battle.active2);
+    int move2 = ai2.choose_move(battle.active2, battle.active1);
+    battle.execute_turn(move1, move2);
+
+    // Replace fainted Pokemon
+    if (battle.active1.hp() <= 0 && !battle.is_team_defeated(1)) {
+      battle.switch_pokemon(1, battle.get_available_pokemon(1)[0]);
+    }
+    if (battle.active2.hp() <= 0 && !battle.is_team_defeated(2)) {
+      battle.switch_pokemon(2, battle.get_available_pokemon(2)[0]);
+    }
+  }
+
+  HeadlessBattleResult result;
+  result.turns = turns;
+  result.remaining1 = battle.get_remaining_pokemon(1);
+  result.remaining2 = battle.get_remaining_pokemon(2);
+
+  if (battle.is_team_defeated(2) && !battle.is_team_defeated(1)) {
+    result.winner = 1;
+  } else if (battle.is_team_defeated(1) && !battle.is_team_defeated(2)) {
+    result.winner = 2;
+  } else {
+    result.winner = 0;
+  }
+  return result;
+}
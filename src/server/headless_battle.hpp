@@ -0,0 +1,20 @@
+#pragma once
+#include "../ai/ai_interface.hpp"
+#include "../core/pokemon.hpp"
+#include <vector>
+
+// Outcome of a battle played entirely by AIs
+struct HeadlessBattleResult {
+  int winner; // 1 or 2, 0 if the turn limit was reached first
+  int turns;
+  int remaining1; // Pokemon left standing on each side
+  int remaining2;
+};
+
+// Play a full battle with no output, both sides driven by a BattleAI.
+// Fainted Pokemon are replaced by the first healthy team member.
+HeadlessBattleResult run_headless_battle(const std::vector<Pokemon> &team1,
+                                         const std::vector<Pokemon> &team2,
+                                         const BattleAI &ai1,
+                                         const BattleAI &ai2,
+                                         int max_turns = 200);
@@ -0,0 +1,149 @@
+#include "lobby_service.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+LobbyService::LobbyService(GameServer &server, BattleExecutor &executor,
+                           ServerEventLoop &loop, LobbyConfig config,
+                           GhostPool *ghosts)
+    : server_(server), executor_(executor), loop_(loop), config_(config),
+      ghosts_(ghosts), running_(false), lobbies_started_(0),
+      lobbies_finished_(0), players_seated_(0) {}
+
+void LobbyService::accept_loop() {
+  while (running_) {
+    if (!server_.has_pending_client(200))
+      continue;
+
+    ClientConnection *client = server_.accept_client();
+    if (!client)
+      continue;
+    if (client->player_name.empty()) {
+      server_.disconnect_client(client); // Never sent CONNECT_REQUEST
+      continue;
+    }
+
+    if (client->spectator) {
+      {
+        std::lock_guard<std::mutex> lock(client->send_mutex);
+        send_message(*client->socket,
+                     Message(MessageType::ERROR_MSG,
+                             "Lobbies cannot be spectated"));
+      }
+      server_.disconnect_client(client);
+      continue;
+    }
+
+    add_player(client);
+  }
+}
+
+void LobbyService::add_player(ClientConnection *client) {
+  std::unique_ptr<AutobattlerLobby> lobby;
+  std::vector<ClientConnection *> gone;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    waiting_.push_back(client);
+
+    // Players who left while waiting give up their seat
+    auto left = std::stable_partition(
+        waiting_.begin(), waiting_.end(),
+        [](ClientConnection *c) { return !c->socket->peer_closed(); });
+    gone.assign(left, waiting_.end());
+    waiting_.erase(left, waiting_.end());
+
+    if (static_cast<int>(waiting_.size()) >= config_.players) {
+      lobby.reset(new AutobattlerLobby(++lobbies_started_, waiting_, config_,
+                                       loop_, executor_, ghosts_));
+      players_seated_ += static_cast<int>(waiting_.size());
+      waiting_.clear();
+    } else {
+      Message queued(MessageType::BATTLE_LOG,
+                     "Waiting for players (" + std::to_string(waiting_.size()) +
+                         "/" + std::to_string(config_.players) + ")...\n");
+      for (ClientConnection *c : waiting_) {
+        std::lock_guard<std::mutex> send_lock(c->send_mutex);
+        send_message(*c->socket, queued);
+      }
+    }
+  }
+
+  for (ClientConnection *c : gone)
+    server_.disconnect_client(c);
+
+  if (lobby) {
+    AutobattlerLobby *started = lobby.get();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      lobbies_.push_back(std::move(lobby));
+    }
+    std::cout << "[Lobby " << started->id() << "] Starting with "
+              << config_.players << " players\n";
+    started->start();
+  }
+}
+
+void LobbyService::reap_finished() {
+  std::vector<std::unique_ptr<AutobattlerLobby>> done;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < lobbies_.size();) {
+      if (lobbies_[i]->finished()) {
+        done.push_back(std::move(lobbies_[i]));
+        lobbies_[i] = std::move(lobbies_.back());
+        lobbies_.pop_back();
+      } else {
+        i++;
+      }
+    }
+  }
+
+  for (auto &lobby : done) {
+    std::cout << "[Lobby " << lobby->id() << "] Finished after round "
+              << lobby->round() << "\n";
+    for (ClientConnection *client : lobby->clients())
+      server_.disconnect_client(client);
+    lobbies_finished_++;
+  }
+}
+
+void LobbyService::print_stats() {
+  size_t waiting;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    waiting = waiting_.size();
+  }
+  std::cout << "[Lobbies] active=" << active_lobbies()
+            << " finished=" << lobbies_finished_ << " players seated="
+            << players_seated_ << " waiting=" << waiting << "\n";
+}
+
+void LobbyService::run(int max_lobbies) {
+  running_ = true;
+  std::thread acceptor([this]() { accept_loop(); });
+
+  auto last_report = std::chrono::steady_clock::now();
+  while (running_) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    reap_finished();
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_report >= std::chrono::seconds(5)) {
+      print_stats();
+      last_report = now;
+    }
+
+    if (max_lobbies > 0 && lobbies_finished_ >= max_lobbies) {
+      running_ = false;
+    }
+  }
+
+  acceptor.join();
+  // Let lobbies still in progress play out
+  while (active_lobbies() > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    reap_finished();
+  }
+  print_stats();
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "autobattler_lobby.hpp"
+#include "battle_executor.hpp"
+#include "game_server.hpp"
+#include "server_event_loop.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Autobattler lobby mode: accepts players continuously and seats every
+// config.players of them in a new AutobattlerLobby. Lobbies share the
+// event loop and the executor, so their count is bounded by memory, not
+// threads.
+class LobbyService {
+private:
+  GameServer &server_;
+  BattleExecutor &executor_;
+  ServerEventLoop &loop_;
+  LobbyConfig config_;
+  GhostPool *ghosts_;
+
+  std::vector<ClientConnection *> waiting_; // Next lobby's players
+  std::vector<std::unique_ptr<AutobattlerLobby>> lobbies_;
+  std::mutex mutex_; // Guards waiting_ and lobbies_
+
+  std::atomic<bool> running_;
+  std::atomic<int> lobbies_started_;
+  std::atomic<int> lobbies_finished_;
+  std::atomic<int> players_seated_;
+
+  void accept_loop();
+  void add_player(ClientConnection *client);
+  void reap_finished();
+  void print_stats();
+
+public:
+  LobbyService(GameServer &server, BattleExecutor &executor,
+               ServerEventLoop &loop, LobbyConfig config = LobbyConfig(),
+               GhostPool *ghosts = nullptr);
+
+  // Blocks until max_lobbies have finished (0 = run until stop())
+  void run(int max_lobbies = 0);
+  void stop() { running_ = false; }
+
+  int active_lobbies() const { return lobbies_started_ - lobbies_finished_; }
+  int lobbies_finished() const { return lobbies_finished_; }
+};
@@ -0,0 +1,133 @@
+#include "matchmaking.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+int RatingTable::get(const std::string &name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = ratings_.find(name);
+  return it != ratings_.end() ? it->second : 1500;
+}
+
+double RatingTable::expected_score(int rating, int opponent) {
+  return 1.0 / (1.0 + std::pow(10.0, (opponent - rating) / 400.0));
+}
+
+int RatingTable::record_result(const std::string &winner,
+                               const std::string &loser) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  int &winner_rating = ratings_.emplace(winner, 1500).first->second;
+  int &loser_rating = ratings_.emplace(loser, 1500).first->second;
+
+  int delta = static_cast<int>(std::lround(
+      k_factor_ * (1.0 - expected_score(winner_rating, loser_rating))));
+  winner_rating += delta;
+  loser_rating -= delta;
+  return delta;
+}
+
+MatchmakingQueue::MatchmakingQueue(MatchmakingConfig config)
+    : config_(config), next_ticket_(1), peak_depth_(0), matched_(0) {}
+
+int MatchmakingQueue::window_for(const Entry &entry,
+                                 Clock::time_point now) const {
+  auto waited =
+      std::chrono::duration_cast<std::chrono::seconds>(now - entry.enqueued);
+  long long window = config_.initial_window +
+                     static_cast<long long>(config_.window_growth) *
+                         std::max<long long>(waited.count(), 0);
+  return static_cast<int>(std::min<long long>(window, config_.max_window));
+}
+
+uint64_t MatchmakingQueue::enqueue(ClientConnection *client, int rating,
+                                   Clock::time_point now,
+                                   std::vector<Pairing> &out) {
+  Entry entry{client, rating, now, next_ticket_++};
+  auto it = by_rating_.emplace(rating, entry);
+  by_age_.push_back(it);
+  tickets_[entry.ticket] = std::prev(by_age_.end());
+  peak_depth_ = std::max(peak_depth_, by_rating_.size());
+
+  try_pair(it, now, out);
+  return entry.ticket;
+}
+
+bool MatchmakingQueue::remove(uint64_t ticket) {
+  auto found = tickets_.find(ticket);
+  if (found == tickets_.end())
+    return false;
+  erase(*found->second);
+  return true;
+}
+
+void MatchmakingQueue::erase(RatingIndex::iterator it) {
+  auto ticket = tickets_.find(it->second.ticket);
+  by_age_.erase(ticket->second);
+  tickets_.erase(ticket);
+  by_rating_.erase(it);
+}
+
+bool MatchmakingQueue::try_pair(RatingIndex::iterator it,
+                                Clock::time_point now,
+                                std::vector<Pairing> &out) {
+  // The closest rating is always an immediate neighbour in the index
+  RatingIndex::iterator best = by_rating_.end();
+  if (it != by_rating_.begin()) {
+    best = std::prev(it);
+  }
+  auto next = std::next(it);
+  if (next != by_rating_.end() &&
+      (best == by_rating_.end() ||
+       next->first - it->first < it->first - best->first)) {
+    best = next;
+  }
+  if (best == by_rating_.end())
+    return false;
+
+  int gap = std::abs(best->first - it->first);
+  int window = std::max(window_for(it->second, now),
+                        window_for(best->second, now));
+  if (gap > window)
+    return false;
+
+  for (const Entry *entry : {&it->second, &best->second}) {
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - entry->enqueued);
+    wait_ms_.record(static_cast<uint64_t>(std::max<long long>(
+        static_cast<long long>(waited.count()), 0)));
+  }
+  matched_ += 2;
+
+  out.push_back({it->second, best->second});
+  erase(it);
+  erase(best);
+  return true;
+}
+
+void MatchmakingQueue::find_matches(Clock::time_point now,
+                                    std::vector<Pairing> &out) {
+  std::vector<uint64_t> oldest_first;
+  oldest_first.reserve(by_age_.size());
+  for (auto it : by_age_) {
+    oldest_first.push_back(it->second.ticket);
+  }
+
+  for (uint64_t ticket : oldest_first) {
+    auto found = tickets_.find(ticket);
+    if (found == tickets_.end())
+      continue; // Already paired this pass
+    try_pair(*found->second, now, out);
+  }
+}
+
+MatchmakingStats MatchmakingQueue::stats() const {
+  MatchmakingStats stats;
+  stats.queue_depth = by_rating_.size();
+  stats.peak_queue_depth = peak_depth_;
+  stats.players_matched = matched_;
+  stats.wait_p50_ms = wait_ms_.percentile(0.50);
+  stats.wait_p99_ms = wait_ms_.percentile(0.99);
+  stats.wait_max_ms = wait_ms_.max();
+  stats.wait_mean_ms = wait_ms_.mean();
+  return stats;
+}
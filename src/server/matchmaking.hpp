@@ -0,0 +1,100 @@
+#pragma once
+#include "../network/latency_histogram.hpp"
+#include "game_server.hpp"
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Elo ratings by player name (new players start at 1500)
+class RatingTable {
+private:
+  std::unordered_map<std::string, int> ratings_;
+  mutable std::mutex mutex_;
+  int k_factor_;
+
+public:
+  explicit RatingTable(int k_factor = 32) : k_factor_(k_factor) {}
+
+  int get(const std::string &name) const;
+
+  // Apply the result of one game; returns the winner's rating change
+  int record_result(const std::string &winner, const std::string &loser);
+
+  // Elo expected score of a player rated `rating` against `opponent`
+  static double expected_score(int rating, int opponent);
+};
+
+struct MatchmakingConfig {
+  int initial_window = 50;  // Rating difference accepted immediately
+  int window_growth = 50;   // Added per second spent waiting
+  int max_window = 1000;    // Widest the window ever gets
+};
+
+struct MatchmakingStats {
+  size_t queue_depth;
+  size_t peak_queue_depth;
+  uint64_t players_matched;
+  uint64_t wait_p50_ms;
+  uint64_t wait_p99_ms;
+  uint64_t wait_max_ms;
+  double wait_mean_ms;
+};
+
+// Queue of waiting players ordered by rating. A player is paired with the
+// nearest-rated waiting player (its neighbour in the rating index, found in
+// O(log n)) once their rating gap fits inside the longer waiter's window.
+class MatchmakingQueue {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    ClientConnection *client;
+    int rating;
+    Clock::time_point enqueued;
+    uint64_t ticket;
+  };
+
+  struct Pairing {
+    Entry first;
+    Entry second;
+  };
+
+private:
+  using RatingIndex = std::multimap<int, Entry>;
+
+  MatchmakingConfig config_;
+  RatingIndex by_rating_;
+  std::list<RatingIndex::iterator> by_age_; // Oldest first
+  std::unordered_map<uint64_t, std::list<RatingIndex::iterator>::iterator>
+      tickets_;
+  uint64_t next_ticket_;
+  size_t peak_depth_;
+  uint64_t matched_;
+  LatencyHistogram wait_ms_;
+
+  int window_for(const Entry &entry, Clock::time_point now) const;
+  bool try_pair(RatingIndex::iterator it, Clock::time_point now,
+                std::vector<Pairing> &out);
+  void erase(RatingIndex::iterator it);
+
+public:
+  explicit MatchmakingQueue(MatchmakingConfig config = MatchmakingConfig());
+
+  // Adds a player and pairs them straight away if someone fits the window
+  uint64_t enqueue(ClientConnection *client, int rating,
+                   Clock::time_point now, std::vector<Pairing> &out);
+
+  // Drop a waiting player (e.g. they disconnected); false if not queued
+  bool remove(uint64_t ticket);
+
+  // Re-check waiting players, oldest first, as their windows widen
+  void find_matches(Clock::time_point now, std::vector<Pairing> &out);
+
+  size_t size() const { return by_rating_.size(); }
+  MatchmakingStats stats() const;
+};
@@ -0,0 +1,197 @@
+#include "matchmaking_service.hpp"
+#include "team_generator.hpp"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+MatchmakingService::MatchmakingService(GameServer &server,
+                                       BattleExecutor &executor,
+                                       MatchmakingConfig config)
+    : server_(server), executor_(executor), queue_(config), running_(false),
+      battles_started_(0), battles_finished_(0) {}
+
+void MatchmakingService::accept_loop() {
+  while (running_) {
+    if (!server_.has_pending_client(200))
+      continue;
+
+    ClientConnection *client = server_.accept_client();
+    if (!client)
+      continue;
+    if (client->player_name.empty()) {
+      server_.disconnect_client(client); // Never sent CONNECT_REQUEST
+      continue;
+    }
+
+    if (client->spectator) {
+      add_spectator(client);
+      continue;
+    }
+
+    int rating = ratings_.get(client->player_name);
+    Message queued(MessageType::BATTLE_LOG,
+                   "Searching for an opponent (rating " +
+                       std::to_string(rating) + ")...\n");
+    {
+      std::lock_guard<std::mutex> lock(client->send_mutex);
+      send_message(*client->socket, queued);
+    }
+
+    std::vector<MatchmakingQueue::Pairing> pairs;
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      queue_.enqueue(client, rating, MatchmakingQueue::Clock::now(), pairs);
+    }
+    start_battles(pairs);
+  }
+}
+
+void MatchmakingService::start_battles(
+    const std::vector<MatchmakingQueue::Pairing> &pairs) {
+  for (const auto &pair : pairs) {
+    ClientConnection *p1 = pair.first.client;
+    ClientConnection *p2 = pair.second.client;
+
+    // Players who left while queued are dropped; their partner requeues
+    bool p1_gone = p1->socket->peer_closed();
+    bool p2_gone = p2->socket->peer_closed();
+    if (p1_gone || p2_gone) {
+      std::vector<MatchmakingQueue::Pairing> retry;
+      {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        auto now = MatchmakingQueue::Clock::now();
+        if (!p1_gone)
+          queue_.enqueue(p1, pair.first.rating, now, retry);
+        if (!p2_gone)
+          queue_.enqueue(p2, pair.second.rating, now, retry);
+      }
+      if (p1_gone)
+        server_.disconnect_client(p1);
+      if (p2_gone)
+        server_.disconnect_client(p2);
+      start_battles(retry);
+      continue;
+    }
+
+    battles_started_++;
+    std::lock_guard<std::mutex> lock(battles_mutex_);
+    battles_.push_back(
+        executor_.submit([this, p1, p2]() { run_battle(p1, p2); }));
+  }
+}
+
+void MatchmakingService::add_spectator(ClientConnection *client) {
+  std::lock_guard<std::mutex> lock(spectate_mutex_);
+  if (live_battles_.empty()) {
+    waiting_spectators_.push_back(client);
+  } else {
+    live_battles_.back()->add_spectator(client);
+  }
+}
+
+void MatchmakingService::run_battle(ClientConnection *p1,
+                                    ClientConnection *p2) {
+  NetworkBattle battle(generate_random_team(6, 50), generate_random_team(6, 50),
+                       p1, p2);
+  battle.set_decision_policy(decision_policy_);
+  battle.set_replay_writer(replay_writer_);
+  {
+    std::lock_guard<std::mutex> lock(spectate_mutex_);
+    live_battles_.push_back(&battle);
+    for (auto *spectator : waiting_spectators_) {
+      battle.add_spectator(spectator);
+    }
+    waiting_spectators_.clear();
+  }
+
+  try {
+    battle.run();
+  } catch (const std::exception &e) {
+    std::cerr << "[Matchmaking] Exception during battle: " << e.what()
+              << "\n";
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(spectate_mutex_);
+    live_battles_.erase(
+        std::find(live_battles_.begin(), live_battles_.end(), &battle));
+  }
+  for (auto *spectator : battle.release_spectators(1000)) {
+    server_.disconnect_client(spectator);
+  }
+
+  if (battle.winner() != 0) {
+    ClientConnection *winner = battle.winner() == 1 ? p1 : p2;
+    ClientConnection *loser = battle.winner() == 1 ? p2 : p1;
+    int delta = ratings_.record_result(winner->player_name, loser->player_name);
+    std::cout << "[Matchmaking] " << winner->player_name << " defeated "
+              << loser->player_name << " (+/-" << delta << ")\n";
+  }
+
+  server_.disconnect_client(p1);
+  server_.disconnect_client(p2);
+  battles_finished_++;
+}
+
+MatchmakingStats MatchmakingService::stats() {
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  return queue_.stats();
+}
+
+void MatchmakingService::print_stats() {
+  MatchmakingStats s = stats();
+  std::cout << "[Matchmaking] queue=" << s.queue_depth
+            << " (peak " << s.peak_queue_depth << ") matched="
+            << s.players_matched << " active battles=" << active_battles()
+            << " time-to-match p50=" << s.wait_p50_ms
+            << "ms p99=" << s.wait_p99_ms << "ms max=" << s.wait_max_ms
+            << "ms\n";
+}
+
+void MatchmakingService::run(int max_battles) {
+  running_ = true;
+  std::thread acceptor([this]() { accept_loop(); });
+
+  auto last_report = MatchmakingQueue::Clock::now();
+  while (running_) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto now = MatchmakingQueue::Clock::now();
+
+    // Widen windows and pair anyone who now fits
+    std::vector<MatchmakingQueue::Pairing> pairs;
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      queue_.find_matches(now, pairs);
+    }
+    start_battles(pairs);
+
+    // Forget finished battles
+    std::unique_lock<std::mutex> battles_lock(battles_mutex_);
+    for (size_t i = 0; i < battles_.size();) {
+      if (battles_[i].wait_for(std::chrono::seconds(0)) ==
+          std::future_status::ready) {
+        battles_[i] = std::move(battles_.back());
+        battles_.pop_back();
+      } else {
+        i++;
+      }
+    }
+    battles_lock.unlock();
+
+    if (now - last_report >= std::chrono::seconds(5)) {
+      print_stats();
+      last_report = now;
+    }
+
+    if (max_battles > 0 && battles_finished_ >= max_battles) {
+      running_ = false;
+    }
+  }
+
+  acceptor.join();
+  for (auto &battle : battles_) {
+    battle.wait();
+  }
+  battles_.clear();
+  print_stats();
+}
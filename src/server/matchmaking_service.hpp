@@ -0,0 +1,56 @@
+#pragma once
+#include "battle_executor.hpp"
+#include "game_server.hpp"
+#include "matchmaking.hpp"
+#include "network_battle.hpp"
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <vector>
+
+// Ranked mode: accepts players continuously, queues them by rating and
+// starts a NetworkBattle on the executor as soon as a pair forms.
+class MatchmakingService {
+private:
+  GameServer &server_;
+  BattleExecutor &executor_;
+  MatchmakingQueue queue_;
+  RatingTable ratings_;
+  std::mutex queue_mutex_;
+
+  std::atomic<bool> running_;
+  std::atomic<int> battles_started_;
+  std::atomic<int> battles_finished_;
+  std::vector<std::future<void>> battles_;
+  std::mutex battles_mutex_; // Appended by the accept thread too
+
+  // Spectators join the newest live battle, or wait for the next one
+  std::vector<NetworkBattle *> live_battles_;
+  std::vector<ClientConnection *> waiting_spectators_;
+  std::mutex spectate_mutex_;
+
+  DecisionPolicy decision_policy_;
+  ReplayWriter *replay_writer_ = nullptr; // Records every battle, if set
+
+  void add_spectator(ClientConnection *client);
+
+  void accept_loop();
+  void start_battles(const std::vector<MatchmakingQueue::Pairing> &pairs);
+  void run_battle(ClientConnection *p1, ClientConnection *p2);
+  void print_stats();
+
+public:
+  MatchmakingService(GameServer &server, BattleExecutor &executor,
+                     MatchmakingConfig config = MatchmakingConfig());
+
+  // Blocks until max_battles have finished (0 = run until stop())
+  void run(int max_battles = 0);
+  void stop() { running_ = false; }
+  void set_decision_policy(const DecisionPolicy &policy) {
+    decision_policy_ = policy;
+  }
+  void set_replay_writer(ReplayWriter *writer) { replay_writer_ = writer; }
+
+  MatchmakingStats stats();
+  int active_battles() const { return battles_started_ - battles_finished_; }
+};
@@ -0,0 +1,447 @@
+#include "matchup_matrix.hpp"
+#include "../ai/gen1_ai.hpp"
+#include "../autobattler/auto_battle.hpp"
+#include "../core/rng.hpp"
+#include "../core/timeline.hpp"
+#include "../data/binary_io.hpp"
+#include "../data/catalog.hpp"
+#include "../data/mapped_file.hpp"
+#include "headless_battle.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const char MATRIX_MAGIC[8] = {'G', '1', 'M', 'A', 'T', 'R', 'I', 'X'};
+const uint32_t MATRIX_FORMAT_VERSION = 1;
+
+using namespace matrix_format;
+
+uint64_t mix(uint64_t value) {
+  value += 0x9E3779B97F4A7C15ULL;
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+  return value ^ (value >> 31);
+}
+
+std::string trim(const std::string &text) {
+  size_t begin = text.find_first_not_of(" \t\r\n");
+  if (begin == std::string::npos)
+    return "";
+  size_t end = text.find_last_not_of(" \t\r\n");
+  return text.substr(begin, end - begin + 1);
+}
+
+std::vector<std::string> split(const std::string &text, char separator) {
+  std::vector<std::string> parts;
+  std::stringstream ss(text);
+  std::string part;
+  while (std::getline(ss, part, separator))
+    parts.push_back(trim(part));
+  return parts;
+}
+
+// Expected damage of a move for this species, before the type chart
+double move_strength(const MoveData &move, const SpeciesData &species) {
+  double strength = move.power * move.accuracy / 100.0;
+  if (move.type == species.type1 || move.type == species.type2)
+    strength *= 1.5;
+  return strength;
+}
+
+void write_csv_label(std::ostream &out, const std::string &label) {
+  out << '"';
+  for (char c : label)
+    out << (c == '"' ? "\"\"" : std::string(1, c));
+  out << '"';
+}
+
+} // namespace
+
+std::vector<const MoveData *> fixed_moveset(const SpeciesData &species) {
+  std::vector<const MoveData *> candidates;
+  for (const MoveData *move : GameData::getInstance().getAllMoves()) {
+    if (move->power > 0 && move->category != MoveCategory::Status &&
+        move->max_pp > 0)
+      candidates.push_back(move);
+  }
+  // Strongest first; getAllMoves() is by name, so ties stay in name order
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [&](const MoveData *a, const MoveData *b) {
+                     return move_strength(*a, species) >
+                            move_strength(*b, species);
+                   });
+
+  std::vector<const MoveData *> moves;
+  auto take_best = [&](auto wanted) {
+    for (const MoveData *move : candidates) {
+      if (moves.size() == 4)
+        return;
+      bool type_taken = false;
+      for (const MoveData *chosen : moves)
+        type_taken = type_taken || chosen->type == move->type;
+      if (!type_taken && wanted(*move))
+        moves.push_back(move);
+    }
+  };
+  // Own types first, then coverage
+  take_best([&](const MoveData &move) {
+    return move.type == species.type1 || move.type == species.type2;
+  });
+  take_best([](const MoveData &) { return true; });
+  return moves;
+}
+
+std::vector<MatrixTeam> single_species_teams(int level) {
+  const GameData &data = GameData::getInstance();
+  std::vector<MatrixTeam> teams;
+  for (size_t id = 0; id < data.speciesCount(); id++) {
+    const SpeciesData *species = data.getSpecies(static_cast<SpeciesId>(id));
+    std::vector<Pokemon> team;
+    team.emplace_back(species, level);
+    for (const MoveData *move : fixed_moveset(*species))
+      team.back().add_move(Move(move));
+
+    MatrixTeam entry;
+    entry.label = species->name;
+    if (TeamSpec::from_team(team, entry.spec))
+      teams.push_back(entry);
+  }
+  return teams;
+}
+
+bool parse_matrix_team(const std::string &line, MatrixTeam &team,
+                       std::string &error) {
+  const GameData &data = GameData::getInstance();
+  std::vector<Pokemon> members;
+  for (const std::string &member : split(line, ';')) {
+    if (member.empty())
+      continue;
+    std::vector<std::string> fields = split(member, ':');
+    const SpeciesData *species = data.getSpecies(fields[0]);
+    if (!species) {
+      error = "Unknown species " + fields[0];
+      return false;
+    }
+
+    int level = 50;
+    if (fields.size() > 1 && !fields[1].empty()) {
+      level = std::atoi(fields[1].c_str());
+      if (level < 1 || level > 100) {
+        error = "Bad level for " + fields[0] + ": " + fields[1];
+        return false;
+      }
+    }
+
+    members.emplace_back(species, level);
+    if (fields.size() > 2) {
+      for (const std::string &name : split(fields[2], '/')) {
+        const MoveData *move = data.getMove(name);
+        if (!move) {
+          error = "Unknown move " + name;
+          return false;
+        }
+        members.back().add_move(Move(move));
+      }
+    } else {
+      for (const MoveData *move : fixed_moveset(*species))
+        members.back().add_move(Move(move));
+    }
+  }
+
+  if (!TeamSpec::from_team(members, team.spec)) {
+    error = members.empty() ? "Empty team" : "Team does not fit a TeamSpec";
+    return false;
+  }
+  team.label = members.front().name();
+  return true;
+}
+
+bool load_matrix_teams(const std::string &path, std::vector<MatrixTeam> &teams,
+                       std::string &error) {
+  std::ifstream in(path);
+  if (!in) {
+    error = "Cannot open " + path;
+    return false;
+  }
+
+  std::string line;
+  int line_number = 0;
+  while (std::getline(in, line)) {
+    line_number++;
+    std::string text = trim(line);
+    if (text.empty() || text[0] == '#')
+      continue;
+    MatrixTeam team;
+    if (!parse_matrix_team(text, team, error)) {
+      error = path + ":" + std::to_string(line_number) + ": " + error;
+      return false;
+    }
+    team.label = std::to_string(line_number) + ":" + team.label;
+    teams.push_back(team);
+  }
+  return true;
+}
+
+MatchupMatrix::MatchupMatrix(std::vector<MatrixTeam> teams,
+                             const MatrixConfig &config)
+    : teams_(std::move(teams)), config_(config),
+      tile_size_(static_cast<size_t>(std::max(1, config.tile))),
+      tiles_per_side_((teams_.size() + tile_size_ - 1) / tile_size_),
+      cells_(teams_.size() * teams_.size()), done_(tile_count(), 0) {}
+
+MatchupMatrix::~MatchupMatrix() {
+  if (file_)
+    std::fclose(file_);
+}
+
+uint64_t MatchupMatrix::fingerprint() const {
+  uint64_t hash = mix(DataCatalog().fingerprint());
+  for (const MatrixTeam &team : teams_)
+    hash = mix(hash ^ team.spec.hash());
+  hash = mix(hash ^ static_cast<uint64_t>(config_.games));
+  hash = mix(hash ^ config_.seed);
+  hash = mix(hash ^ tile_size_);
+  hash = mix(hash ^ static_cast<uint64_t>(config_.engine));
+  return mix(hash ^ static_cast<uint64_t>(config_.max_turns));
+}
+
+MatchupMatrix::Tile MatchupMatrix::tile(size_t index) const {
+  Tile t;
+  t.row = index / tiles_per_side_ * tile_size_;
+  t.col = index % tiles_per_side_ * tile_size_;
+  t.rows = std::min(tile_size_, teams_.size() - t.row);
+  t.cols = std::min(tile_size_, teams_.size() - t.col);
+  return t;
+}
+
+size_t MatchupMatrix::tiles_done() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return tiles_done_;
+}
+
+double MatchupMatrix::overall_win_rate(size_t row) const {
+  MatrixCell total;
+  for (size_t col = 0; col < teams_.size(); col++) {
+    const MatrixCell &c = cell(row, col);
+    total.wins += c.wins;
+    total.losses += c.losses;
+    total.draws += c.draws;
+  }
+  return total.win_rate();
+}
+
+size_t MatchupMatrix::load_tiles(const uint8_t *data, size_t size) {
+  size_t offset = FILE_HEADER_SIZE;
+  while (size - offset >= RECORD_HEADER_SIZE) {
+    const uint8_t *record = data + offset;
+    uint32_t index = get_u32(record);
+    if (index >= tile_count())
+      break;
+    Tile t = tile(index);
+    size_t cell_count = get_u32(record + 4);
+    size_t length = RECORD_HEADER_SIZE + cell_count * CELL_SIZE;
+    if (cell_count != t.rows * t.cols || length > size - offset)
+      break;
+
+    const uint8_t *in = record + RECORD_HEADER_SIZE;
+    for (size_t r = 0; r < t.rows; r++) {
+      for (size_t c = 0; c < t.cols; c++) {
+        MatrixCell &cell = cells_[(t.row + r) * teams_.size() + t.col + c];
+        cell.wins = get_u32(in);
+        cell.losses = get_u32(in + 4);
+        cell.draws = get_u32(in + 8);
+        in += CELL_SIZE;
+      }
+    }
+    if (!done_[index]) {
+      done_[index] = 1;
+      tiles_done_++;
+    }
+    offset += length;
+  }
+  return offset;
+}
+
+bool MatchupMatrix::open(const std::string &path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  error_.clear();
+  if (file_) {
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+
+  uint64_t expected = fingerprint();
+  size_t keep = 0;
+  size_t existing_size = 0;
+  {
+    MappedFile existing;
+    if (existing.open(path) && existing.size() > 0) {
+      const uint8_t *data = existing.data();
+      existing_size = existing.size();
+      if (existing_size < FILE_HEADER_SIZE ||
+          std::memcmp(data, MATRIX_MAGIC, sizeof(MATRIX_MAGIC)) != 0 ||
+          get_u32(data + 8) != MATRIX_FORMAT_VERSION) {
+        error_ = path + " is not a matrix results file";
+        return false;
+      }
+      if (get_u32(data + 12) != teams_.size() ||
+          get_u64(data + 16) != expected) {
+        error_ = path + " holds a different matrix (teams, settings or "
+                        "game data changed)";
+        return false;
+      }
+      keep = load_tiles(data, existing_size);
+    }
+  }
+
+  // Drop a tile torn by a crash so new appends stay readable
+  if (keep < existing_size) {
+    std::error_code ignored;
+    std::filesystem::resize_file(path, keep, ignored);
+  }
+
+  file_ = std::fopen(path.c_str(), "ab");
+  if (!file_) {
+    error_ = "Cannot write " + path;
+    return false;
+  }
+  if (keep == 0) {
+    uint8_t header[FILE_HEADER_SIZE] = {};
+    std::memcpy(header, MATRIX_MAGIC, sizeof(MATRIX_MAGIC));
+    put_u32(header + 8, MATRIX_FORMAT_VERSION);
+    put_u32(header + 12, static_cast<uint32_t>(teams_.size()));
+    put_u64(header + 16, expected);
+    put_u32(header + 24, static_cast<uint32_t>(config_.games));
+    put_u32(header + 28, static_cast<uint32_t>(tile_size_));
+    std::fwrite(header, 1, sizeof(header), file_);
+    std::fflush(file_);
+  }
+  return true;
+}
+
+MatrixCell MatchupMatrix::play_pair(size_t row, size_t col) const {
+  const InternedTeam &team1 = *interned_[row];
+  const InternedTeam &team2 = *interned_[col];
+  uint64_t pair = (row * teams_.size() + col) *
+                  static_cast<uint64_t>(config_.games);
+  Gen1AI ai;
+  AutoBattle auto_battle;
+  MatrixCell cell;
+  for (int game = 0; game < config_.games; game++) {
+    rng_seed(static_cast<uint32_t>(mix(config_.seed ^ mix(pair + game))));
+    int winner;
+    if (config_.engine == MatrixEngine::Ai) {
+      winner = run_headless_battle(team1.team, team2.team, ai, ai,
+                                   config_.max_turns)
+                   .winner;
+    } else {
+      BattleResult result = auto_battle.run(team1, team2);
+      winner = result == BattleResult::Win    ? 1
+               : result == BattleResult::Loss ? 2
+                                              : 0;
+    }
+    if (winner == 1)
+      cell.wins++;
+    else if (winner == 2)
+      cell.losses++;
+    else
+      cell.draws++;
+  }
+  return cell;
+}
+
+void MatchupMatrix::play_tile(size_t index) {
+  timeline::Span span("matrix", "tile", index);
+  Tile t = tile(index);
+  std::vector<uint8_t> record(RECORD_HEADER_SIZE +
+                              t.rows * t.cols * CELL_SIZE);
+  put_u32(record.data(), static_cast<uint32_t>(index));
+  put_u32(record.data() + 4, static_cast<uint32_t>(t.rows * t.cols));
+
+  uint8_t *out = record.data() + RECORD_HEADER_SIZE;
+  for (size_t r = 0; r < t.rows; r++) {
+    for (size_t c = 0; c < t.cols; c++) {
+      MatrixCell cell = play_pair(t.row + r, t.col + c);
+      cells_[(t.row + r) * teams_.size() + t.col + c] = cell;
+      put_u32(out, cell.wins);
+      put_u32(out + 4, cell.losses);
+      put_u32(out + 8, cell.draws);
+      out += CELL_SIZE;
+    }
+  }
+  games_played_ += t.rows * t.cols * static_cast<uint64_t>(config_.games);
+
+  size_t done;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_) {
+      std::fwrite(record.data(), 1, record.size(), file_);
+      std::fflush(file_);
+    }
+    done_[index] = 1;
+    done = ++tiles_done_;
+  }
+  if (progress_)
+    progress_(done, tile_count());
+}
+
+void MatchupMatrix::work() {
+  for (size_t index = next_tile_++; index < tile_count();
+       index = next_tile_++) {
+    bool done;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done = done_[index] != 0;
+    }
+    if (!done)
+      play_tile(index);
+  }
+}
+
+bool MatchupMatrix::run(BattleExecutor &executor) {
+  interned_.clear();
+  for (const MatrixTeam &team : teams_) {
+    interned_.push_back(TeamCache::shared().intern(team.spec));
+    if (!interned_.back()) {
+      error_ = "Cannot build team " + team.label;
+      return false;
+    }
+  }
+
+  next_tile_ = 0;
+  std::vector<std::future<void>> workers;
+  for (unsigned i = 0; i < executor.thread_count(); i++)
+    workers.push_back(executor.submit([this]() { work(); }));
+  for (std::future<void> &worker : workers)
+    worker.get();
+  return true;
+}
+
+bool MatchupMatrix::write_csv(const std::string &path) const {
+  std::ofstream out(path);
+  if (!out)
+    return false;
+
+  out << "team";
+  for (const MatrixTeam &team : teams_) {
+    out << ',';
+    write_csv_label(out, team.label);
+  }
+  out << '\n';
+  for (size_t row = 0; row < teams_.size(); row++) {
+    write_csv_label(out, teams_[row].label);
+    for (size_t col = 0; col < teams_.size(); col++) {
+      out << ',';
+      const MatrixCell &c = cell(row, col);
+      if (c.games())
+        out << c.win_rate();
+    }
+    out << '\n';
+  }
+  return static_cast<bool>(out);
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include "../autobattler/team_cache.hpp"
+#include "../data/team_spec.hpp"
+#include "battle_executor.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// A team in the matrix and the name its row and column go by
+struct MatrixTeam {
+  std::string label;
+  TeamSpec spec;
+};
+
+// Up to four damaging moves for a species, picked the same way every time:
+// the strongest move of each of its own types, then the strongest of other
+// types, at most one per type. Strength is power times accuracy, with the
+// same-type bonus.
+std::vector<const MoveData *> fixed_moveset(const SpeciesData &species);
+
+// Every species as a team of one at this level with its fixed moveset, in
+// species ID order (the order they were loaded in)
+std::vector<MatrixTeam> single_species_teams(int level = 50);
+
+// One team from a line of a teams file: members separated by ';', each
+// "Species[:level[:Move/Move/...]]". Level defaults to 50 and moves to the
+// fixed moveset. False (with the reason in error) for an unknown species
+// or move or a team that does not fit in a TeamSpec.
+bool parse_matrix_team(const std::string &line, MatrixTeam &team,
+                       std::string &error);
+
+// Every team in a file, one per line; blank lines and lines starting
+// with '#' are skipped. Teams are labelled "<line>:<first species>".
+bool load_matrix_teams(const std::string &path, std::vector<MatrixTeam> &teams,
+                       std::string &error);
+
+enum class MatrixEngine {
+  Ai,  // Full engine, both sides played by Gen1AI
+  Auto // AutoBattle (FastAutoBattle where it can model the teams)
+};
+
+struct MatrixConfig {
+  int games = 10; // Per ordered pair
+  uint32_t seed = 1;
+  int tile = 16; // Teams per side of a tile
+  MatrixEngine engine = MatrixEngine::Ai;
+  int max_turns = 200;
+};
+
+// How the row team did as team 1 against the column team
+struct MatrixCell {
+  uint32_t wins = 0;
+  uint32_t losses = 0;
+  uint32_t draws = 0;
+
+  uint32_t games() const { return wins + losses + draws; }
+  // Draws count as half a win; 0 if nothing has been played
+  double win_rate() const {
+    uint32_t total = games();
+    return total ? (wins + 0.5 * draws) / total : 0.0;
+  }
+
+  bool operator==(const MatrixCell &other) const {
+    return wins == other.wins && losses == other.losses &&
+           draws == other.draws;
+  }
+};
+
+// Binary results layout, all little-endian. A 32-byte header (magic,
+// format version, team count, fingerprint of the teams, settings and game
+// data) is followed by one record per finished tile, in whatever order
+// tiles finished:
+//
+//   0  u32  tile index (row-major over the grid of tiles)
+//   4  u32  cell count, rows x columns of that tile
+//   8       cells in row-major order, 12 bytes each: u32 wins, losses,
+//           draws
+namespace matrix_format {
+const size_t FILE_HEADER_SIZE = 32;
+const size_t RECORD_HEADER_SIZE = 8;
+const size_t CELL_SIZE = 12;
+} // namespace matrix_format
+
+// Plays every ordered pair of K teams N times and keeps the K x K results.
+//
+// The matrix is cut into square tiles and each worker takes a whole tile
+// at a time, so it keeps replaying the same few teams while their data is
+// hot rather than sweeping all K. Every game is seeded from the run seed
+// and its row, column and game number, so the results are the same on
+// any number of workers and across a resumed run.
+//
+// With a results file open, each tile is appended to it as soon as it is
+// done. Opening the file again after an interruption loads the finished
+// tiles, and run() plays only the rest.
+class MatchupMatrix {
+public:
+  MatchupMatrix(std::vector<MatrixTeam> teams, const MatrixConfig &config);
+  ~MatchupMatrix();
+
+  MatchupMatrix(const MatchupMatrix &) = delete;
+  MatchupMatrix &operator=(const MatchupMatrix &) = delete;
+
+  // Stream results to path, resuming from the tiles already in it. False
+  // (see error()) if the file holds a different matrix or cannot be
+  // written.
+  bool open(const std::string &path);
+
+  // Called from a worker after each tile with the tiles done and in total
+  void set_progress(std::function<void(size_t, size_t)> progress) {
+    progress_ = std::move(progress);
+  }
+
+  // Play every tile not done yet; false (see error()) if a team cannot be
+  // built from the current GameData
+  bool run(BattleExecutor &executor);
+
+  // The win-rate matrix with a header row and column of labels
+  bool write_csv(const std::string &path) const;
+
+  size_t size() const { return teams_.size(); }
+  const MatrixTeam &team(size_t index) const { return teams_[index]; }
+  const MatrixCell &cell(size_t row, size_t col) const {
+    return cells_[row * teams_.size() + col];
+  }
+  // Row team's win rate over every column
+  double overall_win_rate(size_t row) const;
+
+  size_t tile_count() const { return tiles_per_side_ * tiles_per_side_; }
+  size_t tiles_done() const;
+  uint64_t games_played() const { return games_played_.load(); }
+  uint64_t fingerprint() const;
+
+  const std::string &error() const { return error_; }
+
+private:
+  struct Tile {
+    size_t row, col, rows, cols;
+  };
+
+  std::vector<MatrixTeam> teams_;
+  MatrixConfig config_;
+  size_t tile_size_;
+  size_t tiles_per_side_;
+  std::vector<MatrixCell> cells_; // Row-major; a tile's cells are written
+                                  // only by the worker playing it
+  std::vector<uint8_t> done_;     // Per tile; guarded by mutex_
+  std::vector<std::shared_ptr<const InternedTeam>> interned_;
+  std::function<void(size_t, size_t)> progress_;
+  std::atomic<size_t> next_tile_{0};
+  std::atomic<uint64_t> games_played_{0};
+
+  mutable std::mutex mutex_; // Guards done_, file_ and tiles_done_
+  std::FILE *file_ = nullptr;
+  size_t tiles_done_ = 0;
+  std::string error_;
+
+  Tile tile(size_t index) const;
+  MatrixCell play_pair(size_t row, size_t col) const;
+  void play_tile(size_t index);
+  void work();
+  // Loads the finished tiles; returns where the last complete record ends
+  size_t load_tiles(const uint8_t *data, size_t size);
+};
@@ -1,30 +1,88 @@
 #include "network_battle.hpp"
+#include "../core/rng.hpp"
+#include "../core/timeline.hpp"
 #include "../engine/move_effects.hpp"
 #include "../network/protocol.hpp"
+#include <condition_variable>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 
 NetworkBattle::NetworkBattle(const std::vector<Pokemon> &team1,
                              const std::vector<Pokemon> &team2,
                              ClientConnection *p1, ClientConnection *p2)
-    : Battle(team1, team2), player1_conn_(p1), player2_conn_(p2) {}
+    : Battle(team1, team2), player1_conn_(p1), player2_conn_(p2),
+      player1_name_(p1 ? p1->player_name : "AI"),
+      player2_name_(p2 ? p2->player_name : "AI"),
+      seed_(std::random_device{}()) {}
+
+void NetworkBattle::set_ai_controller(int team_num, const BattleAI *ai,
+                                      const std::string &name) {
+  if (team_num == 1) {
+    player1_ai_ = ai;
+    player1_name_ = name;
+  } else {
+    player2_ai_ = ai;
+    player2_name_ = name;
+  }
+}
 
 void NetworkBattle::send_to_player(ClientConnection *client,
                                    const Message &msg) {
-  client->socket->send(msg.serialize());
+  if (!client)
+    return; // AI-controlled side
+
+  std::lock_guard<std::mutex> lock(client->send_mutex);
+  send_message(*client->socket, msg);
 }
 
-void NetworkBattle::send_team_data(ClientConnection *client,
-                                   const std::vector<Pokemon> &team,
-                                   bool is_own_team) {
+void NetworkBattle::broadcast_frame(const SharedFrame &frame, bool keyframe) {
+  for (ClientConnection *client : {player1_conn_, player2_conn_}) {
+    if (client) {
+      std::lock_guard<std::mutex> lock(client->send_mutex);
+      send_frame(*client->socket, frame);
+    }
+  }
+  spectators_.publish(frame, keyframe);
+}
+
+SharedFrame NetworkBattle::spectator_snapshot() const {
+  auto remaining = [](const std::vector<Pokemon> &team) {
+    int count = 0;
+    for (const auto &pokemon : team) {
+      if (pokemon.hp() > 0)
+        count++;
+    }
+    return count;
+  };
+
+  std::stringstream ss;
+  ss << "Turn " << turn << " | " << player1_name_ << ": " << active1.name()
+     << " HP: " << active1.hp() << "/" << active1.max_hp() << " ("
+     << remaining(team1) << "/" << team1.size() << " left) | "
+     << player2_name_ << ": " << active2.name() << " HP: " << active2.hp()
+     << "/" << active2.max_hp() << " (" << remaining(team2) << "/"
+     << team2.size() << " left)";
+  return encode_frame(Message(MessageType::BATTLE_UPDATE, ss.str()));
+}
+
+static std::string team_listing(const std::string &heading,
+                                const std::vector<Pokemon> &team) {
   std::stringstream ss;
-  ss << (is_own_team ? "Your team:\n" : "Opponent team:\n");
+  ss << heading << ":\n";
   for (size_t i = 0; i < team.size(); i++) {
     ss << (i + 1) << ". " << team[i].name() << " (Lv. " << team[i].level()
        << ") HP: " << team[i].hp() << "/" << team[i].max_hp() << "\n";
   }
+  return ss.str();
+}
 
-  Message msg(MessageType::TEAM_DATA, ss.str());
+void NetworkBattle::send_team_data(ClientConnection *client,
+                                   const std::vector<Pokemon> &team,
+                                   bool is_own_team) {
+  Message msg(MessageType::TEAM_DATA,
+              team_listing(is_own_team ? "Your team" : "Opponent team", team));
   send_to_player(client, msg);
 }
 
@@ -35,20 +93,20 @@ void NetworkBattle::send_battle_log(const std::string &message) {
 void NetworkBattle::flush_battle_log() {
   if (battle_log_.empty())
     return;
+  timeline::Span span("battle", "flush log", seed_, turn);
 
   std::stringstream ss;
   for (const auto &msg : battle_log_) {
     ss << msg << "\n";
   }
 
-  Message log_msg(MessageType::BATTLE_LOG, ss.str());
-  send_to_player(player1_conn_, log_msg);
-  send_to_player(player2_conn_, log_msg);
+  broadcast_frame(encode_frame(Message(MessageType::BATTLE_LOG, ss.str())));
 
   battle_log_.clear();
 }
 
 void NetworkBattle::broadcast_battle_state() {
+  timeline::Span span("battle", "broadcast state", seed_, turn);
   std::stringstream p1_state;
   p1_state << "Your Pokemon: " << active1.name() << " HP: " << active1.hp()
            << "/" << active1.max_hp();
@@ -66,15 +124,18 @@ void NetworkBattle::broadcast_battle_state() {
 
   send_to_player(player1_conn_, p1_update);
   send_to_player(player2_conn_, p2_update);
+  spectators_.publish(spectator_snapshot(), true);
 }
 
-int NetworkBattle::request_switch_from_player(ClientConnection *client) {
+int NetworkBattle::request_switch_from_player(int team_num) {
+  timeline::Span span("battle", "switch request", seed_, turn);
   // Get available Pokemon for the appropriate team
-  int team_num = (client == player1_conn_) ? 1 : 2;
-  std::vector<int> available = get_available_pokemon(team_num);
+  ClientConnection *client = (team_num == 1) ? player1_conn_ : player2_conn_;
+  std::pmr::vector<int> available = get_available_pokemon(team_num);
 
-  std::cout << "[Server] Requesting switch from player " << client->player_name
-            << " (team " << team_num << ")\n";
+  std::cout << "[Server] Requesting switch from player "
+            << (team_num == 1 ? player1_name_ : player2_name_) << " (team "
+            << team_num << ")\n";
   std::cout << "[Server] Available Pokemon: " << available.size() << "\n";
 
   if (available.empty()) {
@@ -82,6 +143,10 @@ int NetworkBattle::request_switch_from_player(ClientConnection *client) {
     return -1; // No Pokemon available
   }
 
+  if (!client) {
+    return available[0]; // AI sends in the next healthy Pokemon
+  }
+
   // Build switch request message
   std::stringstream ss;
   ss << "\nYour Pokemon fainted! Choose a Pokemon to switch to:\n";
@@ -99,16 +164,17 @@ int NetworkBattle::request_switch_from_player(ClientConnection *client) {
   send_to_player(client, request);
   std::cout << "[Server] Switch request sent, waiting for response...\n";
 
-  // Wait for response
-  std::vector<uint8_t> data = client->socket->receive();
-
-  if (data.empty()) {
-    std::cout << "[Server] No response received (empty data), defaulting to "
-                 "first available\n";
-    return available[0]; // Default to first available if no response
+  std::future<DecisionResult> pending = start_decision(team_num);
+  DecisionResult result = finish_decision(team_num, pending);
+  if (result.status == DecisionStatus::Disconnected) {
+    declare_forfeit(team_num);
+    return -1;
+  }
+  if (result.status == DecisionStatus::TimedOut) {
+    return available[0]; // Send in the next healthy Pokemon for them
   }
 
-  Message response = Message::deserialize(data);
+  const Message &response = result.message;
   std::cout << "[Server] Received message type: "
             << static_cast<int>(response.type) << "\n";
 
@@ -129,23 +195,263 @@ int NetworkBattle::request_switch_from_player(ClientConnection *client) {
   return available[0]; // Default to first available
 }
 
-void NetworkBattle::log(const std::string &message) {
-  send_battle_log(message);
+std::future<DecisionResult> NetworkBattle::start_decision(int team_num) {
+  ClientConnection *client = (team_num == 1) ? player1_conn_ : player2_conn_;
+  const BattleAI *ai = (team_num == 1) ? player1_ai_ : player2_ai_;
+  if (!client || ai || !policy_.loop) {
+    return std::future<DecisionResult>();
+  }
+  return policy_.loop->await_message(client, policy_.timeout_ms);
+}
+
+DecisionResult
+NetworkBattle::finish_decision(int team_num,
+                               std::future<DecisionResult> &pending) {
+  ClientConnection *client = (team_num == 1) ? player1_conn_ : player2_conn_;
+
+  DecisionResult result{DecisionStatus::Disconnected, Message()};
+  if (pending.valid()) {
+    result = pending.get();
+  } else if (client && receive_message(*client->socket, result.message)) {
+    // No event loop: wait as long as it takes
+    result.status = DecisionStatus::Received;
+  }
+  settle_decision(team_num, result);
+  return result;
+}
+
+void NetworkBattle::settle_decision(int team_num,
+                                    const DecisionResult &result) {
+  ClientConnection *client = (team_num == 1) ? player1_conn_ : player2_conn_;
+  if (result.status == DecisionStatus::TimedOut) {
+    // Whatever they answer later belongs to this request; drop it
+    client->stale_responses++;
+    send_to_player(client, Message(MessageType::BATTLE_LOG,
+                                   "Time's up! A move was chosen for you.\n"));
+    std::cout << "[Server] "
+              << (team_num == 1 ? player1_name_ : player2_name_)
+              << " timed out\n";
+  }
+}
+
+int NetworkBattle::fallback_move(int team_num) const {
+  const Pokemon &own = (team_num == 1) ? active1 : active2;
+  const Pokemon &opponent = (team_num == 1) ? active2 : active1;
+  if (policy_.fallback_ai) {
+    RngScope decisions(decision_rng_);
+    return policy_.fallback_ai->choose_move(own, opponent);
+  }
+  for (int i = 0; i < own.move_count(); i++) {
+    if (own.get_move(i).has_pp())
+      return i;
+  }
+  return 0;
+}
+
+namespace {
+
+// Both players' move decisions, filled in by the event loop as each one
+// resolves, so the battle can act on whichever comes first
+struct MoveDecisions {
+  std::mutex mutex;
+  std::condition_variable changed;
+  DecisionResult results[2];
+  bool done[2] = {false, false};
+};
+
+} // namespace
+
+bool NetworkBattle::collect_move_choices(int &p1_move, int &p2_move) {
+  ClientConnection *clients[2] = {player1_conn_, player2_conn_};
+  const BattleAI *ais[2] = {player1_ai_, player2_ai_};
+  DecisionResult results[2];
+  bool human[2] = {false, false};
+  int forfeits = 0;
+  for (int i = 0; i < 2; i++) {
+    human[i] = !ais[i];
+    if (human[i] && !clients[i]) {
+      declare_forfeit(i + 1); // Nobody left to play this side
+      return false;
+    }
+  }
+
+  if (policy_.loop) {
+    // Both players decide at once. Their answers are taken in the order
+    // they arrive, so a hang-up forfeits at once instead of after the
+    // other player's clock runs out.
+    auto decisions = std::make_shared<MoveDecisions>();
+    for (int i = 0; i < 2; i++) {
+      if (!human[i])
+        continue;
+      policy_.loop->await_message(
+          clients[i], policy_.timeout_ms,
+          [decisions, i](const DecisionResult &result) {
+            std::lock_guard<std::mutex> lock(decisions->mutex);
+            decisions->results[i] = result;
+            decisions->done[i] = true;
+            decisions->changed.notify_all();
+          });
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(decisions->mutex);
+      decisions->changed.wait(lock, [&]() {
+        for (int i = 0; i < 2; i++) {
+          if (human[i] && decisions->done[i] &&
+              decisions->results[i].status == DecisionStatus::Disconnected) {
+            forfeits = i + 1;
+            return true;
+          }
+        }
+        return (!human[0] || decisions->done[0]) &&
+               (!human[1] || decisions->done[1]);
+      });
+      for (int i = 0; i < 2; i++)
+        results[i] = decisions->results[i];
+    }
+
+    if (forfeits) {
+      // The other player's request is moot; their answer, if it comes,
+      // is stale
+      int other = 2 - forfeits;
+      if (human[other] && policy_.loop->cancel(clients[other]))
+        clients[other]->stale_responses++;
+      declare_forfeit(forfeits);
+      return false;
+    }
+  } else {
+    for (int i = 0; i < 2; i++) {
+      if (!human[i])
+        continue;
+      std::future<DecisionResult> pending; // Blocks until they answer
+      results[i] = finish_decision(i + 1, pending);
+      if (results[i].status == DecisionStatus::Disconnected) {
+        declare_forfeit(i + 1);
+        return false;
+      }
+    }
+  }
+
+  int moves[2] = {0, 0};
+  for (int team_num = 1; team_num <= 2; team_num++) {
+    const Pokemon &own = (team_num == 1) ? active1 : active2;
+    const Pokemon &opponent = (team_num == 1) ? active2 : active1;
+    const BattleAI *ai = ais[team_num - 1];
+    if (ai) {
+      RngScope decisions(decision_rng_);
+      moves[team_num - 1] = ai->choose_move(own, opponent);
+      continue;
+    }
+
+    const DecisionResult &result = results[team_num - 1];
+    if (policy_.loop)
+      settle_decision(team_num, result);
+    if (result.status == DecisionStatus::TimedOut) {
+      moves[team_num - 1] = fallback_move(team_num);
+      continue;
+    }
+
+    int move = 0;
+    if (result.message.type == MessageType::MOVE_RESPONSE) {
+      move = result.message.get_payload_int() -
+             1; // Convert from 1-indexed to 0-indexed
+      if (move < 0 || move >= own.move_count()) {
+        move = 0;
+      }
+    }
+    moves[team_num - 1] = move;
+  }
+
+  p1_move = moves[0];
+  p2_move = moves[1];
+  if (recording_) {
+    ReplayTurn turn;
+    turn.move1 = static_cast<uint8_t>(p1_move);
+    turn.move2 = static_cast<uint8_t>(p2_move);
+    replay_.turns.push_back(turn);
+  }
+  return true;
+}
+
+void NetworkBattle::declare_forfeit(int team_num) {
+  const std::string &quitter = (team_num == 1) ? player1_name_ : player2_name_;
+  std::cout << "[Server] " << quitter << " disconnected, forfeiting\n";
+
+  over = true;
+  winner_ = (team_num == 1) ? 2 : 1;
+  replay_.forfeit = static_cast<uint8_t>(team_num);
+  const std::string &winner_name =
+      (winner_ == 1) ? player1_name_ : player2_name_;
+  send_battle_log("\n" + quitter + " disconnected. " + winner_name +
+                  " wins by forfeit!");
+  flush_battle_log();
+  broadcast_frame(
+      encode_frame(Message(MessageType::WINNER_DECLARED, winner_name)), true);
+}
+
+void NetworkBattle::start_recording() {
+  recording_ = false;
+  if (!replay_writer_)
+    return;
+
+  replay_ = Replay();
+  replay_.seed = seed_;
+  const DataCatalog &catalog = replay_writer_->catalog();
+  for (int team_num = 1; team_num <= 2; team_num++) {
+    const std::vector<Pokemon> &team = (team_num == 1) ? team1 : team2;
+    std::vector<PackedMon> &packed = (team_num == 1) ? replay_.team1
+                                                     : replay_.team2;
+    for (const Pokemon &pokemon : team) {
+      packed.emplace_back();
+      if (!catalog.pack(pokemon, packed.back()))
+        return; // Not in the catalog (e.g. loaded later); can't record
+    }
+  }
+  recording_ = true;
+}
+
+void NetworkBattle::record_switch(int team_num, int switch_choice) {
+  if (!recording_ || replay_.turns.empty())
+    return;
+  uint8_t choice = switch_choice == -1 ? ReplayTurn::FORFEIT
+                                       : static_cast<uint8_t>(switch_choice);
+  if (team_num == 1)
+    replay_.turns.back().switch1 = choice;
+  else
+    replay_.turns.back().switch2 = choice;
+}
+
+void NetworkBattle::record_turn_end() {
+  if (!recording_ || !replay_writer_->tracing())
+    return;
+  replay_.trace.push_back(
+      ReplayTraceEntry::capture(active1_index, active1, active2_index, active2));
+}
+
+void NetworkBattle::log(std::string_view message) {
+  send_battle_log(std::string(message));
 }
 
 void NetworkBattle::run() {
-  std::cout << "[Server] Starting network battle between "
-            << player1_conn_->player_name << " and "
-            << player2_conn_->player_name << "\n";
+  GameDataScope pinned(game_data()); // AI fallbacks read it too
+  std::cout << "[Server] Starting network battle between " << player1_name_
+            << " and " << player2_name_ << "\n";
+
+  rng_seed(seed_);
+  decision_rng_.seed(seed_ ^ 0x9E3779B9u);
+  start_recording();
 
   send_team_data(player1_conn_, team1, true);
   send_team_data(player1_conn_, team2, false);
   send_team_data(player2_conn_, team2, true);
   send_team_data(player2_conn_, team1, false);
+  spectators_.publish(encode_frame(Message(
+      MessageType::TEAM_DATA, team_listing(player1_name_ + "'s team", team1))));
+  spectators_.publish(encode_frame(Message(
+      MessageType::TEAM_DATA, team_listing(player2_name_ + "'s team", team2))));
 
-  Message start_msg(MessageType::GAME_START, "Battle starting!");
-  send_to_player(player1_conn_, start_msg);
-  send_to_player(player2_conn_, start_msg);
+  broadcast_frame(
+      encode_frame(Message(MessageType::GAME_START, "Battle starting!")));
 
   send_battle_log("=== BATTLE START ===");
   send_battle_log(active1.name() + " vs " + active2.name() + "!");
@@ -155,7 +461,14 @@ void NetworkBattle::run() {
 
   std::cout << "[Server] Entering battle loop\n";
   while (!over) {
+    if (turn_limit_ > 0 && turn >= turn_limit_) {
+      over = true;
+      send_battle_log("\nTurn limit reached. The battle is a draw!");
+      flush_battle_log();
+      continue;
+    }
     turn++;
+    timeline::Span turn_span("battle", "turn", seed_, turn);
     std::cout << "[Server] Starting turn " << turn << "\n";
 
     if (turn > 1) {
@@ -192,62 +505,31 @@ void NetworkBattle::run() {
     Message p1_req_msg(MessageType::MOVE_REQUEST, p1_request.str());
     Message p2_req_msg(MessageType::MOVE_REQUEST, p2_request.str());
     std::cout << "[Server] Sending move requests to both players\n";
-    send_to_player(player1_conn_, p1_req_msg);
-    send_to_player(player2_conn_, p2_req_msg);
+    {
+      timeline::Span span("battle", "send move requests", seed_, turn);
+      send_to_player(player1_conn_, p1_req_msg);
+      send_to_player(player2_conn_, p2_req_msg);
+    }
 
     // Wait for both responses
     std::cout << "[Server] Waiting for move responses...\n";
-    std::vector<uint8_t> p1_data = player1_conn_->socket->receive();
-    std::cout << "[Server] Received p1 data: " << p1_data.size() << " bytes\n";
-    std::vector<uint8_t> p2_data = player2_conn_->socket->receive();
-    std::cout << "[Server] Received p2 data: " << p2_data.size() << " bytes\n";
-
     int p1_move = 0;
     int p2_move = 0;
-
-    if (!p1_data.empty()) {
-      Message p1_response = Message::deserialize(p1_data);
-      if (p1_response.type == MessageType::MOVE_RESPONSE) {
-        p1_move = p1_response.get_payload_int() -
-                  1; // Convert from 1-indexed to 0-indexed
-        if (p1_move < 0 || p1_move >= active1.move_count()) {
-          p1_move = 0;
-        }
-      }
+    bool chosen;
+    {
+      timeline::Span span("battle", "await move responses", seed_, turn);
+      chosen = collect_move_choices(p1_move, p2_move);
     }
-
-    if (!p2_data.empty()) {
-      Message p2_response = Message::deserialize(p2_data);
-      if (p2_response.type == MessageType::MOVE_RESPONSE) {
-        p2_move = p2_response.get_payload_int() -
-                  1; // Convert from 1-indexed to 0-indexed
-        if (p2_move < 0 || p2_move >= active2.move_count()) {
-          p2_move = 0;
-        }
-      }
+    if (!chosen) {
+      continue; // Someone disconnected and forfeited
     }
 
     // ========== PHASE 2: EXECUTE MOVES ==========
-    // Determine turn order
-    bool player1_first = active1.get_modified_stat(PokeStat::Speed) >=
-                         active2.get_modified_stat(PokeStat::Speed);
-
-    Pokemon *first = player1_first ? &active1 : &active2;
-    Pokemon *second = player1_first ? &active2 : &active1;
-    int first_move_idx = player1_first ? p1_move : p2_move;
-    int second_move_idx = player1_first ? p2_move : p1_move;
-
-    first->set_moved_first(true);
-    second->set_moved_first(false);
-
-    // Execute moves in order
+    // Faster Pokemon first (replays repeat these phases; see ReplayBattle)
     std::cout << "[Server] Executing moves\n";
-    if (first->hp() > 0) {
-      execute_pokemon_move(*first, *second, first_move_idx);
-    }
-
-    if (second->hp() > 0 && first->hp() > 0) {
-      execute_pokemon_move(*second, *first, second_move_idx);
+    {
+      timeline::Span span("battle", "execute moves", seed_, turn);
+      execute_moves(p1_move, p2_move);
     }
 
     std::cout << "[Server] Flushing battle log\n";
@@ -264,35 +546,34 @@ void NetworkBattle::run() {
       send_battle_log(active1.name() + " fainted!");
       flush_battle_log();
 
-      int switch_choice = request_switch_from_player(player1_conn_);
+      int switch_choice = request_switch_from_player(1);
+      record_switch(1, switch_choice);
       if (switch_choice != -1) {
-        // Manually switch without using base class method (to avoid duplicate
-        // logging)
-        team1[active1_index] = active1;
-        active1_index = switch_choice;
-        active1 = team1[switch_choice];
+        send_in(1, switch_choice);
         send_battle_log("Go, " + active1.name() + "!");
         flush_battle_log();
       }
     }
 
     // Handle player 2's fainted Pokemon
-    if (p2_fainted && !is_team_defeated(2)) {
+    if (p2_fainted && !is_team_defeated(2) && !over) {
       send_battle_log(active2.name() + " fainted!");
       flush_battle_log();
 
-      int switch_choice = request_switch_from_player(player2_conn_);
+      int switch_choice = request_switch_from_player(2);
+      record_switch(2, switch_choice);
       if (switch_choice != -1) {
-        // Manually switch without using base class method (to avoid duplicate
-        // logging)
-        team2[active2_index] = active2;
-        active2_index = switch_choice;
-        active2 = team2[switch_choice];
+        send_in(2, switch_choice);
         send_battle_log("Go, " + active2.name() + "!");
         flush_battle_log();
       }
     }
 
+    if (over) {
+      record_turn_end();
+      continue; // A player disconnected while choosing a switch
+    }
+
     // ========== PHASE 4: CHECK BATTLE END ==========
     std::cout << "[Server] Checking battle end\n";
     if (is_team_defeated(1) || is_team_defeated(2)) {
@@ -300,47 +581,35 @@ void NetworkBattle::run() {
       over = true;
       broadcast_battle_state();
 
-      if (is_team_defeated(1)) {
-        send_battle_log("\n" + player2_conn_->player_name + " wins!");
-        Message winner(MessageType::WINNER_DECLARED,
-                       player2_conn_->player_name);
-        send_to_player(player1_conn_, winner);
-        send_to_player(player2_conn_, winner);
-      } else {
-        send_battle_log("\n" + player1_conn_->player_name + " wins!");
-        Message winner(MessageType::WINNER_DECLARED,
-                       player1_conn_->player_name);
-        send_to_player(player1_conn_, winner);
-        send_to_player(player2_conn_, winner);
-      }
-
+      winner_ = is_team_defeated(1) ? 2 : 1;
+      const std::string &winner_name =
+          (winner_ == 1) ? player1_name_ : player2_name_;
+      send_battle_log("\n" + winner_name + " wins!");
       flush_battle_log();
+
+      broadcast_frame(
+          encode_frame(Message(MessageType::WINNER_DECLARED, winner_name)),
+          true);
+      record_turn_end();
       continue;
     }
 
     // ========== PHASE 5: END OF TURN EFFECTS ==========
     std::cout << "[Server] Applying end of turn effects\n";
-    active1.update_disable();
-    active2.update_disable();
-    active1.update_bide();
-    active2.update_bide();
-    active1.update_screens();
-    active2.update_screens();
-
-    if (active1.hp() > 0) {
-      apply_end_of_turn_status_damage(active1);
-    }
-    if (active2.hp() > 0) {
-      apply_end_of_turn_status_damage(active2);
-    }
+    apply_end_of_turn();
 
     sync_active_to_team();
     flush_battle_log();
     broadcast_battle_state();
+    record_turn_end();
     std::cout << "[Server] Turn " << turn << " complete\n";
   }
 
   std::cout << "[Server] Exited battle loop\n";
+  if (recording_) {
+    replay_.winner = static_cast<uint8_t>(winner_);
+    replay_writer_->record(replay_);
+  }
 
   std::cout << "[Server] Battle complete!\n";
 }
@@ -1,11 +1,24 @@
 #pragma once
+#include "../ai/ai_interface.hpp"
 #include "../core/battle.hpp"
 #include "../core/pokemon.hpp"
 #include "../network/protocol.hpp"
 #include "game_server.hpp"
+#include "replay.hpp"
+#include "server_event_loop.hpp"
+#include "spectator_hub.hpp"
+#include <future>
+#include <random>
 #include <string>
 #include <vector>
 
+// How long players get to answer a request, and who answers when they don't
+struct DecisionPolicy {
+  ServerEventLoop *loop = nullptr; // nullptr: block until the player answers
+  int timeout_ms = 30000;
+  const BattleAI *fallback_ai = nullptr; // nullptr: first move with PP
+};
+
 // Battle that synchronizes state over network
 class NetworkBattle : public Battle {
 private:
@@ -13,12 +26,47 @@ private:
   ClientConnection *player2_conn_;
   std::vector<std::string> battle_log_;
 
+  // Sides without a connection are played by an AI (tournament bots)
+  const BattleAI *player1_ai_ = nullptr;
+  const BattleAI *player2_ai_ = nullptr;
+  std::string player1_name_;
+  std::string player2_name_;
+  int winner_ = 0;
+  int turn_limit_ = 0;
+  SpectatorHub spectators_;
+  DecisionPolicy policy_;
+
+  // Engine rolls come from seed_; AI decisions from their own engine, so a
+  // replay can reproduce the battle from the seed and the choices alone
+  uint32_t seed_;
+  mutable std::mt19937 decision_rng_;
+  ReplayWriter *replay_writer_ = nullptr;
+  Replay replay_;
+  bool recording_ = false;
+
   // Network communication
   void send_to_player(ClientConnection *client, const Message &msg);
+  // Sends one already-encoded frame to both players and all spectators
+  void broadcast_frame(const SharedFrame &frame, bool keyframe = false);
+  SharedFrame spectator_snapshot() const;
   int request_move_from_player(ClientConnection *client,
                                const Pokemon &their_pokemon,
                                const Pokemon &opponent_pokemon);
-  int request_switch_from_player(ClientConnection *client);
+  int request_switch_from_player(int team_num);
+
+  // Decisions: arm the deadline (if any), then wait for the outcome
+  std::future<DecisionResult> start_decision(int team_num);
+  DecisionResult finish_decision(int team_num,
+                                 std::future<DecisionResult> &pending);
+  void settle_decision(int team_num, const DecisionResult &result);
+  bool collect_move_choices(int &p1_move, int &p2_move); // False on forfeit
+  int fallback_move(int team_num) const;
+  void declare_forfeit(int team_num);
+
+  // Replay recording (no-ops unless a writer is set)
+  void start_recording();
+  void record_switch(int team_num, int switch_choice);
+  void record_turn_end();
 
   // State synchronization
   void send_team_data(ClientConnection *client,
@@ -32,8 +80,36 @@ public:
                 const std::vector<Pokemon> &team2, ClientConnection *p1,
                 ClientConnection *p2);
 
+  // Let an AI play a side instead of a connected client
+  void set_ai_controller(int team_num, const BattleAI *ai,
+                         const std::string &name);
+
+  // Bound each decision by a deadline instead of waiting forever
+  void set_decision_policy(const DecisionPolicy &policy) { policy_ = policy; }
+
+  // End the battle undecided (winner 0) after this many turns; 0 for no
+  // limit. Bots that run out of PP would otherwise never finish.
+  void set_turn_limit(int turns) { turn_limit_ = turns; }
+
+  // Record this battle to writer once it is over
+  void set_replay_writer(ReplayWriter *writer) { replay_writer_ = writer; }
+  // Seed for the engine's rolls; random unless set before run()
+  void set_seed(uint32_t seed) { seed_ = seed; }
+  uint32_t seed() const { return seed_; }
+
   void run();
 
+  // Watch this battle; safe to call from another thread while it runs
+  void add_spectator(ClientConnection *client) { spectators_.add(client); }
+  // Detach all spectators once the battle is over (see SpectatorHub)
+  std::vector<ClientConnection *> release_spectators(int timeout_ms) {
+    return spectators_.release(timeout_ms);
+  }
+  SpectatorStats spectator_stats() { return spectators_.stats(); }
+
+  // 1 or 2 once the battle is over, 0 before that
+  int winner() const { return winner_; }
+
   // Override log to send to network instead of stdout
-  void log(const std::string &message) override;
+  void log(std::string_view message) override;
 };
@@ -0,0 +1,423 @@
+#include "replay.hpp"
+#include "../core/battle_output.hpp"
+#include "../core/rng.hpp"
+#include "../data/binary_io.hpp"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+const char REPLAY_MAGIC[8] = {'G', '1', 'R', 'E', 'P', 'L', 'A', 'Y'};
+const uint32_t REPLAY_FORMAT_VERSION = 1;
+const uint8_t FLAG_TRACE = 1;
+
+using namespace replay_format;
+
+bool has_trace(const Replay &replay) {
+  return !replay.trace.empty() && replay.trace.size() == replay.turns.size();
+}
+
+size_t teams_size(size_t team1, size_t team2) {
+  return (team1 + team2) * DataCatalog::PACKED_MON_SIZE;
+}
+
+// Size a record says it has must agree with its counts
+size_t expected_size(const uint8_t *record) {
+  size_t turns = get_u32(record + 8);
+  size_t per_turn = TURN_SIZE + ((record[14] & FLAG_TRACE) ? TRACE_SIZE : 0);
+  return RECORD_HEADER_SIZE + teams_size(record[12], record[13]) +
+         turns * per_turn;
+}
+
+// Checks the file header; on failure says why in error
+bool check_header(const uint8_t *data, size_t size, uint64_t fingerprint,
+                  const std::string &path, std::string &error) {
+  if (size < FILE_HEADER_SIZE ||
+      std::memcmp(data, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0 ||
+      get_u32(data + 8) != REPLAY_FORMAT_VERSION) {
+    error = path + " is not a replay file";
+    return false;
+  }
+  if (get_u64(data + 16) != fingerprint) {
+    error = path + " was recorded with different game data";
+    return false;
+  }
+  return true;
+}
+
+// Walks the records after the header; returns where the last complete one
+// ends. A record torn by a crash (or anything after it) is left out.
+size_t index_records(const uint8_t *data, size_t size,
+                     std::vector<size_t> *offsets) {
+  size_t offset = FILE_HEADER_SIZE;
+  while (size - offset >= RECORD_HEADER_SIZE) {
+    const uint8_t *record = data + offset;
+    size_t length = get_u32(record);
+    if (length != expected_size(record) || length > size - offset)
+      break;
+    if (offsets)
+      offsets->push_back(offset);
+    offset += length;
+  }
+  return offset;
+}
+
+const uint8_t *turns_of(const uint8_t *record) {
+  return record + RECORD_HEADER_SIZE + teams_size(record[12], record[13]);
+}
+
+ReplayTurn decode_turn(const uint8_t *in) {
+  ReplayTurn turn;
+  turn.move1 = in[0];
+  turn.move2 = in[1];
+  turn.switch1 = in[2];
+  turn.switch2 = in[3];
+  return turn;
+}
+
+ReplayTraceEntry decode_trace(const uint8_t *in) {
+  ReplayTraceEntry entry;
+  entry.active[0] = in[0];
+  entry.active[1] = in[1];
+  entry.status[0] = in[2];
+  entry.status[1] = in[3];
+  entry.hp[0] = get_u16(in + 4);
+  entry.hp[1] = get_u16(in + 6);
+  return entry;
+}
+
+} // namespace
+
+ReplayTraceEntry ReplayTraceEntry::capture(int index1, const Pokemon &active1,
+                                           int index2,
+                                           const Pokemon &active2) {
+  ReplayTraceEntry entry;
+  entry.active[0] = static_cast<uint8_t>(index1);
+  entry.active[1] = static_cast<uint8_t>(index2);
+  entry.status[0] = static_cast<uint8_t>(active1.status());
+  entry.status[1] = static_cast<uint8_t>(active2.status());
+  entry.hp[0] = static_cast<uint16_t>(active1.hp());
+  entry.hp[1] = static_cast<uint16_t>(active2.hp());
+  return entry;
+}
+
+bool ReplayTraceEntry::operator==(const ReplayTraceEntry &other) const {
+  return active[0] == other.active[0] && active[1] == other.active[1] &&
+         status[0] == other.status[0] && status[1] == other.status[1] &&
+         hp[0] == other.hp[0] && hp[1] == other.hp[1];
+}
+
+size_t replay_format::record_size(const Replay &replay) {
+  size_t per_turn = TURN_SIZE + (has_trace(replay) ? TRACE_SIZE : 0);
+  return RECORD_HEADER_SIZE +
+         teams_size(replay.team1.size(), replay.team2.size()) +
+         replay.turns.size() * per_turn;
+}
+
+void replay_format::encode(const Replay &replay, std::vector<uint8_t> &out) {
+  size_t start = out.size();
+  size_t length = record_size(replay);
+  out.resize(start + length);
+  uint8_t *p = out.data() + start;
+
+  put_u32(p, static_cast<uint32_t>(length));
+  put_u32(p + 4, replay.seed);
+  put_u32(p + 8, static_cast<uint32_t>(replay.turns.size()));
+  p[12] = static_cast<uint8_t>(replay.team1.size());
+  p[13] = static_cast<uint8_t>(replay.team2.size());
+  p[14] = has_trace(replay) ? FLAG_TRACE : 0;
+  p[15] = static_cast<uint8_t>((replay.winner & 0x0F) | (replay.forfeit << 4));
+  p += RECORD_HEADER_SIZE;
+
+  for (const PackedMon &mon : replay.team1) {
+    DataCatalog::encode(mon, p);
+    p += DataCatalog::PACKED_MON_SIZE;
+  }
+  for (const PackedMon &mon : replay.team2) {
+    DataCatalog::encode(mon, p);
+    p += DataCatalog::PACKED_MON_SIZE;
+  }
+  for (const ReplayTurn &turn : replay.turns) {
+    p[0] = turn.move1;
+    p[1] = turn.move2;
+    p[2] = turn.switch1;
+    p[3] = turn.switch2;
+    p += TURN_SIZE;
+  }
+  if (!has_trace(replay))
+    return;
+  for (const ReplayTraceEntry &entry : replay.trace) {
+    p[0] = entry.active[0];
+    p[1] = entry.active[1];
+    p[2] = entry.status[0];
+    p[3] = entry.status[1];
+    put_u16(p + 4, entry.hp[0]);
+    put_u16(p + 6, entry.hp[1]);
+    p += TRACE_SIZE;
+  }
+}
+
+ReplayWriter::ReplayWriter(const std::string &path, bool trace)
+    : path_(path), trace_(trace), file_(nullptr), recorded_(0) {
+  buffer_.reserve(FLUSH_BYTES * 2);
+  spare_.reserve(FLUSH_BYTES * 2);
+
+  size_t keep = 0;
+  size_t existing_size = 0;
+  {
+    MappedFile existing;
+    if (existing.open(path_) && existing.size() > 0) {
+      std::string error;
+      if (!check_header(existing.data(), existing.size(),
+                        catalog_.fingerprint(), path_, error)) {
+        std::cerr << "[Replays] " << error << ", not recording\n";
+        return;
+      }
+      existing_size = existing.size();
+      keep = index_records(existing.data(), existing.size(), nullptr);
+    }
+  }
+
+  // Drop a record torn by a crash so new appends stay readable
+  if (keep < existing_size) {
+    std::error_code error;
+    std::filesystem::resize_file(path_, keep, error);
+  }
+
+  file_ = std::fopen(path_.c_str(), "ab");
+  if (!file_) {
+    std::cerr << "[Replays] Cannot append to " << path_
+              << ", not recording\n";
+    return;
+  }
+  if (keep == 0) {
+    uint8_t header[FILE_HEADER_SIZE] = {};
+    std::memcpy(header, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    put_u32(header + 8, REPLAY_FORMAT_VERSION);
+    put_u64(header + 16, catalog_.fingerprint());
+    std::fwrite(header, 1, sizeof(header), file_);
+    std::fflush(file_);
+  }
+}
+
+ReplayWriter::~ReplayWriter() {
+  flush();
+  if (file_)
+    std::fclose(file_);
+}
+
+void ReplayWriter::record(const Replay &replay) {
+  if (!file_)
+    return;
+  bool full;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    encode(replay, buffer_);
+    recorded_++;
+    full = buffer_.size() >= FLUSH_BYTES;
+  }
+  if (full)
+    flush();
+}
+
+void ReplayWriter::flush() {
+  // Whoever swapped a block out before us finishes writing it first
+  std::lock_guard<std::mutex> file_lock(file_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer_.swap(spare_);
+  }
+  if (file_ && !spare_.empty()) {
+    std::fwrite(spare_.data(), 1, spare_.size(), file_);
+    std::fflush(file_);
+  }
+  spare_.clear();
+}
+
+size_t ReplayWriter::recorded() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return recorded_;
+}
+
+bool ReplayFile::open(const std::string &path, const DataCatalog &catalog) {
+  offsets_.clear();
+  error_.clear();
+  if (!mapped_.open(path)) {
+    error_ = "Cannot open " + path;
+    return false;
+  }
+  if (!check_header(mapped_.data(), mapped_.size(), catalog.fingerprint(),
+                    path, error_)) {
+    mapped_.close();
+    return false;
+  }
+  index_records(mapped_.data(), mapped_.size(), &offsets_);
+  return true;
+}
+
+Replay ReplayFile::read(size_t index) const {
+  const uint8_t *in = record(index);
+  Replay replay;
+  replay.seed = get_u32(in + 4);
+  uint32_t turns = get_u32(in + 8);
+  replay.winner = in[15] & 0x0F;
+  replay.forfeit = in[15] >> 4;
+
+  const uint8_t *p = in + RECORD_HEADER_SIZE;
+  for (int i = 0; i < in[12]; i++, p += DataCatalog::PACKED_MON_SIZE)
+    replay.team1.push_back(DataCatalog::decode(p));
+  for (int i = 0; i < in[13]; i++, p += DataCatalog::PACKED_MON_SIZE)
+    replay.team2.push_back(DataCatalog::decode(p));
+
+  replay.turns.reserve(turns);
+  for (uint32_t i = 0; i < turns; i++, p += TURN_SIZE)
+    replay.turns.push_back(decode_turn(p));
+  if (in[14] & FLAG_TRACE) {
+    replay.trace.reserve(turns);
+    for (uint32_t i = 0; i < turns; i++, p += TRACE_SIZE)
+      replay.trace.push_back(decode_trace(p));
+  }
+  return replay;
+}
+
+uint32_t ReplayFile::turn_count(size_t index) const {
+  return get_u32(record(index) + 8);
+}
+
+ReplayTurn ReplayFile::turn(size_t index, uint32_t turn) const {
+  return decode_turn(turns_of(record(index)) + turn * TURN_SIZE);
+}
+
+bool ReplayFile::trace(size_t index, uint32_t turn,
+                       ReplayTraceEntry &entry) const {
+  const uint8_t *in = record(index);
+  if (!(in[14] & FLAG_TRACE))
+    return false;
+  const uint8_t *trace = turns_of(in) + turn_count(index) * TURN_SIZE;
+  entry = decode_trace(trace + turn * TRACE_SIZE);
+  return true;
+}
+
+ReplayBattle::ReplayBattle(const std::vector<Pokemon> &team1,
+                           const std::vector<Pokemon> &team2,
+                           const Replay &replay)
+    : Battle(team1, team2), replay_(replay), next_turn_(0), winner_(0),
+      valid_(true) {
+  rng_seed(replay.seed);
+}
+
+bool ReplayBattle::step() {
+  if (over)
+    return false;
+  if (next_turn_ >= replay_.turns.size()) {
+    // Someone left while choosing their next move
+    if (replay_.forfeit)
+      finish_forfeit(replay_.forfeit);
+    return false;
+  }
+
+  const ReplayTurn &choice = replay_.turns[next_turn_++];
+  if (choice.move1 >= 4 || choice.move2 >= 4) {
+    valid_ = false;
+    over = true;
+    return false;
+  }
+
+  // Same phases as NetworkBattle::run
+  turn++;
+  active1.reset_turn_data();
+  active2.reset_turn_data();
+  execute_moves(choice.move1, choice.move2);
+  sync_active_to_team();
+
+  bool fainted1 = active1.hp() == 0;
+  bool fainted2 = active2.hp() == 0;
+  if (!apply_switch(1, choice.switch1, fainted1) ||
+      !apply_switch(2, choice.switch2, fainted2 && !over)) {
+    valid_ = false;
+    over = true;
+    return false;
+  }
+  if (over)
+    return true; // Forfeited instead of switching
+
+  if (is_team_defeated(1) || is_team_defeated(2)) {
+    over = true;
+    winner_ = is_team_defeated(1) ? 2 : 1;
+    return true;
+  }
+
+  apply_end_of_turn();
+  sync_active_to_team();
+  return true;
+}
+
+bool ReplayBattle::apply_switch(int team_num, uint8_t choice, bool fainted) {
+  bool asked = fainted && !is_team_defeated(team_num);
+  if (!asked)
+    return choice == ReplayTurn::NO_SWITCH;
+  if (choice == ReplayTurn::FORFEIT) {
+    finish_forfeit(team_num);
+    return true;
+  }
+
+  const std::vector<Pokemon> &team = (team_num == 1) ? team1 : team2;
+  if (choice >= team.size() || team[choice].hp() <= 0)
+    return false;
+  send_in(team_num, choice);
+  return true;
+}
+
+void ReplayBattle::finish_forfeit(int team_num) {
+  over = true;
+  winner_ = (team_num == 1) ? 2 : 1;
+}
+
+ReplayTraceEntry ReplayBattle::state() const {
+  return ReplayTraceEntry::capture(active1_index, active1, active2_index,
+                                   active2);
+}
+
+bool replay_teams(const Replay &replay, const DataCatalog &catalog,
+                  std::vector<Pokemon> &team1, std::vector<Pokemon> &team2) {
+  team1.clear();
+  team2.clear();
+  for (const PackedMon &mon : replay.team1) {
+    if (!catalog.unpack(mon, team1))
+      return false;
+  }
+  for (const PackedMon &mon : replay.team2) {
+    if (!catalog.unpack(mon, team2))
+      return false;
+  }
+  return !team1.empty() && !team2.empty();
+}
+
+ReplayCheck check_replay(const Replay &replay, const DataCatalog &catalog) {
+  ReplayCheck check;
+  std::vector<Pokemon> team1;
+  std::vector<Pokemon> team2;
+  if (!replay_teams(replay, catalog, team1, team2))
+    return check;
+
+  QuietBattleOutput quiet;
+  ReplayBattle battle(team1, team2, replay);
+  bool traced = has_trace(replay);
+  while (battle.step()) {
+    size_t played = static_cast<size_t>(battle.turns_played());
+    if (traced && !check.diverged_at &&
+        battle.state() != replay.trace[played - 1]) {
+      check.diverged_at = battle.turns_played();
+    }
+  }
+
+  check.valid = battle.valid();
+  check.winner = battle.winner();
+  check.turns = battle.turns_played();
+  if (!check.diverged_at &&
+      static_cast<size_t>(check.turns) < replay.turns.size()) {
+    check.diverged_at = check.turns + 1; // It was over sooner than recorded
+  }
+  return check;
+}
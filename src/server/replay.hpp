@@ -0,0 +1,191 @@
+#pragma once
+#include "../core/battle.hpp"
+#include "../data/catalog.hpp"
+#include "../data/mapped_file.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Choices made in one turn of a recorded NetworkBattle. A switch is the
+// team index sent in after a faint, NO_SWITCH, or FORFEIT if the player
+// left instead of choosing.
+struct ReplayTurn {
+  static const uint8_t NO_SWITCH = 0xFF;
+  static const uint8_t FORFEIT = 0xFE;
+
+  uint8_t move1 = 0;
+  uint8_t move2 = 0;
+  uint8_t switch1 = NO_SWITCH;
+  uint8_t switch2 = NO_SWITCH;
+};
+
+// Both active Pokemon once a turn is over (team index, status, HP)
+struct ReplayTraceEntry {
+  uint8_t active[2] = {0, 0};
+  uint8_t status[2] = {0, 0};
+  uint16_t hp[2] = {0, 0};
+
+  static ReplayTraceEntry capture(int index1, const Pokemon &active1,
+                                  int index2, const Pokemon &active2);
+
+  bool operator==(const ReplayTraceEntry &other) const;
+  bool operator!=(const ReplayTraceEntry &other) const {
+    return !(*this == other);
+  }
+};
+
+// Everything needed to play a NetworkBattle again: the seed its engine
+// rolls came from, the teams, and what both sides chose each turn. The
+// trace is optional and only used to find where a replay goes wrong.
+struct Replay {
+  uint32_t seed = 0;
+  std::vector<PackedMon> team1;
+  std::vector<PackedMon> team2;
+  std::vector<ReplayTurn> turns;
+  std::vector<ReplayTraceEntry> trace; // Empty, or one entry per turn
+  uint8_t winner = 0;  // 0 if the battle never finished
+  uint8_t forfeit = 0; // Team that disconnected, 0 if none
+};
+
+// Binary layout, all little-endian. A file is a 32-byte header (magic,
+// format version, catalog fingerprint) followed by replay records:
+//
+//   0  u32  record size in bytes, header included
+//   4  u32  seed
+//   8  u32  turn count
+//   12 u8   team 1 size    13 u8  team 2 size
+//   14 u8   flags (1 = trace)
+//   15 u8   winner | forfeit << 4
+//   16      packed team members, 12 bytes each (DataCatalog::encode)
+//           turns, 4 bytes each: move1, move2, switch1, switch2
+//           trace, 8 bytes each if flagged: active1, active2, status1,
+//           status2, u16 hp1, u16 hp2
+//
+// Turns and trace entries are fixed-size columns, so turn N of a replay is
+// found by arithmetic rather than by reading the turns before it.
+namespace replay_format {
+const size_t FILE_HEADER_SIZE = 32;
+const size_t RECORD_HEADER_SIZE = 16;
+const size_t TURN_SIZE = 4;
+const size_t TRACE_SIZE = 8;
+
+size_t record_size(const Replay &replay);
+void encode(const Replay &replay, std::vector<uint8_t> &out); // Appends
+} // namespace replay_format
+
+// Appends replays to one file for the whole server. Each replay is encoded
+// into a shared buffer and the buffer goes to disk in large blocks, so
+// recording costs a battle one small copy. Safe to use from any thread.
+class ReplayWriter {
+public:
+  static const size_t FLUSH_BYTES = 64 * 1024;
+
+private:
+  std::string path_;
+  DataCatalog catalog_;
+  bool trace_;
+  std::FILE *file_; // nullptr if the file cannot be used
+
+  std::mutex mutex_; // Guards buffer_ and recorded_
+  std::vector<uint8_t> buffer_;
+  size_t recorded_;
+  std::mutex file_mutex_;     // Held while a block is written out
+  std::vector<uint8_t> spare_; // The block being written; keeps capacity
+
+public:
+  // Appends to path, creating it if needed. trace: battles recording here
+  // also keep the per-turn trace.
+  explicit ReplayWriter(const std::string &path, bool trace = false);
+  ~ReplayWriter(); // Writes out everything recorded
+
+  ReplayWriter(const ReplayWriter &) = delete;
+  ReplayWriter &operator=(const ReplayWriter &) = delete;
+
+  void record(const Replay &replay);
+  void flush(); // Block until everything recorded is on disk
+
+  // Teams must be packed against this catalog
+  const DataCatalog &catalog() const { return catalog_; }
+  bool tracing() const { return trace_; }
+  bool is_open() const { return file_ != nullptr; }
+  size_t recorded();
+};
+
+// A replay file opened for reading. It is memory-mapped and indexed once,
+// so any replay (and any turn of one) is read without touching the rest.
+class ReplayFile {
+private:
+  MappedFile mapped_;
+  std::vector<size_t> offsets_; // Start of each complete record
+  std::string error_;
+
+  const uint8_t *record(size_t index) const {
+    return mapped_.data() + offsets_[index];
+  }
+
+public:
+  // False (see error()) if the file is missing, is not a replay file or
+  // was recorded with different game data
+  bool open(const std::string &path, const DataCatalog &catalog);
+
+  size_t size() const { return offsets_.size(); }
+  Replay read(size_t index) const;
+
+  // Seek straight to one turn (0-based) of a replay
+  uint32_t turn_count(size_t index) const;
+  ReplayTurn turn(size_t index, uint32_t turn) const;
+  bool trace(size_t index, uint32_t turn, ReplayTraceEntry &entry) const;
+
+  const std::string &error() const { return error_; }
+};
+
+// Plays a Replay through the engine a turn at a time, with NetworkBattle's
+// turn order. Battle text goes to battle_out(). Seeds this thread's RNG
+// when constructed.
+class ReplayBattle : public Battle {
+private:
+  const Replay &replay_;
+  size_t next_turn_;
+  int winner_;
+  bool valid_;
+
+  // Apply a recorded switch; false if it could not have been chosen
+  bool apply_switch(int team_num, uint8_t choice, bool fainted);
+  void finish_forfeit(int team_num);
+
+public:
+  // Teams are the replay's, unpacked (see replay_teams)
+  ReplayBattle(const std::vector<Pokemon> &team1,
+               const std::vector<Pokemon> &team2, const Replay &replay);
+
+  // Play the next recorded turn; false once there is none to play
+  bool step();
+
+  ReplayTraceEntry state() const;
+
+  int turns_played() const { return static_cast<int>(next_turn_); }
+  int winner() const { return winner_; }
+  bool finished() const { return over; }
+  bool valid() const { return valid_; } // False on an impossible choice
+};
+
+// Unpack a replay's teams; false if a team is empty or refers to species
+// the catalog does not have
+bool replay_teams(const Replay &replay, const DataCatalog &catalog,
+                  std::vector<Pokemon> &team1, std::vector<Pokemon> &team2);
+
+// Result of playing a replay back against its recording
+struct ReplayCheck {
+  bool valid = false; // Teams and choices made sense
+  int winner = 0;
+  int turns = 0;
+  int diverged_at = 0; // First turn (1-based) that went differently, or 0
+
+  bool matches(const Replay &replay) const {
+    return valid && diverged_at == 0 && winner == replay.winner;
+  }
+};
+
+ReplayCheck check_replay(const Replay &replay, const DataCatalog &catalog);
@@ -0,0 +1,258 @@
+#include "server_event_loop.hpp"
+#include "../core/timeline.hpp"
+#include <vector>
+
+#ifdef _WIN32
+typedef WSAPOLLFD PollFd;
+static int poll_sockets(PollFd *fds, size_t count, int timeout_ms) {
+  return WSAPoll(fds, static_cast<ULONG>(count), timeout_ms);
+}
+#else
+#include <fcntl.h>
+#include <unistd.h>
+typedef pollfd PollFd;
+static int poll_sockets(PollFd *fds, size_t count, int timeout_ms) {
+  return ::poll(fds, static_cast<nfds_t>(count), timeout_ms);
+}
+#endif
+
+ServerEventLoop::ServerEventLoop(uint32_t tick_ms)
+    : epoch_(Clock::now()), wheel_(tick_ms, 512), running_(true),
+      wake_read_(-1), wake_write_(-1) {
+#ifndef _WIN32
+  int fds[2];
+  if (pipe(fds) == 0) {
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL, 0) | O_NONBLOCK);
+    wake_read_ = fds[0];
+    wake_write_ = fds[1];
+  }
+#endif
+  thread_ = std::thread([this]() { loop(); });
+}
+
+ServerEventLoop::~ServerEventLoop() {
+  running_ = false;
+  wake();
+  thread_.join();
+
+  // Nobody will answer now
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!pending_.empty()) {
+      complete(pending_.begin()->first, DecisionStatus::Disconnected);
+    }
+  }
+  run_completed();
+#ifndef _WIN32
+  if (wake_read_ >= 0) {
+    ::close(wake_read_);
+    ::close(wake_write_);
+  }
+#endif
+}
+
+uint64_t ServerEventLoop::now_ms() const {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() -
+                                                            epoch_)
+          .count());
+}
+
+void ServerEventLoop::wake() {
+#ifndef _WIN32
+  if (wake_write_ >= 0) {
+    char byte = 1;
+    ssize_t ignored = ::write(wake_write_, &byte, 1);
+    (void)ignored; // A full pipe already guarantees a wake-up
+  }
+#endif
+}
+
+void ServerEventLoop::complete(ClientConnection *client, DecisionStatus status,
+                               const Message &message) {
+  auto found = pending_.find(client);
+  if (found == pending_.end())
+    return;
+  wheel_.cancel(found->second.timer);
+  completed_.emplace_back(std::move(found->second.done),
+                          DecisionResult{status, message});
+  pending_.erase(found);
+}
+
+void ServerEventLoop::run_completed() {
+  std::vector<std::pair<Callback, DecisionResult>> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready.swap(completed_);
+  }
+  for (auto &entry : ready) {
+    entry.first(entry.second);
+  }
+}
+
+bool ServerEventLoop::read_into_inbox(ClientConnection *client) {
+  uint8_t buffer[4096];
+  while (true) {
+    long received = client->socket->receive_available(buffer, sizeof(buffer));
+    if (received < 0)
+      return false;
+    if (received == 0)
+      return true;
+    client->inbox.feed(buffer, static_cast<size_t>(received));
+  }
+}
+
+bool ServerEventLoop::deliver_buffered(ClientConnection *client) {
+  Message msg;
+  while (client->inbox.next(msg)) {
+    if (msg.type == MessageType::DISCONNECT) {
+      complete(client, DecisionStatus::Disconnected);
+      return true;
+    }
+
+    // A late answer to a request we already gave up on
+    bool is_answer = msg.type == MessageType::MOVE_RESPONSE ||
+                     msg.type == MessageType::SWITCH_RESPONSE ||
+                     msg.type == MessageType::SHOP_ACTION;
+    if (is_answer && client->stale_responses > 0) {
+      client->stale_responses--;
+      continue;
+    }
+
+    complete(client, DecisionStatus::Received, msg);
+    return true;
+  }
+
+  if (client->inbox.failed()) {
+    complete(client, DecisionStatus::Disconnected);
+    return true;
+  }
+  return false;
+}
+
+std::future<DecisionResult>
+ServerEventLoop::await_message(ClientConnection *client, int timeout_ms) {
+  auto promise = std::make_shared<std::promise<DecisionResult>>();
+  std::future<DecisionResult> result = promise->get_future();
+  await_message(client, timeout_ms, [promise](const DecisionResult &decision) {
+    promise->set_value(decision);
+  });
+  return result;
+}
+
+void ServerEventLoop::await_message(ClientConnection *client, int timeout_ms,
+                                    Callback done) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Pending &pending = pending_[client];
+    pending.done = std::move(done);
+
+    if (!client->socket->is_connected()) {
+      pending.timer = 0;
+      complete(client, DecisionStatus::Disconnected);
+    } else {
+      pending.timer = wheel_.schedule(
+          now_ms() + static_cast<uint64_t>(timeout_ms), [this, client]() {
+            complete(client, DecisionStatus::TimedOut);
+          });
+
+      // The answer may already be sitting in the inbox
+      if (!deliver_buffered(client)) {
+        wake();
+      }
+    }
+  }
+  run_completed();
+}
+
+bool ServerEventLoop::cancel(ClientConnection *client) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = pending_.find(client);
+  if (found == pending_.end())
+    return false;
+  wheel_.cancel(found->second.timer);
+  pending_.erase(found);
+  return true;
+}
+
+size_t ServerEventLoop::pending_count() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.size();
+}
+
+void ServerEventLoop::loop() {
+  timeline::name_thread("event loop");
+  std::vector<PollFd> fds;
+  std::vector<ClientConnection *> polled;
+
+  while (running_) {
+    fds.clear();
+    polled.clear();
+    int timeout_ms;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto &entry : pending_) {
+        PollFd pfd{};
+        pfd.fd = entry.first->socket->get_fd();
+        pfd.events = POLLIN;
+        fds.push_back(pfd);
+        polled.push_back(entry.first);
+      }
+      // Only tick while deadlines are armed; otherwise sleep until woken
+      timeout_ms = wheel_.size() > 0 ? static_cast<int>(wheel_.tick_ms()) : -1;
+    }
+
+#ifndef _WIN32
+    if (wake_read_ >= 0) {
+      PollFd pfd{};
+      pfd.fd = wake_read_;
+      pfd.events = POLLIN;
+      fds.push_back(pfd);
+    } else if (timeout_ms < 0) {
+      timeout_ms = static_cast<int>(wheel_.tick_ms());
+    }
+#else
+    if (timeout_ms < 0)
+      timeout_ms = static_cast<int>(wheel_.tick_ms());
+#endif
+
+    if (fds.empty()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+    } else {
+      poll_sockets(fds.data(), fds.size(), timeout_ms);
+    }
+
+#ifndef _WIN32
+    if (wake_read_ >= 0 && fds.back().revents) {
+      char drain[64];
+      while (::read(wake_read_, drain, sizeof(drain)) > 0) {
+      }
+    }
+#endif
+
+    uint64_t dispatch_start = timeline::enabled() ? timeline::now_us() : 0;
+    bool dispatched = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (size_t i = 0; i < polled.size(); i++) {
+        if (fds[i].revents == 0)
+          continue;
+        ClientConnection *client = polled[i];
+        if (pending_.find(client) == pending_.end())
+          continue; // Resolved while we were polling
+
+        bool open = read_into_inbox(client);
+        if (!deliver_buffered(client) && !open) {
+          complete(client, DecisionStatus::Disconnected);
+        }
+        dispatched = true;
+      }
+      wheel_.advance(now_ms());
+    }
+    run_completed();
+    // Idle ticks are left out of the timeline
+    if (dispatched && timeline::enabled())
+      timeline::record("io", "read responses", dispatch_start);
+  }
+}
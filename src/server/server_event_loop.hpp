@@ -0,0 +1,85 @@
+#pragma once
+#include "../network/protocol.hpp"
+#include "game_server.hpp"
+#include "timer_wheel.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class DecisionStatus { Received, TimedOut, Disconnected };
+
+struct DecisionResult {
+  DecisionStatus status;
+  Message message; // Valid when status == Received
+};
+
+// One thread that watches every player the server is waiting on. Battles
+// register "next message from this client, within N ms" and block on the
+// returned future while the loop polls all awaited sockets together.
+// Deadlines live in a timer wheel, so thousands of concurrent turns cost
+// O(1) each to arm and disarm. A hang-up resolves the wait immediately.
+class ServerEventLoop {
+public:
+  typedef std::function<void(const DecisionResult &)> Callback;
+
+private:
+  struct Pending {
+    Callback done;
+    TimerWheel::TimerId timer;
+  };
+
+  typedef std::chrono::steady_clock Clock;
+
+  Clock::time_point epoch_;
+  TimerWheel wheel_;
+  std::unordered_map<ClientConnection *, Pending> pending_;
+  // Resolved waits whose callbacks run once mutex_ is released
+  std::vector<std::pair<Callback, DecisionResult>> completed_;
+  std::mutex mutex_; // Guards pending_, completed_ and wheel_
+
+  std::atomic<bool> running_;
+  std::thread thread_;
+  int wake_read_;  // Self-pipe so new waits interrupt poll() (POSIX only)
+  int wake_write_;
+
+  uint64_t now_ms() const;
+  void wake();
+  void loop();
+  // Resolve and forget a wait; caller holds mutex_
+  void complete(ClientConnection *client, DecisionStatus status,
+                const Message &message = Message());
+  // Run callbacks queued by complete(); caller must not hold mutex_
+  void run_completed();
+  // Drain what the socket has buffered; false once the peer is gone
+  bool read_into_inbox(ClientConnection *client);
+  // Deliver the next non-stale message from the client's inbox, if any
+  bool deliver_buffered(ClientConnection *client);
+
+public:
+  explicit ServerEventLoop(uint32_t tick_ms = 10);
+  ~ServerEventLoop();
+
+  ServerEventLoop(const ServerEventLoop &) = delete;
+  ServerEventLoop &operator=(const ServerEventLoop &) = delete;
+
+  // Resolves with the client's next message, TimedOut after timeout_ms, or
+  // Disconnected. Only one wait per client may be outstanding.
+  std::future<DecisionResult> await_message(ClientConnection *client,
+                                            int timeout_ms);
+
+  // Same, but calls done instead of blocking anyone: on the loop thread, or
+  // on the caller's if the answer is already buffered. done may arm the
+  // next wait. Lets one thread serve many clients at once (e.g. lobbies).
+  void await_message(ClientConnection *client, int timeout_ms, Callback done);
+
+  // Drop the client's outstanding wait without calling it back. False if
+  // there was none (it had already resolved).
+  bool cancel(ClientConnection *client);
+
+  size_t pending_count();
+};
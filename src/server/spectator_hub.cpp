@@ -0,0 +1,164 @@
+#include "spectator_hub.hpp"
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+SpectatorHub::SpectatorHub(size_t max_queued_bytes, int max_skips)
+    : max_queued_bytes_(max_queued_bytes), max_skips_(max_skips) {}
+
+void SpectatorHub::add(ClientConnection *client) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  client->socket->set_non_blocking(true);
+
+  Spectator spectator;
+  spectator.client = client;
+  spectators_.push_back(spectator);
+  if (keyframe_) {
+    enqueue(spectators_.back(), keyframe_);
+    if (!flush(spectators_.back()))
+      drop(spectators_.back());
+  }
+}
+
+void SpectatorHub::enqueue(Spectator &spectator, const SharedFrame &frame) {
+  spectator.queue.push_back(frame);
+  spectator.queued_bytes += frame->size();
+}
+
+void SpectatorHub::skip_to_keyframe(Spectator &spectator) {
+  // A partly written frame has to finish or the stream loses its framing
+  SharedFrame head;
+  if (spectator.head_offset > 0) {
+    head = spectator.queue.front();
+  }
+
+  spectator.queue.clear();
+  spectator.queued_bytes = 0;
+  if (head) {
+    enqueue(spectator, head);
+    spectator.queued_bytes -= spectator.head_offset;
+  } else {
+    spectator.head_offset = 0;
+  }
+  if (keyframe_ && keyframe_ != head) {
+    enqueue(spectator, keyframe_);
+  }
+
+  spectator.skips++;
+  stats_.skips++;
+}
+
+bool SpectatorHub::flush(Spectator &spectator) {
+  const size_t max_slices = 64;
+  IoSlice slices[max_slices];
+
+  while (!spectator.queue.empty()) {
+    size_t count = 0;
+    for (const SharedFrame &frame : spectator.queue) {
+      if (count == max_slices)
+        break;
+      size_t offset = (count == 0) ? spectator.head_offset : 0;
+      slices[count++] = {frame->data() + offset, frame->size() - offset};
+    }
+
+    long sent = spectator.client->socket->send_vectored(slices, count);
+    if (sent < 0)
+      return false;
+    if (sent == 0)
+      return true; // Socket buffer full; retry on the next publish
+
+    stats_.bytes_written += static_cast<uint64_t>(sent);
+    spectator.queued_bytes -= static_cast<size_t>(sent);
+    size_t remaining = static_cast<size_t>(sent);
+    while (remaining > 0) {
+      size_t left_in_head =
+          spectator.queue.front()->size() - spectator.head_offset;
+      if (remaining < left_in_head) {
+        spectator.head_offset += remaining;
+        break;
+      }
+      remaining -= left_in_head;
+      spectator.queue.pop_front();
+      spectator.head_offset = 0;
+    }
+  }
+
+  spectator.skips = 0; // Caught up
+  return true;
+}
+
+void SpectatorHub::drop(Spectator &spectator) {
+  if (spectator.dropped)
+    return;
+  std::cout << "[Spectate] Dropping spectator '"
+            << spectator.client->player_name << "' (too far behind)\n";
+  spectator.dropped = true;
+  spectator.queue.clear();
+  spectator.queued_bytes = 0;
+  spectator.client->socket->close();
+  stats_.dropped++;
+}
+
+void SpectatorHub::publish(const SharedFrame &frame, bool keyframe) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.frames_published++;
+  if (keyframe) {
+    keyframe_ = frame;
+  }
+
+  for (auto &spectator : spectators_) {
+    if (spectator.dropped)
+      continue;
+
+    enqueue(spectator, frame);
+    if (spectator.queued_bytes > max_queued_bytes_) {
+      skip_to_keyframe(spectator);
+      if (spectator.skips > max_skips_) {
+        drop(spectator);
+        continue;
+      }
+    }
+    if (!flush(spectator)) {
+      drop(spectator);
+    }
+  }
+}
+
+std::vector<ClientConnection *> SpectatorHub::release(int timeout_ms) {
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(timeout_ms);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (true) {
+    bool pending = false;
+    for (auto &spectator : spectators_) {
+      if (spectator.dropped || spectator.queue.empty())
+        continue;
+      if (!flush(spectator)) {
+        drop(spectator);
+        continue;
+      }
+      pending = pending || !spectator.queue.empty();
+    }
+    if (!pending || std::chrono::steady_clock::now() >= deadline)
+      break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+
+  std::vector<ClientConnection *> released;
+  for (auto &spectator : spectators_) {
+    released.push_back(spectator.client);
+  }
+  spectators_.clear();
+  return released;
+}
+
+size_t SpectatorHub::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return spectators_.size();
+}
+
+SpectatorStats SpectatorHub::stats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "../network/protocol.hpp"
+#include "game_server.hpp"
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+struct SpectatorStats {
+  uint64_t frames_published = 0;
+  uint64_t bytes_written = 0;
+  uint64_t skips = 0;   // Backlogs discarded in favour of the latest keyframe
+  uint64_t dropped = 0; // Spectators disconnected for falling behind
+};
+
+// Fans a battle's messages out to any number of spectators. Each message is
+// encoded once into a SharedFrame; every spectator just queues a reference
+// to it and drains its queue with non-blocking vectored writes. The battle
+// thread never waits on a spectator: one whose backlog grows too large has
+// it replaced by the latest keyframe, and one that keeps falling behind is
+// dropped.
+class SpectatorHub {
+private:
+  struct Spectator {
+    ClientConnection *client;
+    std::deque<SharedFrame> queue;
+    size_t head_offset = 0;  // Bytes of queue.front() already written
+    size_t queued_bytes = 0; // Unwritten bytes across the queue
+    int skips = 0;           // Consecutive skips without draining
+    bool dropped = false;
+  };
+
+  std::vector<Spectator> spectators_;
+  SharedFrame keyframe_; // Latest full snapshot, sent on join and on skip
+  size_t max_queued_bytes_;
+  int max_skips_;
+  SpectatorStats stats_;
+  std::mutex mutex_; // Spectators join from the accept thread
+
+  void enqueue(Spectator &spectator, const SharedFrame &frame);
+  void skip_to_keyframe(Spectator &spectator);
+  bool flush(Spectator &spectator); // False if the connection failed
+  void drop(Spectator &spectator);
+
+public:
+  explicit SpectatorHub(size_t max_queued_bytes = 64 * 1024,
+                        int max_skips = 4);
+
+  // Starts from the latest keyframe, if one has been published
+  void add(ClientConnection *client);
+
+  // Queue a frame for everyone and write as much as sockets accept now.
+  // A keyframe fully describes the battle so far.
+  void publish(const SharedFrame &frame, bool keyframe = false);
+
+  // Give spectators up to timeout_ms to drain, then hand all of them back
+  // (including dropped ones, whose sockets are already closed)
+  std::vector<ClientConnection *> release(int timeout_ms);
+
+  size_t size();
+  SpectatorStats stats();
+};
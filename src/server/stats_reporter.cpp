@@ -0,0 +1,30 @@
+#include "stats_reporter.hpp"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+StatsReporter::StatsReporter(int interval_seconds)
+    : interval_seconds_(interval_seconds), last_(instrument::snapshot()),
+      stopping_(false), thread_(&StatsReporter::run, this) {}
+
+StatsReporter::~StatsReporter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void StatsReporter::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!cv_.wait_for(lock, std::chrono::seconds(interval_seconds_),
+                       [this]() { return stopping_; })) {
+    instrument::Snapshot now = instrument::snapshot();
+    std::stringstream report;
+    report << "[Stats] Last " << interval_seconds_ << "s:\n"
+           << instrument::format(now.since(last_));
+    std::cout << report.str() << std::flush;
+    last_ = now;
+  }
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "../core/instrument.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Prints what the instrumentation recorded every interval, each report
+// covering only the interval since the last one
+class StatsReporter {
+private:
+  int interval_seconds_;
+  instrument::Snapshot last_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_;
+  std::thread thread_;
+
+  void run();
+
+public:
+  explicit StatsReporter(int interval_seconds);
+  ~StatsReporter(); // Stops without a final report
+
+  StatsReporter(const StatsReporter &) = delete;
+  StatsReporter &operator=(const StatsReporter &) = delete;
+};
@@ -1,6 +1,11 @@
 #pragma once
 #include "../core/pokemon.hpp"
+#include <random>
 #include <vector>
 
 // Generate a random team of Pokemon
 std::vector<Pokemon> generate_random_team(int team_size = 6, int level = 50);
+
+// Same, drawing from the caller's generator so teams can be reproduced
+std::vector<Pokemon> generate_random_team(int team_size, int level,
+                                          std::mt19937 &gen);
@@ -0,0 +1,67 @@
+#include "timer_wheel.hpp"
+
+TimerWheel::TimerWheel(uint32_t tick_ms, size_t slot_count, uint64_t now_ms)
+    : tick_ms_(tick_ms ? tick_ms : 1), slots_(slot_count ? slot_count : 1),
+      current_tick_(now_ms / (tick_ms ? tick_ms : 1)), next_id_(1) {}
+
+TimerWheel::TimerId TimerWheel::schedule(uint64_t deadline_ms,
+                                         std::function<void()> callback) {
+  uint64_t expiry = (deadline_ms + tick_ms_ - 1) / tick_ms_;
+  if (expiry <= current_tick_) {
+    expiry = current_tick_ + 1; // Already due: fire on the next advance
+  }
+
+  size_t slot = static_cast<size_t>(expiry % slots_.size());
+  TimerId id = next_id_++;
+  slots_[slot].push_back(Timer{id, expiry, std::move(callback)});
+  index_[id] = std::make_pair(slot, std::prev(slots_[slot].end()));
+  return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+  auto found = index_.find(id);
+  if (found == index_.end())
+    return false;
+  slots_[found->second.first].erase(found->second.second);
+  index_.erase(found);
+  return true;
+}
+
+void TimerWheel::collect(Slot &slot, uint64_t up_to_tick,
+                         std::vector<std::function<void()>> &expired) {
+  for (auto it = slot.begin(); it != slot.end();) {
+    // Timers more than one revolution out share the slot; leave them
+    if (it->expiry_tick > up_to_tick) {
+      ++it;
+      continue;
+    }
+    expired.push_back(std::move(it->callback));
+    index_.erase(it->id);
+    it = slot.erase(it);
+  }
+}
+
+size_t TimerWheel::advance(uint64_t now_ms) {
+  uint64_t target = now_ms / tick_ms_;
+  if (target <= current_tick_)
+    return 0;
+
+  std::vector<std::function<void()>> expired;
+  if (target - current_tick_ >= slots_.size()) {
+    // Slept through a whole revolution: every slot may hold due timers
+    for (auto &slot : slots_) {
+      collect(slot, target, expired);
+    }
+  } else {
+    for (uint64_t tick = current_tick_ + 1; tick <= target; tick++) {
+      collect(slots_[tick % slots_.size()], tick, expired);
+    }
+  }
+  current_tick_ = target;
+
+  // Callbacks run after the wheel is consistent, so they may reschedule
+  for (auto &callback : expired) {
+    callback();
+  }
+  return expired.size();
+}
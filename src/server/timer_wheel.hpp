@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Hashed timing wheel. Deadlines are rounded up to a whole tick and hashed
+// into slot (tick % slot_count), so scheduling and cancelling are O(1) no
+// matter how many timers are pending, and advance() only visits the slots
+// for ticks that have passed. Not thread-safe.
+class TimerWheel {
+public:
+  typedef uint64_t TimerId;
+
+private:
+  struct Timer {
+    TimerId id;
+    uint64_t expiry_tick;
+    std::function<void()> callback;
+  };
+  typedef std::list<Timer> Slot;
+
+  uint32_t tick_ms_;
+  std::vector<Slot> slots_;
+  std::unordered_map<TimerId, std::pair<size_t, Slot::iterator>> index_;
+  uint64_t current_tick_;
+  TimerId next_id_;
+
+  void collect(Slot &slot, uint64_t up_to_tick,
+               std::vector<std::function<void()>> &expired);
+
+public:
+  TimerWheel(uint32_t tick_ms, size_t slot_count, uint64_t now_ms = 0);
+
+  // Run callback from the first advance() at or after deadline_ms
+  TimerId schedule(uint64_t deadline_ms, std::function<void()> callback);
+  // False if the timer already fired or was cancelled
+  bool cancel(TimerId id);
+  // Fire every timer that is due by now_ms; returns how many fired
+  size_t advance(uint64_t now_ms);
+
+  size_t size() const { return index_.size(); }
+  uint32_t tick_ms() const { return tick_ms_; }
+};
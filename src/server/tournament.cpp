@@ -0,0 +1,447 @@
+#include "tournament.hpp"
+#include "../core/rng.hpp"
+#include "../network/protocol.hpp"
+#include "headless_battle.hpp"
+#include "network_battle.hpp"
+#include <algorithm>
+#include <future>
+#include <iostream>
+#include <sstream>
+
+const char *tournament_format_to_string(TournamentFormat format) {
+  switch (format) {
+  case TournamentFormat::SingleElimination:
+    return "single elimination";
+  case TournamentFormat::DoubleElimination:
+    return "double elimination";
+  case TournamentFormat::Swiss:
+    return "swiss";
+  default:
+    return "unknown";
+  }
+}
+
+Tournament::Tournament(TournamentFormat format, BattleExecutor &executor)
+    : format_(format), executor_(executor), round_(0), verbose_(true) {}
+
+int Tournament::add_human(ClientConnection *connection,
+                          std::vector<Pokemon> team) {
+  TournamentEntrant entrant;
+  entrant.name = connection->player_name;
+  entrant.team = std::move(team);
+  entrant.connection = connection;
+  entrant.ai = nullptr;
+  entrants_.push_back(std::move(entrant));
+  return static_cast<int>(entrants_.size()) - 1;
+}
+
+int Tournament::add_bot(const std::string &name, std::vector<Pokemon> team,
+                        const BattleAI *ai) {
+  TournamentEntrant entrant;
+  entrant.name = name;
+  entrant.team = std::move(team);
+  entrant.connection = nullptr;
+  entrant.ai = ai;
+  entrants_.push_back(std::move(entrant));
+  return static_cast<int>(entrants_.size()) - 1;
+}
+
+int Tournament::swiss_round_count(size_t entrant_count) {
+  int rounds = 0;
+  size_t capacity = 1;
+  while (capacity < entrant_count) {
+    capacity *= 2;
+    rounds++;
+  }
+  return std::max(rounds, 1);
+}
+
+int Tournament::run() {
+  if (entrants_.size() < 2) {
+    return entrants_.empty() ? -1 : 0;
+  }
+
+  std::stringstream ss;
+  ss << "Tournament starting: " << entrants_.size() << " entrants, "
+     << tournament_format_to_string(format_);
+  std::cout << "[Tournament] " << ss.str() << "\n";
+  broadcast(MessageType::TOURNAMENT_START, ss.str());
+
+  int champion = -1;
+  switch (format_) {
+  case TournamentFormat::SingleElimination:
+    champion = run_single_elimination();
+    break;
+  case TournamentFormat::DoubleElimination:
+    champion = run_double_elimination();
+    break;
+  case TournamentFormat::Swiss:
+    champion = run_swiss();
+    break;
+  }
+
+  std::string result = "Tournament champion: " + entrants_[champion].name;
+  std::cout << "[Tournament] " << result << "\n";
+  broadcast(MessageType::GAME_OVER, result);
+  return champion;
+}
+
+int Tournament::run_single_elimination() {
+  std::vector<int> field;
+  for (size_t i = 0; i < entrants_.size(); i++) {
+    field.push_back(static_cast<int>(i));
+  }
+
+  // Round 1 hands byes to the top seeds so later rounds are a power of two
+  size_t bracket_size = 1;
+  while (bracket_size < field.size()) {
+    bracket_size *= 2;
+  }
+  size_t byes = bracket_size - field.size();
+
+  while (field.size() > 1) {
+    round_++;
+    std::vector<TournamentMatch> round_matches;
+    for (size_t i = 0; i < byes; i++) {
+      round_matches.push_back({round_, field[i], -1, -1, "Winners"});
+    }
+    std::vector<int> rest(field.begin() + byes, field.end());
+    pair_in_order(rest, "Winners", round_matches);
+    byes = 0;
+
+    play_round(round_matches);
+
+    field.clear();
+    for (const auto &match : round_matches) {
+      field.push_back(match.winner);
+    }
+  }
+
+  return field[0];
+}
+
+int Tournament::run_double_elimination() {
+  std::vector<int> winners; // Undefeated
+  std::vector<int> losers;  // One loss
+  for (size_t i = 0; i < entrants_.size(); i++) {
+    winners.push_back(static_cast<int>(i));
+  }
+
+  // Give an odd field's bye to whoever has had the fewest so far
+  auto move_bye_to_front = [this](std::vector<int> &field) {
+    if (field.size() % 2 == 0)
+      return;
+    auto fewest = std::min_element(
+        field.begin(), field.end(), [this](int a, int b) {
+          return entrants_[a].byes < entrants_[b].byes;
+        });
+    std::rotate(field.begin(), fewest, fewest + 1);
+  };
+
+  // Winners and losers bracket rounds are played concurrently
+  while (winners.size() > 1 || losers.size() > 1) {
+    round_++;
+    std::vector<TournamentMatch> round_matches;
+
+    if (winners.size() > 1) {
+      move_bye_to_front(winners);
+      pair_in_order(winners, "Winners", round_matches);
+    }
+    size_t losers_start = round_matches.size();
+    if (losers.size() > 1) {
+      move_bye_to_front(losers);
+      pair_in_order(losers, "Losers", round_matches);
+    }
+
+    play_round(round_matches);
+
+    std::vector<int> next_winners =
+        winners.size() > 1 ? std::vector<int>() : winners;
+    std::vector<int> next_losers =
+        losers.size() > 1 ? std::vector<int>() : losers;
+    std::vector<int> dropped;
+
+    for (size_t i = 0; i < round_matches.size(); i++) {
+      const TournamentMatch &match = round_matches[i];
+      int loser = (match.winner == match.entrant1) ? match.entrant2
+                                                   : match.entrant1;
+      if (i < losers_start) {
+        next_winners.push_back(match.winner);
+        if (loser != -1)
+          dropped.push_back(loser);
+      } else {
+        next_losers.push_back(match.winner);
+      }
+    }
+
+    next_losers.insert(next_losers.end(), dropped.begin(), dropped.end());
+    winners = std::move(next_winners);
+    losers = std::move(next_losers);
+  }
+
+  if (losers.empty()) {
+    return winners[0];
+  }
+
+  // Grand final; the losers bracket champion has to win twice
+  round_++;
+  std::vector<TournamentMatch> final_match = {
+      {round_, winners[0], losers[0], -1, "Grand Final"}};
+  play_round(final_match);
+  if (final_match[0].winner == winners[0]) {
+    return winners[0];
+  }
+
+  round_++;
+  std::vector<TournamentMatch> reset_match = {
+      {round_, winners[0], losers[0], -1, "Grand Final"}};
+  play_round(reset_match);
+  return reset_match[0].winner;
+}
+
+int Tournament::run_swiss() {
+  int rounds = swiss_round_count(entrants_.size());
+
+  for (int r = 0; r < rounds; r++) {
+    round_++;
+    std::vector<TournamentMatch> round_matches = pair_swiss();
+    play_round(round_matches);
+  }
+
+  // Most wins, then Buchholz (sum of opponents' wins), then fewest losses
+  auto buchholz = [this](int index) {
+    int total = 0;
+    for (int opponent : entrants_[index].opponents) {
+      total += entrants_[opponent].wins;
+    }
+    return total;
+  };
+
+  int champion = 0;
+  for (size_t i = 1; i < entrants_.size(); i++) {
+    const TournamentEntrant &a = entrants_[i];
+    const TournamentEntrant &best = entrants_[champion];
+    int idx = static_cast<int>(i);
+    if (a.wins != best.wins) {
+      if (a.wins > best.wins)
+        champion = idx;
+    } else if (buchholz(idx) != buchholz(champion)) {
+      if (buchholz(idx) > buchholz(champion))
+        champion = idx;
+    } else if (a.losses < best.losses) {
+      champion = idx;
+    }
+  }
+  return champion;
+}
+
+void Tournament::pair_in_order(const std::vector<int> &field,
+                               const char *bracket,
+                               std::vector<TournamentMatch> &round_matches) {
+  size_t start = 0;
+  if (field.size() % 2 == 1) {
+    round_matches.push_back({round_, field[0], -1, -1, bracket});
+    start = 1;
+  }
+  for (size_t i = start; i + 1 < field.size(); i += 2) {
+    round_matches.push_back({round_, field[i], field[i + 1], -1, bracket});
+  }
+}
+
+std::vector<TournamentMatch> Tournament::pair_swiss() {
+  std::vector<int> order;
+  for (size_t i = 0; i < entrants_.size(); i++) {
+    order.push_back(static_cast<int>(i));
+  }
+  std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+    return entrants_[a].wins > entrants_[b].wins;
+  });
+
+  std::vector<TournamentMatch> round_matches;
+
+  // Odd field: the lowest-ranked entrant with the fewest byes sits out
+  if (order.size() % 2 == 1) {
+    auto bye = order.end() - 1;
+    for (auto it = order.end() - 1;; --it) {
+      if (entrants_[*it].byes < entrants_[*bye].byes)
+        bye = it;
+      if (it == order.begin())
+        break;
+    }
+    round_matches.push_back({round_, *bye, -1, -1, "Swiss"});
+    order.erase(bye);
+  }
+
+  // Greedy pairing down the standings, avoiding rematches where possible
+  std::vector<bool> paired(order.size(), false);
+  for (size_t i = 0; i < order.size(); i++) {
+    if (paired[i])
+      continue;
+    paired[i] = true;
+
+    const std::vector<int> &played = entrants_[order[i]].opponents;
+    size_t partner = order.size();
+    for (size_t j = i + 1; j < order.size(); j++) {
+      if (paired[j])
+        continue;
+      if (partner == order.size())
+        partner = j; // Fallback if everyone left is a rematch
+      if (std::find(played.begin(), played.end(), order[j]) == played.end()) {
+        partner = j;
+        break;
+      }
+    }
+
+    paired[partner] = true;
+    round_matches.push_back({round_, order[i], order[partner], -1, "Swiss"});
+  }
+
+  return round_matches;
+}
+
+void Tournament::play_round(std::vector<TournamentMatch> &round_matches) {
+  if (verbose_) {
+    std::cout << "[Tournament] Round " << round_ << ": "
+              << round_matches.size() << " matches\n";
+  }
+
+  std::vector<std::future<void>> pending;
+  for (auto &match : round_matches) {
+    if (match.entrant2 == -1) {
+      match.winner = match.entrant1;
+      record_result(match);
+      continue;
+    }
+
+    std::string announce = "Round " + std::to_string(round_) + " (" +
+                           match.bracket + "): " +
+                           entrants_[match.entrant1].name + " vs " +
+                           entrants_[match.entrant2].name;
+    send_to(entrants_[match.entrant1], MessageType::MATCH_START, announce);
+    send_to(entrants_[match.entrant2], MessageType::MATCH_START, announce);
+
+    TournamentMatch *slot = &match;
+    pending.push_back(executor_.submit([this, slot]() {
+      slot->winner = play_match(*slot);
+      record_result(*slot);
+    }));
+  }
+
+  // Wait for every match before surfacing any failure
+  for (auto &f : pending) {
+    f.wait();
+  }
+  for (auto &f : pending) {
+    f.get();
+  }
+
+  broadcast(MessageType::ROUND_COMPLETE,
+            "Round " + std::to_string(round_) + " complete\n" +
+                standings_summary(8));
+}
+
+int Tournament::play_match(const TournamentMatch &match) {
+  const TournamentEntrant &a = entrants_[match.entrant1];
+  const TournamentEntrant &b = entrants_[match.entrant2];
+
+  if (!a.connection && !b.connection) {
+    HeadlessBattleResult result =
+        run_headless_battle(a.team, b.team, *a.ai, *b.ai);
+    if (result.winner == 1)
+      return match.entrant1;
+    if (result.winner == 2)
+      return match.entrant2;
+
+    // Turn limit: more Pokemon left standing wins, otherwise a coin flip
+    if (result.remaining1 != result.remaining2) {
+      return result.remaining1 > result.remaining2 ? match.entrant1
+                                                   : match.entrant2;
+    }
+    return rng_int(0, 1) == 0 ? match.entrant1 : match.entrant2;
+  }
+
+  NetworkBattle battle(a.team, b.team, a.connection, b.connection);
+  if (!a.connection)
+    battle.set_ai_controller(1, a.ai, a.name);
+  if (!b.connection)
+    battle.set_ai_controller(2, b.ai, b.name);
+  battle.set_decision_policy(decision_policy_);
+  battle.set_replay_writer(replay_writer_);
+  battle.run();
+
+  return battle.winner() == 2 ? match.entrant2 : match.entrant1;
+}
+
+void Tournament::record_result(const TournamentMatch &match) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  matches_.push_back(match);
+
+  TournamentEntrant &winner = entrants_[match.winner];
+  std::stringstream ss;
+  ss << "Round " << match.round << " (" << match.bracket << "): ";
+
+  if (match.entrant2 == -1) {
+    winner.byes++;
+    if (format_ == TournamentFormat::Swiss)
+      winner.wins++; // A Swiss bye scores as a win
+    ss << winner.name << " has a bye";
+  } else {
+    int loser_index =
+        (match.winner == match.entrant1) ? match.entrant2 : match.entrant1;
+    TournamentEntrant &loser = entrants_[loser_index];
+
+    winner.wins++;
+    loser.losses++;
+    winner.opponents.push_back(loser_index);
+    loser.opponents.push_back(match.winner);
+
+    if (format_ == TournamentFormat::SingleElimination ||
+        (format_ == TournamentFormat::DoubleElimination && loser.losses >= 2)) {
+      loser.eliminated = true;
+    }
+
+    ss << winner.name << " defeated " << loser.name;
+    if (loser.eliminated)
+      ss << " (" << loser.name << " eliminated)";
+  }
+
+  if (verbose_) {
+    std::cout << "[Tournament] " << ss.str() << "\n";
+  }
+  broadcast(MessageType::BRACKET_UPDATE, ss.str());
+}
+
+void Tournament::broadcast(MessageType type, const std::string &text) {
+  for (const auto &entrant : entrants_) {
+    send_to(entrant, type, text);
+  }
+}
+
+void Tournament::send_to(const TournamentEntrant &entrant, MessageType type,
+                         const std::string &text) {
+  if (!entrant.connection)
+    return;
+
+  std::lock_guard<std::mutex> lock(entrant.connection->send_mutex);
+  send_message(*entrant.connection->socket, Message(type, text));
+}
+
+std::string Tournament::standings_summary(size_t max_lines) const {
+  std::vector<int> order;
+  for (size_t i = 0; i < entrants_.size(); i++) {
+    order.push_back(static_cast<int>(i));
+  }
+  std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+    if (entrants_[a].wins != entrants_[b].wins)
+      return entrants_[a].wins > entrants_[b].wins;
+    return entrants_[a].losses < entrants_[b].losses;
+  });
+
+  std::stringstream ss;
+  for (size_t i = 0; i < order.size() && i < max_lines; i++) {
+    const TournamentEntrant &e = entrants_[order[i]];
+    ss << (i + 1) << ". " << e.name << " " << e.wins << "-" << e.losses
+       << (e.eliminated ? " (out)" : "") << "\n";
+  }
+  return ss.str();
+}
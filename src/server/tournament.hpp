@@ -0,0 +1,99 @@
+#pragma once
+#include "../ai/ai_interface.hpp"
+#include "../core/pokemon.hpp"
+#include "../network/protocol.hpp"
+#include "battle_executor.hpp"
+#include "game_server.hpp"
+#include "network_battle.hpp"
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class TournamentFormat { SingleElimination, DoubleElimination, Swiss };
+
+const char *tournament_format_to_string(TournamentFormat format);
+
+// A player in the tournament: either a connected client or a bot
+struct TournamentEntrant {
+  std::string name;
+  std::vector<Pokemon> team;
+  ClientConnection *connection; // nullptr for bots
+  const BattleAI *ai;           // Used when connection is nullptr
+
+  int wins = 0;
+  int losses = 0;
+  int byes = 0;
+  bool eliminated = false;
+  std::vector<int> opponents; // Entrant indices already played (Swiss)
+};
+
+// One pairing. entrant2 == -1 is a bye for entrant1.
+struct TournamentMatch {
+  int round;
+  int entrant1;
+  int entrant2;
+  int winner; // Entrant index, -1 until played
+  const char *bracket; // "Winners", "Losers", "Grand Final" or "Swiss"
+};
+
+// Runs a tournament where every match of a round is played concurrently on
+// the battle executor. Bot-vs-bot matches are headless; any match with a
+// human is a NetworkBattle (bots play their side through BattleAI).
+class Tournament {
+private:
+  TournamentFormat format_;
+  BattleExecutor &executor_;
+  std::vector<TournamentEntrant> entrants_;
+  std::vector<TournamentMatch> matches_;
+  std::mutex mutex_; // Guards entrants_ records and broadcasts
+  int round_;
+  bool verbose_;
+  DecisionPolicy decision_policy_; // For matches with a human in them
+  ReplayWriter *replay_writer_ = nullptr; // Records those matches, if set
+
+  // Round drivers (return the champion's index)
+  int run_single_elimination();
+  int run_double_elimination();
+  int run_swiss();
+
+  // Pair a list of entrant indices in order; an odd one out gets a bye
+  void pair_in_order(const std::vector<int> &field, const char *bracket,
+                     std::vector<TournamentMatch> &round_matches);
+  std::vector<TournamentMatch> pair_swiss();
+
+  // Play all matches concurrently and record results as each one finishes
+  void play_round(std::vector<TournamentMatch> &round_matches);
+  int play_match(const TournamentMatch &match); // Returns winner index
+  void record_result(const TournamentMatch &match);
+
+  // Messaging to connected entrants
+  void broadcast(MessageType type, const std::string &text);
+  void send_to(const TournamentEntrant &entrant, MessageType type,
+               const std::string &text);
+  std::string standings_summary(size_t max_lines) const;
+
+public:
+  Tournament(TournamentFormat format, BattleExecutor &executor);
+
+  // Returns the entrant index
+  int add_human(ClientConnection *connection, std::vector<Pokemon> team);
+  int add_bot(const std::string &name, std::vector<Pokemon> team,
+              const BattleAI *ai);
+
+  // Print every match result to stdout (off for very large fields)
+  void set_verbose(bool verbose) { verbose_ = verbose; }
+  void set_decision_policy(const DecisionPolicy &policy) {
+    decision_policy_ = policy;
+  }
+  void set_replay_writer(ReplayWriter *writer) { replay_writer_ = writer; }
+
+  // Play the whole tournament; returns the champion's entrant index
+  int run();
+
+  // Number of Swiss rounds for a field of this size
+  static int swiss_round_count(size_t entrant_count);
+
+  const std::vector<TournamentEntrant> &entrants() const { return entrants_; }
+  const std::vector<TournamentMatch> &matches() const { return matches_; }
+  int rounds_played() const { return round_; }
+};
@@ -1,10 +1,137 @@
+#include "ai/gen1_ai.hpp"
+#include "ai/random_ai.hpp"
+#include "core/timeline.hpp"
+#include "autobattler/ghost_pool.hpp"
 #include "data/loader.hpp"
+#include "server/battle_executor.hpp"
+#include "server/data_watcher.hpp"
 #include "server/game_server.hpp"
+#include "server/lobby_service.hpp"
+#include "server/matchmaking_service.hpp"
 #include "server/network_battle.hpp"
+#include "server/replay.hpp"
+#include "server/server_event_loop.hpp"
+#include "server/stats_reporter.hpp"
 #include "server/team_generator.hpp"
+#include "server/tournament.hpp"
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
+// Tournament mode. Human players connect first; the rest of the field is
+// filled with bots, so humans == 0 runs a fully headless AI tournament.
+int run_tournament(GameServer &server, TournamentFormat format, int entrants,
+                   int humans, const DecisionPolicy &policy,
+                   ReplayWriter *replays) {
+  std::cout << "\n=== Tournament Mode (" << tournament_format_to_string(format)
+            << ", " << entrants << " entrants, " << humans << " human) ===\n";
+
+  if (humans > 0) {
+    server.wait_for_clients(humans);
+  }
+
+  BattleExecutor executor;
+  Tournament tournament(format, executor);
+  tournament.set_verbose(entrants <= 64);
+  tournament.set_decision_policy(policy);
+  tournament.set_replay_writer(replays);
+
+  for (auto *client : server.get_clients()) {
+    if (client->spectator)
+      continue;
+    tournament.add_human(client, generate_random_team(6, 50));
+  }
+
+  Gen1AI gen1_ai;
+  RandomAI random_ai;
+  for (int i = humans; i < entrants; i++) {
+    const BattleAI *ai = (i % 2 == 0) ? static_cast<const BattleAI *>(&gen1_ai)
+                                      : &random_ai;
+    tournament.add_bot("Bot" + std::to_string(i + 1),
+                       generate_random_team(6, 50), ai);
+  }
+
+  std::cout << "[Server] Running tournament on " << executor.thread_count()
+            << " worker threads\n";
+
+  try {
+    int champion = tournament.run();
+    const TournamentEntrant &winner = tournament.entrants()[champion];
+    std::cout << "\nChampion: " << winner.name << " (" << winner.wins << "-"
+              << winner.losses << ") after " << tournament.rounds_played()
+              << " rounds\n";
+  } catch (const std::exception &e) {
+    std::cerr << "[Server] Exception during tournament: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
+
+TournamentFormat parse_tournament_format(const std::string &name) {
+  if (name == "double")
+    return TournamentFormat::DoubleElimination;
+  if (name == "swiss")
+    return TournamentFormat::Swiss;
+  return TournamentFormat::SingleElimination;
+}
+
+// Usage: battler_server [port] [mode] [format] [entrants] [humans]
+//   e.g. battler_server 8888 2 swiss 1024 0   (headless AI tournament)
+//        battler_server [port] 3 [concurrent battles] [battles before exit]
+//        battler_server [port] 4 [players per lobby] [shop seconds]
+//                       [lobbies before exit]
+// Options (anywhere): --move-timeout=SECONDS  time a player gets per decision
+// before Gen1AI decides for them (default 30)
+//                      --replays=FILE  append a replay of every network battle
+//                      --replay-trace  include per-turn HP/status in replays
+//                      --chrome-trace=FILE  record each battle turn's phases
+// and write them as Chrome trace JSON on exit (chrome://tracing, Perfetto)
+//                      --stats-interval=SECONDS  print instrumentation totals
+// (needs a -DBATTLER_INSTRUMENT=ON build; clients can also ask for them
+// with a STATS_REQUEST, see battler_client --stats)
+//                      --watch-data=SECONDS  reload species.json and
+// moves.json when they change; running battles keep the data they began with
 int main(int argc, char **argv) {
+  int move_timeout = 30;
+  std::string replay_path;
+  bool replay_trace = false;
+  int stats_interval = 0;
+  int watch_interval = 0;
+  std::string chrome_trace_path;
+  std::vector<char *> args;
+  for (int i = 0; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.rfind("--move-timeout=", 0) == 0) {
+      move_timeout = std::max(1, std::atoi(arg.c_str() + 15));
+      continue;
+    }
+    if (arg.rfind("--replays=", 0) == 0) {
+      replay_path = arg.substr(10);
+      continue;
+    }
+    if (arg == "--replay-trace") {
+      replay_trace = true;
+      continue;
+    }
+    if (arg.rfind("--chrome-trace=", 0) == 0) {
+      chrome_trace_path = arg.substr(15);
+      continue;
+    }
+    if (arg.rfind("--stats-interval=", 0) == 0) {
+      stats_interval = std::max(1, std::atoi(arg.c_str() + 17));
+      continue;
+    }
+    if (arg.rfind("--watch-data=", 0) == 0) {
+      watch_interval = std::max(1, std::atoi(arg.c_str() + 13));
+      continue;
+    }
+    args.push_back(argv[i]);
+  }
+  argc = static_cast<int>(args.size());
+  argv = args.data();
+
   int port = 8888; // Default port
   if (argc > 1) {
     port = std::atoi(argv[1]);
@@ -14,11 +141,39 @@ int main(int argc, char **argv) {
 
   // Load game data
   std::cout << "Loading game data...\n";
-  load_species("src/data/species.json");
-  load_moves("src/data/moves.json");
-  load_type_chart("src/data/type_chart.json");
+  load_game_data("src/data/species.json", "src/data/moves.json",
+                 "src/data/type_chart.json");
   std::cout << "Game data loaded!\n\n";
 
+  // Battles record into this once they finish; it writes out on exit
+  std::unique_ptr<ReplayWriter> replays;
+  if (!replay_path.empty()) {
+    replays.reset(new ReplayWriter(replay_path, replay_trace));
+    std::cout << "Recording replays to " << replay_path << "\n\n";
+  }
+
+  // Declared before the server and executors so it is written after their
+  // threads have finished
+  std::unique_ptr<timeline::ChromeTraceFile> chrome_trace;
+  if (!chrome_trace_path.empty())
+    chrome_trace.reset(new timeline::ChromeTraceFile(chrome_trace_path));
+
+  std::unique_ptr<StatsReporter> stats;
+  if (stats_interval > 0) {
+    if (!instrument::enabled())
+      std::cout << "Instrumentation is off in this build, no stats to print\n\n";
+    else
+      stats.reset(new StatsReporter(stats_interval));
+  }
+
+  std::unique_ptr<GameDataWatcher> data_watcher;
+  if (watch_interval > 0) {
+    data_watcher.reset(new GameDataWatcher(
+        "src/data/species.json", "src/data/moves.json", watch_interval));
+    std::cout << "Watching game data for changes every " << watch_interval
+              << "s\n\n";
+  }
+
   // Create and start server
   GameServer server(port);
   if (!server.start()) {
@@ -26,21 +181,38 @@ int main(int argc, char **argv) {
     return 1;
   }
 
-  // Menu: 1v1 or Tournament
-  std::cout << "\nSelect mode:\n";
-  std::cout << "1. 1v1 Battle (2 players)\n";
-  std::cout << "2. Tournament (8 players) [NOT YET IMPLEMENTED]\n";
-  std::cout << "Choice: ";
+  // One thread watches every player we are waiting on and enforces deadlines
+  ServerEventLoop event_loop;
+  Gen1AI fallback_ai;
+  DecisionPolicy policy;
+  policy.loop = &event_loop;
+  policy.timeout_ms = move_timeout * 1000;
+  policy.fallback_ai = &fallback_ai;
 
   int mode;
-  std::cin >> mode;
+  if (argc > 2) {
+    mode = std::atoi(argv[2]);
+  } else {
+    // Menu: 1v1 or Tournament
+    std::cout << "\nSelect mode:\n";
+    std::cout << "1. 1v1 Battle (2 players)\n";
+    std::cout << "2. Tournament (single/double elimination or swiss)\n";
+    std::cout << "3. Ranked matchmaking (continuous)\n";
+    std::cout << "4. Autobattler lobby (continuous)\n";
+    std::cout << "Choice: ";
+    std::cin >> mode;
+  }
 
   if (mode == 1) {
     // 1v1 Battle Mode
     std::cout << "\n=== 1v1 Battle Mode ===\n";
     server.wait_for_clients(2);
 
-    auto clients = server.get_clients();
+    std::vector<ClientConnection *> clients;
+    std::vector<ClientConnection *> spectators;
+    for (auto *client : server.get_clients()) {
+      (client->spectator ? spectators : clients).push_back(client);
+    }
     if (clients.size() < 2) {
       std::cerr << "Not enough clients connected\n";
       return 1;
@@ -54,6 +226,11 @@ int main(int argc, char **argv) {
 
     // Create and run battle
     NetworkBattle battle(team1, team2, clients[0], clients[1]);
+    battle.set_decision_policy(policy);
+    battle.set_replay_writer(replays.get());
+    for (auto *spectator : spectators) {
+      battle.add_spectator(spectator);
+    }
 
     try {
       battle.run();
@@ -65,9 +242,59 @@ int main(int argc, char **argv) {
       return 1;
     }
 
+    battle.release_spectators(1000);
     std::cout << "\nBattle complete! Server shutting down...\n";
   } else if (mode == 2) {
-    std::cout << "\nTournament mode not yet implemented!\n";
+    std::string format = "single";
+    int entrants = 8;
+    int humans = 0;
+
+    if (argc > 3) {
+      format = argv[3];
+      entrants = argc > 4 ? std::atoi(argv[4]) : entrants;
+      humans = argc > 5 ? std::atoi(argv[5]) : humans;
+    } else {
+      std::cout << "Format (single/double/swiss): ";
+      std::cin >> format;
+      std::cout << "Number of entrants: ";
+      std::cin >> entrants;
+      std::cout << "Number of human players: ";
+      std::cin >> humans;
+    }
+
+    humans = std::max(0, std::min(humans, entrants));
+    if (entrants < 2) {
+      std::cerr << "A tournament needs at least 2 entrants\n";
+      return 1;
+    }
+
+    int status = run_tournament(server, parse_tournament_format(format),
+                                entrants, humans, policy, replays.get());
+    server.stop();
+    return status;
+  } else if (mode == 3) {
+    int concurrent = argc > 3 ? std::atoi(argv[3]) : 64;
+    int max_battles = argc > 4 ? std::atoi(argv[4]) : 0;
+
+    std::cout << "\n=== Ranked Matchmaking (" << concurrent
+              << " concurrent battles) ===\n";
+    BattleExecutor executor(static_cast<unsigned>(std::max(concurrent, 1)));
+    MatchmakingService matchmaking(server, executor);
+    matchmaking.set_decision_policy(policy);
+    matchmaking.set_replay_writer(replays.get());
+    matchmaking.run(max_battles);
+  } else if (mode == 4) {
+    LobbyConfig config;
+    config.players = std::max(2, argc > 3 ? std::atoi(argv[3]) : 8);
+    config.shop_seconds = argc > 4 ? std::max(1, std::atoi(argv[4])) : 30;
+    int max_lobbies = argc > 5 ? std::atoi(argv[5]) : 0;
+
+    std::cout << "\n=== Autobattler Lobbies (" << config.players
+              << " players, " << config.shop_seconds << "s shop) ===\n";
+    BattleExecutor executor;
+    GhostPool ghosts("ghosts.bin");
+    LobbyService lobbies(server, executor, event_loop, config, &ghosts);
+    lobbies.run(max_lobbies);
   } else {
     std::cout << "\nInvalid choice\n";
   }
@@ -0,0 +1,36 @@
+#include "allocation_counter.hpp"
+#include <cstdlib>
+#include <new>
+
+static thread_local size_t thread_allocations = 0;
+
+size_t allocation_count() { return thread_allocations; }
+
+void *operator new(size_t size) {
+  thread_allocations++;
+  if (void *ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  thread_allocations++;
+  return std::malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept {
+  return operator new(size, tag);
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
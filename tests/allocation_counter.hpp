@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+
+// The test binary replaces global operator new so tests can assert that a
+// hot path does not touch the heap. Counts are per thread.
+size_t allocation_count();
+
+// Allocations made on this thread since construction
+class AllocationScope {
+private:
+  size_t start_;
+
+public:
+  AllocationScope() : start_(allocation_count()) {}
+  size_t allocations() const { return allocation_count() - start_; }
+};
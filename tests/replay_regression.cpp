@@ -0,0 +1,242 @@
+#include "core/battle_output.hpp"
+#include "data/loader.hpp"
+#include "server/battle_executor.hpp"
+#include "server/replay.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Determinism regression suite. Every battle in the corpus is replayed
+// through the engine, and what came out of it is compared with the golden
+// outcomes recorded when the corpus was made:
+//   - the winner and the number of turns played
+//   - the HP, status and team slot of both actives after every turn
+//   - every line of battle text, in order (damage numbers, crits, effects)
+// so any change to damage, stat or effect code that alters behaviour, even
+// by one roll, fails here. Run by ctest from the source directory.
+//
+// The corpus is bot battles recorded through NetworkBattle. After an
+// intended behaviour change, regenerate both files from the source dir:
+//   rm tests/golden/replay_corpus.bin
+//   battler_replay record tests/golden/replay_corpus.bin 1000 1
+//   replay_regression tests/golden/replay_corpus.bin
+//                     tests/golden/replay_goldens.txt --update
+// Rolls come from std::uniform_int_distribution, whose output differs
+// between standard libraries, so goldens are only valid for libstdc++.
+
+namespace {
+
+const uint64_t FNV_OFFSET = 14695981039346656037ull;
+const uint64_t FNV_PRIME = 1099511628211ull;
+
+// Hashes every character written to it
+class HashingBuffer : public std::streambuf {
+private:
+  uint64_t hash_ = FNV_OFFSET;
+
+protected:
+  int_type overflow(int_type c) override {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      hash_ ^= static_cast<unsigned char>(c);
+      hash_ *= FNV_PRIME;
+    }
+    return traits_type::not_eof(c);
+  }
+
+  std::streamsize xsputn(const char *text, std::streamsize count) override {
+    for (std::streamsize i = 0; i < count; i++) {
+      hash_ ^= static_cast<unsigned char>(text[i]);
+      hash_ *= FNV_PRIME;
+    }
+    return count;
+  }
+
+public:
+  uint64_t hash() const { return hash_; }
+};
+
+struct Outcome {
+  int winner = -1; // -1: the replay could not be played
+  int turns = 0;
+  uint64_t trace_hash = 0; // Both actives after every turn
+  uint64_t event_hash = 0; // All battle text
+
+  bool operator==(const Outcome &other) const {
+    return winner == other.winner && turns == other.turns &&
+           trace_hash == other.trace_hash && event_hash == other.event_hash;
+  }
+};
+
+Outcome play(const Replay &replay, const DataCatalog &catalog) {
+  Outcome outcome;
+  std::vector<Pokemon> team1;
+  std::vector<Pokemon> team2;
+  if (!replay_teams(replay, catalog, team1, team2))
+    return outcome;
+
+  HashingBuffer events;
+  std::ostream event_stream(&events);
+  std::ostream *previous = battle_out_ptr();
+  battle_out_ptr() = &event_stream;
+
+  ReplayBattle battle(team1, team2, replay);
+  uint64_t trace = FNV_OFFSET;
+  while (battle.step()) {
+    ReplayTraceEntry state = battle.state();
+    const uint8_t fields[8] = {
+        state.active[0], state.active[1],
+        state.status[0], state.status[1],
+        static_cast<uint8_t>(state.hp[0]), static_cast<uint8_t>(state.hp[0] >> 8),
+        static_cast<uint8_t>(state.hp[1]), static_cast<uint8_t>(state.hp[1] >> 8)};
+    for (uint8_t byte : fields) {
+      trace ^= byte;
+      trace *= FNV_PRIME;
+    }
+  }
+  battle_out_ptr() = previous;
+
+  if (battle.valid()) {
+    outcome.winner = battle.winner();
+    outcome.turns = battle.turns_played();
+    outcome.trace_hash = trace;
+    outcome.event_hash = events.hash();
+  }
+  return outcome;
+}
+
+std::string describe(const Outcome &outcome) {
+  std::stringstream ss;
+  ss << "winner " << outcome.winner << ", " << outcome.turns << " turns, trace "
+     << std::hex << outcome.trace_hash << ", events " << outcome.event_hash;
+  return ss.str();
+}
+
+bool read_goldens(const std::string &path, std::vector<Outcome> &goldens) {
+  std::ifstream in(path);
+  if (!in)
+    return false;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream fields(line);
+    size_t index;
+    Outcome outcome;
+    fields >> index >> outcome.winner >> outcome.turns >> std::hex >>
+        outcome.trace_hash >> outcome.event_hash;
+    if (!fields || index != goldens.size())
+      return false;
+    goldens.push_back(outcome);
+  }
+  return true;
+}
+
+bool write_goldens(const std::string &path,
+                   const std::vector<Outcome> &outcomes) {
+  std::ofstream out(path);
+  if (!out)
+    return false;
+  out << "# index winner turns trace_hash event_hash\n";
+  for (size_t i = 0; i < outcomes.size(); i++) {
+    const Outcome &outcome = outcomes[i];
+    out << i << " " << outcome.winner << " " << outcome.turns << " "
+        << std::hex << std::setw(16) << std::setfill('0')
+        << outcome.trace_hash << " " << std::setw(16) << outcome.event_hash
+        << std::dec << std::setfill(' ') << "\n";
+  }
+  return static_cast<bool>(out);
+}
+
+} // namespace
+
+// Usage: replay_regression CORPUS GOLDENS [--update]
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: replay_regression CORPUS GOLDENS [--update]\n";
+    return 1;
+  }
+  std::string corpus_path = argv[1];
+  std::string goldens_path = argv[2];
+  bool update = argc > 3 && std::string(argv[3]) == "--update";
+
+  load_game_data("src/data/species.json", "src/data/moves.json",
+                 "src/data/type_chart.json");
+
+  DataCatalog catalog;
+  ReplayFile corpus;
+  if (!corpus.open(corpus_path, catalog)) {
+    std::cerr << corpus.error()
+              << " (regenerate the corpus if the game data changed)\n";
+    return 1;
+  }
+  std::vector<Replay> replays;
+  replays.reserve(corpus.size());
+  for (size_t i = 0; i < corpus.size(); i++)
+    replays.push_back(corpus.read(i));
+
+  // Each worker replays its own slice; the RNG and battle output are
+  // per thread, so slices do not interfere
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+  std::vector<Outcome> outcomes(replays.size());
+  {
+    BattleExecutor executor;
+    size_t slices = executor.thread_count() * 4;
+    size_t per_slice = (replays.size() + slices - 1) / slices;
+    std::vector<std::future<void>> pending;
+    for (size_t first = 0; first < replays.size(); first += per_slice) {
+      size_t last = std::min(replays.size(), first + per_slice);
+      pending.push_back(executor.submit([&, first, last]() {
+        for (size_t i = first; i < last; i++)
+          outcomes[i] = play(replays[i], catalog);
+      }));
+    }
+    for (auto &slice : pending)
+      slice.get();
+  }
+  double seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+
+  if (update) {
+    if (!write_goldens(goldens_path, outcomes)) {
+      std::cerr << "Cannot write " << goldens_path << "\n";
+      return 1;
+    }
+    std::cout << "Wrote " << outcomes.size() << " golden outcomes to "
+              << goldens_path << "\n";
+    return 0;
+  }
+
+  std::vector<Outcome> goldens;
+  if (!read_goldens(goldens_path, goldens)) {
+    std::cerr << "Cannot read goldens from " << goldens_path << "\n";
+    return 1;
+  }
+  if (goldens.size() != outcomes.size()) {
+    std::cerr << "Corpus has " << outcomes.size() << " battles but there are "
+              << goldens.size() << " golden outcomes\n";
+    return 1;
+  }
+
+  size_t mismatched = 0;
+  for (size_t i = 0; i < outcomes.size(); i++) {
+    if (outcomes[i] == goldens[i])
+      continue;
+    if (++mismatched <= 10) {
+      std::cout << "Battle " << i << " (seed " << replays[i].seed
+                << "):\n  expected " << describe(goldens[i]) << "\n  got      "
+                << describe(outcomes[i]) << "\n";
+    }
+  }
+
+  std::cout << "Replayed " << outcomes.size() << " battles in " << seconds
+            << "s: " << outcomes.size() - mismatched << " identical, "
+            << mismatched << " different\n";
+  return mismatched == 0 ? 0 : 1;
+}
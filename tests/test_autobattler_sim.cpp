@@ -0,0 +1,140 @@
+#include "autobattler/auto_battle.hpp"
+#include "autobattler/evolution.hpp"
+#include "autobattler/run_simulator.hpp"
+#include "core/rng.hpp"
+#include "data/game_data.hpp"
+#include <catch2/catch.hpp>
+#include <memory>
+
+namespace {
+
+void addSimData() {
+  auto &gd = GameData::getInstance();
+  gd.addSpecies("Pikachu", {"Pikachu", 35, 55, 30, 90, 50, PokeType::Electric,
+                            PokeType::None, "Raichu"});
+  gd.addSpecies("Raichu", {"Raichu", 60, 90, 55, 100, 90, PokeType::Electric,
+                           PokeType::None});
+  gd.addSpecies("SimMon", {"SimMon", 70, 70, 70, 70, 70, PokeType::Normal,
+                           PokeType::None});
+
+  if (!gd.getMove("SimTackle")) {
+    auto move = std::make_unique<MoveData>();
+    move->name = "SimTackle";
+    move->type = PokeType::Normal;
+    move->category = MoveCategory::Physical;
+    move->power = 50;
+    move->accuracy = 100;
+    move->max_pp = 35;
+    move->primary_effect.type = MoveEffectType::Damage;
+    gd.addMove("SimTackle", std::move(move));
+  }
+}
+
+Pokemon simMon(const std::string &species, int level) {
+  Pokemon mon(species, level);
+  mon.add_move(Move(GameData::getInstance().getMove("SimTackle")));
+  return mon;
+}
+
+} // namespace
+
+TEST_CASE("Auto-battle sends in the next Pokemon after a faint",
+          "[autobattler]") {
+  addSimData();
+  rng_seed(5);
+
+  // The lead is hopelessly outmatched; the level 100 backup is not
+  std::vector<Pokemon> team1 = {simMon("SimMon", 2), simMon("SimMon", 100)};
+  std::vector<Pokemon> team2 = {simMon("SimMon", 40)};
+
+  AutoBattle auto_battle;
+  REQUIRE(auto_battle.run(team1, team2, false) == BattleResult::Win);
+  REQUIRE(auto_battle.run({}, team2, false) == BattleResult::Loss);
+}
+
+TEST_CASE("Evolving keeps the moves the Pokemon knew", "[autobattler]") {
+  addSimData();
+  Pokemon first = simMon("Pikachu", 50);
+  Pokemon second = simMon("Pikachu", 50);
+
+  REQUIRE(EvolutionSystem::can_combine(first, second));
+  Pokemon evolved = EvolutionSystem::combine_and_evolve(first, second);
+  REQUIRE(evolved.name() == "Raichu");
+  REQUIRE(evolved.move_count() == 1);
+  REQUIRE(evolved.get_move(0).data->name == "SimTackle");
+}
+
+TEST_CASE("Evolution chains resolve whatever order species load in",
+          "[autobattler]") {
+  auto &gd = GameData::getInstance();
+  // Middle of the chain first, then its evolution, then its pre-evolution
+  gd.addSpecies("ChainMid", {"ChainMid", 60, 60, 60, 60, 60, PokeType::Water,
+                             PokeType::None, "ChainEnd"});
+  REQUIRE(EvolutionSystem::get_evolution(gd.getSpecies("ChainMid")) ==
+          nullptr);
+  gd.addSpecies("ChainEnd", {"ChainEnd", 90, 90, 90, 90, 90, PokeType::Water,
+                             PokeType::None});
+  gd.addSpecies("ChainStart", {"ChainStart", 40, 40, 40, 40, 40,
+                               PokeType::Water, PokeType::None, "ChainMid"});
+
+  const SpeciesData *start = gd.getSpecies("ChainStart");
+  const SpeciesData *mid = EvolutionSystem::get_evolution(start);
+  REQUIRE(mid == gd.getSpecies("ChainMid"));
+  REQUIRE(EvolutionSystem::get_evolution(mid) == gd.getSpecies("ChainEnd"));
+  REQUIRE(EvolutionSystem::get_evolution(gd.getSpecies("ChainEnd")) ==
+          nullptr);
+  REQUIRE(gd.getSpecies(start->id) == start);
+
+  // Reloading a species keeps its ID and picks up the new chain
+  SpeciesId mid_id = mid->id;
+  gd.addSpecies("ChainMid", {"ChainMid", 60, 60, 60, 60, 60, PokeType::Water,
+                             PokeType::None});
+  REQUIRE(gd.getSpecies("ChainMid")->id == mid_id);
+  REQUIRE(EvolutionSystem::get_evolution(gd.getSpecies("ChainMid")) ==
+          nullptr);
+}
+
+TEST_CASE("Seeded simulations are reproducible across thread counts",
+          "[autobattler]") {
+  addSimData();
+
+  SimulationConfig config;
+  config.runs = 12;
+  config.seed = 99;
+  config.win_target = 3;
+  config.max_rounds = 8;
+
+  for (const char *policy : {"random", "greedy", "evolve"}) {
+    config.policy = policy;
+    config.threads = 1;
+    RunSimulator single(config);
+    REQUIRE(single.valid());
+    SimulationReport a = single.run();
+
+    config.threads = 3;
+    SimulationReport b = RunSimulator(config).run();
+
+    config.pin_threads = true;
+    SimulationReport pinned = RunSimulator(config).run();
+    config.pin_threads = false;
+    REQUIRE(pinned.wins == a.wins);
+    REQUIRE(pinned.gold_by_round == a.gold_by_round);
+
+    REQUIRE(a.runs == 12);
+    REQUIRE(a.winning_runs == b.winning_runs);
+    REQUIRE(a.rounds_survived == b.rounds_survived);
+    REQUIRE(a.wins == b.wins);
+    REQUIRE(a.gold_by_round == b.gold_by_round);
+    REQUIRE(a.species_picks.size() == b.species_picks.size());
+    REQUIRE(a.gold_by_round.at(0) == 12 * 10); // Everyone starts with 10
+
+    RunRecord once = single.play_run(4);
+    RunRecord again = single.play_run(4);
+    REQUIRE(once.gold_by_round == again.gold_by_round);
+    REQUIRE(once.purchases == again.purchases);
+    REQUIRE_FALSE(once.purchases.empty());
+  }
+
+  config.policy = "nonsense";
+  REQUIRE_FALSE(RunSimulator(config).valid());
+}
@@ -1,5 +1,12 @@
+#include "ai/gen1_ai.hpp"
+#include "ai/random_ai.hpp"
+#include "allocation_counter.hpp"
 #include "core/battle.hpp"
+#include "core/battle_output.hpp"
+#include "core/battle_pool.hpp"
+#include "core/stat_cache.hpp"
 #include "data/game_data.hpp"
+#include "server/headless_battle.hpp"
 #include <catch2/catch.hpp>
 
 TEST_CASE("battle runs") {
@@ -36,3 +43,120 @@ TEST_CASE("battle runs") {
   b.execute_turn(0, 0);
   SUCCEED("turn executed");
 }
+
+TEST_CASE("Steady-state turns do not allocate", "[battle][arena]") {
+  // A long name, so every log line is too big for a string's inline buffer
+  GameData::getInstance().addSpecies(
+      "SturdyArenaTestmon", {"SturdyArenaTestmon", 250, 10, 250, 100, 250,
+                             PokeType::Normal, PokeType::None});
+
+  MoveData tackle;
+  tackle.name = "ArenaTackle";
+  tackle.type = PokeType::Normal;
+  tackle.category = MoveCategory::Physical;
+  tackle.power = 10;
+  tackle.accuracy = 100;
+  tackle.max_pp = 35;
+  tackle.primary_effect.type = MoveEffectType::Damage;
+
+  Pokemon mon("SturdyArenaTestmon", 50);
+  mon.add_move(Move(&tackle));
+  mon.add_move(Move(&tackle));
+  Battle battle({mon}, {mon});
+  Gen1AI ai1;
+  RandomAI ai2;
+  QuietBattleOutput quiet;
+
+  auto play_turn = [&]() {
+    int move1 = ai1.choose_move(battle.active1, battle.active2);
+    int move2 = ai2.choose_move(battle.active2, battle.active1);
+    battle.execute_turn(move1, move2);
+    REQUIRE(battle.get_available_pokemon(1).empty());
+  };
+
+  play_turn(); // The first turns may still grow the arena
+  play_turn();
+  uint64_t arena_heap = battle.turn_arena().heap_allocations();
+
+  AllocationScope scope;
+  for (int i = 0; i < 20 && !battle.over; i++) {
+    play_turn();
+  }
+  REQUIRE(scope.allocations() == 0);
+  REQUIRE(battle.turn_arena().heap_allocations() == arena_heap);
+  REQUIRE_FALSE(battle.over);
+}
+
+TEST_CASE("Turn arena grows to fit a turn", "[battle][arena]") {
+  TurnArena arena(64);
+  std::pmr::string text(256, 'x', arena.resource());
+  REQUIRE(arena.heap_allocations() == 1);
+
+  text = std::pmr::string(arena.resource());
+  arena.reset();
+  REQUIRE(arena.capacity() >= 256 + 64);
+
+  std::pmr::string again(256, 'x', arena.resource());
+  REQUIRE(arena.heap_allocations() == 1);
+}
+
+TEST_CASE("Pooled battles start without allocating", "[battle][pool]") {
+  GameData::getInstance().addSpecies(
+      "PoolMon", {"PoolMon", 80, 90, 70, 100, 60, PokeType::Normal,
+                  PokeType::None});
+
+  MoveData strike;
+  strike.name = "PoolStrike";
+  strike.type = PokeType::Normal;
+  strike.category = MoveCategory::Physical;
+  strike.power = 60;
+  strike.accuracy = 100;
+  strike.max_pp = 35;
+  strike.primary_effect.type = MoveEffectType::Damage;
+
+  Pokemon mon("PoolMon", 50);
+  mon.add_move(Move(&strike));
+  std::vector<Pokemon> team1(3, mon);
+  std::vector<Pokemon> team2(3, mon);
+  Gen1AI ai;
+
+  run_headless_battle(team1, team2, ai, ai); // Warms the pool and arena
+  REQUIRE(BattlePool::local().idle() == 1);
+
+  AllocationScope scope;
+  HeadlessBattleResult result = run_headless_battle(team1, team2, ai, ai);
+  REQUIRE(scope.allocations() == 0);
+  REQUIRE(result.winner != 0);
+  REQUIRE(BattlePool::local().idle() == 1);
+
+  SECTION("A reset battle starts from the new teams") {
+    BattlePool::Lease lease = BattlePool::local().acquire(team1, team2);
+    REQUIRE(lease->active1.hp() == mon.max_hp());
+    REQUIRE(lease->get_remaining_pokemon(2) == 3);
+    REQUIRE_FALSE(lease->over);
+  }
+}
+
+TEST_CASE("Stat blocks are cached per species and level", "[pokemon][stats]") {
+  GameData::getInstance().addSpecies(
+      "StatMon", {"StatMon", 45, 49, 49, 45, 65, PokeType::Grass,
+                  PokeType::Poison});
+  const SpeciesData *species = GameData::getInstance().getSpecies("StatMon");
+
+  Pokemon first(species, 50);
+  size_t cached = stat_cache_size();
+
+  // Gen 1 formula with 15 IVs and no EVs
+  REQUIRE(first.max_hp() == ((45 + 15) * 2 * 50) / 100 + 50 + 10);
+  REQUIRE(first.stat(PokeStat::Special) == ((65 + 15) * 2 * 50) / 100 + 5);
+
+  AllocationScope scope;
+  Pokemon second("StatMon", 50);
+  REQUIRE(scope.allocations() == 0);
+  REQUIRE(stat_cache_size() == cached);
+  REQUIRE(second.stat(PokeStat::Attack) == first.stat(PokeStat::Attack));
+
+  Pokemon higher(species, 60);
+  REQUIRE(stat_cache_size() == cached + 1);
+  REQUIRE(higher.max_hp() > first.max_hp());
+}
@@ -0,0 +1,82 @@
+#include "client/bot_player.hpp"
+#include "network/protocol.hpp"
+#include <catch2/catch.hpp>
+
+TEST_CASE("Bot - Parses team and move lines", "[bot]") {
+  std::string name;
+  int level = 0, hp = 0, max_hp = 0;
+  REQUIRE(BotPlayer::parse_pokemon_line("3. Mr. Mime (Lv. 50) HP: 95/110",
+                                        name, level, hp, max_hp));
+  REQUIRE(name == "Mr. Mime");
+  REQUIRE(level == 50);
+  REQUIRE(hp == 95);
+  REQUIRE(max_hp == 110);
+  REQUIRE_FALSE(BotPlayer::parse_pokemon_line("Your team:", name, level, hp,
+                                              max_hp));
+
+  int pp = 0, max_pp = 0;
+  REQUIRE(BotPlayer::parse_move_line("2. Thunder Shock (PP: 0/30)", name, pp,
+                                     max_pp));
+  REQUIRE(name == "Thunder Shock");
+  REQUIRE(pp == 0);
+  REQUIRE(max_pp == 30);
+}
+
+TEST_CASE("Bot - Falls back to a move with PP", "[bot]") {
+  // No AI and no game data: the bot must still answer legally
+  BotPlayer bot(nullptr);
+  std::string request = "Choose your move:\n"
+                        "1. Tackle (PP: 0/35)\n"
+                        "2. Growl (PP: 40/40)\n"
+                        "Your choice (1-2): ";
+  REQUIRE(bot.choose_move(request) == 2);
+}
+
+TEST_CASE("Bot - Switches to the healthiest Pokemon", "[bot]") {
+  BotPlayer bot(nullptr);
+  std::string request =
+      "\nYour Pokemon fainted! Choose a Pokemon to switch to:\n"
+      "1. Pidgey (Lv. 50) HP: 10/100\n"
+      "2. Onix (Lv. 50) HP: 80/90\n"
+      "3. Abra (Lv. 50) HP: 40/70\n"
+      "Your choice (1-3): ";
+  REQUIRE(bot.choose_switch(request) == 2);
+}
+
+TEST_CASE("Frame decoder handles split and coalesced frames", "[bot]") {
+  std::vector<uint8_t> stream;
+  for (int i = 0; i < 3; i++) {
+    Message msg(MessageType::BATTLE_LOG, "message " + std::to_string(i));
+    std::vector<uint8_t> bytes = msg.serialize();
+    stream.insert(stream.end(), bytes.begin(), bytes.end());
+  }
+
+  // Feed one byte at a time, as a slow non-blocking socket might
+  FrameDecoder decoder;
+  std::vector<std::string> received;
+  Message msg;
+  for (uint8_t byte : stream) {
+    decoder.feed(&byte, 1);
+    while (decoder.next(msg)) {
+      received.push_back(msg.get_payload_string());
+    }
+  }
+  REQUIRE(received.size() == 3);
+  REQUIRE(received[2] == "message 2");
+
+  // All at once
+  decoder.reset();
+  decoder.feed(stream.data(), stream.size());
+  int count = 0;
+  while (decoder.next(msg)) {
+    count++;
+  }
+  REQUIRE(count == 3);
+
+  // A length over the limit is rejected rather than buffered
+  uint8_t huge[5] = {0x7F, 0xFF, 0xFF, 0xFF, 0x19};
+  decoder.reset();
+  decoder.feed(huge, sizeof(huge));
+  REQUIRE_FALSE(decoder.next(msg));
+  REQUIRE(decoder.failed());
+}
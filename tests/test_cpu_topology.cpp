@@ -0,0 +1,56 @@
+#include "server/battle_executor.hpp"
+#include "server/cpu_topology.hpp"
+#include <catch2/catch.hpp>
+#include <future>
+#include <vector>
+
+TEST_CASE("Kernel cpulists parse", "[topology]") {
+  REQUIRE(parse_cpu_list("0-3,8,10-11\n") ==
+          std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+  REQUIRE(parse_cpu_list("5") == std::vector<int>{5});
+  REQUIRE(parse_cpu_list("").empty());
+  REQUIRE(parse_cpu_list("3-1").empty());
+  REQUIRE(parse_cpu_list("0-x").empty());
+}
+
+TEST_CASE("Workers fill one node before the next", "[topology]") {
+  CpuTopology topology({{4, 5, 6}, {}, {0, 1}});
+  REQUIRE(topology.node_count() == 2); // The empty node is dropped
+  REQUIRE(topology.cpu_count() == 5);
+
+  std::vector<int> cpus;
+  std::vector<int> nodes;
+  for (size_t worker = 0; worker < 7; worker++) {
+    CpuSlot slot = topology.slot(worker);
+    cpus.push_back(slot.cpu);
+    nodes.push_back(slot.node);
+  }
+  REQUIRE(cpus == std::vector<int>{4, 5, 6, 0, 1, 4, 5});
+  REQUIRE(nodes == std::vector<int>{0, 0, 0, 1, 1, 0, 0});
+
+  CpuTopology empty({});
+  REQUIRE(empty.cpu_count() == 1);
+  REQUIRE(empty.slot(3).cpu == 0);
+}
+
+TEST_CASE("Pinned executors run tasks on their node", "[topology]") {
+  const CpuTopology &topology = CpuTopology::system();
+  REQUIRE(topology.cpu_count() >= 1);
+
+  BattleExecutor executor(2, WorkerPlacement::Pinned);
+  REQUIRE(executor.placement() == WorkerPlacement::Pinned);
+  std::vector<std::future<int>> nodes;
+  for (int i = 0; i < 8; i++)
+    nodes.push_back(executor.submit([]() { return BattleExecutor::current_node(); }));
+  for (auto &node : nodes) {
+    int value = node.get();
+    // -1 only where the platform will not pin threads
+    REQUIRE(value >= -1);
+    REQUIRE(value < static_cast<int>(topology.node_count()));
+  }
+  REQUIRE(BattleExecutor::current_node() == -1); // Not a worker
+
+  BattleExecutor floating(1);
+  REQUIRE(floating.submit([]() { return BattleExecutor::current_node(); })
+              .get() == -1);
+}
@@ -0,0 +1,300 @@
+#include "data/data_file.hpp"
+#include "data/effect_compiler.hpp"
+#include "data/enum_table.hpp"
+#include "data/move_parser.hpp"
+#include <catch2/catch.hpp>
+#include <cstring>
+
+namespace {
+
+bool parse_species(const std::string &text, std::vector<SpeciesData> &species,
+                   std::string &error) {
+  return parse_species_text(text.data(), text.size(), species, error);
+}
+
+bool parse_moves(const std::string &text,
+                 std::vector<std::unique_ptr<MoveData>> &moves,
+                 std::string &error) {
+  return parse_moves_text(text.data(), text.size(), moves, error);
+}
+
+} // namespace
+
+TEST_CASE("Enum tables find every name and nothing else", "[loader]") {
+  EnumTable<int> table{{"Normal", 1}, {"Fire", 2},   {"Water", 3},
+                       {"Grass", 4},  {"Electric", 5}, {"Ice", 6}};
+  int value = 0;
+  REQUIRE(table.find("Electric", value));
+  REQUIRE(value == 5);
+  REQUIRE(table.get("Ice", 0) == 6);
+  REQUIRE(table.get("Fir", -1) == -1);
+  REQUIRE(table.get("", -1) == -1);
+  REQUIRE(table.get("Fire ", -1) == -1);
+
+  REQUIRE(parseType("Dragon") == PokeType::Dragon);
+  REQUIRE(parseType("None") == PokeType::None);
+  REQUIRE(parseCategory("Special") == MoveCategory::Special);
+  REQUIRE(parseCategory("Other") == MoveCategory::Status);
+  REQUIRE(parseStatus("Toxic") == PokeStatus::Toxic);
+  REQUIRE(parseEffectTarget("self") == EffectTarget::Self);
+  REQUIRE(parseEffectTarget("nobody") == EffectTarget::Opponent);
+}
+
+TEST_CASE("Species stream in sorted by name, the last of each winning",
+          "[loader]") {
+  std::string text = R"({
+    "Zubat": {"hp": 40, "attack": 45, "defense": 35, "speed": 55,
+              "special": 40, "type1": "Poison", "type2": "Flying",
+              "evolves_to": "Golbat", "learnset": ["Leech Life", "Bite"],
+              "sprite": {"front": {"x": 1}}},
+    "Abra": {"type2": "None", "type1": "Psychic", "special": 105,
+             "speed": 90, "defense": 15, "attack": 20, "hp": 25.0},
+    "Zubat": {"hp": 41, "attack": 45, "defense": 35, "speed": 55,
+              "special": 40, "type1": "Poison", "type2": "Flying"}
+  })";
+  std::vector<SpeciesData> species;
+  std::string error;
+  REQUIRE(parse_species(text, species, error));
+  REQUIRE(species.size() == 2);
+  REQUIRE(species[0].name == "Abra");
+  REQUIRE(species[0].hp == 25);
+  REQUIRE(species[0].type1 == PokeType::Psychic);
+  REQUIRE(species[0].type2 == PokeType::None);
+  REQUIRE(species[1].name == "Zubat");
+  REQUIRE(species[1].hp == 41);
+  REQUIRE(species[1].evolves_to.empty());
+}
+
+TEST_CASE("Move effects read their fields in any order", "[loader]") {
+  std::string text = R"({
+    "Growl": {"type": "Normal", "category": "Status", "power": 0,
+              "accuracy": 100, "pp": 40,
+              "effect": {"stages": -1, "target": "opponent",
+                         "stat": "Attack", "type": "stat_change"}},
+    "Ember": {"type": "Fire", "category": "Special", "power": 40,
+              "accuracy": 100, "pp": 25,
+              "secondary_effect": {"type": "status", "status": "Burn"}},
+    "Splash": {"type": "Normal", "category": "Status", "power": 0,
+               "accuracy": 100, "pp": 40},
+    "Fly": {"type": "Flying", "category": "Physical", "power": 70,
+            "accuracy": 95, "pp": 15,
+            "effect": {"type": "two_turn", "invulnerable": true,
+                       "charge_message": "flew up high!"}}
+  })";
+  std::vector<std::unique_ptr<MoveData>> moves;
+  std::string error;
+  REQUIRE(parse_moves(text, moves, error));
+  REQUIRE(moves.size() == 4);
+
+  const MoveData &ember = *moves[0];
+  REQUIRE(ember.name == "Ember");
+  REQUIRE(ember.primary_effect.type == MoveEffectType::Damage);
+  REQUIRE(ember.secondary_effect);
+  REQUIRE(ember.secondary_effect->chance == 30);
+  REQUIRE(ember.secondary_effect->effect.status_inflict.status ==
+          PokeStatus::Burn);
+  REQUIRE(ember.secondary_effect->effect.status_inflict.chance == 100);
+
+  const MoveData &fly = *moves[1];
+  REQUIRE(fly.primary_effect.type == MoveEffectType::TwoTurn);
+  REQUIRE(fly.primary_effect.two_turn.invulnerable);
+  REQUIRE(fly.primary_effect.two_turn.charge_message == "flew up high!");
+
+  const MoveData &growl = *moves[2];
+  REQUIRE(growl.primary_effect.type == MoveEffectType::StatChange);
+  REQUIRE(growl.primary_effect.stat_change.stat == PokeStat::Attack);
+  REQUIRE(growl.primary_effect.stat_change.stages == -1);
+  REQUIRE(growl.primary_effect.stat_change.target == EffectTarget::Opponent);
+
+  REQUIRE(moves[3]->primary_effect.type == MoveEffectType::None);
+  REQUIRE_FALSE(moves[3]->secondary_effect);
+}
+
+TEST_CASE("Bad records are reported by name", "[loader]") {
+  std::vector<SpeciesData> species;
+  std::vector<std::unique_ptr<MoveData>> moves;
+  std::string error;
+
+  REQUIRE_FALSE(parse_species(R"({"Mew": {"hp": 100, "attack": 100}})",
+                              species, error));
+  REQUIRE(error.rfind("Mew: ", 0) == 0);
+  REQUIRE(species.empty());
+
+  REQUIRE_FALSE(parse_species(
+      R"({"Mew": {"hp": "lots", "attack": 100, "defense": 100, "speed": 100,
+                  "special": 100, "type1": "Psychic", "type2": "None"}})",
+      species, error));
+  REQUIRE(error == "Mew: hp must be a number");
+
+  // Bad data is an error, never a fallback or a truncated number
+  REQUIRE_FALSE(parse_species(
+      R"({"Mew": {"hp": 100, "attack": 100, "defense": 100, "speed": 100,
+                  "special": 100, "type1": "Psycic", "type2": "None"}})",
+      species, error));
+  REQUIRE(error == "Mew: unknown type \"Psycic\"");
+  REQUIRE_FALSE(parse_species(
+      R"({"Mew": {"hp": 100.5, "attack": 100, "defense": 100, "speed": 100,
+                  "special": 100, "type1": "Psychic", "type2": "None"}})",
+      species, error));
+  REQUIRE(error == "Mew: hp must be a whole number");
+  REQUIRE_FALSE(parse_species(
+      R"({"Mew": {"hp": 4294967396, "attack": 100, "defense": 100,
+                  "speed": 100, "special": 100, "type1": "Psychic",
+                  "type2": "None"}})",
+      species, error));
+  REQUIRE(error == "Mew: hp must be a whole number");
+  REQUIRE(parse_species(
+      R"({"Mew": {"hp": 100.0, "attack": 100, "defense": 100, "speed": 100,
+                  "special": 100, "type1": "Psychic", "type2": "None"}})",
+      species, error));
+  REQUIRE(species[0].hp == 100);
+
+  REQUIRE_FALSE(parse_moves(
+      R"({"Growl": {"type": "Normal", "category": "Status", "power": 0,
+                    "accuracy": 100, "pp": 40,
+                    "effect": {"type": "stat_change", "stat": "Attack"}}})",
+      moves, error));
+  REQUIRE(error.rfind("Growl: ", 0) == 0);
+
+  REQUIRE_FALSE(parse_moves(R"({"Tackle": {"type": "Normal",)", moves, error));
+  REQUIRE_FALSE(error.empty());
+  REQUIRE_FALSE(parse_moves(R"([1, 2, 3])", moves, error));
+  REQUIRE_FALSE(parse_species_file("no_such_species.json", species, error));
+}
+
+TEST_CASE("Move effects are checked and compiled before they are added",
+          "[loader]") {
+  std::vector<std::unique_ptr<MoveData>> moves;
+  EffectCompileReport report;
+  std::string error;
+
+  REQUIRE(parse_moves(
+      R"({"Recover": {"type": "Normal", "category": "Status", "power": 0,
+                      "accuracy": 100, "pp": 20,
+                      "effect": {"type": "heal", "percent": 50}},
+          "Soft-Boiled": {"type": "Normal", "category": "Status", "power": 0,
+                          "accuracy": 100, "pp": 10,
+                          "effect": {"type": "heal", "percent": 50}},
+          "Super Fang": {"type": "Normal", "category": "Physical",
+                         "power": 1, "accuracy": 90, "pp": 10,
+                         "effect": {"type": "fixed_damage",
+                                    "damage_type": "half_hp"}},
+          "Growl": {"type": "Normal", "category": "Status", "power": 0,
+                    "accuracy": 100, "pp": 40,
+                    "effect": {"type": "stat_change", "stat": "Attack",
+                               "stages": -1, "target": "opponent"}}})",
+      moves, error));
+  REQUIRE(compile_moves(moves, report, error));
+  REQUIRE(report.moves == 4);
+  REQUIRE(report.by_type[static_cast<size_t>(MoveEffectType::Heal)] == 2);
+  REQUIRE(report.summary().rfind("Compiled 4 move effects in ", 0) == 0);
+  REQUIRE(report.summary().find("heal 2") != std::string::npos);
+
+  const MoveData &growl = *moves[0];
+  REQUIRE(growl.handler == resolve_move_handler(MoveEffectType::StatChange));
+  REQUIRE(growl.effect.stat == PokeStat::Attack);
+  REQUIRE(growl.effect.stages == -1);
+  REQUIRE(growl.effect.target == EffectTarget::Opponent);
+  REQUIRE(moves[1]->effect.kind == MoveEffectType::Heal);
+  REQUIRE(moves[1]->effect.percent == 50);
+  REQUIRE(moves[3]->effect.kind == MoveEffectType::FixedDamage);
+  REQUIRE(moves[3]->effect.fixed == FixedDamageData::Type::HalfHP);
+  REQUIRE(growl.secondary.kind == MoveEffectType::None);
+
+  // Secondary effects are compiled too, with the secondary's chance
+  REQUIRE(parse_moves(
+      R"({"Acid": {"type": "Poison", "category": "Special", "power": 40,
+                   "accuracy": 100, "pp": 30,
+                   "secondary_effect": {"type": "stat_change",
+                                        "stat": "Defense", "stages": -1,
+                                        "target": "opponent",
+                                        "chance": 33}}})",
+      moves, error));
+  REQUIRE(compile_moves(moves, report, error));
+  REQUIRE(moves[0]->secondary.kind == MoveEffectType::StatChange);
+  REQUIRE(moves[0]->secondary.stat == PokeStat::Defense);
+  REQUIRE(moves[0]->secondary.stages == -1);
+  REQUIRE(moves[0]->secondary.chance == 33);
+  REQUIRE(report.summary().find("; secondary stat_change 1") !=
+          std::string::npos);
+
+  // Names the tables do not know are errors, not fallbacks
+  REQUIRE_FALSE(parse_moves(
+      R"({"Leer": {"type": "Normal", "category": "Status", "power": 0,
+                   "accuracy": 100, "pp": 30,
+                   "effect": {"type": "stat_change", "stat": "Defence",
+                              "stages": -1, "target": "opponent"}}})",
+      moves, error));
+  REQUIRE(error == "Leer: unknown stat \"Defence\"");
+  REQUIRE_FALSE(parse_moves(
+      R"({"Leer": {"type": "Normal", "category": "Status", "power": 0,
+                   "accuracy": 100, "pp": 30,
+                   "effect": {"type": "stat_chnage"}}})",
+      moves, error));
+  REQUIRE(error == "Leer: unknown effect type \"stat_chnage\"");
+  REQUIRE_FALSE(parse_moves(
+      R"({"Bite": {"type": "Normal", "category": "Physical", "power": 60,
+                   "accuracy": 100, "pp": 25, "effect": {"chance": 30}}})",
+      moves, error));
+  REQUIRE(error == "Bite: effect has no type");
+  REQUIRE_FALSE(parse_moves(
+      R"({"Bite": {"type": "Normal", "category": "Physical", "power": 60,
+                   "accuracy": 100, "pp": 25,
+                   "secondary_effect": {"chance": 30}}})",
+      moves, error));
+  REQUIRE(error == "Bite: secondary_effect: effect has no type");
+  REQUIRE_FALSE(parse_moves(
+      R"({"Pound": {"type": "Norml", "category": "Physical", "power": 40,
+                    "accuracy": 100, "pp": 35}})",
+      moves, error));
+  REQUIRE(error == "Pound: unknown type \"Norml\"");
+  REQUIRE_FALSE(parse_moves(
+      R"({"Recover": {"type": "Normal", "category": "Status", "power": 0,
+                      "accuracy": 100, "pp": 20,
+                      "effect": {"type": "heal"}}})",
+      moves, error));
+  REQUIRE(error == "Recover: heal effect needs a percent");
+
+  // Values out of range get through the parser but not the compile pass
+  REQUIRE(parse_moves(
+      R"({"Swords Dance": {"type": "Normal", "category": "Status", "power": 0,
+                           "accuracy": 100, "pp": 30,
+                           "effect": {"type": "stat_change", "stat": "Attack",
+                                      "stages": 12, "target": "self"}}})",
+      moves, error));
+  REQUIRE_FALSE(compile_moves(moves, report, error));
+  REQUIRE(error == "Swords Dance: stat_change stages must be -6..6 and not 0");
+  REQUIRE_FALSE(moves[0]->handler);
+
+  REQUIRE(parse_moves(
+      R"({"Ember": {"type": "Fire", "category": "Special", "power": 40,
+                    "accuracy": 100, "pp": 25,
+                    "secondary_effect": {"type": "status", "status": "Burn",
+                                         "chance": 0}}})",
+      moves, error));
+  REQUIRE_FALSE(compile_moves(moves, report, error));
+  REQUIRE(error == "Ember: secondary_effect chance must be 1..100");
+
+  // A Status move with no effect is an omission, not a plain hit; moves the
+  // engine cannot run yet say so
+  REQUIRE(parse_moves(
+      R"({"Splash": {"type": "Normal", "category": "Status", "power": 0,
+                     "accuracy": 100, "pp": 40}})",
+      moves, error));
+  REQUIRE_FALSE(compile_moves(moves, report, error));
+  REQUIRE(error.rfind("Splash: Status move needs an effect", 0) == 0);
+
+  REQUIRE(parse_moves(
+      R"({"Splash": {"type": "Normal", "category": "Status", "power": 0,
+                     "accuracy": 100, "pp": 40,
+                     "effect": {"type": "not_implemented"}},
+          "Light Screen": {"type": "Psychic", "category": "Status",
+                           "power": 0, "accuracy": 100, "pp": 30,
+                           "effect": {"type": "light_screen"}}})",
+      moves, error));
+  REQUIRE(compile_moves(moves, report, error));
+  REQUIRE(moves[0]->handler ==
+          resolve_move_handler(MoveEffectType::LightScreen));
+  REQUIRE(moves[1]->effect.kind == MoveEffectType::NotImplemented);
+  REQUIRE(report.summary().find("not_implemented 1") != std::string::npos);
+}
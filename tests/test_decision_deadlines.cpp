@@ -0,0 +1,154 @@
+#include "data/game_data.hpp"
+#include "server/network_battle.hpp"
+#include "server/output_capture.hpp"
+#include "server/server_event_loop.hpp"
+#include "server/team_generator.hpp"
+#include "server/timer_wheel.hpp"
+#include <catch2/catch.hpp>
+#include <random>
+
+TEST_CASE("Timer wheel fires timers when due", "[deadline]") {
+  TimerWheel wheel(10, 8);
+  std::vector<int> fired;
+
+  wheel.schedule(25, [&]() { fired.push_back(25); });
+  wheel.schedule(5, [&]() { fired.push_back(5); });
+  // Beyond one revolution (8 slots * 10ms), shares a slot with 20ms
+  wheel.schedule(100, [&]() { fired.push_back(100); });
+  REQUIRE(wheel.size() == 3);
+
+  wheel.advance(9);
+  REQUIRE(fired.empty()); // 5ms rounds up to the 10ms tick
+  wheel.advance(10);
+  REQUIRE(fired == std::vector<int>{5});
+  wheel.advance(30);
+  REQUIRE(fired == std::vector<int>{5, 25});
+  wheel.advance(99);
+  REQUIRE(fired.size() == 2);
+  wheel.advance(100);
+  REQUIRE(fired == std::vector<int>{5, 25, 100});
+  REQUIRE(wheel.size() == 0);
+}
+
+TEST_CASE("Timer wheel cancels and catches up after long gaps",
+          "[deadline]") {
+  TimerWheel wheel(10, 4);
+  int fired = 0;
+
+  TimerWheel::TimerId cancelled = wheel.schedule(20, [&]() { fired += 100; });
+  for (int i = 1; i <= 50; i++) {
+    wheel.schedule(static_cast<uint64_t>(i) * 7, [&]() { fired++; });
+  }
+  REQUIRE(wheel.cancel(cancelled));
+  REQUIRE_FALSE(wheel.cancel(cancelled));
+
+  // Jump far past every deadline in one call
+  REQUIRE(wheel.advance(10000) == 50);
+  REQUIRE(fired == 50);
+}
+
+#ifndef _WIN32
+#include <sys/socket.h>
+
+TEST_CASE("Event loop resolves waits by message, deadline or hang-up",
+          "[deadline]") {
+  int fds[2];
+  REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  ClientConnection client(new Socket(fds[0]), 1);
+  Socket peer(fds[1]);
+
+  ServerEventLoop loop(5);
+
+  SECTION("Answer arrives in time") {
+    auto pending = loop.await_message(&client, 2000);
+    Message move(MessageType::MOVE_RESPONSE);
+    move.set_payload_int(3);
+    send_message(peer, move);
+
+    DecisionResult result = pending.get();
+    REQUIRE(result.status == DecisionStatus::Received);
+    REQUIRE(result.message.get_payload_int() == 3);
+  }
+
+  SECTION("Silent player times out, late answer is discarded") {
+    auto pending = loop.await_message(&client, 30);
+    REQUIRE(pending.wait_for(std::chrono::seconds(2)) ==
+            std::future_status::ready);
+    REQUIRE(pending.get().status == DecisionStatus::TimedOut);
+    client.stale_responses++;
+
+    Message late(MessageType::MOVE_RESPONSE);
+    late.set_payload_int(1);
+    Message next(MessageType::MOVE_RESPONSE);
+    next.set_payload_int(2);
+    send_message(peer, late);
+    send_message(peer, next);
+
+    DecisionResult result = loop.await_message(&client, 2000).get();
+    REQUIRE(result.status == DecisionStatus::Received);
+    REQUIRE(result.message.get_payload_int() == 2);
+  }
+
+  SECTION("Disconnect is reported without waiting for the deadline") {
+    auto pending = loop.await_message(&client, 60000);
+    peer.close();
+    REQUIRE(pending.wait_for(std::chrono::seconds(2)) ==
+            std::future_status::ready);
+    REQUIRE(pending.get().status == DecisionStatus::Disconnected);
+  }
+
+  REQUIRE(loop.pending_count() == 0);
+}
+TEST_CASE("A hang-up forfeits without waiting out the other player's clock",
+          "[deadline]") {
+  auto &gd = GameData::getInstance();
+  gd.addSpecies("DeadlineMon", {"DeadlineMon", 60, 60, 60, 60, 60,
+                                PokeType::Normal, PokeType::None});
+  if (!gd.getMove("DeadlineTackle")) {
+    auto move = std::make_unique<MoveData>();
+    move->name = "DeadlineTackle";
+    move->type = PokeType::Normal;
+    move->category = MoveCategory::Physical;
+    move->power = 40;
+    move->accuracy = 100;
+    move->max_pp = 35;
+    gd.addMove("DeadlineTackle", std::move(move));
+  }
+
+  // Either side hanging up, while the other sits on a minute-long clock
+  for (int quitter = 1; quitter <= 2; quitter++) {
+    int fds1[2];
+    int fds2[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds1) == 0);
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds2) == 0);
+    ClientConnection client1(new Socket(fds1[0]), 1);
+    ClientConnection client2(new Socket(fds2[0]), 2);
+    Socket peer1(fds1[1]);
+    Socket peer2(fds2[1]);
+    (quitter == 1 ? peer1 : peer2).close();
+
+    ServerEventLoop loop(5);
+    DecisionPolicy policy;
+    policy.loop = &loop;
+    policy.timeout_ms = 60000;
+
+    std::mt19937 gen(3);
+    NetworkBattle battle(generate_random_team(2, 30, gen),
+                         generate_random_team(2, 30, gen), &client1,
+                         &client2);
+    battle.set_decision_policy(policy);
+
+    auto start = std::chrono::steady_clock::now();
+    OutputCapture quiet;
+    quiet.start();
+    battle.run();
+    quiet.stop();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    INFO("quitter " << quitter);
+    REQUIRE(battle.winner() == 3 - quitter);
+    REQUIRE(elapsed < std::chrono::seconds(10));
+    REQUIRE(loop.pending_count() == 0);
+  }
+}
+#endif
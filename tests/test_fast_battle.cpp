@@ -0,0 +1,224 @@
+#include "autobattler/auto_battle.hpp"
+#include "core/rng.hpp"
+#include "data/game_data.hpp"
+#include <catch2/catch.hpp>
+#include <functional>
+#include <memory>
+#include <random>
+
+namespace {
+
+// One move per effect the fast path models, plus secondary-effect rolls
+std::vector<const MoveData *> addFastMoves() {
+  auto &gd = GameData::getInstance();
+  gd.setTypeEffectiveness(PokeType::Normal, PokeType::Ghost, 0.0f);
+  gd.setTypeEffectiveness(PokeType::Fire, PokeType::Grass, 2.0f);
+  gd.addSpecies("FastNormal", {"FastNormal", 70, 80, 60, 75, 60,
+                               PokeType::Normal, PokeType::None});
+  gd.addSpecies("FastGhost", {"FastGhost", 50, 60, 50, 95, 110,
+                              PokeType::Ghost, PokeType::Poison});
+  gd.addSpecies("FastGrass", {"FastGrass", 80, 75, 85, 40, 90, PokeType::Grass,
+                              PokeType::None});
+  gd.addSpecies("FastFire", {"FastFire", 65, 95, 60, 100, 70, PokeType::Fire,
+                             PokeType::Flying});
+
+  // The effect is compiled when the move is added, so set it up first
+  auto add = [&](const std::string &name, PokeType type,
+                 MoveCategory category, int power, int pp,
+                 MoveEffectType effect,
+                 std::function<void(MoveEffect &)> setup = {},
+                 std::function<void(SecondaryEffect &)> secondary = {})
+      -> MoveData & {
+    if (!gd.getMove(name)) {
+      auto move = std::make_unique<MoveData>();
+      move->name = name;
+      move->type = type;
+      move->category = category;
+      move->power = power;
+      move->max_pp = pp;
+      move->primary_effect.type = effect;
+      if (setup)
+        setup(move->primary_effect);
+      if (secondary) {
+        move->secondary_effect.reset(new SecondaryEffect());
+        secondary(*move->secondary_effect);
+      }
+      gd.addMove(name, std::move(move));
+    }
+    return *const_cast<MoveData *>(gd.getMove(name));
+  };
+
+  std::vector<const MoveData *> moves;
+  moves.push_back(&add("FastTackle", PokeType::Normal, MoveCategory::Physical,
+                       40, 3, MoveEffectType::Damage));
+  moves.push_back(&add("FastEmber", PokeType::Fire, MoveCategory::Special, 40,
+                       3, MoveEffectType::Damage));
+
+  moves.push_back(&add("FastGrowl", PokeType::Normal, MoveCategory::Status, 0,
+                       2, MoveEffectType::StatChange, [](MoveEffect &effect) {
+                         effect.stat_change = {PokeStat::Attack, -1,
+                                               EffectTarget::Opponent, 100};
+                       }));
+  moves.push_back(&add("FastAgility", PokeType::Psychic, MoveCategory::Status,
+                       0, 2, MoveEffectType::StatChange,
+                       [](MoveEffect &effect) {
+                         effect.stat_change = {PokeStat::Speed, 2,
+                                               EffectTarget::Self, 100};
+                       }));
+
+  PokeStatus statuses[] = {PokeStatus::Burn, PokeStatus::Paralysis,
+                           PokeStatus::Poison, PokeStatus::Sleep,
+                           PokeStatus::Freeze, PokeStatus::Toxic};
+  for (PokeStatus status : statuses) {
+    moves.push_back(&add("FastStatus" + std::to_string(static_cast<int>(status)),
+                         PokeType::Normal, MoveCategory::Status, 0, 1,
+                         MoveEffectType::StatusInflict,
+                         [status](MoveEffect &effect) {
+                           effect.status_inflict = {status, 100,
+                                                    EffectTarget::Opponent};
+                         }));
+  }
+
+  moves.push_back(&add("FastRecoil", PokeType::Normal, MoveCategory::Physical,
+                       90, 2, MoveEffectType::Recoil,
+                       [](MoveEffect &effect) { effect.recoil_percent = 25; }));
+  moves.push_back(&add("FastDrain", PokeType::Grass, MoveCategory::Special, 40,
+                       3, MoveEffectType::Drain,
+                       [](MoveEffect &effect) { effect.drain_percent = 50; }));
+  moves.push_back(&add("FastRecover", PokeType::Normal, MoveCategory::Status,
+                       0, 2, MoveEffectType::Heal,
+                       [](MoveEffect &effect) { effect.heal_percent = 50; }));
+  moves.push_back(&add("FastMultiHit", PokeType::Normal,
+                       MoveCategory::Physical, 15, 3,
+                       MoveEffectType::MultiHit));
+  moves.push_back(&add("FastTwoHit", PokeType::Fire, MoveCategory::Physical,
+                       30, 3, MoveEffectType::TwoHit));
+  moves.push_back(&add("FastOHKO", PokeType::Normal, MoveCategory::Physical, 0,
+                       1, MoveEffectType::OHKO));
+  moves.push_back(&add("FastFixed", PokeType::Ghost, MoveCategory::Special, 0,
+                       2, MoveEffectType::FixedDamage, [](MoveEffect &effect) {
+                         effect.fixed_damage = {FixedDamageData::Type::Level,
+                                                0};
+                       }));
+  moves.push_back(&add("FastSuperFang", PokeType::Normal,
+                       MoveCategory::Physical, 1, 2,
+                       MoveEffectType::FixedDamage, [](MoveEffect &effect) {
+                         effect.fixed_damage = {FixedDamageData::Type::HalfHP,
+                                                0};
+                       }));
+  moves.push_back(&add("FastConfuse", PokeType::Psychic, MoveCategory::Status,
+                       0, 2, MoveEffectType::Confusion));
+  moves.push_back(&add("FastHaze", PokeType::Ice, MoveCategory::Status, 0, 1,
+                       MoveEffectType::Haze));
+
+  // Secondary effects, at chances high enough to come up
+  moves.push_back(&add("FastBite", PokeType::Normal, MoveCategory::Physical,
+                       60, 3, MoveEffectType::Damage, {},
+                       [](SecondaryEffect &secondary) {
+                         secondary.chance = 30;
+                         secondary.effect.type = MoveEffectType::Flinch;
+                         secondary.effect.flinch_chance = 30;
+                       }));
+  moves.push_back(&add("FastAcid", PokeType::Normal, MoveCategory::Special, 40,
+                       3, MoveEffectType::Damage, {},
+                       [](SecondaryEffect &secondary) {
+                         secondary.chance = 50;
+                         secondary.effect.type = MoveEffectType::StatChange;
+                         secondary.effect.stat_change = {
+                             PokeStat::Defense, -1, EffectTarget::Opponent, 50};
+                       }));
+  moves.push_back(&add("FastBodySlam", PokeType::Normal,
+                       MoveCategory::Physical, 85, 2, MoveEffectType::Damage,
+                       {}, [](SecondaryEffect &secondary) {
+                         secondary.chance = 30;
+                         secondary.effect.type = MoveEffectType::StatusInflict;
+                         secondary.effect.status_inflict = {
+                             PokeStatus::Paralysis, 30,
+                             EffectTarget::Opponent};
+                       }));
+  moves.push_back(&add("FastPsybeam", PokeType::Psychic, MoveCategory::Special,
+                       65, 3, MoveEffectType::Damage, {},
+                       [](SecondaryEffect &secondary) {
+                         secondary.chance = 30;
+                         secondary.effect.type = MoveEffectType::Confusion;
+                       }));
+  return moves;
+}
+
+std::vector<Pokemon> fastTeam(const std::vector<const MoveData *> &moves,
+                              std::mt19937 &gen) {
+  static const char *species[] = {"FastNormal", "FastGhost", "FastGrass",
+                                  "FastFire"};
+  std::vector<Pokemon> team;
+  int size = std::uniform_int_distribution<int>(1, 6)(gen);
+  for (int i = 0; i < size; i++) {
+    Pokemon mon(species[std::uniform_int_distribution<int>(0, 3)(gen)],
+                std::uniform_int_distribution<int>(20, 60)(gen));
+    for (int m = 0; m < 4; m++) {
+      mon.add_move(Move(moves[std::uniform_int_distribution<size_t>(
+          0, moves.size() - 1)(gen)]));
+    }
+    team.push_back(mon);
+  }
+  return team;
+}
+
+} // namespace
+
+TEST_CASE("Fast auto-battle matches the engine roll for roll",
+          "[autobattler]") {
+  std::vector<const MoveData *> moves = addFastMoves();
+  std::mt19937 gen(2024);
+  AutoBattle auto_battle;
+
+  for (int i = 0; i < 300; i++) {
+    std::vector<Pokemon> team1 = fastTeam(moves, gen);
+    std::vector<Pokemon> team2 = fastTeam(moves, gen);
+
+    FastAutoBattle fast;
+    REQUIRE(fast.load(team1, team2));
+    rng_seed(static_cast<uint32_t>(i));
+    BattleResult fast_result = fast.run();
+    uint32_t fast_next = rng_engine()();
+
+    rng_seed(static_cast<uint32_t>(i));
+    BattleResult engine_result = auto_battle.run_engine(team1, team2, false);
+    uint32_t engine_next = rng_engine()();
+
+    INFO("battle " << i);
+    REQUIRE(fast_result == engine_result);
+    REQUIRE(fast_next == engine_next); // Same number of rolls consumed
+  }
+}
+
+TEST_CASE("Fast auto-battle refuses teams it cannot model", "[autobattler]") {
+  std::vector<const MoveData *> moves = addFastMoves();
+  auto &gd = GameData::getInstance();
+  if (!gd.getMove("FastCounter")) {
+    auto counter = std::make_unique<MoveData>();
+    counter->name = "FastCounter";
+    counter->category = MoveCategory::Physical;
+    counter->type = PokeType::Fighting;
+    counter->max_pp = 20;
+    counter->primary_effect.type = MoveEffectType::Counter;
+    gd.addMove("FastCounter", std::move(counter));
+  }
+
+  Pokemon plain("FastNormal", 30);
+  plain.add_move(Move(moves[0]));
+  Pokemon counter("FastNormal", 30);
+  counter.add_move(Move(gd.getMove("FastCounter")));
+
+  FastAutoBattle fast;
+  REQUIRE(fast.load({plain}, {plain}));
+  REQUIRE_FALSE(fast.load({plain}, {counter}));
+  REQUIRE_FALSE(fast.load({plain}, std::vector<Pokemon>(7, plain)));
+  REQUIRE_FALSE(FastAutoBattle::supports(gd.getMove("FastCounter")));
+
+  // AutoBattle still resolves it, through the engine
+  AutoBattle auto_battle;
+  rng_seed(5);
+  BattleResult result = auto_battle.run({plain}, {counter}, false);
+  REQUIRE((result == BattleResult::Win || result == BattleResult::Loss ||
+           result == BattleResult::Draw));
+}
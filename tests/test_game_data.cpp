@@ -0,0 +1,166 @@
+#include "core/battle.hpp"
+#include "core/battle_output.hpp"
+#include "data/game_data.hpp"
+#include "data/loader.hpp"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+SpeciesData snapshot_testmon(int attack) {
+  return {"SnapshotTestmon", 100, attack, 100, 100, 100, PokeType::Normal,
+          PokeType::None};
+}
+
+void write_file(const std::string &path, const std::string &text) {
+  std::ofstream out(path);
+  out << text;
+}
+
+} // namespace
+
+TEST_CASE("A held snapshot does not see later edits", "[gamedata]") {
+  GameData &data = GameData::getInstance();
+  data.addSpecies("SnapshotTestmon", snapshot_testmon(50));
+  std::shared_ptr<const GameDataSnapshot> before = data.snapshot();
+  const SpeciesData *old_entry = before->getSpecies("SnapshotTestmon");
+
+  data.addSpecies("SnapshotTestmon", snapshot_testmon(80));
+  REQUIRE(data.version() == before->version() + 1);
+  REQUIRE(data.getSpecies("SnapshotTestmon")->attack == 80);
+  // Same ID, new entry; the old one is still there for anyone holding it
+  REQUIRE(data.getSpecies("SnapshotTestmon")->id == old_entry->id);
+  REQUIRE(before->getSpecies("SnapshotTestmon") == old_entry);
+  REQUIRE(old_entry->attack == 50);
+
+  {
+    GameDataScope pinned(*before);
+    REQUIRE(data.getSpecies("SnapshotTestmon")->attack == 50);
+  }
+  REQUIRE(data.getSpecies("SnapshotTestmon")->attack == 80);
+
+  // Adding it again unchanged publishes nothing
+  uint64_t version = data.version();
+  data.addSpecies("SnapshotTestmon", snapshot_testmon(80));
+  REQUIRE(data.version() == version);
+}
+
+TEST_CASE("An edit publishes once, or not at all if discarded",
+          "[gamedata]") {
+  GameData &data = GameData::getInstance();
+  uint64_t version = data.version();
+  {
+    GameData::Edit edit = data.edit();
+    edit.addSpecies("EditTestmonA", {"EditTestmonA", 10, 10, 10, 10, 10,
+                                     PokeType::Fire, PokeType::None});
+    edit.addSpecies("EditTestmonB", {"EditTestmonB", 10, 10, 10, 10, 10,
+                                     PokeType::Water, PokeType::None});
+    REQUIRE(edit.draft().getSpecies("EditTestmonB") != nullptr);
+    REQUIRE(data.getSpecies("EditTestmonA") == nullptr);
+  }
+  REQUIRE(data.version() == version + 1);
+  REQUIRE(data.getSpecies("EditTestmonA") != nullptr);
+  REQUIRE(data.getSpecies("EditTestmonB") != nullptr);
+
+  {
+    GameData::Edit edit = data.edit();
+    edit.addSpecies("EditTestmonC", {"EditTestmonC", 10, 10, 10, 10, 10,
+                                     PokeType::Grass, PokeType::None});
+    edit.discard();
+  }
+  REQUIRE(data.version() == version + 1);
+  REQUIRE(data.getSpecies("EditTestmonC") == nullptr);
+}
+
+TEST_CASE("A battle keeps the data it started with", "[gamedata]") {
+  GameData &data = GameData::getInstance();
+  data.addSpecies("PinnedTestmon", {"PinnedTestmon", 200, 50, 100, 100, 100,
+                                    PokeType::Normal, PokeType::None});
+  auto tackle = std::make_unique<MoveData>();
+  tackle->name = "PinnedTackle";
+  tackle->type = PokeType::Normal;
+  tackle->category = MoveCategory::Physical;
+  tackle->power = 40;
+  tackle->accuracy = 100;
+  tackle->max_pp = 35;
+  tackle->primary_effect.type = MoveEffectType::Damage;
+  data.addMove("PinnedTackle", std::move(tackle));
+
+  Pokemon mon("PinnedTestmon", 50);
+  mon.add_move(Move(data.getMove("PinnedTackle")));
+  Battle battle({mon}, {mon});
+  uint64_t started_on = battle.game_data().version();
+
+  // A balance change lands mid-battle
+  data.addSpecies("PinnedTestmon", {"PinnedTestmon", 200, 150, 100, 100, 100,
+                                    PokeType::Normal, PokeType::None});
+  REQUIRE(data.version() > started_on);
+
+  QuietBattleOutput quiet;
+  battle.execute_turn(0, 0);
+  REQUIRE(battle.game_data().version() == started_on);
+  REQUIRE(battle.game_data().getSpecies("PinnedTestmon")->attack == 50);
+}
+
+TEST_CASE("Reloads publish while readers keep reading", "[gamedata]") {
+  const std::string species_path = "gamedata_test_species.json";
+  const std::string moves_path = "gamedata_test_moves.json";
+  auto write_species = [&](int hp) {
+    write_file(species_path, "{\n  \"ReloadTestmon\": {\n    \"hp\": " +
+                                 std::to_string(hp) +
+                                 ",\n    \"attack\": 60,\n    \"defense\": 60,"
+                                 "\n    \"speed\": 60,\n    \"special\": 60,"
+                                 "\n    \"type1\": \"Ice\","
+                                 "\n    \"type2\": \"None\"\n  }\n}\n");
+  };
+  write_species(100);
+  write_file(moves_path, "{\n  \"Reload Beam\": {\n    \"type\": \"Ice\","
+                         "\n    \"category\": \"Special\",\n    \"power\": 90,"
+                         "\n    \"accuracy\": 100,\n    \"pp\": 10\n  }\n}\n");
+
+  GameData &data = GameData::getInstance();
+  REQUIRE(reload_game_data(species_path, moves_path));
+  REQUIRE(data.getSpecies("ReloadTestmon")->hp == 100);
+  REQUIRE(data.getMove("Reload Beam")->power == 90);
+
+  // Reading the same files again changes nothing
+  uint64_t version = data.version();
+  REQUIRE(reload_game_data(species_path, moves_path));
+  REQUIRE(data.version() == version);
+
+  // A file that does not parse publishes nothing
+  REQUIRE_FALSE(reload_game_data(species_path, "no_such_moves.json"));
+  REQUIRE(data.version() == version);
+
+  std::atomic<bool> done{false};
+  std::atomic<int> bad_reads{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 2; i++) {
+    readers.emplace_back([&]() {
+      while (!done.load()) {
+        const SpeciesData *species = data.getSpecies("ReloadTestmon");
+        if (!species || species->hp < 100 || species->hp > 120)
+          bad_reads++;
+        if (!data.getMove("Reload Beam"))
+          bad_reads++;
+      }
+    });
+  }
+  for (int hp = 101; hp <= 120; hp++) {
+    write_species(hp);
+    REQUIRE(reload_game_data(species_path, moves_path));
+  }
+  done = true;
+  for (std::thread &reader : readers)
+    reader.join();
+
+  REQUIRE(bad_reads == 0);
+  REQUIRE(data.getSpecies("ReloadTestmon")->hp == 120);
+  REQUIRE(data.version() == version + 20);
+  std::remove(species_path.c_str());
+  std::remove(moves_path.c_str());
+}
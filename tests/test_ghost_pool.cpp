@@ -0,0 +1,136 @@
+#include "autobattler/ghost_pool.hpp"
+#include "data/game_data.hpp"
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+namespace {
+
+const char *GHOST_TEST_FILE = "test_ghosts.bin";
+
+void addGhostData() {
+  auto &gd = GameData::getInstance();
+  gd.addSpecies("GhostMonA", {"GhostMonA", 50, 60, 50, 60, 50,
+                              PokeType::Ghost, PokeType::None});
+  gd.addSpecies("GhostMonB", {"GhostMonB", 80, 80, 80, 80, 80,
+                              PokeType::Ghost, PokeType::Poison});
+  if (!gd.getMove("GhostLick")) {
+    auto move = std::make_unique<MoveData>();
+    move->name = "GhostLick";
+    move->type = PokeType::Ghost;
+    move->category = MoveCategory::Physical;
+    move->power = 20;
+    move->accuracy = 100;
+    move->max_pp = 30;
+    move->primary_effect.type = MoveEffectType::Damage;
+    gd.addMove("GhostLick", std::move(move));
+  }
+}
+
+PlayerState playerAt(int round, const std::string &species, int level) {
+  PlayerState player("Ghost");
+  for (int r = 1; r < round; r++)
+    player.next_round();
+  Pokemon mon(species, level);
+  mon.add_move(Move(GameData::getInstance().getMove("GhostLick")));
+  player.add_to_team(mon);
+  return player;
+}
+
+} // namespace
+
+TEST_CASE("Ghost pool draws teams recorded for the round", "[ghost]") {
+  addGhostData();
+  GhostPool pool("");
+  std::mt19937 rng(3);
+  std::vector<Pokemon> team;
+
+  REQUIRE_FALSE(pool.draw(1, 1, rng, team));
+
+  pool.record(playerAt(2, "GhostMonA", 20));
+  pool.record(playerAt(5, "GhostMonB", 40));
+  REQUIRE(pool.size() == 2);
+
+  REQUIRE(pool.draw(5, 1, rng, team));
+  REQUIRE(team.size() == 1);
+  REQUIRE(team[0].name() == "GhostMonB");
+  REQUIRE(team[0].level() == 40);
+  REQUIRE(team[0].move_count() == 1);
+  REQUIRE(team[0].get_move(0).data->name == "GhostLick");
+
+  // Nothing for round 4: the closest earlier round is used
+  REQUIRE(pool.draw(4, 1, rng, team));
+  REQUIRE(team[0].name() == "GhostMonA");
+
+  // Nothing at or before round 1, or at another tier
+  REQUIRE_FALSE(pool.draw(1, 1, rng, team));
+  REQUIRE_FALSE(pool.draw(5, 2, rng, team));
+}
+
+TEST_CASE("Ghost pool persists to an append-only file", "[ghost]") {
+  addGhostData();
+  std::remove(GHOST_TEST_FILE);
+
+  {
+    GhostPool pool(GHOST_TEST_FILE);
+    REQUIRE(pool.persistent());
+    for (int i = 0; i < 100; i++) {
+      pool.record(playerAt(3, i % 2 ? "GhostMonA" : "GhostMonB", 30 + i % 7));
+    }
+    pool.flush();
+
+    // A second process sees the appends after a reload
+    GhostPool reader(GHOST_TEST_FILE);
+    REQUIRE(reader.size() == 100);
+    pool.record(playerAt(7, "GhostMonA", 70));
+    pool.flush();
+    REQUIRE(reader.size() == 100);
+    reader.reload();
+    REQUIRE(reader.size() == 101);
+  } // Destructor writes anything still queued
+
+  // A crash mid-append leaves a torn record, which is dropped on open
+  {
+    std::ofstream torn(GHOST_TEST_FILE, std::ios::binary | std::ios::app);
+    torn.write("\x07\x00\x01", 3);
+  }
+
+  GhostPool reopened(GHOST_TEST_FILE);
+  REQUIRE(reopened.persistent());
+  REQUIRE(reopened.size() == 101);
+
+  std::mt19937 rng(11);
+  std::vector<Pokemon> team;
+  REQUIRE(reopened.draw(7, 1, rng, team));
+  REQUIRE(team[0].name() == "GhostMonA");
+  REQUIRE(team[0].level() == 70);
+
+  reopened.record(playerAt(9, "GhostMonB", 90));
+  reopened.flush();
+  GhostPool again(GHOST_TEST_FILE);
+  REQUIRE(again.size() == 102);
+  REQUIRE(again.draw(9, 1, rng, team));
+  REQUIRE(team[0].name() == "GhostMonB");
+
+  std::remove(GHOST_TEST_FILE);
+}
+
+TEST_CASE("Ghost files from other game data are left alone", "[ghost]") {
+  addGhostData();
+  std::remove(GHOST_TEST_FILE);
+  {
+    GhostPool pool(GHOST_TEST_FILE);
+    pool.record(playerAt(1, "GhostMonA", 10));
+  }
+
+  // New species change the catalog the records index into
+  GameData::getInstance().addSpecies(
+      "GhostMonC",
+      {"GhostMonC", 10, 10, 10, 10, 10, PokeType::Ghost, PokeType::None});
+  GhostPool mismatched(GHOST_TEST_FILE);
+  REQUIRE_FALSE(mismatched.persistent());
+  REQUIRE(mismatched.size() == 0);
+
+  std::remove(GHOST_TEST_FILE);
+}
@@ -0,0 +1,77 @@
+#include "core/battle.hpp"
+#include "core/battle_output.hpp"
+#include "core/instrument.hpp"
+#include "data/game_data.hpp"
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Instrumentation totals cover every thread", "[instrument]") {
+  instrument::Snapshot before = instrument::snapshot();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([]() {
+      for (int i = 0; i < 1000; i++) {
+        instrument::count(instrument::Counter::DamageCalcs);
+        instrument::count_effect(MoveEffectType::Drain);
+        instrument::count_sent(25, 40);
+      }
+      instrument::record_time(instrument::Timer::AiDecision, 1000);
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  // Exited threads' blocks are reused, not lost
+  std::thread([]() { instrument::count(instrument::Counter::DamageCalcs, 5); })
+      .join();
+
+  instrument::Snapshot delta = instrument::snapshot().since(before);
+  REQUIRE(delta.counter(instrument::Counter::DamageCalcs) == 4005);
+  REQUIRE(delta.effects[static_cast<size_t>(MoveEffectType::Drain)] == 4000);
+  REQUIRE(delta.messages[25].sent == 4000);
+  REQUIRE(delta.messages[25].bytes_sent == 160000);
+  REQUIRE(delta.timer(instrument::Timer::AiDecision).count == 4);
+  REQUIRE(delta.timer(instrument::Timer::AiDecision).mean_ns() == 1000.0);
+}
+
+TEST_CASE("Timer percentiles come from power-of-two buckets",
+          "[instrument]") {
+  instrument::TimerStats stats;
+  stats.count = 100;
+  stats.max_ns = 5000;
+  stats.buckets[6] = 99; // 64-127 ns
+  stats.buckets[12] = 1; // 4096-8191 ns
+  REQUIRE(stats.percentile_ns(0.5) == 127);
+  REQUIRE(stats.percentile_ns(1.0) == 5000); // Capped at the real max
+}
+
+TEST_CASE("Hot paths only record in instrumented builds", "[instrument]") {
+  GameData::getInstance().addSpecies(
+      "InstrumentMon", {"InstrumentMon", 100, 100, 100, 100, 100,
+                        PokeType::Normal, PokeType::None});
+  MoveData tackle;
+  tackle.name = "InstrumentTackle";
+  tackle.type = PokeType::Normal;
+  tackle.category = MoveCategory::Physical;
+  tackle.power = 40;
+  tackle.max_pp = 35;
+  Pokemon p1("InstrumentMon", 50);
+  Pokemon p2("InstrumentMon", 50);
+  p1.add_move(Move(&tackle));
+  p2.add_move(Move(&tackle));
+
+  instrument::Snapshot before = instrument::snapshot();
+  {
+    QuietBattleOutput quiet;
+    Battle battle({p1}, {p2});
+    battle.execute_turn(0, 0);
+  }
+  instrument::Snapshot delta = instrument::snapshot().since(before);
+
+  uint64_t expected = instrument::enabled() ? 1 : 0;
+  REQUIRE(delta.counter(instrument::Counter::Turns) == expected);
+  REQUIRE(delta.timer(instrument::Timer::Turn).count == expected);
+  REQUIRE(delta.effects[static_cast<size_t>(MoveEffectType::Damage)] ==
+          2 * expected);
+}
@@ -0,0 +1,139 @@
+#include "client/bot_player.hpp"
+#include "data/game_data.hpp"
+#include "server/autobattler_lobby.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+void addLobbyData() {
+  auto &gd = GameData::getInstance();
+  gd.addSpecies("LobbyMon", {"LobbyMon", 60, 60, 60, 60, 60, PokeType::Normal,
+                             PokeType::None});
+  if (!gd.getMove("LobbyTackle")) {
+    auto move = std::make_unique<MoveData>();
+    move->name = "LobbyTackle";
+    move->type = PokeType::Normal;
+    move->category = MoveCategory::Physical;
+    move->power = 50;
+    move->accuracy = 100;
+    move->max_pp = 35;
+    move->primary_effect.type = MoveEffectType::Damage;
+    gd.addMove("LobbyTackle", std::move(move));
+  }
+}
+
+} // namespace
+
+TEST_CASE("Bot buys what it can afford, then readies", "[lobby]") {
+  BotPlayer bot(nullptr);
+  std::string state = "=== ROUND 1 | TIER 1 ===\n"
+                      "Gold: 3 | Hearts: 5 | Wins: 0\n"
+                      "Team (0/3):\n"
+                      "Shop:\n"
+                      "1. Mew [Legendary] - 10 gold\n"
+                      "2. (sold)\n"
+                      "3. Pidgey [Common] - 2 gold\n";
+  REQUIRE(bot.choose_shop_action(state) == "buy 3");
+
+  std::string full = "Gold: 9 | Hearts: 5 | Wins: 0\n"
+                     "Team (1/1):\n"
+                     "1. Pidgey (Lv. 5) HP: 20/20\n"
+                     "Shop:\n"
+                     "1. Rattata [Common] - 1 gold\n";
+  REQUIRE(bot.choose_shop_action(full) == "ready");
+}
+
+TEST_CASE("Lobby state lists team, shop and time", "[lobby]") {
+  addLobbyData();
+  PlayerState player("Ash");
+  Shop shop(1, 7);
+  std::string text = AutobattlerLobby::describe(player, shop, 12);
+  REQUIRE(text.find("Gold: " + std::to_string(player.gold())) !=
+          std::string::npos);
+  REQUIRE(text.find("Shop:\n1. ") != std::string::npos);
+  REQUIRE(text.find("Time left: 12s") != std::string::npos);
+}
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <thread>
+
+TEST_CASE("Lobby plays to the end with bots, idlers and leavers",
+          "[lobby]") {
+  addLobbyData();
+
+  const int players = 4;
+  std::vector<std::unique_ptr<ClientConnection>> clients;
+  std::vector<std::unique_ptr<Socket>> peers;
+  for (int i = 0; i < players; i++) {
+    int fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    clients.emplace_back(new ClientConnection(new Socket(fds[0]), i + 1));
+    clients.back()->player_name = "P" + std::to_string(i + 1);
+    peers.emplace_back(new Socket(fds[1]));
+  }
+
+  // Seats 0 and 1 shop with the bot, seat 2 never answers, seat 3 leaves
+  std::vector<int> game_overs(players, 0);
+  std::vector<int> results(players, 0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 3; i++) {
+    threads.emplace_back([&, i]() {
+      BotPlayer bot(nullptr);
+      Message msg;
+      while (receive_message(*peers[i], msg)) {
+        if (msg.type == MessageType::LOBBY_STATE && i < 2) {
+          send_message(*peers[i],
+                       Message(MessageType::SHOP_ACTION,
+                               bot.choose_shop_action(
+                                   msg.get_payload_string())));
+        } else if (msg.type == MessageType::LOBBY_RESULT) {
+          results[i]++;
+        } else if (msg.type == MessageType::GAME_OVER) {
+          game_overs[i]++;
+          return;
+        }
+      }
+    });
+  }
+  peers[3]->close();
+
+  LobbyConfig config;
+  config.players = players;
+  config.shop_seconds = 1;
+  config.max_rounds = 3;
+
+  ServerEventLoop loop(5);
+  BattleExecutor executor(2);
+  GhostPool ghosts("");
+  std::vector<ClientConnection *> seated;
+  for (auto &client : clients)
+    seated.push_back(client.get());
+
+  AutobattlerLobby lobby(1, seated, config, loop, executor, &ghosts);
+  lobby.start();
+  REQUIRE(lobby.wait(30000));
+  for (auto &thread : threads)
+    thread.join();
+
+  REQUIRE(lobby.round() <= config.max_rounds);
+  for (int i = 0; i < 3; i++) {
+    REQUIRE(game_overs[i] == 1);
+    REQUIRE(results[i] >= 1);
+  }
+
+  // Every seat is placed, and someone came first
+  std::vector<int> placements = lobby.placements();
+  for (int placement : placements) {
+    REQUIRE(placement >= 1);
+    REQUIRE(placement <= players);
+  }
+  REQUIRE(std::count(placements.begin(), placements.end(), 1) >= 1);
+
+  // The idle player timed out every round they shopped in
+  REQUIRE(clients[2]->stale_responses >= 1);
+  REQUIRE(ghosts.size() >= static_cast<size_t>(players));
+}
+#endif
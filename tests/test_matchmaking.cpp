@@ -0,0 +1,126 @@
+#include "network/latency_histogram.hpp"
+#include "server/matchmaking.hpp"
+#include <catch2/catch.hpp>
+
+using Clock = MatchmakingQueue::Clock;
+
+TEST_CASE("Matchmaking - Close ratings pair immediately", "[matchmaking]") {
+  MatchmakingQueue queue;
+  std::vector<MatchmakingQueue::Pairing> pairs;
+  Clock::time_point now = Clock::now();
+
+  queue.enqueue(nullptr, 1500, now, pairs);
+  REQUIRE(pairs.empty());
+  queue.enqueue(nullptr, 1530, now, pairs);
+
+  REQUIRE(pairs.size() == 1);
+  REQUIRE(queue.size() == 0);
+  REQUIRE(queue.stats().players_matched == 2);
+}
+
+TEST_CASE("Matchmaking - Nearest rating is chosen", "[matchmaking]") {
+  MatchmakingConfig config;
+  config.initial_window = 100;
+  MatchmakingQueue queue(config);
+  std::vector<MatchmakingQueue::Pairing> pairs;
+  Clock::time_point now = Clock::now();
+
+  queue.enqueue(nullptr, 1000, now, pairs);
+  queue.enqueue(nullptr, 1300, now, pairs);
+  queue.enqueue(nullptr, 1700, now, pairs);
+  REQUIRE(pairs.empty());
+
+  queue.enqueue(nullptr, 1320, now, pairs);
+  REQUIRE(pairs.size() == 1);
+  int a = pairs[0].first.rating;
+  int b = pairs[0].second.rating;
+  REQUIRE(std::min(a, b) == 1300);
+  REQUIRE(std::max(a, b) == 1320);
+  REQUIRE(queue.size() == 2);
+}
+
+TEST_CASE("Matchmaking - Window widens while waiting", "[matchmaking]") {
+  MatchmakingConfig config;
+  config.initial_window = 50;
+  config.window_growth = 100;
+  MatchmakingQueue queue(config);
+  std::vector<MatchmakingQueue::Pairing> pairs;
+  Clock::time_point start = Clock::now();
+
+  queue.enqueue(nullptr, 1200, start, pairs);
+  queue.enqueue(nullptr, 1500, start, pairs);
+  REQUIRE(pairs.empty());
+
+  queue.find_matches(start + std::chrono::seconds(1), pairs);
+  REQUIRE(pairs.empty()); // Window is 150, gap is 300
+
+  queue.find_matches(start + std::chrono::seconds(3), pairs);
+  REQUIRE(pairs.size() == 1); // Window is 350
+
+  MatchmakingStats stats = queue.stats();
+  REQUIRE(stats.queue_depth == 0);
+  REQUIRE(stats.peak_queue_depth == 2);
+  REQUIRE(stats.wait_max_ms >= 2900);
+}
+
+TEST_CASE("Matchmaking - Removed players are not paired", "[matchmaking]") {
+  MatchmakingQueue queue;
+  std::vector<MatchmakingQueue::Pairing> pairs;
+  Clock::time_point now = Clock::now();
+
+  uint64_t ticket = queue.enqueue(nullptr, 1500, now, pairs);
+  REQUIRE(queue.remove(ticket));
+  REQUIRE_FALSE(queue.remove(ticket));
+
+  queue.enqueue(nullptr, 1500, now, pairs);
+  REQUIRE(pairs.empty());
+  REQUIRE(queue.size() == 1);
+}
+
+TEST_CASE("Matchmaking - Thousands of queued players", "[matchmaking]") {
+  MatchmakingConfig config;
+  config.initial_window = 0;
+  MatchmakingQueue queue(config);
+  std::vector<MatchmakingQueue::Pairing> pairs;
+  Clock::time_point now = Clock::now();
+
+  // Spread ratings so nobody fits a zero-width window
+  for (int i = 0; i < 5000; i++) {
+    queue.enqueue(nullptr, 1000 + i * 3, now, pairs);
+  }
+  REQUIRE(pairs.empty());
+  REQUIRE(queue.size() == 5000);
+
+  // After a second everyone is within reach of a neighbour
+  queue.find_matches(now + std::chrono::seconds(1), pairs);
+  REQUIRE(pairs.size() == 2500);
+  for (const auto &pair : pairs) {
+    REQUIRE(std::abs(pair.first.rating - pair.second.rating) == 3);
+  }
+}
+
+TEST_CASE("Elo ratings", "[matchmaking]") {
+  RatingTable ratings;
+  REQUIRE(ratings.get("Red") == 1500);
+
+  int delta = ratings.record_result("Red", "Blue");
+  REQUIRE(delta == 16);
+  REQUIRE(ratings.get("Red") == 1516);
+  REQUIRE(ratings.get("Blue") == 1484);
+
+  // Beating a weaker player earns less
+  REQUIRE(ratings.record_result("Red", "Blue") < 16);
+}
+
+TEST_CASE("Latency histogram percentiles", "[matchmaking]") {
+  LatencyHistogram histogram;
+  for (uint64_t v = 1; v <= 1000; v++) {
+    histogram.record(v);
+  }
+  REQUIRE(histogram.count() == 1000);
+  REQUIRE(histogram.max() == 1000);
+  REQUIRE(histogram.percentile(0.5) >= 480);
+  REQUIRE(histogram.percentile(0.5) <= 540);
+  REQUIRE(histogram.percentile(0.99) >= 950);
+  REQUIRE(histogram.percentile(1.0) == 1000);
+}
@@ -0,0 +1,176 @@
+#include "data/game_data.hpp"
+#include "server/battle_executor.hpp"
+#include "server/matchup_matrix.hpp"
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+
+namespace {
+
+void addMatrixData() {
+  auto &gd = GameData::getInstance();
+  gd.setTypeEffectiveness(PokeType::Water, PokeType::Fire, 2.0f);
+  gd.addSpecies("MatrixFire", {"MatrixFire", 60, 80, 55, 90, 70,
+                               PokeType::Fire, PokeType::None});
+  gd.addSpecies("MatrixWater", {"MatrixWater", 80, 60, 75, 50, 80,
+                                PokeType::Water, PokeType::None});
+  gd.addSpecies("MatrixDragon", {"MatrixDragon", 90, 90, 90, 70, 90,
+                                 PokeType::Dragon, PokeType::None});
+
+  auto add = [&](const std::string &name, PokeType type, int power) {
+    if (gd.getMove(name))
+      return;
+    auto move = std::make_unique<MoveData>();
+    move->name = name;
+    move->type = type;
+    move->category = MoveCategory::Special;
+    move->power = power;
+    move->accuracy = 100;
+    move->max_pp = 15;
+    move->primary_effect.type = MoveEffectType::Damage;
+    gd.addMove(name, std::move(move));
+  };
+  add("MatrixEmber", PokeType::Fire, 40);
+  add("MatrixBubble", PokeType::Water, 40);
+  add("MatrixOutrage", PokeType::Dragon, 400);
+  add("MatrixTwister", PokeType::Dragon, 300);
+}
+
+std::vector<MatrixTeam> matrixTeams() {
+  addMatrixData();
+  std::vector<MatrixTeam> teams;
+  for (const char *line :
+       {"MatrixFire:30:MatrixEmber", "MatrixWater:30:MatrixBubble",
+        "MatrixFire:25:MatrixEmber; MatrixWater:25:MatrixBubble"}) {
+    MatrixTeam team;
+    std::string error;
+    REQUIRE(parse_matrix_team(line, team, error));
+    teams.push_back(team);
+  }
+  return teams;
+}
+
+MatrixConfig smallConfig() {
+  MatrixConfig config;
+  config.games = 4;
+  config.seed = 7;
+  config.tile = 2; // 3 teams: a 2 x 2 grid of tiles
+  return config;
+}
+
+bool sameCells(const MatchupMatrix &a, const MatchupMatrix &b) {
+  for (size_t row = 0; row < a.size(); row++)
+    for (size_t col = 0; col < a.size(); col++)
+      if (!(a.cell(row, col) == b.cell(row, col)))
+        return false;
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("Fixed movesets take the strongest move of each type",
+          "[matrix]") {
+  addMatrixData();
+  const SpeciesData *dragon = GameData::getInstance().getSpecies("MatrixDragon");
+  std::vector<const MoveData *> moves = fixed_moveset(*dragon);
+
+  REQUIRE(!moves.empty());
+  REQUIRE(moves.size() <= 4);
+  REQUIRE(moves[0]->name == "MatrixOutrage");
+  for (size_t i = 0; i < moves.size(); i++) {
+    REQUIRE(moves[i]->name != "MatrixTwister"); // One move per type
+    for (size_t j = i + 1; j < moves.size(); j++)
+      REQUIRE(moves[i]->type != moves[j]->type);
+  }
+  REQUIRE(fixed_moveset(*dragon) == moves);
+}
+
+TEST_CASE("Matrix teams parse from text", "[matrix]") {
+  addMatrixData();
+  MatrixTeam team;
+  std::string error;
+  REQUIRE(parse_matrix_team("MatrixFire:40:MatrixEmber; MatrixDragon", team,
+                            error));
+  REQUIRE(team.spec.size == 2);
+  REQUIRE(team.spec.level(0) == 40);
+  REQUIRE(team.spec.level(1) == 50);
+  REQUIRE(team.spec.move(1, 0) ==
+          GameData::getInstance().getMove("MatrixOutrage")->id);
+  REQUIRE(team.label == "MatrixFire");
+
+  REQUIRE_FALSE(parse_matrix_team("MatrixNobody:40", team, error));
+  REQUIRE(error.find("MatrixNobody") != std::string::npos);
+  REQUIRE_FALSE(parse_matrix_team("MatrixFire:40:MatrixNothing", team, error));
+}
+
+TEST_CASE("Matrix results do not depend on the worker count", "[matrix]") {
+  for (MatrixEngine engine : {MatrixEngine::Ai, MatrixEngine::Auto}) {
+    MatrixConfig config = smallConfig();
+    config.engine = engine;
+
+    MatchupMatrix serial(matrixTeams(), config);
+    BattleExecutor one(1);
+    REQUIRE(serial.run(one));
+    REQUIRE(serial.tiles_done() == 4);
+    REQUIRE(serial.games_played() == 9 * 4);
+
+    MatchupMatrix parallel(matrixTeams(), config);
+    BattleExecutor three(3);
+    REQUIRE(parallel.run(three));
+    REQUIRE(sameCells(serial, parallel));
+
+    for (size_t row = 0; row < 3; row++)
+      for (size_t col = 0; col < 3; col++)
+        REQUIRE(serial.cell(row, col).games() == 4);
+  }
+}
+
+TEST_CASE("A matrix resumes from its results file", "[matrix]") {
+  const std::string path = "test_matrix.bin";
+  const std::string torn = "test_matrix_torn.bin";
+  std::remove(path.c_str());
+  std::remove(torn.c_str());
+  BattleExecutor executor(2);
+
+  MatchupMatrix full(matrixTeams(), smallConfig());
+  REQUIRE(full.open(path));
+  REQUIRE(full.run(executor));
+
+  SECTION("A finished file plays nothing more") {
+    MatchupMatrix again(matrixTeams(), smallConfig());
+    REQUIRE(again.open(path));
+    REQUIRE(again.tiles_done() == 4);
+    REQUIRE(again.run(executor));
+    REQUIRE(again.games_played() == 0);
+    REQUIRE(sameCells(full, again));
+  }
+
+  SECTION("A torn last tile is played again") {
+    std::filesystem::copy_file(path, torn);
+    std::filesystem::resize_file(torn, std::filesystem::file_size(torn) - 5);
+
+    MatchupMatrix resumed(matrixTeams(), smallConfig());
+    REQUIRE(resumed.open(torn));
+    REQUIRE(resumed.tiles_done() == 3);
+    REQUIRE(resumed.run(executor));
+    REQUIRE(resumed.tiles_done() == 4);
+    REQUIRE(resumed.games_played() > 0);
+    REQUIRE(sameCells(full, resumed));
+
+    MatchupMatrix reread(matrixTeams(), smallConfig());
+    REQUIRE(reread.open(torn));
+    REQUIRE(reread.tiles_done() == 4);
+  }
+
+  SECTION("A file from other settings is refused") {
+    MatrixConfig other = smallConfig();
+    other.seed = 8;
+    MatchupMatrix different(matrixTeams(), other);
+    REQUIRE_FALSE(different.open(path));
+    REQUIRE(!different.error().empty());
+  }
+
+  std::remove(path.c_str());
+  std::remove(torn.c_str());
+}
@@ -1,10 +1,13 @@
 #include "core/battle.hpp"
+#include "core/battle_output.hpp"
 #include "core/pokemon.hpp"
 #include "data/game_data.hpp"
 #include "data/loader.hpp"
 #include "engine/move_effects.hpp"
 #include <catch2/catch.hpp>
 #include <memory>
+#include <sstream>
+#include <vector>
 
 // Helper to create test Pokemon
 Pokemon createPokemon(const std::string &name, PokeType type1, int level = 50) {
@@ -184,6 +187,53 @@ TEST_CASE("Move Effects - Fixed Damage Moves", "[move][fixed]") {
 
     REQUIRE(result.damage == 20);
   }
+
+  SECTION("Super Fang halves the target's current HP") {
+    Pokemon attacker = createPokemon("Attacker17", PokeType::Normal);
+    Pokemon defender = createPokemon("Defender17", PokeType::Normal);
+
+    auto moveData =
+        createMoveWithEffect("SuperFang", MoveEffectType::FixedDamage, 1);
+    moveData->primary_effect.fixed_damage.type = FixedDamageData::Type::HalfHP;
+
+    defender.take_damage(defender.max_hp() - 41);
+    EffectResult result =
+        apply_move_effect(attacker, defender, moveData.get(), nullptr);
+    REQUIRE(result.damage == 20);
+    REQUIRE(defender.hp() == 21);
+
+    // Never less than 1
+    defender.take_damage(defender.hp() - 1);
+    result = apply_move_effect(attacker, defender, moveData.get(), nullptr);
+    REQUIRE(result.damage == 1);
+    REQUIRE(defender.hp() == 0);
+  }
+}
+
+TEST_CASE("Move Effects - Healing", "[move][heal]") {
+  load_type_chart("src/data/type_chart.json");
+
+  SECTION("Recover restores half of max HP, and fails at full HP") {
+    Pokemon attacker = createPokemon("Attacker18", PokeType::Normal);
+    Pokemon defender = createPokemon("Defender18", PokeType::Normal);
+
+    auto moveData = createMoveWithEffect("Recover", MoveEffectType::Heal, 0);
+    moveData->category = MoveCategory::Status;
+    moveData->primary_effect.heal_percent = 50;
+
+    EffectResult result =
+        apply_move_effect(attacker, defender, moveData.get(), nullptr);
+    REQUIRE_FALSE(result.success);
+    REQUIRE(attacker.hp() == attacker.max_hp());
+
+    attacker.take_damage(attacker.max_hp() - 10);
+    result = apply_move_effect(attacker, defender, moveData.get(), nullptr);
+    REQUIRE(result.success);
+    REQUIRE(attacker.hp() == 10 + attacker.max_hp() / 2);
+
+    apply_move_effect(attacker, defender, moveData.get(), nullptr);
+    REQUIRE(attacker.hp() == attacker.max_hp());
+  }
 }
 
 TEST_CASE("Move Effects - Stat Changes", "[move][stat]") {
@@ -262,6 +312,21 @@ TEST_CASE("Move Effects - Status Infliction", "[move][status]") {
     REQUIRE(result.success);
     REQUIRE(defender.status() == PokeStatus::Toxic);
   }
+
+  SECTION("Toxic damage grows by 1/16 of max HP each turn") {
+    QuietBattleOutput quiet;
+    Pokemon defender = createPokemon("Defender19", PokeType::Normal);
+    REQUIRE(defender.apply_status(PokeStatus::Toxic));
+
+    int sixteenth = defender.max_hp() / 16;
+    int hp = defender.hp();
+    for (int turn = 1; turn <= 3; turn++) {
+      apply_end_of_turn_status_damage(defender);
+      REQUIRE(defender.hp() == hp - sixteenth * turn);
+      hp = defender.hp();
+    }
+    REQUIRE(defender.toxic_counter() == 4);
+  }
 }
 
 TEST_CASE("Move Effects - Confusion", "[move][confusion]") {
@@ -281,3 +346,68 @@ TEST_CASE("Move Effects - Confusion", "[move][confusion]") {
     REQUIRE(defender.volatile_status() == VolatileStatus::Confusion);
   }
 }
+
+TEST_CASE("Move Effects - Handlers report events", "[move][events]") {
+  load_type_chart("src/data/type_chart.json");
+
+  struct Recorder : BattleEventSink {
+    std::vector<BattleEvent> events;
+    void on_event(const BattleEvent &event) override {
+      events.push_back(event);
+    }
+  };
+
+  SECTION("GameData resolves the handler when a move is added") {
+    auto moveData =
+        createMoveWithEffect("HandlerHaze", MoveEffectType::Haze, 0);
+    GameData::getInstance().addMove("HandlerHaze", std::move(moveData));
+    const MoveData *move = GameData::getInstance().getMove("HandlerHaze");
+
+    REQUIRE(move->handler == resolve_move_handler(MoveEffectType::Haze));
+  }
+
+  SECTION("Stat changes arrive as events, not text") {
+    Pokemon attacker = createPokemon("Attacker15", PokeType::Normal);
+    Pokemon defender = createPokemon("Defender15", PokeType::Normal);
+
+    auto moveData =
+        createMoveWithEffect("HandlerGrowl", MoveEffectType::StatChange, 0);
+    moveData->primary_effect.stat_change.stat = PokeStat::Attack;
+    moveData->primary_effect.stat_change.stages = -1;
+    moveData->primary_effect.stat_change.target = EffectTarget::Opponent;
+    Move move(moveData.get());
+
+    Recorder recorder;
+    resolve_move_handler(MoveEffectType::StatChange)(
+        attacker, defender, move,
+        compile_move_effect(moveData->primary_effect), recorder);
+
+    REQUIRE(recorder.events.size() == 1);
+    REQUIRE(recorder.events[0].type == BattleEventType::StatChanged);
+    REQUIRE(recorder.events[0].pokemon == &defender);
+    REQUIRE(recorder.events[0].amount == -1);
+
+    std::ostringstream text;
+    write_event(text, recorder.events[0]);
+    REQUIRE(text.str() == "Defender15's Attack fell!\n");
+  }
+
+  SECTION("Damage is reported with its hit count") {
+    Pokemon attacker = createPokemon("Attacker16", PokeType::Fighting);
+    Pokemon defender = createPokemon("Defender16", PokeType::Normal);
+
+    auto moveData =
+        createMoveWithEffect("HandlerKick", MoveEffectType::TwoHit, 30);
+    Move move(moveData.get());
+
+    Recorder recorder;
+    resolve_move_handler(MoveEffectType::TwoHit)(
+        attacker, defender, move,
+        compile_move_effect(moveData->primary_effect), recorder);
+
+    REQUIRE(recorder.events.size() == 1);
+    REQUIRE(recorder.events[0].type == BattleEventType::Damage);
+    REQUIRE(recorder.events[0].hits == 2);
+    REQUIRE(defender.hp() == defender.max_hp() - recorder.events[0].amount);
+  }
+}
@@ -0,0 +1,202 @@
+#include "ai/gen1_ai.hpp"
+#include "ai/random_ai.hpp"
+#include "data/game_data.hpp"
+#include "server/network_battle.hpp"
+#include "server/output_capture.hpp"
+#include "server/replay.hpp"
+#include "server/team_generator.hpp"
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+void addReplayData() {
+  auto &gd = GameData::getInstance();
+  gd.addSpecies("ReplayFire", {"ReplayFire", 60, 80, 55, 90, 70,
+                               PokeType::Fire, PokeType::None});
+  gd.addSpecies("ReplayWater", {"ReplayWater", 80, 60, 75, 50, 80,
+                                PokeType::Water, PokeType::None});
+  gd.setTypeEffectiveness(PokeType::Water, PokeType::Fire, 2.0f);
+
+  auto add = [&](const std::string &name, PokeType type, int power,
+                 MoveEffectType effect) {
+    if (gd.getMove(name))
+      return;
+    auto move = std::make_unique<MoveData>();
+    move->name = name;
+    move->type = type;
+    move->category =
+        power > 0 ? MoveCategory::Physical : MoveCategory::Status;
+    move->power = power;
+    move->accuracy = 100;
+    move->max_pp = 15;
+    move->primary_effect.type = effect;
+    gd.addMove(name, std::move(move));
+  };
+  add("ReplayEmber", PokeType::Fire, 40, MoveEffectType::Damage);
+  add("ReplaySplash", PokeType::Water, 50, MoveEffectType::Damage);
+  add("ReplayConfuse", PokeType::Psychic, 0, MoveEffectType::Confusion);
+}
+
+// Bot battles recorded the way the server records them
+void recordBotBattles(ReplayWriter &writer, int battles, uint32_t seed) {
+  Gen1AI gen1_ai;
+  RandomAI random_ai;
+  std::mt19937 gen(seed);
+  OutputCapture quiet;
+  quiet.start();
+  for (int i = 0; i < battles; i++) {
+    NetworkBattle battle(generate_random_team(3, 30, gen),
+                         generate_random_team(3, 30, gen), nullptr, nullptr);
+    battle.set_ai_controller(1, &gen1_ai, "Gen1AI");
+    battle.set_ai_controller(2, &random_ai, "RandomAI");
+    battle.set_turn_limit(300);
+    battle.set_seed(seed + static_cast<uint32_t>(i));
+    battle.set_replay_writer(&writer);
+    battle.run();
+  }
+  quiet.stop();
+}
+
+} // namespace
+
+TEST_CASE("Recorded battles replay turn for turn", "[replay]") {
+  addReplayData();
+  const std::string path = "test_replays.bin";
+  std::remove(path.c_str());
+
+  {
+    ReplayWriter writer(path, true);
+    REQUIRE(writer.is_open());
+    recordBotBattles(writer, 25, 11);
+    REQUIRE(writer.recorded() == 25);
+  } // Written out on destruction
+
+  DataCatalog catalog;
+  ReplayFile file;
+  REQUIRE(file.open(path, catalog));
+  REQUIRE(file.size() == 25);
+
+  for (size_t i = 0; i < file.size(); i++) {
+    Replay replay = file.read(i);
+    INFO("replay " << i);
+    REQUIRE(replay.team1.size() == 3);
+    REQUIRE(replay.trace.size() == replay.turns.size());
+
+    ReplayCheck check = check_replay(replay, catalog);
+    REQUIRE(check.valid);
+    REQUIRE(check.diverged_at == 0);
+    REQUIRE(check.winner == replay.winner);
+    REQUIRE(check.matches(replay));
+
+    // Seeking lands on the same turn a full read does
+    if (!replay.turns.empty()) {
+      uint32_t last = file.turn_count(i) - 1;
+      ReplayTurn turn = file.turn(i, last);
+      REQUIRE(turn.move1 == replay.turns[last].move1);
+      REQUIRE(turn.switch2 == replay.turns[last].switch2);
+      ReplayTraceEntry entry;
+      REQUIRE(file.trace(i, last, entry));
+      REQUIRE(entry == replay.trace[last]);
+    }
+  }
+
+  // A different seed plays out differently, and the trace says where
+  Replay altered = file.read(0);
+  altered.seed ^= 0x5555;
+  REQUIRE_FALSE(check_replay(altered, catalog).matches(altered));
+
+  Replay impossible = file.read(1);
+  REQUIRE_FALSE(impossible.turns.empty());
+  impossible.turns[0].move1 = 9;
+  REQUIRE_FALSE(check_replay(impossible, catalog).valid);
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Replay writer appends after a torn record", "[replay]") {
+  addReplayData();
+  const std::string path = "test_replays_torn.bin";
+  std::remove(path.c_str());
+
+  {
+    ReplayWriter writer(path);
+    recordBotBattles(writer, 2, 3);
+  }
+  {
+    // A crash mid-write leaves half a record behind
+    std::FILE *file = std::fopen(path.c_str(), "ab");
+    REQUIRE(file);
+    const uint8_t torn[20] = {200, 0, 0, 0, 1, 2, 3};
+    std::fwrite(torn, 1, sizeof(torn), file);
+    std::fclose(file);
+  }
+  {
+    ReplayWriter writer(path);
+    REQUIRE(writer.is_open());
+    recordBotBattles(writer, 1, 4);
+  }
+
+  DataCatalog catalog;
+  ReplayFile file;
+  REQUIRE(file.open(path, catalog));
+  REQUIRE(file.size() == 3);
+  for (size_t i = 0; i < file.size(); i++) {
+    Replay replay = file.read(i);
+    REQUIRE(check_replay(replay, catalog).matches(replay));
+  }
+  std::remove(path.c_str());
+
+  // Anything that is not a replay file is left alone
+  {
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    std::fputs("not a replay", file);
+    std::fclose(file);
+  }
+  ReplayWriter foreign(path);
+  REQUIRE_FALSE(foreign.is_open());
+  REQUIRE_FALSE(file.open(path, catalog));
+  std::remove(path.c_str());
+}
+
+#ifndef _WIN32
+#include <sys/socket.h>
+
+TEST_CASE("A forfeit is part of the replay", "[replay]") {
+  addReplayData();
+  const std::string path = "test_replays_forfeit.bin";
+  std::remove(path.c_str());
+
+  int fds[2];
+  REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  ClientConnection client(new Socket(fds[0]), 1);
+  client.player_name = "Leaver";
+  Socket peer(fds[1]);
+  peer.close(); // Gone before the first move
+
+  std::mt19937 gen(8);
+  Gen1AI ai;
+  {
+    ReplayWriter writer(path);
+    NetworkBattle battle(generate_random_team(3, 30, gen),
+                         generate_random_team(3, 30, gen), &client, nullptr);
+    battle.set_ai_controller(2, &ai, "Gen1AI");
+    battle.set_replay_writer(&writer);
+    OutputCapture quiet;
+    quiet.start();
+    battle.run();
+    quiet.stop();
+    REQUIRE(battle.winner() == 2);
+  }
+
+  DataCatalog catalog;
+  ReplayFile file;
+  REQUIRE(file.open(path, catalog));
+  REQUIRE(file.size() == 1);
+  Replay replay = file.read(0);
+  REQUIRE(replay.forfeit == 1);
+  REQUIRE(replay.winner == 2);
+  REQUIRE(check_replay(replay, catalog).matches(replay));
+  std::remove(path.c_str());
+}
+#endif
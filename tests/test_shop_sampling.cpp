@@ -0,0 +1,125 @@
+#include "allocation_counter.hpp"
+#include "autobattler/shop.hpp"
+#include "core/alias_table.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+
+static void add_pool_species() {
+  auto &gd = GameData::getInstance();
+  // Stat totals 300 / 420 / 470 / 520 / 620 cover every tier
+  gd.addSpecies("PoolCommon",
+                {"PoolCommon", 60, 60, 60, 60, 60, PokeType::Normal,
+                 PokeType::None});
+  gd.addSpecies("PoolUncommon",
+                {"PoolUncommon", 84, 84, 84, 84, 84, PokeType::Water,
+                 PokeType::None});
+  gd.addSpecies("PoolRare", {"PoolRare", 94, 94, 94, 94, 94, PokeType::Fire,
+                             PokeType::None});
+  gd.addSpecies("PoolEpic", {"PoolEpic", 104, 104, 104, 104, 104,
+                             PokeType::Grass, PokeType::None});
+  gd.addSpecies("PoolLegend", {"PoolLegend", 124, 124, 124, 124, 124,
+                               PokeType::Psychic, PokeType::None});
+
+  auto move = std::make_unique<MoveData>();
+  move->name = "PoolMove";
+  move->type = PokeType::Normal;
+  move->category = MoveCategory::Physical;
+  move->power = 40;
+  move->accuracy = 100;
+  move->max_pp = 35;
+  move->primary_effect.type = MoveEffectType::Damage;
+  gd.addMove("PoolMove", std::move(move));
+}
+
+TEST_CASE("Alias table samples in proportion to weights", "[shop]") {
+  AliasTable table({50, 30, 15, 4, 1, 0});
+  std::mt19937 rng(1234);
+  const int draws = 200000;
+  std::vector<int> counts(table.size(), 0);
+  for (int i = 0; i < draws; i++) {
+    counts[table.sample(rng)]++;
+  }
+
+  REQUIRE(counts[0] / double(draws) == Approx(0.50).margin(0.01));
+  REQUIRE(counts[1] / double(draws) == Approx(0.30).margin(0.01));
+  REQUIRE(counts[2] / double(draws) == Approx(0.15).margin(0.01));
+  REQUIRE(counts[3] / double(draws) == Approx(0.04).margin(0.005));
+  REQUIRE(counts[4] / double(draws) == Approx(0.01).margin(0.003));
+  REQUIRE(counts[5] == 0);
+
+  // All-zero weights fall back to uniform
+  AliasTable uniform({0, 0});
+  int first = 0;
+  for (int i = 0; i < 10000; i++) {
+    first += uniform.sample(rng) == 0;
+  }
+  REQUIRE(first == Approx(5000).margin(300));
+}
+
+TEST_CASE("Species pools bucket species by stat total", "[shop]") {
+  add_pool_species();
+  std::shared_ptr<const SpeciesPools> current = SpeciesPools::current();
+  const SpeciesPools &pools = *current;
+
+  auto in_pool = [&](Rarity rarity, const std::string &name) {
+    const auto &pool = pools.pool(rarity);
+    return std::any_of(pool.begin(), pool.end(), [&](const SpeciesData *s) {
+      return s->name == name;
+    });
+  };
+  REQUIRE(in_pool(Rarity::Common, "PoolCommon"));
+  REQUIRE(in_pool(Rarity::Uncommon, "PoolUncommon"));
+  REQUIRE(in_pool(Rarity::Rare, "PoolRare"));
+  REQUIRE(in_pool(Rarity::Epic, "PoolEpic"));
+  REQUIRE(in_pool(Rarity::Legendary, "PoolLegend"));
+  REQUIRE_FALSE(in_pool(Rarity::Common, "PoolLegend"));
+
+  std::mt19937 rng(7);
+  for (int i = 0; i < 100; i++) {
+    const SpeciesData *picked = pools.pick(Rarity::Legendary, rng);
+    REQUIRE(picked != nullptr);
+    REQUIRE(rarity_for_stat_total(picked->hp + picked->attack +
+                                  picked->defense + picked->special +
+                                  picked->speed) == Rarity::Legendary);
+  }
+}
+
+TEST_CASE("Species pools follow the pinned snapshot", "[shop]") {
+  add_pool_species();
+  std::shared_ptr<const GameDataSnapshot> pinned =
+      GameData::getInstance().snapshot();
+  std::shared_ptr<const SpeciesPools> before = SpeciesPools::current();
+  REQUIRE(SpeciesPools::current() == before); // Built once per snapshot
+
+  GameData::getInstance().addSpecies(
+      "PoolLate", {"PoolLate", 60, 60, 60, 60, 60, PokeType::Normal,
+                   PokeType::None});
+  auto has_late = [](const SpeciesPools &pools) {
+    const auto &pool = pools.pool(Rarity::Common);
+    return std::any_of(pool.begin(), pool.end(), [](const SpeciesData *s) {
+      return s->name == "PoolLate";
+    });
+  };
+  REQUIRE(has_late(*SpeciesPools::current()));
+  REQUIRE_FALSE(has_late(*before));
+
+  GameDataScope scope(*pinned);
+  REQUIRE(SpeciesPools::current() == before);
+}
+
+TEST_CASE("Shop refresh does not allocate", "[shop]") {
+  add_pool_species();
+  Shop shop(3);
+  shop.refresh(); // Pools are built on first use
+
+  AllocationScope scope;
+  for (int i = 0; i < 1000; i++) {
+    shop.refresh();
+  }
+  REQUIRE(scope.allocations() == 0);
+
+  for (const ShopSlot &slot : shop.slots()) {
+    REQUIRE(slot.species != nullptr);
+    REQUIRE(slot.cost == get_base_cost(slot.rarity));
+  }
+}
@@ -0,0 +1,107 @@
+#include "network/protocol.hpp"
+#include "server/spectator_hub.hpp"
+#include <catch2/catch.hpp>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+
+// A connected spectator plus the reading end of its socket
+struct SpectatorPair {
+  ClientConnection *client;
+  Socket *reader;
+
+  SpectatorPair() {
+    int fds[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    int small = 4096;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+    setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &small, sizeof(small));
+    client = new ClientConnection(new Socket(fds[0]), 1);
+    client->player_name = "Watcher";
+    reader = new Socket(fds[1]);
+  }
+
+  ~SpectatorPair() {
+    delete client;
+    delete reader;
+  }
+
+  // Everything readable right now, decoded
+  std::vector<Message> drain() {
+    reader->set_non_blocking(true);
+    FrameDecoder decoder;
+    uint8_t buffer[4096];
+    long received;
+    while ((received = reader->receive_some(buffer, sizeof(buffer))) > 0) {
+      decoder.feed(buffer, static_cast<size_t>(received));
+    }
+    std::vector<Message> messages;
+    Message msg;
+    while (decoder.next(msg)) {
+      messages.push_back(msg);
+    }
+    return messages;
+  }
+};
+
+TEST_CASE("Spectators share one encoded frame", "[spectate]") {
+  SpectatorHub hub;
+  SpectatorPair a, b;
+  hub.add(a.client);
+  hub.add(b.client);
+
+  SharedFrame frame = encode_frame(Message(MessageType::BATTLE_LOG, "hello"));
+  hub.publish(frame);
+
+  // Both spectators got the bytes; nobody kept a private copy queued
+  REQUIRE(frame.use_count() == 1);
+  REQUIRE(a.drain()[0].get_payload_string() == "hello");
+  REQUIRE(b.drain()[0].get_payload_string() == "hello");
+  REQUIRE(hub.stats().bytes_written == 2 * frame->size());
+  hub.release(0);
+}
+
+TEST_CASE("Late spectators start from the latest keyframe", "[spectate]") {
+  SpectatorHub hub;
+  hub.publish(encode_frame(Message(MessageType::BATTLE_UPDATE, "turn 1")),
+              true);
+  hub.publish(encode_frame(Message(MessageType::BATTLE_LOG, "log")));
+  hub.publish(encode_frame(Message(MessageType::BATTLE_UPDATE, "turn 2")),
+              true);
+
+  SpectatorPair late;
+  hub.add(late.client);
+  std::vector<Message> received = late.drain();
+  REQUIRE(received.size() == 1);
+  REQUIRE(received[0].get_payload_string() == "turn 2");
+  hub.release(0);
+}
+
+TEST_CASE("Slow spectators skip ahead and are eventually dropped",
+          "[spectate]") {
+  SpectatorHub hub(8 * 1024, 2);
+  SpectatorPair slow, fast;
+  hub.add(slow.client);
+  hub.add(fast.client);
+
+  // The slow spectator never reads, so its socket buffer fills up
+  std::string payload(1024, 'x');
+  int fast_received = 0;
+  for (int turn = 0; turn < 200; turn++) {
+    hub.publish(encode_frame(Message(MessageType::BATTLE_LOG, payload)));
+    hub.publish(encode_frame(Message(MessageType::BATTLE_UPDATE,
+                                     "turn " + std::to_string(turn))),
+                true);
+    fast_received += static_cast<int>(fast.drain().size());
+  }
+
+  SpectatorStats stats = hub.stats();
+  REQUIRE(stats.skips > 0);
+  REQUIRE(stats.dropped == 1);
+  REQUIRE_FALSE(slow.client->socket->is_connected());
+  REQUIRE(fast.client->socket->is_connected());
+  REQUIRE(fast_received == 400);
+
+  REQUIRE(hub.release(0).size() == 2);
+}
+#endif
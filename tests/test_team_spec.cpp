@@ -0,0 +1,149 @@
+#include "autobattler/auto_battle.hpp"
+#include "autobattler/team_cache.hpp"
+#include "core/rng.hpp"
+#include "data/game_data.hpp"
+#include "data/team_spec.hpp"
+#include <catch2/catch.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const MoveData *addSpecMove(const std::string &name, PokeType type,
+                            int power) {
+  auto &gd = GameData::getInstance();
+  if (!gd.getMove(name)) {
+    auto move = std::make_unique<MoveData>();
+    move->name = name;
+    move->type = type;
+    move->category = MoveCategory::Physical;
+    move->power = power;
+    move->max_pp = 20;
+    move->primary_effect.type = MoveEffectType::Damage;
+    gd.addMove(name, std::move(move));
+  }
+  return gd.getMove(name);
+}
+
+// Two-member teams; `variant` changes the moves and DVs
+std::vector<Pokemon> specTeam(int variant) {
+  auto &gd = GameData::getInstance();
+  gd.setTypeEffectiveness(PokeType::Water, PokeType::Fire, 2.0f);
+  gd.addSpecies("SpecFire", {"SpecFire", 60, 80, 60, 90, 70, PokeType::Fire,
+                             PokeType::None});
+  gd.addSpecies("SpecWater", {"SpecWater", 90, 70, 80, 50, 60,
+                              PokeType::Water, PokeType::Ice});
+  const MoveData *splash = addSpecMove("SpecSplashHit", PokeType::Water, 50);
+  const MoveData *flame = addSpecMove("SpecFlame", PokeType::Fire, 60);
+  const MoveData *tackle = addSpecMove("SpecTackle", PokeType::Normal, 40);
+
+  std::vector<Pokemon> team;
+  Pokemon fire("SpecFire", 40 + variant);
+  fire.add_move(Move(flame));
+  fire.add_move(Move(tackle));
+  fire.set_dvs(10 + variant, 3, 15, 8);
+  team.push_back(fire);
+
+  Pokemon water("SpecWater", 45);
+  water.add_move(Move(variant ? tackle : splash));
+  team.push_back(water);
+  return team;
+}
+
+} // namespace
+
+TEST_CASE("TeamSpec round-trips a team", "[teamspec]") {
+  std::vector<Pokemon> team = specTeam(0);
+  TeamSpec spec;
+  REQUIRE(TeamSpec::from_team(team, spec));
+  REQUIRE(spec.size == 2);
+  REQUIRE(spec.dv(0, PokeStat::Attack) == 10);
+  REQUIRE(spec.dv(0, PokeStat::HP) == 0b0110); // Low bits of 10, 3, 15, 8
+  REQUIRE(spec.move(1, 1) == NO_MOVE);
+
+  std::vector<Pokemon> rebuilt;
+  REQUIRE(spec.to_team(rebuilt));
+  REQUIRE(rebuilt.size() == team.size());
+  for (size_t i = 0; i < team.size(); i++) {
+    REQUIRE(rebuilt[i].name() == team[i].name());
+    REQUIRE(rebuilt[i].level() == team[i].level());
+    REQUIRE(rebuilt[i].move_count() == team[i].move_count());
+    REQUIRE(rebuilt[i].ivs() == team[i].ivs());
+    for (int s = 0; s < 5; s++) {
+      PokeStat stat = static_cast<PokeStat>(s);
+      REQUIRE(rebuilt[i].stat(stat) == team[i].stat(stat));
+    }
+    for (int m = 0; m < team[i].move_count(); m++)
+      REQUIRE(rebuilt[i].get_move(m).data == team[i].get_move(m).data);
+  }
+}
+
+TEST_CASE("TeamSpec equality and hash follow the team", "[teamspec]") {
+  TeamSpec a, b, c;
+  REQUIRE(TeamSpec::from_team(specTeam(0), a));
+  REQUIRE(TeamSpec::from_team(specTeam(0), b));
+  REQUIRE(TeamSpec::from_team(specTeam(1), c));
+
+  REQUIRE(a == b);
+  REQUIRE(a.hash() == b.hash());
+  REQUIRE(a != c);
+  REQUIRE(a.hash() != c.hash());
+
+  std::vector<Pokemon> seven(7, specTeam(0)[0]);
+  TeamSpec too_big;
+  REQUIRE_FALSE(TeamSpec::from_team(seven, too_big));
+  REQUIRE(too_big.size == 0);
+}
+
+TEST_CASE("TeamCache shares one interned team per spec", "[teamspec]") {
+  TeamSpec spec;
+  REQUIRE(TeamSpec::from_team(specTeam(0), spec));
+  TeamCache cache;
+
+  std::shared_ptr<const InternedTeam> first = cache.intern(spec);
+  REQUIRE(first);
+  REQUIRE(first->fast);
+  REQUIRE(first->matchups.size() == 2);
+  REQUIRE(first->matchups[0][static_cast<size_t>(PokeType::Water)] == 2.0f);
+  REQUIRE(cache.intern(spec) == first);
+
+  std::vector<std::shared_ptr<const InternedTeam>> seen(4);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < seen.size(); t++)
+    threads.emplace_back([&, t]() { seen[t] = cache.intern(spec); });
+  for (std::thread &thread : threads)
+    thread.join();
+  for (const auto &team : seen)
+    REQUIRE(team == first);
+  REQUIRE(cache.size() == 1);
+}
+
+TEST_CASE("Interned teams fight like the teams they came from",
+          "[teamspec][fast]") {
+  std::vector<Pokemon> team1 = specTeam(0);
+  std::vector<Pokemon> team2 = specTeam(1);
+  TeamSpec spec1, spec2;
+  REQUIRE(TeamSpec::from_team(team1, spec1));
+  REQUIRE(TeamSpec::from_team(team2, spec2));
+  TeamCache cache;
+  auto interned1 = cache.intern(spec1);
+  auto interned2 = cache.intern(spec2);
+
+  for (uint32_t seed = 1; seed <= 20; seed++) {
+    FastAutoBattle from_vectors;
+    REQUIRE(from_vectors.load(team1, team2));
+    rng_seed(seed);
+    BattleResult expected = from_vectors.run();
+
+    FastAutoBattle from_cache;
+    REQUIRE(from_cache.load(*interned1, *interned2));
+    rng_seed(seed);
+    REQUIRE(from_cache.run() == expected);
+    for (int t = 1; t <= 2; t++) {
+      for (int i = 0; i < 2; i++)
+        REQUIRE(from_cache.side(t).mons[i].hp ==
+                from_vectors.side(t).mons[i].hp);
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#include "core/timeline.hpp"
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Timeline spans are written as Chrome trace JSON", "[timeline]") {
+  {
+    timeline::Span ignored("test", "before start"); // Not recording yet
+  }
+  size_t before = timeline::event_count();
+  timeline::start();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 3; t++) {
+    threads.emplace_back([t]() {
+      timeline::name_thread("test worker " + std::to_string(t));
+      for (uint32_t turn = 1; turn <= 5000; turn++) // Spills into a 2nd chunk
+        timeline::Span span("test", "turn", 77, turn);
+    });
+  }
+  {
+    timeline::Span outer("test", "wait for workers");
+    for (auto &thread : threads)
+      thread.join();
+  }
+  timeline::stop();
+  REQUIRE(timeline::event_count() == before + 3 * 5000 + 1);
+
+  const std::string path = "test_timeline.json";
+  REQUIRE(timeline::write_chrome_trace(path));
+  std::ifstream in(path);
+  nlohmann::json trace = nlohmann::json::parse(in);
+  in.close();
+  std::remove(path.c_str());
+
+  size_t turns = 0;
+  size_t thread_names = 0;
+  bool saw_outer = false;
+  for (const auto &event : trace["traceEvents"]) {
+    if (event["ph"] == "M") {
+      std::string name = event["args"]["name"];
+      if (name.rfind("test worker", 0) == 0)
+        thread_names++;
+      continue;
+    }
+    REQUIRE(event["ph"] == "X");
+    REQUIRE(event["name"] != "before start");
+    if (event["name"] == "turn") {
+      REQUIRE(event["args"]["id"] == 77);
+      turns++;
+    }
+    if (event["name"] == "wait for workers")
+      saw_outer = true;
+  }
+  REQUIRE(turns == 3 * 5000);
+  REQUIRE(thread_names == 3);
+  REQUIRE(saw_outer);
+}
@@ -0,0 +1,133 @@
+#include "ai/random_ai.hpp"
+#include "data/game_data.hpp"
+#include "server/battle_executor.hpp"
+#include "server/tournament.hpp"
+#include <catch2/catch.hpp>
+#include <memory>
+
+namespace {
+
+const MoveData *tournamentTestMove() {
+  static std::unique_ptr<MoveData> move = [] {
+    auto data = std::make_unique<MoveData>();
+    data->name = "TourneyTackle";
+    data->type = PokeType::Normal;
+    data->category = MoveCategory::Physical;
+    data->power = 60;
+    data->accuracy = 100;
+    data->max_pp = 35;
+    data->primary_effect.type = MoveEffectType::Damage;
+    return data;
+  }();
+  return move.get();
+}
+
+std::vector<Pokemon> tournamentTestTeam(int size) {
+  GameData::getInstance().addSpecies(
+      "TourneyMon",
+      {"TourneyMon", 60, 80, 60, 70, 60, PokeType::Normal, PokeType::None});
+
+  std::vector<Pokemon> team;
+  for (int i = 0; i < size; i++) {
+    Pokemon mon("TourneyMon", 50);
+    mon.add_move(Move(tournamentTestMove()));
+    team.push_back(mon);
+  }
+  return team;
+}
+
+void addBots(Tournament &tournament, int count, const BattleAI &ai) {
+  for (int i = 0; i < count; i++) {
+    tournament.add_bot("Bot" + std::to_string(i), tournamentTestTeam(2), &ai);
+  }
+}
+
+} // namespace
+
+TEST_CASE("Tournament - Swiss round count", "[tournament]") {
+  REQUIRE(Tournament::swiss_round_count(2) == 1);
+  REQUIRE(Tournament::swiss_round_count(8) == 3);
+  REQUIRE(Tournament::swiss_round_count(9) == 4);
+  REQUIRE(Tournament::swiss_round_count(1024) == 10);
+}
+
+TEST_CASE("Tournament - Single elimination", "[tournament]") {
+  BattleExecutor executor(2);
+  RandomAI ai;
+
+  SECTION("Power of two field") {
+    Tournament tournament(TournamentFormat::SingleElimination, executor);
+    tournament.set_verbose(false);
+    addBots(tournament, 8, ai);
+
+    int champion = tournament.run();
+    REQUIRE(champion >= 0);
+    REQUIRE(tournament.rounds_played() == 3);
+    REQUIRE(tournament.matches().size() == 7);
+    REQUIRE_FALSE(tournament.entrants()[champion].eliminated);
+    REQUIRE(tournament.entrants()[champion].wins == 3);
+
+    int eliminated = 0;
+    for (const auto &entrant : tournament.entrants()) {
+      if (entrant.eliminated)
+        eliminated++;
+    }
+    REQUIRE(eliminated == 7);
+  }
+
+  SECTION("Odd field gets first round byes") {
+    Tournament tournament(TournamentFormat::SingleElimination, executor);
+    tournament.set_verbose(false);
+    addBots(tournament, 13, ai);
+
+    int champion = tournament.run();
+    REQUIRE(champion >= 0);
+    REQUIRE(tournament.rounds_played() == 4);
+
+    int byes = 0;
+    for (const auto &match : tournament.matches()) {
+      if (match.entrant2 == -1) {
+        byes++;
+        REQUIRE(match.round == 1);
+      }
+    }
+    REQUIRE(byes == 3);
+  }
+}
+
+TEST_CASE("Tournament - Double elimination", "[tournament]") {
+  BattleExecutor executor(2);
+  RandomAI ai;
+  Tournament tournament(TournamentFormat::DoubleElimination, executor);
+  tournament.set_verbose(false);
+  addBots(tournament, 11, ai);
+
+  int champion = tournament.run();
+  REQUIRE(champion >= 0);
+  REQUIRE(tournament.entrants()[champion].losses <= 1);
+
+  for (size_t i = 0; i < tournament.entrants().size(); i++) {
+    if (static_cast<int>(i) == champion)
+      continue;
+    REQUIRE(tournament.entrants()[i].losses == 2);
+    REQUIRE(tournament.entrants()[i].eliminated);
+  }
+}
+
+TEST_CASE("Tournament - Swiss", "[tournament]") {
+  BattleExecutor executor(2);
+  RandomAI ai;
+  Tournament tournament(TournamentFormat::Swiss, executor);
+  tournament.set_verbose(false);
+  addBots(tournament, 9, ai);
+
+  int champion = tournament.run();
+  REQUIRE(champion >= 0);
+  REQUIRE(tournament.rounds_played() == 4);
+
+  // Everyone plays (or sits out) every round
+  for (const auto &entrant : tournament.entrants()) {
+    REQUIRE(entrant.wins + entrant.losses == 4);
+    REQUIRE(entrant.wins <= tournament.entrants()[champion].wins);
+  }
+}